@@ -0,0 +1,196 @@
+/*
+  SignalFilter.cpp - one channel of a sensor filter bank for OpenCR
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include <math.h>
+#include "SignalFilter.h"
+
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+SignalFilter::SignalFilter( void )
+{
+  deadband = 0.0f;
+  setNone();
+}
+
+void SignalFilter::setNone( void )
+{
+  type   = SIGNAL_FILTER_NONE;
+  length = 1;
+  reset();
+}
+
+// Mean of the last length samples
+bool SignalFilter::setAverage( uint8_t length )
+{
+  if (length == 0 || length > SIGNAL_FILTER_AVERAGE_MAX)
+  {
+    return false;
+  }
+
+  this->type   = SIGNAL_FILTER_AVERAGE;
+  this->length = length;
+  reset();
+
+  return true;
+}
+
+// First order, bilinear transform with the cutoff prewarped
+bool SignalFilter::setLowPass1( float cutoff_hz, float sample_hz )
+{
+  float k;
+
+  if (cutoff_hz <= 0.0f || cutoff_hz >= sample_hz / 2.0f)
+  {
+    return false;
+  }
+
+  k  = tanf((float)M_PI * cutoff_hz / sample_hz);
+  b0 = k / (1.0f + k);
+  b1 = b0;
+  b2 = 0.0f;
+  a1 = (k - 1.0f) / (k + 1.0f);
+  a2 = 0.0f;
+
+  type = SIGNAL_FILTER_LOWPASS1;
+  reset();
+
+  return true;
+}
+
+// Second order Butterworth with the default q
+bool SignalFilter::setLowPass2( float cutoff_hz, float sample_hz, float q )
+{
+  return setBiquad(SIGNAL_FILTER_LOWPASS2, cutoff_hz, sample_hz, q);
+}
+
+// Rejects center_hz, the bandwidth is center_hz / q
+bool SignalFilter::setNotch( float center_hz, float sample_hz, float q )
+{
+  return setBiquad(SIGNAL_FILTER_NOTCH, center_hz, sample_hz, q);
+}
+
+// Outputs with a magnitude below deadband are 0
+void SignalFilter::setDeadband( float deadband )
+{
+  this->deadband = deadband;
+}
+
+uint8_t SignalFilter::getType( void )
+{
+  return type;
+}
+
+void SignalFilter::reset( void )
+{
+  primed = false;
+}
+
+float SignalFilter::apply( float input )
+{
+  float   output;
+  uint8_t i;
+
+  switch (type)
+  {
+    case SIGNAL_FILTER_AVERAGE:
+      if (primed == false)
+      {
+        for (i=0; i<length; i++)
+        {
+          ring[i] = input;
+        }
+        sum    = input * length;
+        index  = 0;
+        primed = true;
+      }
+      sum += input - ring[index];
+      ring[index] = input;
+      index++;
+      if (index >= length)
+      {
+        // Rounding errors of the running sum do not build up
+        index = 0;
+        sum   = 0.0f;
+        for (i=0; i<length; i++)
+        {
+          sum += ring[i];
+        }
+      }
+      output = sum / length;
+      break;
+
+    case SIGNAL_FILTER_LOWPASS1:
+    case SIGNAL_FILTER_LOWPASS2:
+    case SIGNAL_FILTER_NOTCH:
+      if (primed == false)
+      {
+        // Steady state of a constant input, the DC gain is 1
+        z2     = input * (b2 - a2);
+        z1     = input * (b1 - a1) + z2;
+        primed = true;
+      }
+      output = b0 * input + z1;
+      z1     = b1 * input - a1 * output + z2;
+      z2     = b2 * input - a2 * output;
+      break;
+
+    default:
+      output = input;
+      break;
+  }
+
+  if (fabsf(output) < deadband)
+  {
+    output = 0.0f;
+  }
+
+  return output;
+}
+
+bool SignalFilter::setBiquad( uint8_t biquad_type, float freq_hz, float sample_hz, float q )
+{
+  float w0;
+  float cos_w0;
+  float alpha;
+  float a0;
+
+  if (freq_hz <= 0.0f || freq_hz >= sample_hz / 2.0f || q <= 0.0f)
+  {
+    return false;
+  }
+
+  w0     = 2.0f * (float)M_PI * freq_hz / sample_hz;
+  cos_w0 = cosf(w0);
+  alpha  = sinf(w0) / (2.0f * q);
+  a0     = 1.0f + alpha;
+
+  if (biquad_type == SIGNAL_FILTER_NOTCH)
+  {
+    b0 = 1.0f / a0;
+    b1 = -2.0f * cos_w0 / a0;
+    b2 = b0;
+  }
+  else
+  {
+    b0 = (1.0f - cos_w0) / 2.0f / a0;
+    b1 = (1.0f - cos_w0) / a0;
+    b2 = b0;
+  }
+  a1 = -2.0f * cos_w0 / a0;
+  a2 = (1.0f - alpha) / a0;
+
+  type = biquad_type;
+  reset();
+
+  return true;
+}
@@ -0,0 +1,71 @@
+/*
+  SignalFilter.h - one channel of a sensor filter bank for OpenCR
+
+  Moving average on a ring with a running sum, first and second order
+  low-pass and notch filters as a biquad (transposed direct form II),
+  followed by an optional deadband. The running sum is added up again
+  from the ring each time the ring wraps, so that rounding errors do not
+  build up: that sample costs length more additions than the others.
+
+  The IIR coefficients are computed from the sample rate of the channel,
+  configure it again when the rate changes.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#ifndef _SIGNAL_FILTER_H_
+#define _SIGNAL_FILTER_H_
+
+#include <stdint.h>
+
+
+#define SIGNAL_FILTER_NONE          0
+#define SIGNAL_FILTER_AVERAGE       1
+#define SIGNAL_FILTER_LOWPASS1      2
+#define SIGNAL_FILTER_LOWPASS2      3
+#define SIGNAL_FILTER_NOTCH         4
+
+#define SIGNAL_FILTER_AVERAGE_MAX   16
+
+
+class SignalFilter
+{
+  public:
+    SignalFilter( void );
+
+    void    setNone( void );
+    bool    setAverage( uint8_t length );
+    bool    setLowPass1( float cutoff_hz, float sample_hz );
+    bool    setLowPass2( float cutoff_hz, float sample_hz, float q = 0.7071f );
+    bool    setNotch( float center_hz, float sample_hz, float q = 2.0f );
+    void    setDeadband( float deadband );
+
+    uint8_t getType( void );
+
+    // The next sample starts the filter as if it had always been the input
+    void    reset( void );
+    float   apply( float input );
+
+  private:
+    uint8_t type;
+    bool    primed;
+    float   deadband;
+
+    // SIGNAL_FILTER_AVERAGE
+    float   ring[SIGNAL_FILTER_AVERAGE_MAX];
+    float   sum;
+    uint8_t length;
+    uint8_t index;
+
+    // SIGNAL_FILTER_LOWPASS1, LOWPASS2, NOTCH
+    float   b0, b1, b2;
+    float   a1, a2;
+    float   z1, z2;
+
+    bool    setBiquad( uint8_t biquad_type, float freq_hz, float sample_hz, float q );
+};
+
+#endif /* _SIGNAL_FILTER_H_ */
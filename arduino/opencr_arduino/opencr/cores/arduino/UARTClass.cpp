@@ -39,6 +39,10 @@ UARTClass::UARTClass(uint8_t uart_num, uint8_t uart_mode, uint8_t *txBuffer, uin
   tx_write_size = 0;
   tx_buffer.buffer = txBuffer;
   tx_buffer.buffer_size = tx_buffer_size;
+  tx_queue_head = 0;
+  tx_queue_tail = 0;
+  tx_blocking = true;
+  tx_callback = NULL;
 }
 
 void UARTClass::begin(const uint32_t dwBaudRate)
@@ -55,6 +59,8 @@ void UARTClass::begin(const uint32_t dwBaudRate, const UARTModes config)
 #endif
   tx_buffer.iHead = 0;
   tx_buffer.iTail = 0;
+  tx_queue_head = 0;
+  tx_queue_tail = 0;
 
   _uart_baudrate = dwBaudRate;
 
@@ -91,7 +97,7 @@ int UARTClass::availableForWrite(void)
 {
   int head = tx_buffer.iHead;
   int tail = tx_buffer.iTail;
-  if (head >= tail) return SERIAL_BUFFER_SIZE - 1 - head + tail;
+  if (head >= tail) return tx_buffer.buffer_size - 1 - head + tail;
   return tail - head - 1;
 }
 
@@ -181,48 +187,172 @@ size_t UARTClass::write( const uint8_t uc_data )
 {
   return write(&uc_data, 1); // Lets call the buffer function to do the main work
 }
+// Called with interrupts disabled or from the TX interrupt
 void inline UARTClass::startNextTransmitDMAorIT()
 {
-  tx_write_size = (tx_buffer.iTail < tx_buffer.iHead)? tx_buffer.iHead-tx_buffer.iTail : tx_buffer.buffer_size - tx_buffer.iTail;
-  if (drv_uart_write_dma_it(_uart_num, &tx_buffer.buffer[tx_buffer.iTail], tx_write_size) != 0) 
+  if (tx_queue_tail == tx_queue_head)
   {
-    tx_write_size = 0;  // error so clear it out
+    tx_write_size = 0;
+    return;
+  }
+  tx_write_size = tx_queue[tx_queue_tail].length;
+  if (drv_uart_write_dma_it(_uart_num, tx_queue[tx_queue_tail].buffer, tx_write_size) != 0) 
+  {
+    tx_write_size = 0;  // error so clear it out, the next write tries again
   }
 }
 
+// Copies what fits in one piece of free TX buffer and queues it
+size_t UARTClass::copyToTxBuffer( const uint8_t *buffer, size_t size )
+{
+  uint16_t head = tx_buffer.iHead;
+  uint16_t tail = tx_buffer.iTail;
+  uint16_t last;
+  size_t   length;
+
+  if (head >= tail)
+  {
+    length = tx_buffer.buffer_size - head - (tail == 0 ? 1 : 0);
+  }
+  else
+  {
+    length = tail - head - 1;
+  }
+  if (length > size)
+  {
+    length = size;
+  }
+  if (length == 0)
+  {
+    return 0;
+  }
+
+  // The free part of the buffer is not read until it is queued
+  memcpy(&tx_buffer.buffer[head], buffer, length);
+
+  __disable_irq();
+  last = (tx_queue_head + SERIAL_TX_QUEUE_SIZE - 1) % SERIAL_TX_QUEUE_SIZE;
+  if (tx_queue_head != tx_queue_tail
+      && (last != tx_queue_tail || tx_write_size == 0)
+      && tx_queue[last].copied == true
+      && tx_queue[last].buffer + tx_queue[last].length == &tx_buffer.buffer[head]
+      && tx_queue[last].length + length <= 0xFFFF)
+  {
+    // Joins the bytes of the previous write that is not transmitted yet
+    tx_queue[last].length += length;
+  }
+  else if ((tx_queue_head + 1) % SERIAL_TX_QUEUE_SIZE != tx_queue_tail)
+  {
+    tx_queue[tx_queue_head].buffer = &tx_buffer.buffer[head];
+    tx_queue[tx_queue_head].length = length;
+    tx_queue[tx_queue_head].copied = true;
+    tx_queue_head = (tx_queue_head + 1) % SERIAL_TX_QUEUE_SIZE;
+  }
+  else
+  {
+    length = 0;
+  }
+  if (length > 0)
+  {
+    tx_buffer.iHead = (head + length) % tx_buffer.buffer_size;
+  }
+  if (!tx_write_size)
+  {
+    startNextTransmitDMAorIT();
+  }
+  __enable_irq();
+
+  return length;
+}
+
 size_t UARTClass::write( const uint8_t *buffer, size_t size )
 {
-  tx_cnt += size;
-  size_t cbLeft = size; 
+  size_t written = 0;
+  size_t length;
 
-  // Lets try to put as much of this data into our TX buffer as possible. 
-  while (cbLeft--) 
+  // At most two copies, up to the end of the TX buffer and from its start
+  while (written < size)
   {
-    uint16_t nextWrite = (tx_buffer.iHead + 1) % tx_buffer.buffer_size;
-    if (tx_buffer.iTail == nextWrite) 
+    length = copyToTxBuffer(&buffer[written], size - written);
+    written += length;
+
+    if (length == 0)
     {
-      // See if we have an active TX or not
-      if (!tx_write_size)
+      if (tx_blocking == false)
       {
-        startNextTransmitDMAorIT();
+        break;
       }
-      // right now this will wait for the entire previous write to complete before continue...
-      while (tx_buffer.iTail == nextWrite) 
+      // Waits for the transfers to free the buffer or the queue
+      if (!tx_write_size)
       {
-
+        __disable_irq();
+        startNextTransmitDMAorIT();
+        __enable_irq();
       }
     }
-    tx_buffer.buffer[tx_buffer.iHead] = *buffer++;
-    tx_buffer.iHead = nextWrite;
+  }
 
+  tx_cnt += written;
+  return written; 
+}
+
+size_t UARTClass::writeRef( const uint8_t *buffer, size_t size )
+{
+  uint32_t addr;
+
+  if (size == 0)
+  {
+    return 0;
   }
-  // we finished putting stuff on queue, so see if we need to start up write
-  // or if it is already going. 
-  if (!tx_write_size)
+  if (size > 0xFFFF)
   {
-    startNextTransmitDMAorIT();
+    size = 0xFFFF;
+  }
+
+  // DMA reads the memory, not the data cache
+  addr = (uint32_t)buffer & ~31UL;
+  SCB_CleanDCache_by_Addr((uint32_t *)addr, (int32_t)((uint32_t)buffer + size - addr));
+
+  while (1)
+  {
+    __disable_irq();
+    if ((tx_queue_head + 1) % SERIAL_TX_QUEUE_SIZE != tx_queue_tail)
+    {
+      tx_queue[tx_queue_head].buffer = buffer;
+      tx_queue[tx_queue_head].length = size;
+      tx_queue[tx_queue_head].copied = false;
+      tx_queue_head = (tx_queue_head + 1) % SERIAL_TX_QUEUE_SIZE;
+      if (!tx_write_size)
+      {
+        startNextTransmitDMAorIT();
+      }
+      __enable_irq();
+      break;
+    }
+    if (!tx_write_size)
+    {
+      startNextTransmitDMAorIT();
+    }
+    __enable_irq();
+
+    if (tx_blocking == false)
+    {
+      return 0;
+    }
   }
-  return size; 
+
+  tx_cnt += size;
+  return size;
+}
+
+void UARTClass::setWriteBlocking( bool blocking )
+{
+  tx_blocking = blocking;
+}
+
+void UARTClass::attachTxCallback( UARTTxCallback callback )
+{
+  tx_callback = callback;
 }
 
 
@@ -261,18 +391,29 @@ void UARTClass::RxHandler (void)
 
 void UARTClass::TxHandler(void)
 {
-  // We completed previous write, so update our tail pointer by count
-  tx_buffer.iTail += tx_write_size; 
-  if (tx_buffer.iTail >= tx_buffer.buffer_size) 
-    tx_buffer.iTail = 0;  // Should only wrap to start by our other stuff...
+  tx_segment segment;
 
-  if (tx_buffer.iHead != tx_buffer.iTail)
+  if (tx_queue_tail == tx_queue_head)
   {
-    startNextTransmitDMAorIT();
+    tx_write_size = 0;
+    return;
   }
-  else 
+  segment = tx_queue[tx_queue_tail];
+
+  // We completed previous write, so update our tail pointer by count
+  if (segment.copied == true)
   {
-    // finished all outstanding writes so lets set count to 0
-    tx_write_size = 0;
+    tx_buffer.iTail += segment.length; 
+    if (tx_buffer.iTail >= tx_buffer.buffer_size) 
+      tx_buffer.iTail = 0;  // a segment never wraps
   }
+  tx_queue_tail = (tx_queue_tail + 1) % SERIAL_TX_QUEUE_SIZE;
+
+  if (tx_callback != NULL)
+  {
+    tx_callback(segment.copied ? NULL : segment.buffer, segment.length);
+  }
+
+  // Starts the next segment or sets the count to 0 when all is sent
+  startNextTransmitDMAorIT();
 }
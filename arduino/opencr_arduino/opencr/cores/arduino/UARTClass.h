@@ -31,6 +31,12 @@
 
 #define SERIAL_BUFFER_SIZE 2048
 #define SERIAL_WRITES_NON_BLOCKING 1
+#define SERIAL_TX_QUEUE_SIZE 8
+
+// Called from the TX interrupt for every transmitted segment, buffer is the one
+// given to writeRef() or NULL for bytes copied by write()
+typedef void (*UARTTxCallback)(const uint8_t *buffer, size_t size);
+
 class UARTClass : public HardwareSerial
 {
   public:
@@ -56,6 +62,14 @@ class UARTClass : public HardwareSerial
     size_t write(const uint8_t *buffer, size_t size); 
     using Print::write; // pull in write(str) and write(buf, size) from Print
 
+    // Queues the buffer itself instead of a copy, it must not change until
+    // the callback reports it transmitted. Up to 65535 bytes are queued.
+    size_t writeRef(const uint8_t *buffer, size_t size);
+
+    // Without blocking, write() and writeRef() return the bytes they could queue
+    void setWriteBlocking(bool blocking);
+    void attachTxCallback(UARTTxCallback callback);
+
 
     void RxHandler(void); /* Vassilis Serasidis */
     void TxHandler(void); /* Vassilis Serasidis */
@@ -69,6 +83,7 @@ class UARTClass : public HardwareSerial
 
   protected:
     void inline startNextTransmitDMAorIT(void);
+    size_t copyToTxBuffer(const uint8_t *buffer, size_t size);
 #ifdef DRV_UART_RX_DMA_ONLY
     struct ring_buffer
     {
@@ -84,6 +99,13 @@ class UARTClass : public HardwareSerial
       volatile uint16_t iHead;
       volatile uint16_t iTail;
     };
+    // One DMA or IT transfer, from tx_buffer or from the buffer of writeRef()
+    struct tx_segment
+    {
+      const uint8_t *buffer;
+      uint16_t length;
+      bool     copied;
+    };
 
     uint8_t  _uart_num;
     uint8_t  _uart_mode;
@@ -92,6 +114,11 @@ class UARTClass : public HardwareSerial
     uint8_t r_byte;
     volatile uint16_t    tx_write_size;
     tx_no_cache_buffer tx_buffer;
+    tx_segment tx_queue[SERIAL_TX_QUEUE_SIZE];
+    volatile uint8_t tx_queue_head;
+    volatile uint8_t tx_queue_tail;
+    bool tx_blocking;
+    UARTTxCallback tx_callback;
 #ifdef DRV_UART_RX_DMA_ONLY
     ring_buffer rx_buffer;
 #endif
@@ -78,6 +78,21 @@ int USBSerial::read(void)
   return vcp_getch();
 }
 
+size_t USBSerial::read(uint8_t *buffer, size_t size)
+{
+  uint32_t length;
+
+  length = vcp_read(buffer, (uint32_t)size);
+
+  rx_cnt += length;
+
+  return (size_t)length;
+}
+
+int USBSerial::availableForWrite(void){
+  return vcp_tx_available();
+}
+
 void USBSerial::flush(void){
   while( vcp_is_transmitted() == FALSE );
 }
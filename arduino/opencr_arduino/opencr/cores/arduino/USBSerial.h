@@ -50,6 +50,8 @@ class USBSerial : public Stream {
     //virtual void accept(void);
     virtual int peek(void);
     virtual int read(void);
+    size_t read(uint8_t *buffer, size_t size);
+    virtual int availableForWrite(void);
     virtual void flush(void);
     virtual size_t write(uint8_t c);
     virtual size_t write(const uint8_t *buffer, size_t size);
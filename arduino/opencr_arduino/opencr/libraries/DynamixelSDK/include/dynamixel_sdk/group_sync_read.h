@@ -90,6 +90,18 @@ class WINDECLSPEC GroupSyncRead
   ////////////////////////////////////////////////////////////////////////////////
   bool    addParam    (uint8_t id);
 
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets the Sync Read list to the given IDs, keeping the current list when it is the same
+  /// @description The list stays registered after GroupSyncRead::txRxPacket, so it only needs to be set once and the packet parameter is reused on every read.
+  /// @param id Dynamixel ID list
+  /// @param id_num The number of Dynamixel IDs
+  /// @return false
+  /// @return   when the ID list has duplicated IDs
+  /// @return   when the protocol1.0 has been used
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    setParam    (uint8_t *id, uint8_t id_num);
+
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that removes id from the Sync Read list
   /// @param id Dynamixel ID
@@ -57,6 +57,8 @@ void GroupSyncRead::makeParam()
   int idx = 0;
   for (unsigned int i = 0; i < id_list_.size(); i++)
     param_[idx++] = id_list_[i];
+
+  is_param_changed_ = false;
 }
 
 bool GroupSyncRead::addParam(uint8_t id)
@@ -74,6 +76,26 @@ bool GroupSyncRead::addParam(uint8_t id)
   is_param_changed_   = true;
   return true;
 }
+
+bool GroupSyncRead::setParam(uint8_t *id, uint8_t id_num)
+{
+  if (ph_->getProtocolVersion() == 1.0)
+    return false;
+
+  // keep the registered buffers and the prebuilt parameter when the list is unchanged
+  if (id_list_.size() == id_num && std::equal(id_list_.begin(), id_list_.end(), id))
+    return true;
+
+  clearParam();
+  for (int i = 0; i < id_num; i++)
+  {
+    if (addParam(id[i]) == false)
+      return false;
+  }
+
+  return true;
+}
+
 void GroupSyncRead::removeParam(uint8_t id)
 {
   if (ph_->getProtocolVersion() == 1.0)
@@ -214,7 +214,12 @@ bool PortHandlerArduino::isPacketTimeout()
 
 double PortHandlerArduino::getCurrentTime()
 {
+#if defined(__OPENCR__)
+  // micros() reads a free running timer, so packet timeouts still expire inside timer interrupts
+  return (double)micros() / 1000.0;
+#else
   return (double)millis();
+#endif
 }
 
 double PortHandlerArduino::getTimeSinceStart()
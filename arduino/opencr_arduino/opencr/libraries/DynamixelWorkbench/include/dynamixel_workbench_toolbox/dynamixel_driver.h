@@ -32,6 +32,7 @@
 #define MAX_DXL_SERIES_NUM  5
 #define MAX_HANDLER_NUM     5
 #define MAX_BULK_PARAMETER  21
+#define MAX_DXL_NUM         253
 
 typedef struct 
 {
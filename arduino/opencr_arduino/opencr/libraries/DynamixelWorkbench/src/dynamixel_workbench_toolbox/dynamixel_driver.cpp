@@ -1098,20 +1098,29 @@ bool DynamixelDriver::syncRead(uint8_t index, const char **log)
 {
   ErrorFromSDK sdk_error = {0, false, false, 0};
 
-  syncReadHandler_[index].groupSyncRead->clearParam();
+  uint8_t id[MAX_DXL_NUM];
+  uint8_t id_num = 0;
+
   for (int i = 0; i < tools_cnt_; i++)
   {
     for (int j = 0; j < tools_[i].getDynamixelCount(); j++)
     {
-      sdk_error.dxl_addparam_result = syncReadHandler_[index].groupSyncRead->addParam(tools_[i].getID()[j]);
-      if (sdk_error.dxl_addparam_result != true)
+      if (id_num >= MAX_DXL_NUM)
       {
-        if (log != NULL) *log = "groupSyncWrite addparam failed";
+        if (log != NULL) *log = "[DynamixelDriver] Too many Dynamixels to sync read (MAX = 253)";
         return false;
       }
+      id[id_num++] = tools_[i].getID()[j];
     }
   }
 
+  sdk_error.dxl_addparam_result = syncReadHandler_[index].groupSyncRead->setParam(id, id_num);
+  if (sdk_error.dxl_addparam_result != true)
+  {
+    if (log != NULL) *log = "groupSyncRead setparam failed";
+    return false;
+  }
+
   sdk_error.dxl_comm_result = syncReadHandler_[index].groupSyncRead->txRxPacket();
   if (sdk_error.dxl_comm_result != COMM_SUCCESS)
   {
@@ -1127,15 +1136,12 @@ bool DynamixelDriver::syncRead(uint8_t index, uint8_t *id, uint8_t id_num, const
 {
   ErrorFromSDK sdk_error = {0, false, false, 0};
 
-  syncReadHandler_[index].groupSyncRead->clearParam();
-  for (int i = 0; i < id_num; i++)
+  // The ID list is kept registered, so it is only rebuilt when a different list is requested
+  sdk_error.dxl_addparam_result = syncReadHandler_[index].groupSyncRead->setParam(id, id_num);
+  if (sdk_error.dxl_addparam_result != true)
   {
-    sdk_error.dxl_addparam_result = syncReadHandler_[index].groupSyncRead->addParam(id[i]);
-    if (sdk_error.dxl_addparam_result != true)
-    {
-      if (log != NULL) *log = "groupSyncWrite addparam failed";
-      return false;
-    }
+    if (log != NULL) *log = "groupSyncRead setparam failed";
+    return false;
   }
 
   sdk_error.dxl_comm_result = syncReadHandler_[index].groupSyncRead->txRxPacket();
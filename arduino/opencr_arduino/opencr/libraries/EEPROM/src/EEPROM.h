@@ -24,6 +24,8 @@
 #include <inttypes.h>
 #include "drv_eeprom.h"
 
+// Cells 0x0F00..0x0F0E hold the IMU calibration (IMU_CALI_EEPROM_ADDR), see README.md
+
 /***
     EERef class.
 
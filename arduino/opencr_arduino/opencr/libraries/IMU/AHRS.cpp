@@ -0,0 +1,62 @@
+//=============================================================================================
+// AHRS.cpp
+//=============================================================================================
+//
+// Common part of the orientation filters.
+//
+//=============================================================================================
+
+//-------------------------------------------------------------------------------------------
+// Header files
+
+#include "AHRS.h"
+#include <math.h>
+
+//-------------------------------------------------------------------------------------------
+// Definitions
+
+#define sampleFreqDef   512.0f          // sample frequency in Hz
+
+
+
+//============================================================================================
+// Functions
+
+AHRS::AHRS() {
+	q0 = 1.0f;
+	q1 = 0.0f;
+	q2 = 0.0f;
+	q3 = 0.0f;
+	invSampleFreq = 1.0f / sampleFreqDef;
+	anglesComputed = 0;
+}
+
+//-------------------------------------------------------------------------------------------
+// Starts from a known orientation, e.g. the one of the filter used before
+
+void AHRS::setQuaternion(float w, float x, float y, float z) {
+	q0 = w;
+	q1 = x;
+	q2 = y;
+	q3 = z;
+	anglesComputed = 0;
+}
+
+//-------------------------------------------------------------------------------------------
+// Fixed rate batch update, filters override it to compute the per rate constants once
+
+void AHRS::updateIMUBatch(const float gyro[][3], const float acc[][3], uint32_t count) {
+	for(uint32_t i = 0; i < count; i++) {
+		updateIMU(gyro[i][0], gyro[i][1], gyro[i][2], acc[i][0], acc[i][1], acc[i][2]);
+	}
+}
+
+//-------------------------------------------------------------------------------------------
+
+void AHRS::computeAngles()
+{
+	roll = atan2f(q0*q1 + q2*q3, 0.5f - q1*q1 - q2*q2);
+	pitch = asinf(-2.0f * (q1*q3 - q0*q2));
+	yaw = atan2f(q1*q2 + q0*q3, 0.5f - q2*q2 - q3*q3);
+	anglesComputed = 1;
+}
@@ -0,0 +1,89 @@
+//=============================================================================================
+// AHRS.h
+//=============================================================================================
+//
+// Common interface of the orientation filters (Madgwick, Mahony, EKF) used by cIMU.
+// Gyroscope in degrees/sec, accelerometer and magnetometer in any consistent unit.
+// All arithmetic is single precision for the FPU of the Cortex-M7.
+//
+// Define AHRS_USE_CMSIS_DSP to take the square roots from CMSIS-DSP.
+//
+//=============================================================================================
+#ifndef AHRS_h
+#define AHRS_h
+#include <math.h>
+#include <stdint.h>
+
+#if defined(AHRS_USE_CMSIS_DSP)
+#ifndef ARM_MATH_CM7
+#define ARM_MATH_CM7
+#endif
+#include <arm_math.h>
+#endif
+
+#define AHRS_DEG_TO_RAD     0.0174533f
+
+//--------------------------------------------------------------------------------------------
+// Variable declaration
+class AHRS{
+protected:
+    float roll;
+    float pitch;
+    float yaw;
+    char anglesComputed;
+    void computeAngles();
+
+    // The bit trick inverse square root is no faster than VSQRT + VDIV on this FPU
+    static inline float invSqrt(float x) {
+#if defined(AHRS_USE_CMSIS_DSP)
+        float32_t root;
+        arm_sqrt_f32(x, &root);
+        return 1.0f / root;
+#else
+        return 1.0f / sqrtf(x);
+#endif
+    }
+
+//-------------------------------------------------------------------------------------------
+// Function declarations
+public:
+    float invSampleFreq;
+
+    float q0;
+    float q1;
+    float q2;
+    float q3;	// quaternion of sensor frame relative to auxiliary frame
+
+    AHRS(void);
+    void begin(float sampleFrequency) { invSampleFreq = 1.0f / sampleFrequency; }
+    void setQuaternion(float w, float x, float y, float z);
+    virtual void update(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz) = 0;
+    virtual void updateIMU(float gx, float gy, float gz, float ax, float ay, float az) = 0;
+    // count samples taken invSampleFreq apart, gyro[i] and acc[i] of the i-th (oldest first)
+    virtual void updateIMUBatch(const float gyro[][3], const float acc[][3], uint32_t count);
+    float getRoll() {
+        if (!anglesComputed) computeAngles();
+        return roll * 57.29578f;
+    }
+    float getPitch() {
+        if (!anglesComputed) computeAngles();
+        return pitch * 57.29578f;
+    }
+    float getYaw() {
+        if (!anglesComputed) computeAngles();
+        return yaw * 57.29578f + 180.0f;
+    }
+    float getRollRadians() {
+        if (!anglesComputed) computeAngles();
+        return roll;
+    }
+    float getPitchRadians() {
+        if (!anglesComputed) computeAngles();
+        return pitch;
+    }
+    float getYawRadians() {
+        if (!anglesComputed) computeAngles();
+        return yaw;
+    }
+};
+#endif
@@ -23,6 +23,9 @@
 #define PITCH		1
 #define YAW			2
 
+// FIFO sample : accel(6), gyro(6), big endian as the data registers
+#define IMU_FIFO_SAMPLE_SIZE   12
+
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,213 @@
+//=============================================================================================
+// EkfAHRS.cpp
+//=============================================================================================
+//
+// Quaternion extended Kalman filter.
+//
+// State      q = [q0 q1 q2 q3], P its covariance
+// Prediction q = F q with F = I + dt/2 * Omega(gyro)
+//            P = F P F' + Q, Q = (dt/2)^2 * gyroVar * (I - q q')
+// Correction h(q) = direction of gravity in the sensor frame, H = dh/dq
+//            K = P H' (H P H' + R)^-1, q += K (acc - h(q)), P -= K H P
+//
+//=============================================================================================
+
+//-------------------------------------------------------------------------------------------
+// Header files
+
+#include "EkfAHRS.h"
+#include <math.h>
+
+//-------------------------------------------------------------------------------------------
+// Definitions
+
+#define gyroNoiseDef    0.5f            // gyroscope noise in degrees/sec
+#define accNoiseDef     0.05f           // accelerometer noise, fraction of the gravity
+#define covarianceDef   0.1f            // initial variance of each quaternion element
+
+
+
+//============================================================================================
+// Functions
+
+Ekf::Ekf() {
+	setNoise(gyroNoiseDef, accNoiseDef);
+	resetCovariance();
+}
+
+void Ekf::setNoise(float gyroNoise, float accNoise) {
+	gyroVar = gyroNoise * AHRS_DEG_TO_RAD;
+	gyroVar *= gyroVar;
+	accVar = accNoise * accNoise;
+}
+
+void Ekf::resetCovariance(void) {
+	for(int i = 0; i < 4; i++) {
+		for(int j = 0; j < 4; j++) {
+			P[i][j] = (i == j) ? covarianceDef : 0.0f;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------
+// AHRS algorithm update, the magnetometer is not used
+
+void Ekf::update(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz) {
+	(void)mx;
+	(void)my;
+	(void)mz;
+	updateIMU(gx, gy, gz, ax, ay, az);
+}
+
+//-------------------------------------------------------------------------------------------
+// IMU algorithm step
+// halfDt turns degrees/sec into half the angle turned during one sample, qVar is the
+// variance of that half angle from the gyroscope noise
+
+inline void Ekf::stepIMU(float gx, float gy, float gz, float ax, float ay, float az, float halfDt, float qVar) {
+	float recipNorm;
+	float F[4][4];
+	float FP[4][4];
+	float H[3][4];
+	float PHt[4][3];
+	float K[4][3];
+	float S00, S01, S02, S11, S12, S22;
+	float c00, c01, c02, c11, c12, c22, det;
+	float ex, ey, ez;
+	float n0, n1, n2, n3;
+	int i, j, k;
+
+	// Convert gyroscope degrees/sec to half the angle turned in radians
+	gx *= halfDt;
+	gy *= halfDt;
+	gz *= halfDt;
+
+	// Predict the quaternion
+	F[0][0] = 1.0f; F[0][1] = -gx;  F[0][2] = -gy;  F[0][3] = -gz;
+	F[1][0] = gx;   F[1][1] = 1.0f; F[1][2] = gz;   F[1][3] = -gy;
+	F[2][0] = gy;   F[2][1] = -gz;  F[2][2] = 1.0f; F[2][3] = gx;
+	F[3][0] = gz;   F[3][1] = gy;   F[3][2] = -gx;  F[3][3] = 1.0f;
+
+	n0 = q0 - gx * q1 - gy * q2 - gz * q3;
+	n1 = q1 + gx * q0 + gz * q2 - gy * q3;
+	n2 = q2 + gy * q0 - gz * q1 + gx * q3;
+	n3 = q3 + gz * q0 + gy * q1 - gx * q2;
+	recipNorm = invSqrt(n0 * n0 + n1 * n1 + n2 * n2 + n3 * n3);
+	q0 = n0 * recipNorm;
+	q1 = n1 * recipNorm;
+	q2 = n2 * recipNorm;
+	q3 = n3 * recipNorm;
+
+	// Predict the covariance, only the upper half is computed as P is symmetric
+	for(i = 0; i < 4; i++) {
+		for(j = 0; j < 4; j++) {
+			FP[i][j] = F[i][0] * P[0][j] + F[i][1] * P[1][j] + F[i][2] * P[2][j] + F[i][3] * P[3][j];
+		}
+	}
+	float q[4] = {q0, q1, q2, q3};
+	for(i = 0; i < 4; i++) {
+		for(j = i; j < 4; j++) {
+			P[i][j] = FP[i][0] * F[j][0] + FP[i][1] * F[j][1] + FP[i][2] * F[j][2] + FP[i][3] * F[j][3] - qVar * q[i] * q[j];
+			P[j][i] = P[i][j];
+		}
+		P[i][i] += qVar;
+	}
+
+	// Correct only if accelerometer measurement valid (avoids NaN in accelerometer normalisation)
+	if((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f)) {
+		return;
+	}
+
+	// Normalise accelerometer measurement
+	recipNorm = invSqrt(ax * ax + ay * ay + az * az);
+	ax *= recipNorm;
+	ay *= recipNorm;
+	az *= recipNorm;
+
+	// Error between measured and estimated direction of gravity
+	ex = ax - 2.0f * (q1 * q3 - q0 * q2);
+	ey = ay - 2.0f * (q0 * q1 + q2 * q3);
+	ez = az - (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3);
+
+	H[0][0] = -2.0f * q2; H[0][1] = 2.0f * q3;  H[0][2] = -2.0f * q0; H[0][3] = 2.0f * q1;
+	H[1][0] = 2.0f * q1;  H[1][1] = 2.0f * q0;  H[1][2] = 2.0f * q3;  H[1][3] = 2.0f * q2;
+	H[2][0] = 2.0f * q0;  H[2][1] = -2.0f * q1; H[2][2] = -2.0f * q2; H[2][3] = 2.0f * q3;
+
+	for(i = 0; i < 4; i++) {
+		for(k = 0; k < 3; k++) {
+			PHt[i][k] = P[i][0] * H[k][0] + P[i][1] * H[k][1] + P[i][2] * H[k][2] + P[i][3] * H[k][3];
+		}
+	}
+
+	// Innovation covariance S = H P H' + R and its inverse from the cofactors
+	S00 = H[0][0] * PHt[0][0] + H[0][1] * PHt[1][0] + H[0][2] * PHt[2][0] + H[0][3] * PHt[3][0] + accVar;
+	S01 = H[0][0] * PHt[0][1] + H[0][1] * PHt[1][1] + H[0][2] * PHt[2][1] + H[0][3] * PHt[3][1];
+	S02 = H[0][0] * PHt[0][2] + H[0][1] * PHt[1][2] + H[0][2] * PHt[2][2] + H[0][3] * PHt[3][2];
+	S11 = H[1][0] * PHt[0][1] + H[1][1] * PHt[1][1] + H[1][2] * PHt[2][1] + H[1][3] * PHt[3][1] + accVar;
+	S12 = H[1][0] * PHt[0][2] + H[1][1] * PHt[1][2] + H[1][2] * PHt[2][2] + H[1][3] * PHt[3][2];
+	S22 = H[2][0] * PHt[0][2] + H[2][1] * PHt[1][2] + H[2][2] * PHt[2][2] + H[2][3] * PHt[3][2] + accVar;
+
+	c00 = S11 * S22 - S12 * S12;
+	c01 = S02 * S12 - S01 * S22;
+	c02 = S01 * S12 - S02 * S11;
+	c11 = S00 * S22 - S02 * S02;
+	c12 = S01 * S02 - S00 * S12;
+	c22 = S00 * S11 - S01 * S01;
+	det = S00 * c00 + S01 * c01 + S02 * c02;
+	if(det <= 0.0f) {
+		return;
+	}
+	det = 1.0f / det;
+	c00 *= det; c01 *= det; c02 *= det;
+	c11 *= det; c12 *= det; c22 *= det;
+
+	// Kalman gain K = P H' S^-1
+	for(i = 0; i < 4; i++) {
+		K[i][0] = PHt[i][0] * c00 + PHt[i][1] * c01 + PHt[i][2] * c02;
+		K[i][1] = PHt[i][0] * c01 + PHt[i][1] * c11 + PHt[i][2] * c12;
+		K[i][2] = PHt[i][0] * c02 + PHt[i][1] * c12 + PHt[i][2] * c22;
+	}
+
+	// Correct the quaternion
+	n0 = q0 + K[0][0] * ex + K[0][1] * ey + K[0][2] * ez;
+	n1 = q1 + K[1][0] * ex + K[1][1] * ey + K[1][2] * ez;
+	n2 = q2 + K[2][0] * ex + K[2][1] * ey + K[2][2] * ez;
+	n3 = q3 + K[3][0] * ex + K[3][1] * ey + K[3][2] * ez;
+	recipNorm = invSqrt(n0 * n0 + n1 * n1 + n2 * n2 + n3 * n3);
+	q0 = n0 * recipNorm;
+	q1 = n1 * recipNorm;
+	q2 = n2 * recipNorm;
+	q3 = n3 * recipNorm;
+
+	// Correct the covariance, K H P = K (P H')'
+	for(i = 0; i < 4; i++) {
+		for(j = i; j < 4; j++) {
+			P[i][j] -= K[i][0] * PHt[j][0] + K[i][1] * PHt[j][1] + K[i][2] * PHt[j][2];
+			P[j][i] = P[i][j];
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------
+// IMU algorithm update
+
+void Ekf::updateIMU(float gx, float gy, float gz, float ax, float ay, float az) {
+	float halfDt = 0.5f * invSampleFreq;
+
+	stepIMU(gx, gy, gz, ax, ay, az, AHRS_DEG_TO_RAD * halfDt, gyroVar * halfDt * halfDt);
+	anglesComputed = 0;
+}
+
+//-------------------------------------------------------------------------------------------
+// IMU algorithm update of samples taken invSampleFreq apart
+
+void Ekf::updateIMUBatch(const float gyro[][3], const float acc[][3], uint32_t count) {
+	float halfDt = 0.5f * invSampleFreq;
+	float qVar = gyroVar * halfDt * halfDt;
+
+	halfDt *= AHRS_DEG_TO_RAD;
+	for(uint32_t i = 0; i < count; i++) {
+		stepIMU(gyro[i][0], gyro[i][1], gyro[i][2], acc[i][0], acc[i][1], acc[i][2], halfDt, qVar);
+	}
+	anglesComputed = 0;
+}
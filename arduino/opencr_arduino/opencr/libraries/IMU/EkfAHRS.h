@@ -0,0 +1,35 @@
+//=============================================================================================
+// EkfAHRS.h
+//=============================================================================================
+//
+// Quaternion extended Kalman filter.
+// The gyroscope drives the prediction and the direction of gravity measured by the
+// accelerometer corrects roll and pitch. The magnetometer is not used, so the yaw
+// is integrated from the gyroscope as with updateIMU() of the other filters.
+//
+//=============================================================================================
+#ifndef EkfAHRS_h
+#define EkfAHRS_h
+#include <math.h>
+#include "AHRS.h"
+
+//--------------------------------------------------------------------------------------------
+// Variable declaration
+class Ekf : public AHRS{
+private:
+    float gyroVar;      // gyroscope variance in (radians/sec)^2
+    float accVar;       // accelerometer variance of the normalised measurement
+    float P[4][4];      // covariance of the quaternion
+    inline void stepIMU(float gx, float gy, float gz, float ax, float ay, float az, float halfDt, float qVar);
+
+//-------------------------------------------------------------------------------------------
+// Function declarations
+public:
+    Ekf(void);
+    void update(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz);
+    void updateIMU(float gx, float gy, float gz, float ax, float ay, float az);
+    void updateIMUBatch(const float gyro[][3], const float acc[][3], uint32_t count);
+    void setNoise(float gyroNoise, float accNoise);
+    void resetCovariance(void);
+};
+#endif
@@ -10,6 +10,14 @@
 #define ICM20648_ADDRESS    0x68
 #define MPU_CALI_COUNT      512
 
+// ACCEL_XOUT_H ~ TEMPERATURE_L : accel(6), gyro(6), temperature(2)
+#define ICM_BURST_LENGTH    14
+#define ICM_BURST_ACC       0
+#define ICM_BURST_GYRO      6
+#define ICM_BURST_TEMP      12
+
+#define ICM_FIFO_SIZE       512
+
 
 #define ACC_ORIENTATION(X, Y, Z)  {accADC[PITCH]  =  Y; accADC[ROLL]  =  X; accADC[YAW]  =   Z;}
 #define GYRO_ORIENTATION(X, Y, Z) {gyroADC[PITCH] =  Y; gyroADC[ROLL] =  X; gyroADC[YAW] =   Z;}
@@ -26,10 +34,17 @@ cICM20648::cICM20648()
 	calibratingA = 0;
   calibratingM = 0;
   bConnected   = false;
+  tempRAW      = 0;
+  bank_        = 0xFF;
 }
 
 void cICM20648::selectBank(uint8_t bank)
 {
+  // Data registers are all in bank 0, so the bank is written only when it changes
+  if (bank == bank_)
+    return;
+  bank_ = bank;
+
   digitalWrite( BDPIN_SPI_CS_IMU, LOW);
 
   /* clear R/W bit - write, send the address */
@@ -128,6 +143,7 @@ void cICM20648::init( void )
   //ICM20648 Reset
   spiWriteByte(ICM20648_REG_PWR_MGMT_1, ICM20648_BIT_H_RESET);
 	delay(100);
+  bank_ = 0xFF;
 
 	//ICM20648 Set Clock Source
   // Auto selects the best available clock source  PLL if ready, else use the Internal oscillator
@@ -182,30 +198,126 @@ void cICM20648::gyro_init( void )
 	calibratingG = MPU_CALI_COUNT;
 }
 
-void cICM20648::gyro_get_adc( void )
+// Reads accel, gyro and temperature with one SPI burst, so all of them are from the same sample
+void cICM20648::get_adc( void )
 {
-	int16_t x = 0;
-	int16_t y = 0;
-	int16_t z = 0;
+  uint8_t rawADC[ICM_BURST_LENGTH];
+
+  if( bConnected == true )
+  {
+    spiRead(ICM20648_REG_ACCEL_XOUT_H_SH, &rawADC[0], ICM_BURST_LENGTH);
+
+    acc_set_adc(&rawADC[ICM_BURST_ACC]);
+    gyro_set_adc(&rawADC[ICM_BURST_GYRO]);
+    tempRAW = (((int16_t)rawADC[ICM_BURST_TEMP]) << 8) | rawADC[ICM_BURST_TEMP+1];
+  }
+
+  acc_common();
+  gyro_common();
+  mag_common();
+}
+
+// Accel and gyro are written to the FIFO at 'hz', returns the sample period in us
+uint32_t cICM20648::fifo_begin( uint32_t hz )
+{
+  uint32_t div;
+
+  if( bConnected == false || hz == 0 )
+  {
+    return 0;
+  }
+
+  // SAMPLE_RATE = 1.125kHz (DLPF enabled) / (1 + SMPLRT_DIV)
+  div = constrain(1125/hz, 1, 256) - 1;
+  spiWriteByte(ICM20648_REG_GYRO_SMPLRT_DIV, div);
+  spiWriteByte(ICM20648_REG_ACCEL_SMPLRT_DIV_1, 0x00);
+  spiWriteByte(ICM20648_REG_ACCEL_SMPLRT_DIV_2, div);
+  delay(1);
+
+  spiWriteByte(ICM20648_REG_FIFO_EN_2, 0x00);
+  spiWriteByte(ICM20648_REG_FIFO_MODE, 0x00); // Stream, new samples overwrite old ones
+  fifo_reset();
+  spiWriteByte(ICM20648_REG_FIFO_EN_2, ICM20648_BIT_ACCEL_FIFO_EN | ICM20648_BITS_GYRO_FIFO_EN);
+  spiWriteByte(ICM20648_REG_USER_CTRL, ICM20648_BIT_I2C_IF_DIS | ICM20648_BIT_FIFO_EN);
+  spiWriteByte(ICM20648_REG_INT_ENABLE_1, ICM20648_BIT_RAW_DATA_0_RDY_EN);
+  delay(1);
+
+  return (div + 1) * 1000000 / 1125;
+}
+
+// Returns bytes in the FIFO, -1 if the FIFO overflowed and was reset
+int32_t cICM20648::fifo_get_count( void )
+{
+  uint8_t data[2];
+  int32_t count;
+
+  if( bConnected == false )
+  {
+    return 0;
+  }
+
+  spiRead(ICM20648_REG_FIFO_COUNT_H, data, 2);
+  count = ((data[0] & 0x1F) << 8) | data[1];
+
+  // Old samples were overwritten, the sample boundary is lost
+  if( count > ICM_FIFO_SIZE - IMU_FIFO_SAMPLE_SIZE )
+  {
+    fifo_reset();
+    return -1;
+  }
+
+  return count;
+}
+
+void cICM20648::fifo_read( uint8_t *p_data, uint16_t length )
+{
+  spiRead(ICM20648_REG_FIFO_R_W, p_data, length);
+}
+
+void cICM20648::fifo_reset( void )
+{
+  spiWriteByte(ICM20648_REG_FIFO_RST, 0x1F);
+  spiWriteByte(ICM20648_REG_FIFO_RST, 0x00);
+}
+
+// Decodes one FIFO sample (IMU_FIFO_SAMPLE_SIZE bytes)
+void cICM20648::fifo_get_adc( uint8_t *p_data )
+{
+  acc_set_adc(&p_data[0]);
+  gyro_set_adc(&p_data[6]);
+
+  acc_common();
+  gyro_common();
+}
 
+void cICM20648::gyro_get_adc( void )
+{
   uint8_t rawADC[6];
 
   if( bConnected == true )
   {
     spiRead(ICM20648_REG_GYRO_XOUT_H_SH, &rawADC[0], 6);
+    gyro_set_adc(&rawADC[0]);
+  }
 
- 		x = (((int16_t)rawADC[0]) << 8) | rawADC[1];
-  	y = (((int16_t)rawADC[2]) << 8) | rawADC[3];
-  	z = (((int16_t)rawADC[4]) << 8) | rawADC[5];
+  gyro_common();
+}
 
-  	gyroRAW[0] = x;
-  	gyroRAW[1] = y;
-  	gyroRAW[2] = z;
+void cICM20648::gyro_set_adc( uint8_t *rawADC )
+{
+	int16_t x = 0;
+	int16_t y = 0;
+	int16_t z = 0;
 
-  	GYRO_ORIENTATION( x, y,z );
-  }
+  x = (((int16_t)rawADC[0]) << 8) | rawADC[1];
+  y = (((int16_t)rawADC[2]) << 8) | rawADC[3];
+  z = (((int16_t)rawADC[4]) << 8) | rawADC[5];
 
-  gyro_common();
+  gyroRAW[0] = x;
+  gyroRAW[1] = y;
+  gyroRAW[2] = z;
+
+  GYRO_ORIENTATION( x, y,z );
 }
 
 void cICM20648::gyro_cali_start()
@@ -228,29 +340,34 @@ void cICM20648::acc_init( void )
 
 void cICM20648::acc_get_adc( void )
 {
-	int16_t x = 0;
-	int16_t y = 0;
-	int16_t z = 0;
   uint8_t rawADC[6];
 
   if( bConnected == true )
   {    
     spiRead(ICM20648_REG_ACCEL_XOUT_H_SH, &rawADC[0], 6);
-
-    x = (((int16_t)rawADC[0]) << 8) | rawADC[1];
-    y = (((int16_t)rawADC[2]) << 8) | rawADC[3];
-    z = (((int16_t)rawADC[4]) << 8) | rawADC[5];
-
-    accRAW[0] = x;
-    accRAW[1] = y;
-    accRAW[2] = z;
-    
-		ACC_ORIENTATION( x,	y, z );
+    acc_set_adc(&rawADC[0]);
 	}
 
 	acc_common();
 }
 
+void cICM20648::acc_set_adc( uint8_t *rawADC )
+{
+	int16_t x = 0;
+	int16_t y = 0;
+	int16_t z = 0;
+
+  x = (((int16_t)rawADC[0]) << 8) | rawADC[1];
+  y = (((int16_t)rawADC[2]) << 8) | rawADC[3];
+  z = (((int16_t)rawADC[4]) << 8) | rawADC[5];
+
+  accRAW[0] = x;
+  accRAW[1] = y;
+  accRAW[2] = z;
+
+  ACC_ORIENTATION( x,	y, z );
+}
+
 void cICM20648::gyro_common()
 {
 	static int16_t previousGyroADC[3];
@@ -370,3 +487,20 @@ bool cICM20648::gyro_cali_get_done()
 	if( calibratingG == 0 ) return true;
 	else                    return false;
 }
+
+// Bias from outside, a running calibration is stopped
+void cICM20648::gyro_set_zero( const int16_t *p_zero )
+{
+  calibratingG = 0;
+  gyroZero[0]  = p_zero[0];
+  gyroZero[1]  = p_zero[1];
+  gyroZero[2]  = p_zero[2];
+}
+
+void cICM20648::acc_set_zero( const int16_t *p_zero )
+{
+  calibratingA = 0;
+  accZero[0]   = p_zero[0];
+  accZero[1]   = p_zero[1];
+  accZero[2]   = p_zero[2];
+}
@@ -42,23 +42,34 @@ public:
 
   int16_t AK8963_ASA[3];
 
+  int16_t  tempRAW;
+
 
 public:
 	cICM20648();
 
   bool begin( void );
   void init( void );
+  void get_adc( void );
+
+  uint32_t fifo_begin( uint32_t hz );
+  int32_t  fifo_get_count( void );
+  void     fifo_read( uint8_t *p_data, uint16_t length );
+  void     fifo_reset( void );
+  void     fifo_get_adc( uint8_t *p_data );
 	void gyro_init( void );
 	void gyro_get_adc( void );
 	void gyro_common();
 	void gyro_cali_start();
 	bool gyro_cali_get_done();
+	void gyro_set_zero( const int16_t *p_zero );
 
 	void acc_init( void );
 	void acc_get_adc( void );
 	void acc_common();
 	void acc_cali_start();
 	bool acc_cali_get_done();
+	void acc_set_zero( const int16_t *p_zero );
 
   void mag_init( void );
 	void mag_get_adc( void );
@@ -68,6 +79,11 @@ public:
 
 
 private:
+  uint8_t bank_;
+
+  void acc_set_adc( uint8_t *rawADC );
+  void gyro_set_adc( uint8_t *rawADC );
+
   void selectBank(uint8_t bank);
   void spiRead(uint16_t addr, uint8_t *p_data, uint32_t length);
   uint8_t spiReadByte(uint16_t addr);
@@ -15,6 +15,35 @@
 #include "IMU.h"
 
 
+static volatile uint32_t data_ready_stamp = 0;
+static volatile uint32_t data_ready_isr_count = 0;
+
+static void dataReadyISR( void )
+{
+  data_ready_stamp = micros();
+  data_ready_isr_count++;
+}
+
+// CPU cycles from the DWT cycle counter, always 0 where there is none
+static void cycleCounterBegin( void )
+{
+#if defined(DWT)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR   = 0xC5ACCE55;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+static uint32_t cycleCounter( void )
+{
+#if defined(DWT)
+  return DWT->CYCCNT;
+#else
+  return 0;
+#endif
+}
+
+
 
 
 
@@ -34,9 +63,33 @@ cIMU::cIMU()
   {
     rpy[i] = 0.;
 
+    // As the former integer mean: truncated to 3 LSB or less it was 0
+    gyroFilter[i].setAverage(3);
+    gyroFilter[i].setDeadband(4);
   }
 
 	bConnected = false;
+
+  fifo_mode           = false;
+  sample_period_us    = 0;
+  sample_stamp        = 0;
+  overrun_count       = 0;
+  latency_us          = 0;
+  data_ready_attached = false;
+  data_ready_count    = 0;
+  sample_rate         = 0.;
+  rate_sample_count   = 0;
+  rate_time           = 0;
+  ring_head           = 0;
+  ring_tail           = 0;
+  filter              = &madgwick;
+  filter_type         = IMU_FILTER_MADGWICK;
+  filter_cycles       = 0;
+  capture_port        = NULL;
+  capture_drops       = 0;
+  replay_stamp        = 0;
+  replay_period_us    = 0;
+  replay_started      = false;
 }
 
 
@@ -52,7 +105,6 @@ uint8_t cIMU::begin( uint32_t hz )
 {
 	uint8_t err_code = IMU_OK;
   uint32_t i;
-  uint32_t pre_time;
 
   update_hz = hz;
   update_us = 1000000/hz;
@@ -68,23 +120,26 @@ uint8_t cIMU::begin( uint32_t hz )
   
   if( bConnected == true )
   {
-    filter.begin(update_hz);
-
-    for (i=0; i<32; i++)
+    // The sensor samples at its own rate into the FIFO, update() takes every sample
+    sample_period_us = SEN.fifo_begin(update_hz);
+    if( sample_period_us > 0 )
     {
-      update();
+      fifo_mode = true;
+      update_us = sample_period_us;
+      update_hz = 1000000/sample_period_us;
+      rate_time = micros();
     }
 
-    pre_time = millis();
-    while(!SEN.gyro_cali_get_done())
+    filter->begin(update_hz);
+    cycleCounterBegin();
+
+    for (i=0; i<32; i++)
     {
       update();
-
-      if (millis()-pre_time > 5000)
-      {
-        break;
-      }
     }
+
+    // Without stored biases the gyro calibration goes on in the background,
+    // the filter starts when it ends
   }
   
   
@@ -111,10 +166,16 @@ uint16_t cIMU::update( uint32_t option )
 	static uint32_t tTime;
 
 
+  if( fifo_mode == true )
+  {
+    return updateFIFO();
+  }
+
 	if( (micros()-tTime) >= update_us )
 	{
 		ret_time = micros()-tTime;
     tTime = micros();
+    sample_stamp = tTime;
 
 		computeIMU();
 
@@ -147,7 +208,466 @@ uint16_t cIMU::update( uint32_t option )
 }
 
 
-#define FILTER_NUM    3
+/*---------------------------------------------------------------------------
+     TITLE   : updateFIFO
+     WORK    : Takes the samples in the FIFO and feeds them to the filter
+               at the sample period of the sensor
+     ARG     : void
+     RET     : time since the last samples were taken, 0 if no new sample
+---------------------------------------------------------------------------*/
+uint16_t cIMU::updateFIFO( void )
+{
+  static uint32_t tTime;
+  uint8_t  data[IMU_FIFO_BATCH * IMU_FIFO_SAMPLE_SIZE];
+  float    gyro_batch[IMU_FIFO_BATCH][3];
+  float    acc_batch[IMU_FIFO_BATCH][3];
+  uint32_t batch_count = 0;
+  uint32_t cycles;
+  uint16_t ret_time = 0;
+  int32_t  count;
+  uint32_t fifo_samples;
+  uint32_t read_time;
+  uint32_t newest_stamp;
+  uint32_t i;
+  uint32_t axis;
+  imu_sample_t *p_sample;
+
+
+  if( data_ready_attached == true )
+  {
+    if( data_ready_isr_count == data_ready_count )
+    {
+      return 0;
+    }
+  }
+  else if( (micros()-tTime) < sample_period_us )
+  {
+    return 0;
+  }
+
+  count     = SEN.fifo_get_count();
+  read_time = micros();
+
+  if( count < 0 )
+  {
+    overrun_count++;
+    return 0;
+  }
+
+  fifo_samples = count / IMU_FIFO_SAMPLE_SIZE;
+  if( fifo_samples == 0 )
+  {
+    return 0;
+  }
+
+  // The newest sample in the FIFO was taken at the last data ready edge
+  newest_stamp = read_time;
+  if( data_ready_attached == true )
+  {
+    do
+    {
+      data_ready_count = data_ready_isr_count;
+      newest_stamp     = data_ready_stamp;
+    } while( data_ready_count != data_ready_isr_count );
+  }
+
+  // Samples left by a full batch are taken next time
+  count = fifo_samples;
+  if( count > IMU_FIFO_BATCH )
+  {
+    count = IMU_FIFO_BATCH;
+  }
+  SEN.fifo_read( data, count * IMU_FIFO_SAMPLE_SIZE );
+
+  // The mag is not in the FIFO, its latest sample is used
+  SEN.mag_get_adc();
+
+  for( i=0; i<(uint32_t)count; i++ )
+  {
+    SEN.fifo_get_adc( &data[i * IMU_FIFO_SAMPLE_SIZE] );
+
+    p_sample = &sample_ring[ring_head % IMU_SAMPLE_RING_SIZE];
+    p_sample->stamp_us = newest_stamp - (fifo_samples - 1 - i) * sample_period_us;
+    if( capture_port != NULL )
+    {
+      captureSample(p_sample->stamp_us);
+    }
+    for( axis=0; axis<3; axis++ )
+    {
+      p_sample->acc[axis]  = SEN.accADC[axis];
+      p_sample->gyro[axis] = SEN.gyroADC[axis];
+    }
+    ring_head++;
+    if( ring_head - ring_tail > IMU_SAMPLE_RING_SIZE )
+    {
+      ring_tail = ring_head - IMU_SAMPLE_RING_SIZE;
+    }
+
+    computeSample();
+
+    if (SEN.calibratingG == 0 && SEN.calibratingA == 0)
+    {
+      gyro_batch[batch_count][0] = gx;
+      gyro_batch[batch_count][1] = gy;
+      gyro_batch[batch_count][2] = gz;
+      acc_batch[batch_count][0]  = ax;
+      acc_batch[batch_count][1]  = ay;
+      acc_batch[batch_count][2]  = az;
+      batch_count++;
+    }
+  }
+
+  // All samples of the batch are sample_period_us apart
+  if( batch_count > 0 )
+  {
+    filter->invSampleFreq = (float)sample_period_us/1000000.0f;
+    cycles = cycleCounter();
+    filter->updateIMUBatch( gyro_batch, acc_batch, batch_count );
+    filter_cycles = (cycleCounter() - cycles) / batch_count;
+  }
+  computeAngles();
+
+  latency_us   = read_time - (newest_stamp - (fifo_samples - 1) * sample_period_us);
+  sample_stamp = newest_stamp - (fifo_samples - count) * sample_period_us;
+
+  rate_sample_count += count;
+  if( read_time - rate_time >= 1000000 )
+  {
+    sample_rate       = (float)rate_sample_count * 1000000. / (float)(read_time - rate_time);
+    rate_sample_count = 0;
+    rate_time         = read_time;
+  }
+
+  ret_time = read_time - tTime;
+  tTime    = read_time;
+
+  for( i=0; i<3; i++ )
+  {
+    gyroData[i] = SEN.gyroADC[i];
+    gyroRaw[i]  = SEN.gyroRAW[i];
+    accData[i]  = SEN.accADC[i];
+    accRaw[i]   = SEN.accRAW[i];
+    magData[i]  = SEN.magADC[i];
+    magRaw[i]   = SEN.magRAW[i];
+  }
+
+  // 0 means no new sample
+  if( ret_time == 0 )
+  {
+    ret_time = 1;
+  }
+
+	return ret_time;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : attachDataReady
+     WORK    : The FIFO is read only after a data ready edge and the edge
+               time stamps the newest sample
+     ARG     : exti_num : external interrupt the sensor INT pin is wired to
+     RET     : void
+---------------------------------------------------------------------------*/
+void cIMU::attachDataReady( uint32_t exti_num )
+{
+  if( fifo_mode == false )
+  {
+    return;
+  }
+
+  data_ready_count = data_ready_isr_count;
+  attachInterrupt( exti_num, dataReadyISR, SEN.int_active_low() ? FALLING : RISING );
+  data_ready_attached = true;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : sample ring and statistics
+     WORK    :
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+uint16_t cIMU::sampleAvailable( void )
+{
+  return ring_head - ring_tail;
+}
+
+bool cIMU::readSample( imu_sample_t *p_sample )
+{
+  if( ring_head == ring_tail )
+  {
+    return false;
+  }
+
+  *p_sample = sample_ring[ring_tail % IMU_SAMPLE_RING_SIZE];
+  ring_tail++;
+
+  return true;
+}
+
+// micros() when the newest sample used by the filter was taken
+uint32_t cIMU::getSampleStamp( void )
+{
+  return sample_stamp;
+}
+
+uint32_t cIMU::getSamplePeriod( void )
+{
+  return sample_period_us;
+}
+
+// Samples taken per second, measured over about one second
+float cIMU::getSampleRate( void )
+{
+  return sample_rate;
+}
+
+// FIFO overflows, samples were lost because update() was not called in time
+uint32_t cIMU::getOverrunCount( void )
+{
+  return overrun_count;
+}
+
+// Age of the oldest sample in the FIFO when it was read
+uint32_t cIMU::getLatency( void )
+{
+  return latency_us;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : setFilter
+     WORK    : Selects the orientation filter
+     ARG     : type : IMU_FILTER_MADGWICK, IMU_FILTER_MAHONY or IMU_FILTER_EKF
+     RET     : false if the type is unknown
+---------------------------------------------------------------------------*/
+bool cIMU::setFilter( uint8_t type )
+{
+  AHRS *p_filter;
+
+  switch( type )
+  {
+    case IMU_FILTER_MADGWICK:
+      p_filter = &madgwick;
+      break;
+
+    case IMU_FILTER_MAHONY:
+      p_filter = &mahony;
+      break;
+
+    case IMU_FILTER_EKF:
+      p_filter = &ekf;
+      break;
+
+    default:
+      return false;
+  }
+
+  if( p_filter != filter )
+  {
+    p_filter->invSampleFreq = filter->invSampleFreq;
+    p_filter->setQuaternion( filter->q0, filter->q1, filter->q2, filter->q3 );
+    filter      = p_filter;
+    filter_type = type;
+  }
+
+  return true;
+}
+
+uint8_t cIMU::getFilter( void )
+{
+  return filter_type;
+}
+
+// CPU cycles the filter took for the last sample, 0 without a cycle counter
+uint32_t cIMU::getFilterCycles( void )
+{
+  return filter_cycles;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : startCapture
+     WORK    : Writes the log header, every following sample is written
+               as a sample record
+     ARG     : p_port : USB serial port, e.g. &Serial
+     RET     : false if the header does not fit into the USB buffer
+---------------------------------------------------------------------------*/
+bool cIMU::startCapture( USBSerial *p_port )
+{
+  imu_log_header_t header;
+  uint32_t axis;
+
+  if( p_port == NULL || p_port->availableForWrite() < (int)sizeof(header) )
+  {
+    return false;
+  }
+
+  header.sync      = IMU_LOG_SYNC;
+  header.type      = IMU_LOG_TYPE_HEADER;
+  header.version   = IMU_LOG_VERSION;
+  header.fifo      = (fifo_mode == true) ? 1 : 0;
+  header.period_us = update_us;
+  header.aRes      = aRes;
+  header.gRes      = gRes;
+  header.mRes      = mRes;
+  for( axis=0; axis<3; axis++ )
+  {
+    header.gyroZero[axis] = SEN.gyroZero[axis];
+    header.accZero[axis]  = SEN.accZero[axis];
+  }
+  header.checksum  = imu_log_checksum(&header, sizeof(header) - 1);
+
+  p_port->write((uint8_t *)&header, sizeof(header));
+
+  capture_drops = 0;
+  capture_port  = p_port;
+
+  return true;
+}
+
+void cIMU::stopCapture( void )
+{
+  capture_port = NULL;
+}
+
+// Sample records that did not fit into the USB buffer since startCapture()
+uint32_t cIMU::getCaptureDrops( void )
+{
+  return capture_drops;
+}
+
+void cIMU::captureSample( uint32_t stamp_us )
+{
+  imu_log_sample_t record;
+  uint32_t axis;
+
+  if( capture_port->availableForWrite() < (int)sizeof(record) )
+  {
+    capture_drops++;
+    return;
+  }
+
+  record.sync     = IMU_LOG_SYNC;
+  record.type     = IMU_LOG_TYPE_SAMPLE;
+  record.stamp_us = stamp_us;
+  for( axis=0; axis<3; axis++ )
+  {
+    record.acc[axis]  = SEN.accUncal[axis];
+    record.gyro[axis] = SEN.gyroUncal[axis];
+    record.mag[axis]  = SEN.magADC[axis];
+  }
+  record.checksum = imu_log_checksum(&record, sizeof(record) - 1);
+
+  capture_port->write((uint8_t *)&record, sizeof(record));
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : replayBegin
+     WORK    : Takes the scales, rate and biases of a log
+     ARG     : p_header : header record of the log
+     RET     : void
+---------------------------------------------------------------------------*/
+void cIMU::replayBegin( const imu_log_header_t *p_header )
+{
+  int16_t  gyro_zero[3];
+  int16_t  acc_zero[3];
+  uint32_t i;
+
+  aRes = p_header->aRes;
+  gRes = p_header->gRes;
+  mRes = p_header->mRes;
+
+  if( p_header->period_us > 0 )
+  {
+    update_us = p_header->period_us;
+    update_hz = 1000000/update_us;
+    filter->begin(update_hz);
+  }
+
+  // FIFO samples were taken at a fixed period, the others at their stamps
+  replay_period_us = (p_header->fifo == 1) ? p_header->period_us : 0;
+  replay_started   = false;
+
+  filter->setQuaternion(1.0f, 0.0f, 0.0f, 0.0f);
+  ekf.resetCovariance();
+  for( i=0; i<3; i++ )
+  {
+    gyroFilter[i].reset();
+    accFilter[i].reset();
+
+    // The records are packed, their members may not be aligned
+    gyro_zero[i] = p_header->gyroZero[i];
+    acc_zero[i]  = p_header->accZero[i];
+  }
+  SEN.replay_zero(gyro_zero, acc_zero);
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : replaySample
+     WORK    : Same processing as a sample of the sensor, the time comes
+               from the log only so a replay always gives the same result
+     ARG     : p_sample : sample record of the log
+     RET     : void
+---------------------------------------------------------------------------*/
+void cIMU::replaySample( const imu_log_sample_t *p_sample )
+{
+  int16_t  acc[3];
+  int16_t  gyro[3];
+  int16_t  mag[3];
+  uint32_t process_time;
+  uint32_t axis;
+
+  if( replay_period_us > 0 )
+  {
+    process_time = replay_period_us;
+  }
+  else if( replay_started == true )
+  {
+    process_time = p_sample->stamp_us - replay_stamp;
+  }
+  else
+  {
+    process_time = update_us;
+  }
+  replay_stamp   = p_sample->stamp_us;
+  replay_started = true;
+  sample_stamp   = p_sample->stamp_us;
+
+  for( axis=0; axis<3; axis++ )
+  {
+    acc[axis]  = p_sample->acc[axis];
+    gyro[axis] = p_sample->gyro[axis];
+    mag[axis]  = p_sample->mag[axis];
+  }
+  SEN.replay_adc(acc, gyro, mag);
+
+  computeAHRS(process_time);
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : replayEnd
+     WORK    : The sensor samples are corrected with the biases of the
+               calibration again, begin() takes back the rate of the sensor
+               if the log had another one
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+void cIMU::replayEnd( void )
+{
+  SEN.replay_end();
+}
+
 
 /*---------------------------------------------------------------------------
      TITLE   : compute
@@ -160,36 +680,65 @@ void cIMU::computeIMU( void )
   static uint32_t prev_process_time = micros();
   static uint32_t cur_process_time = 0;
   static uint32_t process_time = 0;
-  uint32_t i;
-  static int32_t gyroADC[3][FILTER_NUM] = {0,};
-  int32_t gyroAdcSum;
 
-  uint32_t axis;
+  // accel, gyro and mag of the same sample with one SPI burst
+  SEN.get_adc();
 
-	SEN.acc_get_adc();
-	SEN.gyro_get_adc();
-  SEN.mag_get_adc();
+  if( capture_port != NULL )
+  {
+    captureSample(sample_stamp);
+  }
 
-  for (axis = 0; axis < 3; axis++)
+  cur_process_time  = micros();
+  process_time      = cur_process_time-prev_process_time;
+  prev_process_time = cur_process_time;
+
+  computeAHRS(process_time);
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : computeAHRS
+     WORK    :
+     ARG     : process_time : time since the last sample in us
+     RET     : void
+---------------------------------------------------------------------------*/
+void cIMU::computeAHRS( uint32_t process_time )
+{
+  uint32_t cycles;
+
+  computeSample();
+
+  if (SEN.calibratingG == 0 && SEN.calibratingA == 0)
   {
-    gyroADC[axis][0] = SEN.gyroADC[axis];
+    filter->invSampleFreq = (float)process_time/1000000.0f;
+    cycles = cycleCounter();
+    filter->updateIMU(gx, gy, gz, ax, ay, az);
+    //filter->update(gx, gy, gz, ax, ay, az, mx, my, mz);
+    filter_cycles = cycleCounter() - cycles;
+  }
 
+  computeAngles();
+}
 
-    gyroAdcSum = 0;
-    for (i=0; i<FILTER_NUM; i++)
-    {
-      gyroAdcSum += gyroADC[axis][i];
-    }
-    SEN.gyroADC[axis] = gyroAdcSum/FILTER_NUM;
-    for (i=FILTER_NUM-1; i>0; i--)
-    {
-      gyroADC[axis][i] = gyroADC[axis][i-1];
-    }
 
-    if (abs(SEN.gyroADC[axis]) <= 3)
-    {
-      SEN.gyroADC[axis] = 0;
-    }
+
+/*---------------------------------------------------------------------------
+     TITLE   : computeSample
+     WORK    : Filters the ADC values and converts the sample for the filter
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+void cIMU::computeSample( void )
+{
+  uint32_t i;
+  uint32_t axis;
+
+  for (axis = 0; axis < 3; axis++)
+  {
+    SEN.gyroADC[axis] = (int16_t)gyroFilter[axis].apply((float)SEN.gyroADC[axis]);
+    SEN.accADC[axis]  = (int16_t)accFilter[axis].apply((float)SEN.accADC[axis]);
   }
 
 
@@ -214,28 +763,26 @@ void cIMU::computeIMU( void )
   mx = (float)SEN.magADC[0]*mRes;
   my = (float)SEN.magADC[1]*mRes;
   mz = (float)SEN.magADC[2]*mRes;
+}
 
 
-  cur_process_time  = micros();
-  process_time      = cur_process_time-prev_process_time;
-  prev_process_time = cur_process_time;
-
-  if (SEN.calibratingG == 0 && SEN.calibratingA == 0)
-  {
-    filter.invSampleFreq = (float)process_time/1000000.0f;
-    filter.updateIMU(gx, gy, gz, ax, ay, az);
-    //filter.update(gx, gy, gz, ax, ay, az, mx, my, mz);
-  }
-
-
-  rpy[0] = filter.getRoll();
-  rpy[1] = filter.getPitch();
-  rpy[2] = filter.getYaw()-180.;
 
-  quat[0] = filter.q0;
-  quat[1] = filter.q1;
-  quat[2] = filter.q2;
-  quat[3] = filter.q3;
+/*---------------------------------------------------------------------------
+     TITLE   : computeAngles
+     WORK    :
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+void cIMU::computeAngles( void )
+{
+  rpy[0] = filter->getRoll();
+  rpy[1] = filter->getPitch();
+  rpy[2] = filter->getYaw()-180.;
+
+  quat[0] = filter->q0;
+  quat[1] = filter->q1;
+  quat[2] = filter->q2;
+  quat[3] = filter->q3;
 
   angle[0] = (int16_t)(rpy[0] * 10.);
   angle[1] = (int16_t)(rpy[1] * 10.);
@@ -18,14 +18,33 @@
 #include <Arduino.h>
 
 #include <SPI.h>
+#include <SignalFilter.h>
 // #include "MPU9250.h"
 #include "MadgwickAHRS.h"
+#include "MahonyAHRS.h"
+#include "EkfAHRS.h"
 
 #include "imu_selector.h"
+#include "imu_log.h"
 
 #define IMU_OK			  0x00
 #define IMU_ERR_I2C		0x01
 
+#define IMU_FIFO_BATCH        20    // samples read from the FIFO with one SPI burst (up to 255 bytes)
+#define IMU_SAMPLE_RING_SIZE  32
+
+#define IMU_FILTER_MADGWICK   0
+#define IMU_FILTER_MAHONY     1
+#define IMU_FILTER_EKF        2
+
+
+typedef struct
+{
+  uint32_t stamp_us;    // micros() when the sensor took the sample
+  int16_t  acc[3];      // accADC
+  int16_t  gyro[3];     // gyroADC
+} imu_sample_t;
+
 
 
 class cIMU
@@ -56,18 +75,86 @@ public:
   float gRes;
   float mRes;
 
+  // Filter bank of the ADC values fed to the orientation filter, one channel per axis.
+  // The gyro defaults to a 3 sample average zeroed below 4 LSB,
+  // the IIR filters are designed for a sample rate, e.g. getSampleRate().
+  SignalFilter gyroFilter[3];
+  SignalFilter accFilter[3];
+
 public:
 	cIMU();
 
 	uint8_t  begin( uint32_t hz = 200 );
 	uint16_t update( uint32_t option = 0 );
 
+  // Optional : the sensor INT pin wired to an external interrupt (attachInterrupt() number)
+  void     attachDataReady( uint32_t exti_num );
+
+  // Samples taken from the FIFO, the oldest one is overwritten when the ring is full
+  uint16_t sampleAvailable( void );
+  bool     readSample( imu_sample_t *p_sample );
+
+  uint32_t getSampleStamp( void );
+  uint32_t getSamplePeriod( void );
+  float    getSampleRate( void );
+  uint32_t getOverrunCount( void );
+  uint32_t getLatency( void );
+
+  // Orientation filter, the new one starts from the current orientation
+  bool     setFilter( uint8_t type );
+  uint8_t  getFilter( void );
+  uint32_t getFilterCycles( void );
+
+  // Samples streamed as an IMU log (imu_log.h), a record that does not fit
+  // into the USB buffer is dropped instead of waiting
+  bool     startCapture( USBSerial *p_port );
+  void     stopCapture( void );
+  uint32_t getCaptureDrops( void );
+
+  // Runs the samples of a log through the filters in place of the sensor
+  void     replayBegin( const imu_log_header_t *p_header );
+  void     replaySample( const imu_log_sample_t *p_sample );
+  void     replayEnd( void );
+
 private:
-  Madgwick filter;
+  Madgwick madgwick;
+  Mahony   mahony;
+  Ekf      ekf;
+  AHRS     *filter;
+  uint8_t  filter_type;
+  uint32_t filter_cycles;
   uint32_t update_hz;
   uint32_t update_us;
 
+  bool     fifo_mode;
+  uint32_t sample_period_us;
+  uint32_t sample_stamp;
+  uint32_t overrun_count;
+  uint32_t latency_us;
+
+  bool     data_ready_attached;
+  uint32_t data_ready_count;
+
+  float    sample_rate;
+  uint32_t rate_sample_count;
+  uint32_t rate_time;
+
+  imu_sample_t sample_ring[IMU_SAMPLE_RING_SIZE];
+  uint32_t ring_head;
+  uint32_t ring_tail;
+
+  USBSerial *capture_port;
+  uint32_t capture_drops;
+  uint32_t replay_stamp;
+  uint32_t replay_period_us;
+  bool     replay_started;
+
 	void computeIMU( void );
+  void computeAHRS( uint32_t process_time );
+  void computeSample( void );
+  void computeAngles( void );
+  uint16_t updateFIFO( void );
+  void captureSample( uint32_t stamp_us );
 
 };
 
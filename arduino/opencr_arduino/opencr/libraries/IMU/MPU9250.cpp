@@ -24,6 +24,16 @@
 #define MPU9250_ADDRESS     0x68
 #define MPU_CALI_COUNT      512
 
+// ACCEL_XOUT_H ~ EXT_SENS_DATA_07 : accel(6), temperature(2), gyro(6), AK8963 ST1 ~ ST2(8)
+#define MPU_BURST_LENGTH    22
+#define MPU_BURST_ACC       0
+#define MPU_BURST_TEMP      6
+#define MPU_BURST_GYRO      8
+#define MPU_BURST_MAG       14
+
+#define MPU_FIFO_SIZE       512
+#define MPU_MAG_HZ          100     // AK8963 continuous measurement mode 2
+
 
 //#define ACC_ORIENTATION(X, Y, Z)  {accADC[PITCH]  = -X; accADC[ROLL]  =  Y; accADC[YAW]  =   Z;}
 //#define GYRO_ORIENTATION(X, Y, Z) {gyroADC[PITCH] =  Y; gyroADC[ROLL] =  X; gyroADC[YAW] =   Z;}
@@ -49,6 +59,7 @@ cMPU9250::cMPU9250()
 	calibratingA = 0;
   calibratingM = 0;
   bConnected   = false;
+  tempRAW      = 0;
 }
 
 
@@ -189,6 +200,151 @@ void cMPU9250::init( void )
 }
 
 
+/*---------------------------------------------------------------------------
+     TITLE   : get_adc
+     WORK    : Reads accel, temperature, gyro and mag with one SPI burst,
+               so all of them are from the same sample
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+void cMPU9250::get_adc( void )
+{
+  uint8_t rawADC[MPU_BURST_LENGTH];
+
+  if( bConnected == true )
+  {
+    imu_spi_reads( MPU9250_ADDRESS, MPU9250_ACCEL_XOUT_H, MPU_BURST_LENGTH, rawADC );
+
+    acc_set_adc( &rawADC[MPU_BURST_ACC] );
+    tempRAW = (((int16_t)rawADC[MPU_BURST_TEMP]) << 8) | rawADC[MPU_BURST_TEMP+1];
+    gyro_set_adc( &rawADC[MPU_BURST_GYRO] );
+    mag_set_adc( &rawADC[MPU_BURST_MAG] );
+  }
+
+  acc_common();
+  gyro_common();
+  mag_common();
+}
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : fifo_begin
+     WORK    : Accel and gyro are written to the FIFO at 'hz'
+     ARG     : hz : sample rate
+     RET     : sample period in us, 0 if not connected
+---------------------------------------------------------------------------*/
+uint32_t cMPU9250::fifo_begin( uint32_t hz )
+{
+  uint32_t div;
+  uint32_t mag_div;
+  uint8_t  state;
+
+  if( bConnected == false || hz == 0 )
+  {
+    return 0;
+  }
+
+  //SAMPLE_RATE = 1kHz (DLPF enabled) / (1 + SMPLRT_DIV)
+  div = constrain(1000/hz, 1, 256) - 1;
+	imu_spi_write(MPU9250_SPIx_ADDR, MPU9250_SMPLRT_DIV, div);
+	delay(1);
+
+  //AK8963 is read by the I2C master every (1 + I2C_MST_DLY) samples
+  mag_div = constrain(1000/(div+1)/MPU_MAG_HZ, 1, 32) - 1;
+	imu_spi_write(MPU9250_SPIx_ADDR, MPU9250_I2C_SLV4_CTRL, mag_div);
+	delay(1);
+
+	imu_spi_write(MPU9250_SPIx_ADDR, MPU9250_FIFO_EN, 0x00);
+	delay(1);
+	state = imu_spi_read(MPU9250_SPIx_ADDR, MPU9250_USER_CTRL);
+	imu_spi_write(MPU9250_SPIx_ADDR, MPU9250_USER_CTRL, state | MPU9250_FIFO_RST);
+	delay(1);
+	imu_spi_write(MPU9250_SPIx_ADDR, MPU9250_FIFO_EN, MPU9250_ACCEL | MPU9250_GYRO_XOUT | MPU9250_GYRO_YOUT | MPU9250_GYRO_ZOUT);
+	delay(1);
+	imu_spi_write(MPU9250_SPIx_ADDR, MPU9250_USER_CTRL, state | MPU9250_FIFO_ENABLE);
+	delay(1);
+
+  return (div + 1) * 1000;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : fifo_get_count
+     WORK    :
+     ARG     : void
+     RET     : bytes in the FIFO, -1 if the FIFO overflowed and was reset
+---------------------------------------------------------------------------*/
+int32_t cMPU9250::fifo_get_count( void )
+{
+  uint8_t data[2];
+  int32_t count;
+
+  if( bConnected == false )
+  {
+    return 0;
+  }
+
+  imu_spi_reads( MPU9250_ADDRESS, MPU9250_FIFO_COUNTH, 2, data );
+  count = ((data[0] & 0x1F) << 8) | data[1];
+
+  // Old samples were overwritten, the sample boundary is lost
+  if( count > MPU_FIFO_SIZE - IMU_FIFO_SAMPLE_SIZE )
+  {
+    fifo_reset();
+    return -1;
+  }
+
+  return count;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : fifo_read
+     WORK    :
+     ARG     : p_data, length : up to 255 bytes
+     RET     : void
+---------------------------------------------------------------------------*/
+void cMPU9250::fifo_read( uint8_t *p_data, uint16_t length )
+{
+  imu_spi_reads( MPU9250_ADDRESS, MPU9250_FIFO_R_W, length, p_data );
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : fifo_reset
+     WORK    :
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+void cMPU9250::fifo_reset( void )
+{
+  uint8_t state;
+
+	state = imu_spi_read(MPU9250_SPIx_ADDR, MPU9250_USER_CTRL);
+	imu_spi_write(MPU9250_SPIx_ADDR, MPU9250_USER_CTRL, state | MPU9250_FIFO_RST);
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : fifo_get_adc
+     WORK    : Decodes one FIFO sample
+     ARG     : p_data : IMU_FIFO_SAMPLE_SIZE bytes
+     RET     : void
+---------------------------------------------------------------------------*/
+void cMPU9250::fifo_get_adc( uint8_t *p_data )
+{
+  acc_set_adc( &p_data[0] );
+  gyro_set_adc( &p_data[6] );
+
+  acc_common();
+  gyro_common();
+}
+
+
 /*---------------------------------------------------------------------------
      TITLE   : gyro_init
      WORK    :
@@ -219,28 +375,40 @@ void cMPU9250::gyro_init( void )
 ---------------------------------------------------------------------------*/
 void cMPU9250::gyro_get_adc( void )
 {
-  int16_t x = 0;
-  int16_t y = 0;
-  int16_t z = 0;
-
   uint8_t rawADC[6];
 
   if( bConnected == true )
   {
     imu_spi_reads( MPU9250_ADDRESS, MPU9250_GYRO_XOUT_H, 6, rawADC );
+    gyro_set_adc( rawADC );
+  }
 
- 	x = (((int16_t)rawADC[0]) << 8) | rawADC[1];
-  	y = (((int16_t)rawADC[2]) << 8) | rawADC[3];
-  	z = (((int16_t)rawADC[4]) << 8) | rawADC[5];
+  gyro_common();
+}
 
-  	gyroRAW[0] = x;
-  	gyroRAW[1] = y;
-  	gyroRAW[2] = z;
 
-  	GYRO_ORIENTATION( x, y,z );
-  }
 
-  gyro_common();
+/*---------------------------------------------------------------------------
+     TITLE   : gyro_set_adc
+     WORK    :
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+void cMPU9250::gyro_set_adc( uint8_t *rawADC )
+{
+  int16_t x = 0;
+  int16_t y = 0;
+  int16_t z = 0;
+
+  x = (((int16_t)rawADC[0]) << 8) | rawADC[1];
+  y = (((int16_t)rawADC[2]) << 8) | rawADC[3];
+  z = (((int16_t)rawADC[4]) << 8) | rawADC[5];
+
+  gyroRAW[0] = x;
+  gyroRAW[1] = y;
+  gyroRAW[2] = z;
+
+  GYRO_ORIENTATION( x, y,z );
 }
 
 
@@ -290,24 +458,12 @@ void cMPU9250::acc_init( void )
 ---------------------------------------------------------------------------*/
 void cMPU9250::acc_get_adc( void )
 {
-  int16_t x = 0;
-  int16_t y = 0;
-  int16_t z = 0;
   uint8_t rawADC[6];
 
   if( bConnected == true )
   {
     imu_spi_reads( MPU9250_ADDRESS, MPU9250_ACCEL_XOUT_H, 6, rawADC );
-
-    x = (((int16_t)rawADC[0]) << 8) | rawADC[1];
-    y = (((int16_t)rawADC[2]) << 8) | rawADC[3];
-    z = (((int16_t)rawADC[4]) << 8) | rawADC[5];
-
-    accRAW[0] = x;
-    accRAW[1] = y;
-    accRAW[2] = z;
-	
-	ACC_ORIENTATION( x,	y, z );
+    acc_set_adc( rawADC );
   }
 
 	acc_common();
@@ -315,6 +471,31 @@ void cMPU9250::acc_get_adc( void )
 
 
 
+/*---------------------------------------------------------------------------
+     TITLE   : acc_set_adc
+     WORK    :
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+void cMPU9250::acc_set_adc( uint8_t *rawADC )
+{
+  int16_t x = 0;
+  int16_t y = 0;
+  int16_t z = 0;
+
+  x = (((int16_t)rawADC[0]) << 8) | rawADC[1];
+  y = (((int16_t)rawADC[2]) << 8) | rawADC[3];
+  z = (((int16_t)rawADC[4]) << 8) | rawADC[5];
+
+  accRAW[0] = x;
+  accRAW[1] = y;
+  accRAW[2] = z;
+
+  ACC_ORIENTATION( x,	y, z );
+}
+
+
+
 
 
 /*---------------------------------------------------------------------------
@@ -445,10 +626,6 @@ void cMPU9250::mag_init( void )
 ---------------------------------------------------------------------------*/
 void cMPU9250::mag_get_adc( void )
 {
-	// int16_t x = 0;
-	// int16_t y = 0;
-	// int16_t z = 0;
-
   uint8_t data[8];
 
 
@@ -456,22 +633,7 @@ void cMPU9250::mag_get_adc( void )
   if( bConnected == true )
   {
   	imu_spi_reads(MPU9250_ADDRESS, MPU9250_EXT_SENS_DATA_00, 8, data);
-
-  	if (!(data[0] & MPU9250_AK8963_DATA_READY) || (data[0] & MPU9250_AK8963_DATA_OVERRUN))
-    {
-  		return;
-  	}
-  	if (data[7] & MPU9250_AK8963_OVERFLOW)
-    {
-  		return;
-  	}
-  	magRAW[0] = (data[2] << 8) | data[1];
-  	magRAW[1] = (data[4] << 8) | data[3];
-  	magRAW[2] = (data[6] << 8) | data[5];
-
-  	magRAW[0] = ((long)magRAW[0] * AK8963_ASA[0]) >> 8;
-  	magRAW[1] = ((long)magRAW[1] * AK8963_ASA[1]) >> 8;
-  	magRAW[2] = ((long)magRAW[2] * AK8963_ASA[2]) >> 8;
+  	mag_set_adc(data);
 	}
 
 	mag_common();
@@ -479,6 +641,34 @@ void cMPU9250::mag_get_adc( void )
 
 
 
+/*---------------------------------------------------------------------------
+     TITLE   : mag_set_adc
+     WORK    : AK8963 ST1 ~ ST2 read by the I2C master (SLV0)
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+void cMPU9250::mag_set_adc( uint8_t *data )
+{
+  // The last sample is kept when no new sample is ready or it is not valid
+  if (!(data[0] & MPU9250_AK8963_DATA_READY) || (data[0] & MPU9250_AK8963_DATA_OVERRUN))
+  {
+    return;
+  }
+  if (data[7] & MPU9250_AK8963_OVERFLOW)
+  {
+    return;
+  }
+  magRAW[0] = (data[2] << 8) | data[1];
+  magRAW[1] = (data[4] << 8) | data[3];
+  magRAW[2] = (data[6] << 8) | data[5];
+
+  magRAW[0] = ((long)magRAW[0] * AK8963_ASA[0]) >> 8;
+  magRAW[1] = ((long)magRAW[1] * AK8963_ASA[1]) >> 8;
+  magRAW[2] = ((long)magRAW[2] * AK8963_ASA[2]) >> 8;
+}
+
+
+
 
 
 /*---------------------------------------------------------------------------
@@ -539,3 +729,37 @@ bool cMPU9250::gyro_cali_get_done()
 	if( calibratingG == 0 ) return true;
 	else                    return false;
 }
+
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : gyro_set_zero
+     WORK    : Bias from outside, a running calibration is stopped
+     ARG     : p_zero : 3 axes
+     RET     : void
+---------------------------------------------------------------------------*/
+void cMPU9250::gyro_set_zero( const int16_t *p_zero )
+{
+  calibratingG = 0;
+  gyroZero[0]  = p_zero[0];
+  gyroZero[1]  = p_zero[1];
+  gyroZero[2]  = p_zero[2];
+}
+
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : acc_set_zero
+     WORK    : Bias from outside, a running calibration is stopped
+     ARG     : p_zero : 3 axes
+     RET     : void
+---------------------------------------------------------------------------*/
+void cMPU9250::acc_set_zero( const int16_t *p_zero )
+{
+  calibratingA = 0;
+  accZero[0]   = p_zero[0];
+  accZero[1]   = p_zero[1];
+  accZero[2]   = p_zero[2];
+}
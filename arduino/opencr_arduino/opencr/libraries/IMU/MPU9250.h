@@ -48,6 +48,8 @@ class cMPU9250
     int16_t  magRAW[3];
     int16_t  magZero[3];
 
+    int16_t  tempRAW;
+
     int16_t  gyroData[3];
     int16_t  accSmooth[3];
 
@@ -62,17 +64,26 @@ class cMPU9250
 
     bool begin( void );
     void init( void );
+    void get_adc( void );
+
+    uint32_t fifo_begin( uint32_t hz );
+    int32_t  fifo_get_count( void );
+    void     fifo_read( uint8_t *p_data, uint16_t length );
+    void     fifo_reset( void );
+    void     fifo_get_adc( uint8_t *p_data );
 	void gyro_init( void );
 	void gyro_get_adc( void );
 	void gyro_common();
 	void gyro_cali_start();
 	bool gyro_cali_get_done();
+	void gyro_set_zero( const int16_t *p_zero );
 
 	void acc_init( void );
 	void acc_get_adc( void );
 	void acc_common();
 	void acc_cali_start();
 	bool acc_cali_get_done();
+	void acc_set_zero( const int16_t *p_zero );
 
     void mag_init( void );
 	void mag_get_adc( void );
@@ -80,6 +91,10 @@ class cMPU9250
 	void mag_cali_start();
 	bool mag_cali_get_done();
 
+ private:
+  void acc_set_adc( uint8_t *rawADC );
+  void gyro_set_adc( uint8_t *rawADC );
+  void mag_set_adc( uint8_t *data );
 };
 
 
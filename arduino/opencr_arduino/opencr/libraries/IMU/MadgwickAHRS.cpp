@@ -25,7 +25,6 @@
 //-------------------------------------------------------------------------------------------
 // Definitions
 
-#define sampleFreqDef   512.0f          // sample frequency in Hz
 #define betaDef         0.1f            // 2 * proportional gain
 
 
@@ -38,12 +37,6 @@
 
 Madgwick::Madgwick() {
 	beta = betaDef;
-	q0 = 1.0f;
-	q1 = 0.0f;
-	q2 = 0.0f;
-	q3 = 0.0f;
-	invSampleFreq = 1.0f / sampleFreqDef;
-	anglesComputed = 0;
 }
 
 void Madgwick::update(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz) {
@@ -60,9 +53,9 @@ void Madgwick::update(float gx, float gy, float gz, float ax, float ay, float az
 	}
 
 	// Convert gyroscope degrees/sec to radians/sec
-	gx *= 0.0174533f;
-	gy *= 0.0174533f;
-	gz *= 0.0174533f;
+	gx *= AHRS_DEG_TO_RAD;
+	gy *= AHRS_DEG_TO_RAD;
+	gz *= AHRS_DEG_TO_RAD;
 
 	// Rate of change of quaternion from gyroscope
 	qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
@@ -120,17 +113,16 @@ void Madgwick::update(float gx, float gy, float gz, float ax, float ay, float az
 		s1 = _2q3 * (2.0f * q1q3 - _2q0q2 - ax) + _2q0 * (2.0f * q0q1 + _2q2q3 - ay) - 4.0f * q1 * (1 - 2.0f * q1q1 - 2.0f * q2q2 - az) + _2bz * q3 * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (_2bx * q2 + _2bz * q0) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + (_2bx * q3 - _4bz * q1) * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
 		s2 = -_2q0 * (2.0f * q1q3 - _2q0q2 - ax) + _2q3 * (2.0f * q0q1 + _2q2q3 - ay) - 4.0f * q2 * (1 - 2.0f * q1q1 - 2.0f * q2q2 - az) + (-_4bx * q2 - _2bz * q0) * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (_2bx * q1 + _2bz * q3) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + (_2bx * q0 - _4bz * q2) * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
 		s3 = _2q1 * (2.0f * q1q3 - _2q0q2 - ax) + _2q2 * (2.0f * q0q1 + _2q2q3 - ay) + (-_4bx * q3 + _2bz * q1) * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (-_2bx * q0 + _2bz * q2) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + _2bx * q1 * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
-		recipNorm = invSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3); // normalise step magnitude
-		s0 *= recipNorm;
-		s1 *= recipNorm;
-		s2 *= recipNorm;
-		s3 *= recipNorm;
-
-		// Apply feedback step
-		qDot1 -= beta * s0;
-		qDot2 -= beta * s1;
-		qDot3 -= beta * s2;
-		qDot4 -= beta * s3;
+		recipNorm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+		if(recipNorm > 0.0f) {
+			recipNorm = beta * invSqrt(recipNorm); // normalise step magnitude
+
+			// Apply feedback step
+			qDot1 -= recipNorm * s0;
+			qDot2 -= recipNorm * s1;
+			qDot3 -= recipNorm * s2;
+			qDot4 -= recipNorm * s3;
+		}
 	}
 
 	// Integrate rate of change of quaternion to yield quaternion
@@ -149,24 +141,26 @@ void Madgwick::update(float gx, float gy, float gz, float ax, float ay, float az
 }
 
 //-------------------------------------------------------------------------------------------
-// IMU algorithm update
+// IMU algorithm step
+// halfDt turns degrees/sec into half the angle turned during one sample and betaDt is the
+// gradient step of one sample, so the rate of change is integrated without extra products
 
-void Madgwick::updateIMU(float gx, float gy, float gz, float ax, float ay, float az) {
+inline void Madgwick::stepIMU(float gx, float gy, float gz, float ax, float ay, float az, float halfDt, float betaDt) {
 	float recipNorm;
 	float s0, s1, s2, s3;
 	float qDot1, qDot2, qDot3, qDot4;
 	float _2q0, _2q1, _2q2, _2q3, _4q0, _4q1, _4q2 ,_8q1, _8q2, q0q0, q1q1, q2q2, q3q3;
 
-	// Convert gyroscope degrees/sec to radians/sec
-	gx *= 0.0174533f;
-	gy *= 0.0174533f;
-	gz *= 0.0174533f;
+	// Convert gyroscope degrees/sec to half the angle turned in radians
+	gx *= halfDt;
+	gy *= halfDt;
+	gz *= halfDt;
 
-	// Rate of change of quaternion from gyroscope
-	qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
-	qDot2 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
-	qDot3 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
-	qDot4 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+	// Change of quaternion from gyroscope during one sample
+	qDot1 = -q1 * gx - q2 * gy - q3 * gz;
+	qDot2 = q0 * gx + q2 * gz - q3 * gy;
+	qDot3 = q0 * gy - q1 * gz + q3 * gx;
+	qDot4 = q0 * gz + q1 * gy - q2 * gx;
 
 	// Compute feedback only if accelerometer measurement valid (avoids NaN in accelerometer normalisation)
 	if(!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))) {
@@ -197,24 +191,23 @@ void Madgwick::updateIMU(float gx, float gy, float gz, float ax, float ay, float
 		s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
 		s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
 		s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
-		recipNorm = invSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3); // normalise step magnitude
-		s0 *= recipNorm;
-		s1 *= recipNorm;
-		s2 *= recipNorm;
-		s3 *= recipNorm;
-
-		// Apply feedback step
-		qDot1 -= beta * s0;
-		qDot2 -= beta * s1;
-		qDot3 -= beta * s2;
-		qDot4 -= beta * s3;
+		recipNorm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+		if(recipNorm > 0.0f) {
+			recipNorm = betaDt * invSqrt(recipNorm); // normalise step magnitude
+
+			// Apply feedback step
+			qDot1 -= recipNorm * s0;
+			qDot2 -= recipNorm * s1;
+			qDot3 -= recipNorm * s2;
+			qDot4 -= recipNorm * s3;
+		}
 	}
 
-	// Integrate rate of change of quaternion to yield quaternion
-	q0 += qDot1 * invSampleFreq;
-	q1 += qDot2 * invSampleFreq;
-	q2 += qDot3 * invSampleFreq;
-	q3 += qDot4 * invSampleFreq;
+	// Integrate change of quaternion to yield quaternion
+	q0 += qDot1;
+	q1 += qDot2;
+	q2 += qDot3;
+	q3 += qDot4;
 
 	// Normalise quaternion
 	recipNorm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
@@ -222,30 +215,25 @@ void Madgwick::updateIMU(float gx, float gy, float gz, float ax, float ay, float
 	q1 *= recipNorm;
 	q2 *= recipNorm;
 	q3 *= recipNorm;
-	anglesComputed = 0;
 }
 
 //-------------------------------------------------------------------------------------------
-// Fast inverse square-root
-// See: http://en.wikipedia.org/wiki/Fast_inverse_square_root
-
-float Madgwick::invSqrt(float x) {
-	float halfx = 0.5f * x;
-	float y = x;
-	long i = *(long*)&y;
-	i = 0x5f3759df - (i>>1);
-	y = *(float*)&i;
-	y = y * (1.5f - (halfx * y * y));
-	y = y * (1.5f - (halfx * y * y));
-	return y;
+// IMU algorithm update
+
+void Madgwick::updateIMU(float gx, float gy, float gz, float ax, float ay, float az) {
+	stepIMU(gx, gy, gz, ax, ay, az, 0.5f * AHRS_DEG_TO_RAD * invSampleFreq, beta * invSampleFreq);
+	anglesComputed = 0;
 }
 
 //-------------------------------------------------------------------------------------------
+// IMU algorithm update of samples taken invSampleFreq apart
+
+void Madgwick::updateIMUBatch(const float gyro[][3], const float acc[][3], uint32_t count) {
+	float halfDt = 0.5f * AHRS_DEG_TO_RAD * invSampleFreq;
+	float betaDt = beta * invSampleFreq;
 
-void Madgwick::computeAngles()
-{
-	roll = atan2f(q0*q1 + q2*q3, 0.5f - q1*q1 - q2*q2);
-	pitch = asinf(-2.0f * (q1*q3 - q0*q2));
-	yaw = atan2f(q1*q2 + q0*q3, 0.5f - q2*q2 - q3*q3);
-	anglesComputed = 1;
+	for(uint32_t i = 0; i < count; i++) {
+		stepIMU(gyro[i][0], gyro[i][1], gyro[i][2], acc[i][0], acc[i][1], acc[i][2], halfDt, betaDt);
+	}
+	anglesComputed = 0;
 }
@@ -0,0 +1,40 @@
+//=============================================================================================
+// MahonyAHRS.h
+//=============================================================================================
+//
+// Madgwick's implementation of Mahony's AHRS algorithm.
+// See: http://www.x-io.co.uk/open-source-imu-and-ahrs-algorithms/
+//
+// From the x-io website "Open-source resources available on this website are
+// provided under the GNU General Public Licence unless an alternative licence
+// is provided in source."
+//
+// Date			Author			Notes
+// 29/09/2011	SOH Madgwick    Initial release
+// 02/10/2011	SOH Madgwick	Optimised for reduced CPU load
+//
+//=============================================================================================
+#ifndef MahonyAHRS_h
+#define MahonyAHRS_h
+#include <math.h>
+#include "AHRS.h"
+
+//--------------------------------------------------------------------------------------------
+// Variable declaration
+class Mahony : public AHRS{
+private:
+    float twoKp;		// 2 * proportional gain (Kp)
+    float twoKi;		// 2 * integral gain (Ki)
+    float integralFBx, integralFBy, integralFBz;  // integral error terms scaled by Ki
+    inline void stepIMU(float gx, float gy, float gz, float ax, float ay, float az, float dt);
+
+//-------------------------------------------------------------------------------------------
+// Function declarations
+public:
+    Mahony(void);
+    void update(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz);
+    void updateIMU(float gx, float gy, float gz, float ax, float ay, float az);
+    void updateIMUBatch(const float gyro[][3], const float acc[][3], uint32_t count);
+    void setGain(float kp, float ki) { twoKp = 2.0f * kp; twoKi = 2.0f * ki; }
+};
+#endif
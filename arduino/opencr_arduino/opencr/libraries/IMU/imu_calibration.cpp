@@ -0,0 +1,333 @@
+#include <Arduino.h>
+#include "imu_calibration.h"
+#include "drv_eeprom.h"
+
+
+#define IMU_CALI_EEPROM_MAGIC   0xCA
+
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : cIMUCalibration
+     WORK    :
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+cIMUCalibration::cIMUCalibration()
+{
+  uint8_t axis;
+
+  for( axis=0; axis<3; axis++ )
+  {
+    gyroBias[axis] = 0.;
+    accBias[axis]  = 0.;
+    gyroMean[axis] = 0.;
+    gyroVar[axis]  = 0.;
+    accMean[axis]  = 0.;
+    accVar[axis]   = 0.;
+  }
+
+  request     = 0;
+  valid       = 0;
+  windows     = 0;
+  still       = false;
+  ended_still = false;
+  tracking    = true;
+  bestScore   = -1.;
+
+  reset();
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : start
+     WORK    : Requests a calibration, it ends with the next still window
+     ARG     : sensors : IMU_CALI_GYRO | IMU_CALI_ACC
+     RET     : void
+---------------------------------------------------------------------------*/
+void cIMUCalibration::start( uint8_t sensors )
+{
+  request  |= sensors;
+  windows   = 0;
+  bestScore = -1.;
+
+  reset();
+}
+
+// Sensors whose calibration has not ended yet
+uint8_t cIMUCalibration::pending( void )
+{
+  return request;
+}
+
+// Sensors with a bias from a calibration, stored or done since boot
+uint8_t cIMUCalibration::calibrated( void )
+{
+  return valid;
+}
+
+bool cIMUCalibration::isStill( void )
+{
+  return still;
+}
+
+// The last requested calibration ended on a still window, not on the quietest
+// one of a robot that kept moving. Only such biases are worth storing.
+bool cIMUCalibration::endedStill( void )
+{
+  return ended_still;
+}
+
+void cIMUCalibration::setTracking( bool enable )
+{
+  tracking = enable;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : update
+     WORK    : Adds one sample to the running mean and variance (Welford)
+               and updates the biases at the end of each window
+     ARG     : gyro, acc : oriented ADC values without bias correction
+     RET     : true if a bias changed
+---------------------------------------------------------------------------*/
+bool cIMUCalibration::update( const int32_t *gyro, const int32_t *acc )
+{
+  uint8_t axis;
+  float   inv_count;
+  float   delta;
+  float   score;
+  bool    ret = false;
+
+
+  count++;
+  inv_count = 1.0f / (float)count;
+
+  for( axis=0; axis<3; axis++ )
+  {
+    delta         = (float)gyro[axis] - gyroM1[axis];
+    gyroM1[axis] += delta * inv_count;
+    gyroM2[axis] += delta * ((float)gyro[axis] - gyroM1[axis]);
+
+    delta         = (float)acc[axis] - accM1[axis];
+    accM1[axis]  += delta * inv_count;
+    accM2[axis]  += delta * ((float)acc[axis] - accM1[axis]);
+  }
+
+  if( count < IMU_CALI_WINDOW )
+  {
+    return false;
+  }
+
+
+  still = true;
+  score = 0.;
+  for( axis=0; axis<3; axis++ )
+  {
+    gyroMean[axis] = gyroM1[axis];
+    gyroVar[axis]  = gyroM2[axis] / (float)(count - 1);
+    accMean[axis]  = accM1[axis];
+    accVar[axis]   = accM2[axis] / (float)(count - 1);
+
+    if( gyroVar[axis] > IMU_CALI_GYRO_VAR || accVar[axis] > IMU_CALI_ACC_VAR )
+    {
+      still = false;
+    }
+    score += gyroVar[axis] / IMU_CALI_GYRO_VAR + accVar[axis] / IMU_CALI_ACC_VAR;
+  }
+  reset();
+
+
+  if( request != 0 )
+  {
+    // The quietest window is taken if the robot does not stay still
+    if( bestScore < 0. || score < bestScore )
+    {
+      bestScore = score;
+      for( axis=0; axis<3; axis++ )
+      {
+        bestGyro[axis] = gyroMean[axis];
+        bestAcc[axis]  = accMean[axis];
+      }
+    }
+    windows++;
+
+    if( still == true || windows >= IMU_CALI_WINDOW_MAX )
+    {
+      for( axis=0; axis<3; axis++ )
+      {
+        if( request & IMU_CALI_GYRO ) gyroBias[axis] = bestGyro[axis];
+        if( request & IMU_CALI_ACC )  accBias[axis]  = bestAcc[axis];
+      }
+      // The Z axis keeps the gravity
+      if( request & IMU_CALI_ACC ) accBias[2] = 0.;
+
+      valid      |= request;
+      request     = 0;
+      ended_still = still;
+      ret         = true;
+    }
+  }
+  else if( tracking == true && still == true )
+  {
+    // A slow turn is also still, only small changes are taken as drift
+    for( axis=0; axis<3; axis++ )
+    {
+      if( fabsf(gyroMean[axis] - gyroBias[axis]) > IMU_CALI_TRACK_LIMIT )
+      {
+        return false;
+      }
+    }
+    for( axis=0; axis<3; axis++ )
+    {
+      gyroBias[axis] += IMU_CALI_TRACK_GAIN * (gyroMean[axis] - gyroBias[axis]);
+    }
+    ret = true;
+  }
+
+  return ret;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : getGyroZero, getAccZero
+     WORK    : Biases rounded to the ADC values the sensors subtract
+     ARG     : p_zero : 3 axes
+     RET     : void
+---------------------------------------------------------------------------*/
+void cIMUCalibration::getGyroZero( int16_t *p_zero )
+{
+  uint8_t axis;
+
+  for( axis=0; axis<3; axis++ )
+  {
+    p_zero[axis] = (int16_t)lroundf(gyroBias[axis]);
+  }
+}
+
+void cIMUCalibration::getAccZero( int16_t *p_zero )
+{
+  uint8_t axis;
+
+  for( axis=0; axis<3; axis++ )
+  {
+    p_zero[axis] = (int16_t)lroundf(accBias[axis]);
+  }
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : load
+     WORK    : Reads the biases stored by save()
+     ARG     : model : sensor the biases belong to
+     RET     : false if nothing valid is stored for the sensor
+---------------------------------------------------------------------------*/
+bool cIMUCalibration::load( uint8_t model )
+{
+  uint8_t data[IMU_CALI_EEPROM_LENGTH];
+  uint8_t checksum = 0;
+  uint8_t axis;
+  int     i;
+
+  // save() does not store the record in a shorter EEPROM either
+  if( drv_eeprom_get_length() < IMU_CALI_EEPROM_ADDR + IMU_CALI_EEPROM_LENGTH )
+  {
+    return false;
+  }
+
+  for( i=0; i<IMU_CALI_EEPROM_LENGTH; i++ )
+  {
+    data[i] = drv_eeprom_read_byte(IMU_CALI_EEPROM_ADDR + i);
+  }
+  for( i=0; i<IMU_CALI_EEPROM_LENGTH-1; i++ )
+  {
+    checksum += data[i];
+  }
+
+  if( data[0] != IMU_CALI_EEPROM_MAGIC || data[1] != model || data[IMU_CALI_EEPROM_LENGTH-1] != checksum )
+  {
+    return false;
+  }
+
+  for( axis=0; axis<3; axis++ )
+  {
+    gyroBias[axis] = (int16_t)(data[2 + axis*2] | (data[3 + axis*2] << 8));
+    accBias[axis]  = (int16_t)(data[8 + axis*2] | (data[9 + axis*2] << 8));
+  }
+  valid = IMU_CALI_GYRO | IMU_CALI_ACC;
+
+  return true;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : save
+     WORK    : Stores the biases, only bytes that changed are written
+               to spare the flash behind the emulated EEPROM
+     ARG     : model : sensor the biases belong to
+     RET     : false if the EEPROM is not available
+---------------------------------------------------------------------------*/
+bool cIMUCalibration::save( uint8_t model )
+{
+  uint8_t data[IMU_CALI_EEPROM_LENGTH];
+  int16_t gyro_zero[3];
+  int16_t acc_zero[3];
+  uint8_t checksum = 0;
+  uint8_t axis;
+  int     i;
+
+  if( drv_eeprom_get_length() < IMU_CALI_EEPROM_ADDR + IMU_CALI_EEPROM_LENGTH )
+  {
+    return false;
+  }
+
+  getGyroZero(gyro_zero);
+  getAccZero(acc_zero);
+
+  data[0] = IMU_CALI_EEPROM_MAGIC;
+  data[1] = model;
+  for( axis=0; axis<3; axis++ )
+  {
+    data[2 + axis*2] = (uint8_t)(gyro_zero[axis] >> 0);
+    data[3 + axis*2] = (uint8_t)(gyro_zero[axis] >> 8);
+    data[8 + axis*2] = (uint8_t)(acc_zero[axis] >> 0);
+    data[9 + axis*2] = (uint8_t)(acc_zero[axis] >> 8);
+  }
+  for( i=0; i<IMU_CALI_EEPROM_LENGTH-1; i++ )
+  {
+    checksum += data[i];
+  }
+  data[IMU_CALI_EEPROM_LENGTH-1] = checksum;
+
+  for( i=0; i<IMU_CALI_EEPROM_LENGTH; i++ )
+  {
+    if( drv_eeprom_read_byte(IMU_CALI_EEPROM_ADDR + i) != data[i] )
+    {
+      drv_eeprom_write_byte(IMU_CALI_EEPROM_ADDR + i, data[i]);
+    }
+  }
+
+  return true;
+}
+
+
+
+void cIMUCalibration::reset( void )
+{
+  uint8_t axis;
+
+  count = 0;
+  for( axis=0; axis<3; axis++ )
+  {
+    gyroM1[axis] = 0.;
+    gyroM2[axis] = 0.;
+    accM1[axis]  = 0.;
+    accM2[axis]  = 0.;
+  }
+}
@@ -0,0 +1,73 @@
+#ifndef _IMU_CALIBRATION_H_
+#define _IMU_CALIBRATION_H_
+
+#include <inttypes.h>
+
+
+#define IMU_CALI_GYRO           0x01
+#define IMU_CALI_ACC            0x02
+
+#define IMU_CALI_WINDOW         200       // samples of one stillness window (1 s at 200 Hz)
+#define IMU_CALI_WINDOW_MAX     10        // windows waited for stillness, then the quietest one is taken
+#define IMU_CALI_GYRO_VAR       16.0f     // gyro variance while still, LSB^2 (0.25 dps at 16.4 LSB/dps)
+#define IMU_CALI_ACC_VAR        6400.0f   // acc variance while still, LSB^2 (0.02 g at 4096 LSB/g)
+#define IMU_CALI_TRACK_LIMIT    8.0f      // largest gyro bias change taken by tracking, LSB (0.5 dps)
+#define IMU_CALI_TRACK_GAIN     0.2f      // share of the still window mean taken by tracking
+
+#define IMU_CALI_EEPROM_ADDR    0x0F00    // emulated EEPROM address of the stored biases, listed in the EEPROM README
+#define IMU_CALI_EEPROM_LENGTH  15
+
+
+// Biases from the running mean and variance of the sample stream.
+// A requested calibration ends with the first still window, tracking follows
+// slow gyro bias drift in every still window after that.
+class cIMUCalibration
+{
+ public:
+  cIMUCalibration();
+
+  void     start( uint8_t sensors );
+  uint8_t  pending( void );
+  uint8_t  calibrated( void );
+  bool     update( const int32_t *gyro, const int32_t *acc );
+  bool     isStill( void );
+  bool     endedStill( void );
+  void     setTracking( bool enable );
+
+  void     getGyroZero( int16_t *p_zero );
+  void     getAccZero( int16_t *p_zero );
+
+  bool     load( uint8_t model );
+  bool     save( uint8_t model );
+
+ public:
+  float    gyroBias[3];
+  float    accBias[3];
+
+  float    gyroMean[3];     // of the last complete window
+  float    gyroVar[3];
+  float    accMean[3];
+  float    accVar[3];
+
+ private:
+  uint8_t  request;
+  uint8_t  valid;
+  uint8_t  windows;
+  bool     still;
+  bool     ended_still;
+  bool     tracking;
+
+  uint32_t count;
+  float    gyroM1[3];
+  float    gyroM2[3];
+  float    accM1[3];
+  float    accM2[3];
+
+  float    bestScore;
+  float    bestGyro[3];
+  float    bestAcc[3];
+
+  void     reset( void );
+};
+
+#endif
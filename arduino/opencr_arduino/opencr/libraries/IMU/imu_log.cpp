@@ -0,0 +1,120 @@
+#include <string.h>
+#include "imu_log.h"
+
+
+
+
+uint8_t imu_log_checksum( const void *p_record, uint32_t length )
+{
+  const uint8_t *p_data = (const uint8_t *)p_record;
+  uint8_t  checksum = 0;
+  uint32_t i;
+
+  for( i=0; i<length; i++ )
+  {
+    checksum += p_data[i];
+  }
+
+  return checksum;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : cIMULogReader
+     WORK    :
+     ARG     : void
+     RET     : void
+---------------------------------------------------------------------------*/
+cIMULogReader::cIMULogReader()
+{
+  memset(&header, 0, sizeof(header));
+  memset(&sample, 0, sizeof(sample));
+
+  error_count = 0;
+  reset();
+}
+
+void cIMULogReader::reset( void )
+{
+  index  = 0;
+  length = 0;
+}
+
+uint32_t cIMULogReader::getErrorCount( void )
+{
+  return error_count;
+}
+
+
+
+/*---------------------------------------------------------------------------
+     TITLE   : feed
+     WORK    : Adds one byte of the stream, a record with a wrong checksum
+               is searched again for a sync byte
+     ARG     : data : next byte of the stream
+     RET     : IMU_LOG_TYPE_HEADER or IMU_LOG_TYPE_SAMPLE when a record
+               is complete, 0 otherwise
+---------------------------------------------------------------------------*/
+uint8_t cIMULogReader::feed( uint8_t data )
+{
+  uint8_t  type = 0;
+  uint32_t i;
+
+  buffer[index++] = data;
+
+  while( index > 0 )
+  {
+    if( buffer[0] != IMU_LOG_SYNC )
+    {
+      length = 0;
+    }
+    else if( index >= 2 )
+    {
+      switch( buffer[1] )
+      {
+        case IMU_LOG_TYPE_HEADER: length = sizeof(imu_log_header_t); break;
+        case IMU_LOG_TYPE_SAMPLE: length = sizeof(imu_log_sample_t); break;
+        default:                  length = 0;                        break;
+      }
+      if( length == 0 )
+      {
+        error_count++;
+      }
+    }
+    else
+    {
+      break;
+    }
+
+    if( length > 0 && index < length )
+    {
+      break;
+    }
+
+    if( length > 0 && imu_log_checksum(buffer, length - 1) == buffer[length - 1] )
+    {
+      type = buffer[1];
+      if( type == IMU_LOG_TYPE_HEADER ) memcpy(&header, buffer, length);
+      else                              memcpy(&sample, buffer, length);
+      index -= length;
+      memmove(buffer, &buffer[length], index);
+      break;
+    }
+
+    // Not a record, it starts at one of the next sync bytes if any
+    if( length > 0 )
+    {
+      error_count++;
+    }
+    for( i=1; i<index; i++ )
+    {
+      if( buffer[i] == IMU_LOG_SYNC ) break;
+    }
+    index -= i;
+    memmove(buffer, &buffer[i], index);
+    length = 0;
+  }
+
+  return type;
+}
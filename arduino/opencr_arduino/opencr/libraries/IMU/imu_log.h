@@ -0,0 +1,70 @@
+#ifndef _IMU_LOG_H_
+#define _IMU_LOG_H_
+
+#include <inttypes.h>
+
+
+// Binary log of cIMU::startCapture(), little endian records:
+//   header : written once when the capture starts
+//   sample : one per sensor sample
+// Each record starts with IMU_LOG_SYNC and its type and ends with the 8 bit
+// sum of all the bytes before the checksum.
+#define IMU_LOG_SYNC            0xA5
+#define IMU_LOG_VERSION         1
+
+#define IMU_LOG_TYPE_HEADER     0x01
+#define IMU_LOG_TYPE_SAMPLE     0x02
+
+
+typedef struct __attribute__((packed))
+{
+  uint8_t  sync;
+  uint8_t  type;
+  uint8_t  version;
+  uint8_t  fifo;          // 1 if the samples were taken from the sensor FIFO
+  uint32_t period_us;     // sample period
+  float    aRes;
+  float    gRes;
+  float    mRes;
+  int16_t  gyroZero[3];   // biases when the capture started
+  int16_t  accZero[3];
+  uint8_t  checksum;
+} imu_log_header_t;
+
+typedef struct __attribute__((packed))
+{
+  uint8_t  sync;
+  uint8_t  type;
+  uint32_t stamp_us;      // micros() when the sensor took the sample
+  int16_t  acc[3];        // oriented ADC values without bias correction
+  int16_t  gyro[3];
+  int16_t  mag[3];
+  uint8_t  checksum;
+} imu_log_sample_t;
+
+
+uint8_t imu_log_checksum( const void *p_record, uint32_t length );
+
+
+// Finds the records in a byte stream of a capture, bytes between records are skipped
+class cIMULogReader
+{
+ public:
+  cIMULogReader();
+
+  void     reset( void );
+  uint8_t  feed( uint8_t data );      // type of the record completed by data, 0 if none
+  uint32_t getErrorCount( void );
+
+ public:
+  imu_log_header_t header;
+  imu_log_sample_t sample;
+
+ private:
+  uint8_t  buffer[sizeof(imu_log_header_t)];
+  uint32_t index;
+  uint32_t length;
+  uint32_t error_count;
+};
+
+#endif
@@ -14,10 +14,72 @@ bool cIMUDevice::begin( void )
     device_model = ICM20468;
     result = true;
   }
-  
+
+  if (result == true)
+  {
+    // The biases stored by the last calibration are used until a new one ends
+    if (cali.load(device_model) == false)
+    {
+      cali.start(IMU_CALI_GYRO);
+    }
+    set_zero();
+  }
+
   return result;
 }
 
+// Sensors subtract the biases of the calibration instead of their own
+void cIMUDevice::set_zero( void )
+{
+  cali.getGyroZero(gyroZero);
+  cali.getAccZero(accZero);
+
+  switch(device_model)
+  {
+    case MPU9250:
+      DEV1.gyro_set_zero(gyroZero);
+      DEV1.acc_set_zero(accZero);
+      break;
+    case ICM20468:
+      DEV2.gyro_set_zero(gyroZero);
+      DEV2.acc_set_zero(accZero);
+      break;
+    default : break;
+  }
+
+  // The filter waits only for the first bias, a new calibration keeps the last one meanwhile
+  calibratingG = (cali.pending() & ~cali.calibrated() & IMU_CALI_GYRO) ? 1 : 0;
+  calibratingA = (cali.pending() & ~cali.calibrated() & IMU_CALI_ACC) ? 1 : 0;
+}
+
+void cIMUDevice::cali_update( void )
+{
+  int32_t gyro[3];
+  int32_t acc[3];
+  uint8_t pending = cali.pending();
+
+  for (uint8_t axis = 0; axis < 3; axis++)
+  {
+    gyro[axis] = gyroADC[axis] + gyroZero[axis];
+    acc[axis]  = accADC[axis] + accZero[axis];
+
+    gyroUncal[axis] = gyro[axis];
+    accUncal[axis]  = acc[axis];
+  }
+
+  if (cali.update(gyro, acc) == true)
+  {
+    set_zero();
+
+    // Tracked drift is not stored, it would wear the flash. Neither are the biases
+    // of a robot that never stayed still, they are only used until the next boot.
+    if (pending != 0 && cali.pending() == 0 && cali.endedStill() == true)
+    {
+      cali.save(device_model);
+    }
+  }
+}
+
 void cIMUDevice::init( void )
 {
   switch(device_model)
@@ -32,82 +94,210 @@ void cIMUDevice::init( void )
   }
 }
 
-void cIMUDevice::gyro_init( void )
+void cIMUDevice::get_adc( void )
 {
   switch(device_model)
   {
     case MPU9250:
-      DEV1.gyro_init();
+      DEV1.get_adc();
+      memcpy(accRAW,DEV1.accRAW,3*sizeof(int16_t));
+      memcpy(accADC,DEV1.accADC,3*sizeof(int16_t));
+      memcpy(gyroRAW,DEV1.gyroRAW,3*sizeof(int16_t));
+      memcpy(gyroADC,DEV1.gyroADC,3*sizeof(int16_t));
+      memcpy(magRAW,DEV1.magRAW,3*sizeof(int16_t));
+      memcpy(magADC,DEV1.magADC,3*sizeof(int16_t));
+      tempRAW = DEV1.tempRAW;
       break;
     case ICM20468:
-      DEV2.gyro_init();
+      DEV2.get_adc();
+      memcpy(accRAW,DEV2.accRAW,3*sizeof(int16_t));
+      memcpy(accADC,DEV2.accADC,3*sizeof(int16_t));
+      memcpy(gyroRAW,DEV2.gyroRAW,3*sizeof(int16_t));
+      memcpy(gyroADC,DEV2.gyroADC,3*sizeof(int16_t));
+      memcpy(magRAW,DEV2.magRAW,3*sizeof(int16_t));
+      memcpy(magADC,DEV2.magADC,3*sizeof(int16_t));
+      tempRAW = DEV2.tempRAW;
+      break;
+    default : return;
+  }
+
+  cali_update();
+}
+
+uint32_t cIMUDevice::fifo_begin( uint32_t hz )
+{
+  uint32_t result = 0;
+
+  switch(device_model)
+  {
+    case MPU9250:
+      result = DEV1.fifo_begin(hz);
+      break;
+    case ICM20468:
+      result = DEV2.fifo_begin(hz);
       break;
     default : break;
   }
+
+  return result;
 }
 
-void cIMUDevice::gyro_get_adc( void )
+int32_t cIMUDevice::fifo_get_count( void )
 {
+  int32_t result = 0;
+
   switch(device_model)
   {
     case MPU9250:
-      DEV1.gyro_get_adc();
+      result = DEV1.fifo_get_count();
+      break;
+    case ICM20468:
+      result = DEV2.fifo_get_count();
+      break;
+    default : break;
+  }
+
+  return result;
+}
+
+void cIMUDevice::fifo_read( uint8_t *p_data, uint16_t length )
+{
+  switch(device_model)
+  {
+    case MPU9250:
+      DEV1.fifo_read(p_data, length);
+      break;
+    case ICM20468:
+      DEV2.fifo_read(p_data, length);
+      break;
+    default : break;
+  }
+}
+
+void cIMUDevice::fifo_get_adc( uint8_t *p_data )
+{
+  switch(device_model)
+  {
+    case MPU9250:
+      DEV1.fifo_get_adc(p_data);
+      memcpy(accRAW,DEV1.accRAW,3*sizeof(int16_t));
+      memcpy(accADC,DEV1.accADC,3*sizeof(int16_t));
       memcpy(gyroRAW,DEV1.gyroRAW,3*sizeof(int16_t));
       memcpy(gyroADC,DEV1.gyroADC,3*sizeof(int16_t));
       break;
     case ICM20468:
-      DEV2.gyro_get_adc();
+      DEV2.fifo_get_adc(p_data);
+      memcpy(accRAW,DEV2.accRAW,3*sizeof(int16_t));
+      memcpy(accADC,DEV2.accADC,3*sizeof(int16_t));
       memcpy(gyroRAW,DEV2.gyroRAW,3*sizeof(int16_t));
       memcpy(gyroADC,DEV2.gyroADC,3*sizeof(int16_t));
       break;
-    default : break;
+    default : return;
   }
+
+  cali_update();
 }
 
-void cIMUDevice::gyro_common()
+// The calibration does not see replayed samples, its window, tracking and pending
+// request would make the result depend on what ran before and it could store the
+// biases of the log as the ones of this sensor.
+void cIMUDevice::replay_adc( const int16_t *acc, const int16_t *gyro, const int16_t *mag )
+{
+  for (uint8_t axis = 0; axis < 3; axis++)
+  {
+    accRAW[axis]  = acc[axis];
+    accADC[axis]  = acc[axis] - accZero[axis];
+    gyroRAW[axis] = gyro[axis];
+    gyroADC[axis] = gyro[axis] - gyroZero[axis];
+    magRAW[axis]  = mag[axis];
+    magADC[axis]  = mag[axis];
+
+    gyroUncal[axis] = gyro[axis];
+    accUncal[axis]  = acc[axis];
+  }
+}
+
+// The biases of the log are used as they are for the whole replay
+void cIMUDevice::replay_zero( const int16_t *gyro_zero, const int16_t *acc_zero )
+{
+  for (uint8_t axis = 0; axis < 3; axis++)
+  {
+    gyroZero[axis] = gyro_zero[axis];
+    accZero[axis]  = acc_zero[axis];
+  }
+
+  calibratingG = 0;
+  calibratingA = 0;
+}
+
+// Back to the biases of the calibration
+void cIMUDevice::replay_end( void )
+{
+  set_zero();
+}
+
+// MPU9250 INT is push-pull active high, ICM20648 INT is open drain active low
+bool cIMUDevice::int_active_low( void )
+{
+  return device_model == ICM20468;
+}
+
+void cIMUDevice::gyro_init( void )
 {
   switch(device_model)
   {
     case MPU9250:
-      DEV1.gyro_common();
+      DEV1.gyro_init();
       break;
     case ICM20468:
-      DEV2.gyro_common();
+      DEV2.gyro_init();
       break;
     default : break;
   }
 }
 
-void cIMUDevice::gyro_cali_start()
+void cIMUDevice::gyro_get_adc( void )
 {
   switch(device_model)
   {
     case MPU9250:
-      DEV1.gyro_cali_start();
+      DEV1.gyro_get_adc();
+      memcpy(gyroRAW,DEV1.gyroRAW,3*sizeof(int16_t));
+      memcpy(gyroADC,DEV1.gyroADC,3*sizeof(int16_t));
       break;
     case ICM20468:
-      DEV2.gyro_cali_start();
+      DEV2.gyro_get_adc();
+      memcpy(gyroRAW,DEV2.gyroRAW,3*sizeof(int16_t));
+      memcpy(gyroADC,DEV2.gyroADC,3*sizeof(int16_t));
       break;
-    default : break; 
+    default : break;
   }
 }
 
-bool cIMUDevice::gyro_cali_get_done()
+void cIMUDevice::gyro_common()
 {
-  bool result = false;
-
   switch(device_model)
   {
     case MPU9250:
-      result = DEV1.gyro_cali_get_done();
+      DEV1.gyro_common();
       break;
     case ICM20468:
-      result = DEV2.gyro_cali_get_done();
+      DEV2.gyro_common();
       break;
     default : break;
   }
+}
 
-  return result;
+// Returns at once, the calibration ends with the next still window
+void cIMUDevice::gyro_cali_start()
+{
+  cali.start(IMU_CALI_GYRO);
+  set_zero();
+}
+
+bool cIMUDevice::gyro_cali_get_done()
+{
+  return (cali.pending() & IMU_CALI_GYRO) == 0;
 }
 
 void cIMUDevice::acc_init( void )
@@ -156,35 +346,16 @@ void cIMUDevice::acc_common( void )
   }
 }
 
+// Returns at once, the robot has to be level when it stays still
 void cIMUDevice::acc_cali_start()
 {
-  switch(device_model)
-  {
-    case MPU9250:
-      DEV1.acc_cali_start();
-      break;
-    case ICM20468:
-      DEV2.acc_cali_start();
-      break;
-    default : break;
-  }
+  cali.start(IMU_CALI_ACC);
+  set_zero();
 }
 
 bool cIMUDevice::acc_cali_get_done()
 {
-  bool result = false;
-
-  switch(device_model)
-  {
-    case MPU9250:
-    result = DEV1.acc_cali_get_done();
-    break;
-    case ICM20468:
-    result = DEV2.acc_cali_get_done();
-    break;
-    default : break;
-  }
-  return result;
+  return (cali.pending() & IMU_CALI_ACC) == 0;
 }
 
 void cIMUDevice::mag_init( void )
@@ -4,6 +4,7 @@
 
 #include "ICM20648.h"
 #include "MPU9250.h"
+#include "imu_calibration.h"
 
 
 class cIMUDevice
@@ -11,6 +12,12 @@ class cIMUDevice
  public:  
   bool begin( void );
   void init( void );
+  void get_adc( void );
+  uint32_t fifo_begin( uint32_t hz );
+  int32_t  fifo_get_count( void );
+  void fifo_read( uint8_t *p_data, uint16_t length );
+  void fifo_get_adc( uint8_t *p_data );
+  bool int_active_low( void );
   void gyro_init( void );
   void gyro_get_adc( void );
   void gyro_common();
@@ -27,6 +34,11 @@ class cIMUDevice
   void mag_cali_start();
   bool mag_cali_get_done();
 
+  // Samples and biases of a capture in place of the sensor
+  void replay_adc( const int16_t *acc, const int16_t *gyro, const int16_t *mag );
+  void replay_zero( const int16_t *gyro_zero, const int16_t *acc_zero );
+  void replay_end( void );
+
  public : 
   bool     bConnected;
   
@@ -42,6 +54,12 @@ class cIMUDevice
   int16_t  magRAW[3];
   int16_t  magZero[3];
 
+  int16_t  tempRAW;
+
+  // Oriented ADC values of the last sample before bias correction
+  int16_t  gyroUncal[3];
+  int16_t  accUncal[3];
+
   int16_t  gyroData[3];
   int16_t  accSmooth[3];
 
@@ -51,12 +69,18 @@ class cIMUDevice
 
   int16_t AK8963_ASA[3];
 
+  // Background gyro and acc calibration on the samples of get_adc() and fifo_get_adc()
+  cIMUCalibration cali;
+
  private:
   cMPU9250 DEV1;
   cICM20648 DEV2;
 
   uint8_t device_model;
 
+  void cali_update( void );
+  void set_zero( void );
+
   enum DeviceModel
   {
     MPU9250=1,
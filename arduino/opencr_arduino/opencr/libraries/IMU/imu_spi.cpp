@@ -49,17 +49,14 @@ int  imu_spi_writes(uint8_t slave_addr, uint8_t reg_addr, uint8_t length, uint8_
 
 int imu_spi_reads(uint8_t slave_addr, uint8_t reg_addr, uint8_t length, uint8_t *data)
 {
-  uint32_t i;
-  //uint8_t read_value;
-
 	UNUSED(slave_addr);
 
+  // Registers are read with one transfer, the sensor increments the address
+  memset( data, 0xFF, length );
+
   digitalWrite( BDPIN_SPI_CS_IMU, LOW);
   SPI_IMU.transfer( reg_addr | 0x80 );  // reg | 0x80 to denote read
-  for( i=0; i<length; i++ )
-  {
-    data[i] = SPI_IMU.transfer( 0xFF );
-  }
+  SPI_IMU.transfer( data, length );
   digitalWrite( BDPIN_SPI_CS_IMU, HIGH);
 	return 0;
 }
@@ -207,13 +207,13 @@ int OLLO::read(int devNum){ // general sensor reading method
 	}
 	switch(devNum){
 	case 1:
-		return (int)analogRead(PORT1_ADC);
+		return readADC(1);
 	case 2:
-		return (int)analogRead(PORT2_ADC);
+		return readADC(2);
 	case 3:
-		return (int)analogRead(PORT3_ADC);
+		return readADC(3);
 	case 4:
-		return (int)analogRead(PORT4_ADC);
+		return readADC(4);
 	default:
 		return 0;
 	}
@@ -237,13 +237,13 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 		if(device_index == IR_SENSOR){
 			digitalWrite(PORT1_SIG2, HIGH);
 			delayMicroseconds(15);
-			adcValue = analogRead(PORT1_ADC);
+			adcValue = readADC(1);
 			digitalWrite(PORT1_SIG2, LOW);
 			return adcValue;
 		}else if(device_index == MAGNETIC_SENSOR || device_index == TOUCH_SENSOR  || device_index == PIR_SENSOR){
 			return digitalRead(PORT1_ADC);
 		}else if(device_index == ULTRASONIC_SENSOR){
-			distance_value = (int)analogRead(PORT1_ADC);
+			distance_value = readADC(1);
 			dis_value = (((distance_value * 0.24)/4) - 3);
 			average_cnt++;
 			average_value+=dis_value;
@@ -253,7 +253,7 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 			}
 			  return average_value;
 		}else if(device_index == TEMPERATURE_SENSOR){
-			analogValue = analogRead(PORT1_ADC);
+			analogValue = readADC(1);
 			vvalue = (4095 - analogValue) * 10000 /analogValue;
 			for(scount = -20; scount < 140; scount++){
 				if(vvalue > gwTheRmistor[scount +20]){
@@ -264,20 +264,20 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 		else if(device_index == COLOR_SENSOR){
 			return this->detectColor(1);
 		}else{
-			return (int)analogRead(PORT1_ADC);
+			return readADC(1);
 		}
 		break;
 	case 2:
 		if(device_index == IR_SENSOR){
 			digitalWrite(PORT2_SIG2, HIGH);//digitalWrite(PORT1_SIG2, HIGH); -> digitalWrite(PORT2_SIG2, HIGH); 140324
 			delayMicroseconds(15);
-			adcValue = analogRead(PORT2_ADC);//adcValue = analogRead(PORT1_ADC); -> adcValue = analogRead(PORT2_ADC); 140324
+			adcValue = readADC(2);//adcValue = analogRead(PORT1_ADC); -> adcValue = analogRead(PORT2_ADC); 140324
 			digitalWrite(PORT2_SIG2, LOW);//digitalWrite(PORT1_SIG2, LOW); -> digitalWrite(PORT2_SIG2, LOW);
 			return adcValue;
 		}else if(device_index == MAGNETIC_SENSOR || device_index == TOUCH_SENSOR || device_index == PIR_SENSOR){
 			return digitalRead(PORT2_ADC);
 		}else if(device_index == ULTRASONIC_SENSOR){
-			distance_value = (int)analogRead(PORT2_ADC); //analogRead(PORT1_ADC); -> analogRead(PORT2_ADC); 140324
+			distance_value = readADC(2); //analogRead(PORT1_ADC); -> analogRead(PORT2_ADC); 140324
 			dis_value = (((distance_value * 0.24)/4) - 3);
 			average_cnt++;
 			average_value+=dis_value;
@@ -290,7 +290,7 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 			return this->detectColor(2);
 		}
 		else if(device_index == TEMPERATURE_SENSOR){
-			analogValue = analogRead(PORT2_ADC);
+			analogValue = readADC(2);
 			vvalue = (4095 - analogValue) * 10000 /analogValue;
 			for(scount = -20; scount < 140; scount++){
 				if(vvalue > gwTheRmistor[scount +20]){
@@ -299,20 +299,20 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 			}
 		}
 		else{
-			return (int)analogRead(PORT2_ADC);
+			return readADC(2);
 		}
 		break;
 	case 3:
 		if(device_index == IR_SENSOR){
 			digitalWrite(PORT3_SIG2, HIGH);////digitalWrite(PORT1_SIG2, HIGH); -> digitalWrite(PORT3_SIG2, HIGH); 140324
 			delayMicroseconds(15);
-			adcValue = analogRead(PORT3_ADC);//adcValue = analogRead(PORT1_ADC); -> adcValue = analogRead(PORT3_ADC); 140324
+			adcValue = readADC(3);//adcValue = analogRead(PORT1_ADC); -> adcValue = analogRead(PORT3_ADC); 140324
 			digitalWrite(PORT3_SIG2, LOW);//digitalWrite(PORT1_SIG2, LOW); -> digitalWrite(PORT3_SIG2, LOW);
 			return adcValue;
 		}else if(device_index == MAGNETIC_SENSOR || device_index == TOUCH_SENSOR || device_index == PIR_SENSOR){
 			return digitalRead(PORT3_ADC);
 		}else if(device_index == ULTRASONIC_SENSOR){
-			distance_value = (int)analogRead(PORT3_ADC); //analogRead(PORT1_ADC); -> analogRead(PORT3_ADC); 140324
+			distance_value = readADC(3); //analogRead(PORT1_ADC); -> analogRead(PORT3_ADC); 140324
 			dis_value = (((distance_value * 0.24)/4) - 3);
 			average_cnt++;
 			average_value+=dis_value;
@@ -322,7 +322,7 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 			}
 			  return average_value;
 		}else if(device_index == TEMPERATURE_SENSOR){
-			analogValue = analogRead(PORT3_ADC);
+			analogValue = readADC(3);
 			vvalue = (4095 - analogValue) * 10000 /analogValue;
 			for(scount = -20; scount < 140; scount++){
 				if(vvalue > gwTheRmistor[scount +20]){
@@ -332,20 +332,20 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 		}else if(device_index == COLOR_SENSOR){
 			return OLLO::detectColor(3);
 		}else{
-			return (int)analogRead(PORT3_ADC);
+			return readADC(3);
 		}
 		break;
 	case 4:
 		if(device_index == IR_SENSOR){
 			digitalWrite(PORT4_SIG2, HIGH); //digitalWrite(PORT1_SIG2, HIGH); -> digitalWrite(PORT4_SIG2, HIGH); 140324
 			delayMicroseconds(15);
-			adcValue = analogRead(PORT4_ADC); //adcValue = analogRead(PORT1_ADC); -> adcValue = analogRead(PORT4_ADC); 140324
+			adcValue = readADC(4); //adcValue = analogRead(PORT1_ADC); -> adcValue = analogRead(PORT4_ADC); 140324
 			digitalWrite(PORT4_SIG2, LOW);//digitalWrite(PORT1_SIG2, LOW); -> digitalWrite(PORT4_SIG2, LOW);
 			return adcValue;
 		}else if(device_index == MAGNETIC_SENSOR || device_index == TOUCH_SENSOR || device_index == PIR_SENSOR ){
 			return digitalRead(PORT4_ADC);
 		}else if(device_index == ULTRASONIC_SENSOR){
-			distance_value = (int)analogRead(PORT4_ADC); //analogRead(PORT1_ADC); -> analogRead(PORT4_ADC); 140324
+			distance_value = readADC(4); //analogRead(PORT1_ADC); -> analogRead(PORT4_ADC); 140324
 			dis_value = (((distance_value * 0.24)/4) - 3);
 			average_cnt++;
 			average_value+=dis_value;
@@ -355,7 +355,7 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 			}
 			  return average_value;
 		}else if(device_index == TEMPERATURE_SENSOR){
-			analogValue = analogRead(PORT4_ADC);// 2014-04-17 shin
+			analogValue = readADC(4);// 2014-04-17 shin
 			vvalue = (4095 - analogValue) * 10000 /analogValue;
 			for(scount = -20; scount < 140; scount++){
 				if(vvalue > gwTheRmistor[scount +20]){
@@ -365,7 +365,7 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 		}else if(device_index == COLOR_SENSOR){
 			return OLLO::detectColor(4);
 		}else{
-			return (int)analogRead(PORT4_ADC);
+			return readADC(4);
 		}
 		break;
 	default:
@@ -374,6 +374,35 @@ int OLLO::read(int devNum, OlloDeviceIndex device_index){ // IR SENSOR, Button,
 	return 0;
 }
 
+int OLLO::readADC(int devNum){ // analog value of a port through its filter
+	uint8_t pin;
+
+	switch(devNum){
+	case 1:
+		pin = PORT1_ADC;
+		break;
+	case 2:
+		pin = PORT2_ADC;
+		break;
+	case 3:
+		pin = PORT3_ADC;
+		break;
+	case 4:
+		pin = PORT4_ADC;
+		break;
+	default:
+		return 0;
+	}
+	return (int)lroundf(mFilter[devNum-1].apply((float)analogRead(pin)));
+}
+
+SignalFilter *OLLO::getFilter(int devNum){
+	if( devNum < 1 || devNum > 4 ){
+		return NULL;
+	}
+	return &mFilter[devNum-1];
+}
+
 int OLLO::read(int devNum, OlloDeviceIndex device_index, ColorIndex sub_index){ //COLOR SENSOR
 	//int adcValue = 0;
 	if( devNum == 0 ){
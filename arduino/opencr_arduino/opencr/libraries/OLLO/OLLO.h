@@ -8,6 +8,7 @@
 #ifndef OLLO_H_
 #define OLLO_H_
 #include <Arduino.h>
+#include <SignalFilter.h>
 
 
 
@@ -70,6 +71,8 @@ private:
 		//int color_chk();
 	void setColor(ColorIndex colorIndex);
 	int read(int devNum, OlloDeviceIndex device_index, ColorIndex sub_index);
+	SignalFilter mFilter[4];
+	int readADC(int devNum);
 public:
 	OLLO();
 	virtual ~OLLO();
@@ -81,6 +84,9 @@ public:
 	int read(int devNum);
 	int read(int devNum, OlloDeviceIndex device_index);
 
+	//ADC filter of a port, no filtering until one is set
+	SignalFilter *getFilter(int devNum);
+
 //	uint8_t isGreen(uint8_t port);
 //	uint8_t isWhite(uint8_t port);
 //	uint8_t isBlue(uint8_t port);
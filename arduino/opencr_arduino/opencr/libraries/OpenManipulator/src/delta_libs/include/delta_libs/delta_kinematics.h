@@ -37,10 +37,15 @@ namespace delta_kinematics
 class SolverUsingGeometry : public robotis_manipulator::Kinematics
 {
 private:
+  Eigen::Vector3d fk_position_;       // last forward kinematics solution (warm start)
+
   bool inverseKinematicsSolverUsingGeometry(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_value);
+  bool forwardKinematicsSolverUsingNewtonRaphson(Manipulator *manipulator);
+  void calcConstraint(std::vector<double> joint_angle, Eigen::Vector3d position,
+                      Eigen::Vector3d *constraint, Eigen::Matrix3d *position_jacobian, Eigen::Matrix3d *angle_jacobian);
 
 public:
-  SolverUsingGeometry() {}
+  SolverUsingGeometry();
   virtual ~SolverUsingGeometry() {}
 
   virtual void setOption(const void *arg);
@@ -21,17 +21,45 @@
 using namespace robotis_manipulator; 
 using namespace delta_kinematics;
 
+// Arm geometry of the inverse and forward kinematics (unit: m)
+#define BASE_RADIUS       0.055
+#define BASE_HEIGHT       0.17875
+#define UPPER_ARM_LENGTH  0.100
+#define LOWER_ARM_LENGTH  0.224
+#define PLATFORM_RADIUS   0.020
+
+#define FK_ITERATION      10
+#define FK_TOLERANCE      1E-18
+
 /*****************************************************************************
 ** Kinematics Solver 
 *****************************************************************************/
+SolverUsingGeometry::SolverUsingGeometry()
+{
+  fk_position_ = math::vector3(0.0, 0.0, 0.0);
+}
+
 void SolverUsingGeometry::setOption(const void *arg) {}
 
 Eigen::MatrixXd SolverUsingGeometry::jacobian(Manipulator *manipulator, Name tool_name)
 {
-  return Eigen::MatrixXd::Identity(6, manipulator->getDOF());
+  // Platform linear velocity over actuated joint velocity at the present pose (the platform does not rotate)
+  Eigen::Vector3d constraint;
+  Eigen::Matrix3d position_jacobian;
+  Eigen::Matrix3d angle_jacobian;
+
+  calcConstraint(manipulator->getAllActiveJointPosition(), manipulator->getComponentPositionFromWorld(tool_name),
+                 &constraint, &position_jacobian, &angle_jacobian);
+
+  Eigen::MatrixXd jacobian = Eigen::MatrixXd::Zero(6, manipulator->getDOF());
+  jacobian.block(0, 0, 3, 3) = -position_jacobian.partialPivLu().solve(angle_jacobian);
+  return jacobian;
 }
 
-void SolverUsingGeometry::solveForwardKinematics(Manipulator *manipulator) {}
+void SolverUsingGeometry::solveForwardKinematics(Manipulator *manipulator)
+{
+  forwardKinematicsSolverUsingNewtonRaphson(manipulator);
+}
 
 bool SolverUsingGeometry::solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue> *goal_joint_value)
 {
@@ -41,6 +69,65 @@ bool SolverUsingGeometry::solveInverseKinematics(Manipulator *manipulator, Name
 /*****************************************************************************
 ** Private
 *****************************************************************************/
+void SolverUsingGeometry::calcConstraint(std::vector<double> joint_angle, Eigen::Vector3d position,
+                                         Eigen::Vector3d *constraint, Eigen::Matrix3d *position_jacobian, Eigen::Matrix3d *angle_jacobian)
+{
+  // Each lower arm keeps its length : |G_i - E_i|^2 - LOWER_ARM_LENGTH^2 = 0
+  angle_jacobian->setZero();
+  for (int i=0; i<3; i++)
+  {
+    double arm_angle = PI*2.0/3.0*i;
+    double angle = joint_angle.at(i);
+
+    Eigen::Vector3d start(-BASE_RADIUS*cos(arm_angle), -BASE_RADIUS*sin(arm_angle), BASE_HEIGHT);
+    Eigen::Vector3d elbow = start + UPPER_ARM_LENGTH*math::vector3(-cos(arm_angle)*cos(angle),
+                                                                   -sin(arm_angle)*cos(angle),
+                                                                   sin(angle));
+    Eigen::Vector3d elbow_derivative = UPPER_ARM_LENGTH*math::vector3(cos(arm_angle)*sin(angle),
+                                                                      sin(arm_angle)*sin(angle),
+                                                                      cos(angle));
+    Eigen::Vector3d goal = position + math::vector3(-PLATFORM_RADIUS*cos(arm_angle), -PLATFORM_RADIUS*sin(arm_angle), 0.0);
+    Eigen::Vector3d arm = goal - elbow;
+
+    (*constraint)(i) = arm.squaredNorm() - LOWER_ARM_LENGTH*LOWER_ARM_LENGTH;
+    position_jacobian->row(i) = 2.0*arm.transpose();
+    (*angle_jacobian)(i, i) = -2.0*arm.dot(elbow_derivative);
+  }
+}
+
+bool SolverUsingGeometry::forwardKinematicsSolverUsingNewtonRaphson(Manipulator *manipulator)
+{
+  std::vector<double> joint_angle = manipulator->getAllActiveJointPosition();
+  if (joint_angle.size() < 3)
+    return false;
+
+  Eigen::Vector3d position = fk_position_;
+  Eigen::Vector3d constraint;
+  Eigen::Matrix3d position_jacobian;
+  Eigen::Matrix3d angle_jacobian;
+
+  bool solved = false;
+  for (int8_t count = 0; count < FK_ITERATION; count++)
+  {
+    calcConstraint(joint_angle, position, &constraint, &position_jacobian, &angle_jacobian);
+    if (constraint.squaredNorm() < FK_TOLERANCE)
+    {
+      solved = true;
+      break;
+    }
+    position -= position_jacobian.partialPivLu().solve(constraint);
+  }
+
+  // Keep the previous pose when the measured angles have no nearby solution
+  if (!solved)
+    return false;
+
+  fk_position_ = position;
+  manipulator->setComponentPositionFromWorld(manipulator->getAllToolComponentName().at(0), position);
+
+  return true;
+}
+
 bool SolverUsingGeometry::inverseKinematicsSolverUsingGeometry(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue> *goal_joint_value)
 {
   std::vector<JointValue> target_angle_vector;
@@ -49,7 +136,7 @@ bool SolverUsingGeometry::inverseKinematicsSolverUsingGeometry(Manipulator *mani
   double temp_angle2[3];
   JointValue target_angle[12];
   JointValue target_angle2[3];
-  const double link[3] = {0.100, 0.224, 0.020};
+  const double link[3] = {UPPER_ARM_LENGTH, LOWER_ARM_LENGTH, PLATFORM_RADIUS};
   double start_x[3], start_y[3], start_z[3];
   double goal_x[3], goal_y[3], goal_z[3];
   double diff_x[3], diff_y[3], diff_z[3];
@@ -62,9 +149,9 @@ bool SolverUsingGeometry::inverseKinematicsSolverUsingGeometry(Manipulator *mani
   // Start pose for each set of two joints
   for (int i=0; i<3; i++)
   {
-    start_x[i] = cos(PI*2.0/3.0*i)*(-0.055);
-    start_y[i] = sin(PI*2.0/3.0*i)*(-0.055);
-    start_z[i] = 0.17875;
+    start_x[i] = cos(PI*2.0/3.0*i)*(-BASE_RADIUS);
+    start_y[i] = sin(PI*2.0/3.0*i)*(-BASE_RADIUS);
+    start_z[i] = BASE_HEIGHT;
   }
   
   // Goal pose for each set of two joints
@@ -90,7 +177,8 @@ bool SolverUsingGeometry::inverseKinematicsSolverUsingGeometry(Manipulator *mani
     temp3[i] = sqrt(pow(link[1],2) - pow(temp2[i],2));
     temp4[i] = sqrt(pow(temp[i],2) + pow(diff_z[i],2));
     temp5[i] = pow(temp3[i],2) - pow(temp4[i],2) - pow(link[0],2);
-    target_angle[i].position = asin(temp5[i] / (2*temp4[i]*link[0])) - acos(-diff_z[i]/temp4[i]);    
+    // Signed, the lower arm can end inside of the upper arm joint
+    target_angle[i].position = asin(temp5[i] / (2*temp4[i]*link[0])) - atan2(temp[i], -diff_z[i]);
   }
 
   target_angle_vector.push_back(target_angle[0]);
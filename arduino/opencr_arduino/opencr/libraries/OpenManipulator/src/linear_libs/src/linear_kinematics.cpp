@@ -92,7 +92,7 @@ void SolverUsingGeometry::forwardKinematicsSolverUsingGeometry(Manipulator *mani
 
   pos_joint1 << wheel_radius * motor_angle[0], 0                            , 0;
   pos_joint2 << wheel_radius * motor_angle[0], wheel_radius * motor_angle[1], 0;
-  pos_joint3 << wheel_radius * motor_angle[0], wheel_radius * motor_angle[1], -0,01;
+  pos_joint3 << wheel_radius * motor_angle[0], wheel_radius * motor_angle[1], -0.01;
   pos_joint4 << wheel_radius * motor_angle[0], wheel_radius * motor_angle[1], wheel_radius * motor_angle[2];
 
   // Set my position and orientation 
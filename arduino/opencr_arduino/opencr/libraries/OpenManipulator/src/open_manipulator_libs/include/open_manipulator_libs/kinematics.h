@@ -93,6 +93,53 @@ public:
 };
 
 
+/*****************************************************************************
+** Kinematics Solver Using Chain Rule and Damped Least Squares Jacobian
+*****************************************************************************/
+typedef struct _DLSOption
+{
+  double initial_damping;   // starting Levenberg-Marquardt damping
+  double error_tolerance;   // weighted squared pose error regarded as solved
+  double step_tolerance;    // joint step norm regarded as converged
+  int8_t max_iteration;
+} DLSOption;
+
+typedef struct _IKSolveInfo
+{
+  bool success;
+  bool warm_started;
+  uint8_t iteration;
+  double residual;          // weighted squared pose error
+  double manipulability;    // sqrt(det(J^T J)) at the solution
+} IKSolveInfo;
+
+class SolverUsingCRAndDLSJacobian : public robotis_manipulator::Kinematics
+{
+private:
+  DLSOption option_;
+  IKSolveInfo solve_info_;
+  Eigen::VectorXd pose_weight_;
+  std::vector<double> warm_start_angle_;
+
+  void forwardSolverUsingChainRule(Manipulator *manipulator, Name component_name);
+  bool inverseSolverUsingDLSJacobian(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_value);
+  double calcWeightedError(Manipulator *manipulator, Name tool_name, Pose target_pose, Eigen::VectorXd *pose_changed);
+
+public:
+  SolverUsingCRAndDLSJacobian();
+  virtual ~SolverUsingCRAndDLSJacobian(){}
+
+  virtual void setOption(const void *arg);
+  virtual MatrixXd jacobian(Manipulator *manipulator, Name tool_name);
+  virtual void solveForwardKinematics(Manipulator *manipulator);
+  virtual bool solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_value);
+
+  void setWarmStart(std::vector<double> joint_angle);
+  void clearWarmStart();
+  IKSolveInfo getSolveInfo();
+};
+
+
 /*****************************************************************************
 ** Kinematics Solver Customized for OpenManipulator Chain
 *****************************************************************************/
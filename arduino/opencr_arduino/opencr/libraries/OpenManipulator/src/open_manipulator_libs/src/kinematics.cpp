@@ -713,6 +713,276 @@ bool SolverUsingCRAndSRPositionOnlyJacobian::inverseSolverUsingPositionOnlySRJac
 }
 
 
+/*****************************************************************************
+** Kinematics Solver Using Chain Rule and Damped Least Squares Jacobian
+*****************************************************************************/
+SolverUsingCRAndDLSJacobian::SolverUsingCRAndDLSJacobian()
+{
+  option_.initial_damping = 0.01;
+  option_.error_tolerance = 1E-12;
+  option_.step_tolerance = 1E-8;
+  option_.max_iteration = 20;
+
+  solve_info_.success = false;
+  solve_info_.warm_started = false;
+  solve_info_.iteration = 0;
+  solve_info_.residual = 0.0;
+  solve_info_.manipulability = 0.0;
+
+  //same weights as the sr solver
+  pose_weight_.resize(6);
+  pose_weight_ << 1 / 0.3, 1 / 0.3, 1 / 0.3, 1 / (2 * M_PI), 1 / (2 * M_PI), 1 / (2 * M_PI);
+}
+
+void SolverUsingCRAndDLSJacobian::setOption(const void *arg)
+{
+  if(arg != NULL)
+    option_ = *((DLSOption *)arg);
+}
+
+Eigen::MatrixXd SolverUsingCRAndDLSJacobian::jacobian(Manipulator *manipulator, Name tool_name)
+{
+  Eigen::MatrixXd jacobian = Eigen::MatrixXd::Identity(6, manipulator->getDOF());
+
+  Eigen::Vector3d joint_axis = Eigen::Vector3d::Zero(3);
+
+  Eigen::Vector3d position_changed = Eigen::Vector3d::Zero(3);
+  Eigen::Vector3d orientation_changed = Eigen::Vector3d::Zero(3);
+  Eigen::VectorXd pose_changed = Eigen::VectorXd::Zero(6);
+
+  //////////////////////////////////////////////////////////////////////////////////
+
+  int8_t index = 0;
+  Name my_name =  manipulator->getWorldChildName();
+
+  for (int8_t size = 0; size < manipulator->getDOF(); size++)
+  {
+    Name parent_name = manipulator->getComponentParentName(my_name);
+    if (parent_name == manipulator->getWorldName())
+    {
+      joint_axis = manipulator->getWorldOrientation() * manipulator->getAxis(my_name);
+    }
+    else
+    {
+      joint_axis = manipulator->getComponentOrientationFromWorld(parent_name) * manipulator->getAxis(my_name);
+    }
+
+    position_changed = math::skewSymmetricMatrix(joint_axis) *
+                       (manipulator->getComponentPositionFromWorld(tool_name) - manipulator->getComponentPositionFromWorld(my_name));
+    orientation_changed = joint_axis;
+
+    pose_changed << position_changed(0),
+        position_changed(1),
+        position_changed(2),
+        orientation_changed(0),
+        orientation_changed(1),
+        orientation_changed(2);
+
+    jacobian.col(index) = pose_changed;
+    index++;
+    my_name = manipulator->getComponentChildName(my_name).at(0); // Get Child name which has active joint
+  }
+  return jacobian;
+}
+
+void SolverUsingCRAndDLSJacobian::solveForwardKinematics(Manipulator *manipulator)
+{
+  forwardSolverUsingChainRule(manipulator, manipulator->getWorldChildName());
+}
+
+bool SolverUsingCRAndDLSJacobian::solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue> *goal_joint_value)
+{
+  return inverseSolverUsingDLSJacobian(manipulator, tool_name, target_pose, goal_joint_value);
+}
+
+void SolverUsingCRAndDLSJacobian::setWarmStart(std::vector<double> joint_angle)
+{
+  warm_start_angle_ = joint_angle;
+}
+
+void SolverUsingCRAndDLSJacobian::clearWarmStart()
+{
+  warm_start_angle_.clear();
+}
+
+IKSolveInfo SolverUsingCRAndDLSJacobian::getSolveInfo()
+{
+  return solve_info_;
+}
+
+
+//private
+void SolverUsingCRAndDLSJacobian::forwardSolverUsingChainRule(Manipulator *manipulator, Name component_name)
+{
+  Name my_name = component_name;
+  Name parent_name = manipulator->getComponentParentName(my_name);
+  int8_t number_of_child = manipulator->getComponentChildName(my_name).size();
+
+  Pose parent_pose_value;
+  Pose my_pose_value;
+
+  //Get Parent Pose
+  if (parent_name == manipulator->getWorldName())
+  {
+    parent_pose_value = manipulator->getWorldPose();
+  }
+  else
+  {
+    parent_pose_value = manipulator->getComponentPoseFromWorld(parent_name);
+  }
+
+  //position
+  my_pose_value.kinematic.position = parent_pose_value.kinematic.position
+                                   + (parent_pose_value.kinematic.orientation * manipulator->getComponentRelativePositionFromParent(my_name));
+  //orientation
+  my_pose_value.kinematic.orientation = parent_pose_value.kinematic.orientation * math::rodriguesRotationMatrix(manipulator->getAxis(my_name), manipulator->getJointPosition(my_name));
+  //linear velocity
+  my_pose_value.dynamic.linear.velocity = math::vector3(0.0, 0.0, 0.0);
+  //angular velocity
+  my_pose_value.dynamic.angular.velocity = math::vector3(0.0, 0.0, 0.0);
+  //linear acceleration
+  my_pose_value.dynamic.linear.acceleration = math::vector3(0.0, 0.0, 0.0);
+  //angular acceleration
+  my_pose_value.dynamic.angular.acceleration = math::vector3(0.0, 0.0, 0.0);
+
+  manipulator->setComponentPoseFromWorld(my_name, my_pose_value);
+
+  for (int8_t index = 0; index < number_of_child; index++)
+  {
+    Name child_name = manipulator->getComponentChildName(my_name).at(index);
+    forwardSolverUsingChainRule(manipulator, child_name);
+  }
+}
+
+double SolverUsingCRAndDLSJacobian::calcWeightedError(Manipulator *manipulator, Name tool_name, Pose target_pose, Eigen::VectorXd *pose_changed)
+{
+  *pose_changed = math::poseDifference(target_pose.kinematic.position, manipulator->getComponentPositionFromWorld(tool_name),
+                                       target_pose.kinematic.orientation, manipulator->getComponentOrientationFromWorld(tool_name));
+
+  return pose_changed->dot(pose_weight_.asDiagonal() * (*pose_changed));
+}
+
+bool SolverUsingCRAndDLSJacobian::inverseSolverUsingDLSJacobian(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue> *goal_joint_value)
+{
+  //manipulator
+  Manipulator _manipulator = *manipulator;
+  int8_t dof = _manipulator.getDOF();
+
+  //solver parameter
+  double lambda = option_.initial_damping;
+  const double lambda_min = 1E-9;
+  const double lambda_max = 1E9;
+
+  Eigen::MatrixXd jacobian = Eigen::MatrixXd::Identity(6, dof);
+  Eigen::MatrixXd jtj = Eigen::MatrixXd::Identity(dof, dof);
+  Eigen::VectorXd pose_changed = Eigen::VectorXd::Zero(6);
+  Eigen::VectorXd new_pose_changed = Eigen::VectorXd::Zero(6);
+  Eigen::VectorXd angle_changed = Eigen::VectorXd::Zero(dof);
+  Eigen::VectorXd gerr(dof);
+
+  std::vector<double> present_angle;
+  std::vector<double> set_angle(dof);
+
+  solve_info_.success = false;
+  solve_info_.warm_started = false;
+  solve_info_.iteration = 0;
+
+  ////////////////////////////initial guess//////////////////////////////
+  solveForwardKinematics(&_manipulator);
+  double pre_Ek = calcWeightedError(&_manipulator, tool_name, target_pose, &pose_changed);
+
+  // The previous solution is only used when it is closer to the target than the present pose
+  if(warm_start_angle_.size() == (uint32_t)dof)
+  {
+    present_angle = _manipulator.getAllActiveJointPosition();
+    _manipulator.setAllActiveJointPosition(warm_start_angle_);
+    solveForwardKinematics(&_manipulator);
+    double warm_Ek = calcWeightedError(&_manipulator, tool_name, target_pose, &new_pose_changed);
+
+    if(warm_Ek < pre_Ek)
+    {
+      pre_Ek = warm_Ek;
+      pose_changed = new_pose_changed;
+      solve_info_.warm_started = true;
+    }
+    else
+    {
+      _manipulator.setAllActiveJointPosition(present_angle);
+      solveForwardKinematics(&_manipulator);
+    }
+  }
+
+  //////////////////////////solving loop///////////////////////////////
+  present_angle = _manipulator.getAllActiveJointPosition();
+  jacobian = this->jacobian(&_manipulator, tool_name);
+
+  while (pre_Ek >= option_.error_tolerance && solve_info_.iteration < option_.max_iteration)
+  {
+    solve_info_.iteration++;
+
+    jtj = jacobian.transpose() * pose_weight_.asDiagonal() * jacobian;        //J^T*We*J
+    gerr = jacobian.transpose() * pose_weight_.asDiagonal() * pose_changed;  //J^T*We*dx
+
+    angle_changed = (jtj + lambda * Eigen::MatrixXd::Identity(dof, dof)).ldlt().solve(gerr);
+
+    for (int8_t index = 0; index < dof; index++)
+      set_angle.at(index) = present_angle.at(index) + angle_changed(index);
+    _manipulator.setAllActiveJointPosition(set_angle);
+    solveForwardKinematics(&_manipulator);
+
+    double new_Ek = calcWeightedError(&_manipulator, tool_name, target_pose, &new_pose_changed);
+
+    if (new_Ek < pre_Ek)
+    {
+      //accept the step and trust the Gauss-Newton direction more
+      pre_Ek = new_Ek;
+      pose_changed = new_pose_changed;
+      present_angle = set_angle;
+      jacobian = this->jacobian(&_manipulator, tool_name);
+      lambda = std::max(lambda * 0.1, lambda_min);
+
+      if (angle_changed.norm() < option_.step_tolerance)
+        break;
+    }
+    else
+    {
+      //reject the step and fall back towards gradient descent
+      _manipulator.setAllActiveJointPosition(present_angle);
+      solveForwardKinematics(&_manipulator);
+      lambda = lambda * 10.0;
+
+      if (lambda > lambda_max || angle_changed.norm() < option_.step_tolerance)
+        break;
+    }
+  }
+
+  solve_info_.residual = pre_Ek;
+  if (jacobian.rows() >= jacobian.cols())
+    solve_info_.manipulability = sqrt(fabs((jacobian.transpose() * jacobian).determinant()));
+  else
+    solve_info_.manipulability = sqrt(fabs((jacobian * jacobian.transpose()).determinant()));
+
+  if (pre_Ek < option_.error_tolerance)
+  {
+    solve_info_.success = true;
+    warm_start_angle_ = present_angle;
+
+    *goal_joint_value = _manipulator.getAllActiveJointValue();
+    for(int8_t index = 0; index < dof; index++)
+    {
+      goal_joint_value->at(index).velocity = 0.0;
+      goal_joint_value->at(index).acceleration = 0.0;
+      goal_joint_value->at(index).effort = 0.0;
+    }
+    return true;
+  }
+
+  log::error("[dls]fail to solve inverse kinematics (please change the solver)");
+  *goal_joint_value = {};
+  return false;
+}
+
+
 /*****************************************************************************
 ** Kinematics Solver Customized for OpenManipulator Chain
 *****************************************************************************/
@@ -99,6 +99,7 @@ void OpenManipulator::initOpenManipulator(bool using_actual_robot_state, STRING
   *****************************************************************************/
   kinematics_ = new kinematics::SolverCustomizedforOMChain();
   // kinematics_ = new kinematics::SolverUsingCRAndSRPositionOnlyJacobian();
+  // kinematics_ = new kinematics::SolverUsingCRAndDLSJacobian();
   addKinematics(kinematics_);
 
   /*****************************************************************************
@@ -37,10 +37,16 @@ namespace stewart_kinematics
 class SolverUsingGeometry : public robotis_manipulator::Kinematics
 {
 private:
+  Eigen::Vector3d fk_position_;       // last forward kinematics solution (warm start)
+  Eigen::Matrix3d fk_orientation_;
+
   bool inverseKinematicsSolverUsingGeometry(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_value);
+  bool forwardKinematicsSolverUsingNewtonRaphson(Manipulator *manipulator);
+  void calcConstraint(std::vector<double> joint_angle, Eigen::Vector3d position, Eigen::Matrix3d orientation,
+                      Eigen::VectorXd *constraint, Eigen::MatrixXd *pose_jacobian, Eigen::MatrixXd *angle_jacobian);
 
 public:
-  SolverUsingGeometry() {}
+  SolverUsingGeometry();
   virtual ~SolverUsingGeometry() {}
 
   virtual void setOption(const void *arg);
@@ -21,17 +21,48 @@
 using namespace robotis_manipulator;
 using namespace stewart_kinematics;
 
+// Leg geometry of the inverse and forward kinematics (unit: m, rad)
+#define BASE_RADIUS       0.0774
+#define BASE_HEIGHT      -0.1057
+#define BASE_ANGLE        0.436
+#define PLATFORM_RADIUS   0.07825
+#define PLATFORM_ANGLE    0.911
+#define CRANK_LENGTH      0.026
+#define ROD_LENGTH        0.1227
+
+#define FK_ITERATION      10
+#define FK_TOLERANCE      1E-18
+
 /*****************************************************************************
 ** Kinematics Solver 
 *****************************************************************************/
+SolverUsingGeometry::SolverUsingGeometry()
+{
+  fk_position_ = Eigen::Vector3d::Zero();
+  fk_orientation_ = Eigen::Matrix3d::Identity();
+}
+
 void SolverUsingGeometry::setOption(const void *arg) {}
 
 Eigen::MatrixXd SolverUsingGeometry::jacobian(Manipulator *manipulator, Name tool_name) 
 {
-  return Eigen::MatrixXd::Identity(6, manipulator->getDOF());
+  // Platform twist (linear, angular) over actuated joint velocity at the present pose
+  Eigen::VectorXd constraint(6);
+  Eigen::MatrixXd pose_jacobian(6, 6);
+  Eigen::MatrixXd angle_jacobian(6, 6);
+
+  calcConstraint(manipulator->getAllActiveJointPosition(),
+                 manipulator->getComponentPositionFromWorld(tool_name),
+                 manipulator->getComponentOrientationFromWorld(tool_name),
+                 &constraint, &pose_jacobian, &angle_jacobian);
+
+  return -pose_jacobian.partialPivLu().solve(angle_jacobian);
 }
 
-void SolverUsingGeometry::solveForwardKinematics(Manipulator *manipulator) {}
+void SolverUsingGeometry::solveForwardKinematics(Manipulator *manipulator)
+{
+  forwardKinematicsSolverUsingNewtonRaphson(manipulator);
+}
 
 bool SolverUsingGeometry::solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue> *goal_joint_value)
 {
@@ -41,6 +72,87 @@ bool SolverUsingGeometry::solveInverseKinematics(Manipulator *manipulator, Name
 /*****************************************************************************
 ** Private
 *****************************************************************************/
+void SolverUsingGeometry::calcConstraint(std::vector<double> joint_angle, Eigen::Vector3d position, Eigen::Matrix3d orientation,
+                                         Eigen::VectorXd *constraint, Eigen::MatrixXd *pose_jacobian, Eigen::MatrixXd *angle_jacobian)
+{
+  // Each rod keeps its length : |P_i - E_i|^2 - ROD_LENGTH^2 = 0
+  angle_jacobian->setZero();
+  for (int i=0; i<6; i++)
+  {
+    double sign = -pow(-1,i%2);
+    double base_angle = PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE;
+    double platform_angle = PI*2.0/3.0*(i/2) - pow(-1,i%2)*PLATFORM_ANGLE;
+    double crank_angle = -joint_angle.at(i);
+
+    Eigen::Vector3d start(-BASE_RADIUS*cos(base_angle), -BASE_RADIUS*sin(base_angle), BASE_HEIGHT);
+    Eigen::Vector3d elbow = start + CRANK_LENGTH*sign*math::vector3(-sin(base_angle)*cos(crank_angle),
+                                                                     cos(base_angle)*cos(crank_angle),
+                                                                     sin(crank_angle));
+    Eigen::Vector3d elbow_derivative = -CRANK_LENGTH*sign*math::vector3(sin(base_angle)*sin(crank_angle),
+                                                                         -cos(base_angle)*sin(crank_angle),
+                                                                         cos(crank_angle));
+    Eigen::Vector3d target = orientation * (position + math::vector3(-PLATFORM_RADIUS*cos(platform_angle),
+                                                                     -PLATFORM_RADIUS*sin(platform_angle),
+                                                                     0.0));
+    Eigen::Vector3d rod = target - elbow;
+
+    (*constraint)(i) = rod.squaredNorm() - ROD_LENGTH*ROD_LENGTH;
+
+    // d(target) = orientation * d(position) + omega x target
+    pose_jacobian->block(i, 0, 1, 3) = 2.0*rod.transpose()*orientation;
+    pose_jacobian->block(i, 3, 1, 3) = 2.0*target.cross(rod).transpose();
+    (*angle_jacobian)(i, i) = -2.0*rod.dot(elbow_derivative);
+  }
+}
+
+bool SolverUsingGeometry::forwardKinematicsSolverUsingNewtonRaphson(Manipulator *manipulator)
+{
+  std::vector<double> joint_angle = manipulator->getAllActiveJointPosition();
+  if (joint_angle.size() < 6)
+    return false;
+
+  Eigen::Vector3d position = fk_position_;
+  Eigen::Matrix3d orientation = fk_orientation_;
+
+  Eigen::VectorXd constraint(6);
+  Eigen::MatrixXd pose_jacobian(6, 6);
+  Eigen::MatrixXd angle_jacobian(6, 6);
+  Eigen::VectorXd pose_changed(6);
+
+  bool solved = false;
+  for (int8_t count = 0; count < FK_ITERATION; count++)
+  {
+    calcConstraint(joint_angle, position, orientation, &constraint, &pose_jacobian, &angle_jacobian);
+    if (constraint.squaredNorm() < FK_TOLERANCE)
+    {
+      solved = true;
+      break;
+    }
+
+    pose_changed = -pose_jacobian.partialPivLu().solve(constraint);
+    position += pose_changed.head(3);
+
+    Eigen::Vector3d omega = pose_changed.tail(3);
+    if (omega.norm() > 0.0)
+      orientation = math::rodriguesRotationMatrix(omega.normalized(), omega.norm()) * orientation;
+  }
+
+  // Keep the previous pose when the measured angles have no nearby solution
+  if (!solved)
+    return false;
+
+  fk_position_ = position;
+  fk_orientation_ = orientation;
+
+  Name tool_name = manipulator->getAllToolComponentName().at(0);
+  KinematicPose tool_pose;
+  tool_pose.position = position;
+  tool_pose.orientation = orientation;
+  manipulator->setComponentKinematicPoseFromWorld(tool_name, tool_pose);
+
+  return true;
+}
+
 bool SolverUsingGeometry::inverseKinematicsSolverUsingGeometry(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue> *goal_joint_value)
 {
   std::vector<JointValue> target_angle_vector;
@@ -48,7 +160,7 @@ bool SolverUsingGeometry::inverseKinematicsSolverUsingGeometry(Manipulator *mani
   double temp_angle[6];
   double temp_angle2[6];
   JointValue target_angle[21];
-  double link[2] = {0.026, 0.1227};
+  double link[2] = {CRANK_LENGTH, ROD_LENGTH};
   double start_x[6], start_y[6], start_z[6],
          temp_x[6], temp_y[6], temp_z[6],
          target_x[6], target_y[6], target_z[6],
@@ -67,16 +179,16 @@ bool SolverUsingGeometry::inverseKinematicsSolverUsingGeometry(Manipulator *mani
 
   // Start pose for each set of two joints
   for (int i=0; i<6; i++){
-    start_x[i] = cos(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436)*(-0.0774);  
-    start_y[i] = sin(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436)*(-0.0774);  
-    start_z[i] = -0.1057;
+    start_x[i] = cos(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE)*(-BASE_RADIUS);  
+    start_y[i] = sin(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE)*(-BASE_RADIUS);  
+    start_z[i] = BASE_HEIGHT;
   }  
 
   // Goal pose for each set of two joints
   for (int i=0; i<6; i++)
   {
-    temp_x[i] = target_pose.kinematic.position(0) + cos(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.911)*(-0.07825);
-    temp_y[i] = target_pose.kinematic.position(1) + sin(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.911)*(-0.07825);
+    temp_x[i] = target_pose.kinematic.position(0) + cos(PI*2.0/3.0*(i/2) - pow(-1,i%2)*PLATFORM_ANGLE)*(-PLATFORM_RADIUS);
+    temp_y[i] = target_pose.kinematic.position(1) + sin(PI*2.0/3.0*(i/2) - pow(-1,i%2)*PLATFORM_ANGLE)*(-PLATFORM_RADIUS);
     temp_z[i] = target_pose.kinematic.position(2);
   }
 
@@ -107,7 +219,7 @@ bool SolverUsingGeometry::inverseKinematicsSolverUsingGeometry(Manipulator *mani
 
   for (int i=0; i<6; i++)
   {
-    temp[i] = -diff_x[i]*sin(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436)+diff_y[i]*cos(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436);  
+    temp[i] = -diff_x[i]*sin(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE)+diff_y[i]*cos(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE);  
     temp2[i] = sqrt(temp[i]*temp[i] + diff_z[i]*diff_z[i]);
 
     temp_angle[i] = asin((link[1]*link[1] - link[0]*link[0] - diff_x[i]*diff_x[i] - diff_y[i]*diff_y[i] - diff_z[i]*diff_z[i])
@@ -133,15 +245,15 @@ bool SolverUsingGeometry::inverseKinematicsSolverUsingGeometry(Manipulator *mani
     // Adjust motor rotation direction
     target_angle[i].position = -target_angle[i].position;  
 
-    elbow_x[i] = start_x[i] - sin(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436)*link[0]*(-pow(-1,i%2))*cos(target_angle[i].position);
-    elbow_y[i] = start_y[i] + cos(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436)*link[0]*(-pow(-1,i%2))*cos(target_angle[i].position);
+    elbow_x[i] = start_x[i] - sin(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE)*link[0]*(-pow(-1,i%2))*cos(target_angle[i].position);
+    elbow_y[i] = start_y[i] + cos(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE)*link[0]*(-pow(-1,i%2))*cos(target_angle[i].position);
     elbow_z[i] = start_z[i] + link[0]*(-pow(-1,i%2))*sin(target_angle[i].position);
   
-    temp_elbow_x[i] = cos(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436))*elbow_x[i] - sin(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436))*elbow_y[i];
-    temp_elbow_y[i] = sin(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436))*elbow_x[i] + cos(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436))*elbow_y[i];
+    temp_elbow_x[i] = cos(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE))*elbow_x[i] - sin(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE))*elbow_y[i];
+    temp_elbow_y[i] = sin(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE))*elbow_x[i] + cos(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE))*elbow_y[i];
     temp_elbow_z[i] = elbow_z[i]; 
-    temp_target_x[i] = cos(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436))*target_x[i] - sin(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436))*target_y[i];
-    temp_target_y[i] = sin(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436))*target_x[i] + cos(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*0.436))*target_y[i];
+    temp_target_x[i] = cos(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE))*target_x[i] - sin(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE))*target_y[i];
+    temp_target_y[i] = sin(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE))*target_x[i] + cos(-(PI*2.0/3.0*(i/2) - pow(-1,i%2)*BASE_ANGLE))*target_y[i];
     temp_target_z[i] = target_z[i];
   }
   
@@ -181,6 +181,7 @@ public:
   void makeJointTrajectory(Name tool_name, Eigen::Vector3d goal_position, double move_time, std::vector<JointValue> present_joint_value = {});
   void makeJointTrajectory(Name tool_name, Eigen::Matrix3d goal_orientation, double move_time, std::vector<JointValue> present_joint_value = {});
   void makeJointTrajectory(Name tool_name, KinematicPose goal_pose, double move_time, std::vector<JointValue> present_joint_value = {});
+  bool makeBlendedJointTrajectory(std::vector<std::vector<double> > goal_joint_position_list, std::vector<double> max_velocity, std::vector<double> max_acceleration, std::vector<JointValue> present_joint_value = {});
 
   void makeTaskTrajectoryFromPresentPose(Name tool_name, Eigen::Vector3d position_meter, double move_time, std::vector<JointValue> present_joint_value = {});
   void makeTaskTrajectoryFromPresentPose(Name tool_name, Eigen::Matrix3d orientation_meter, double move_time, std::vector<JointValue> present_joint_value = {});
@@ -193,6 +194,9 @@ public:
   void makeCustomTrajectory(Name trajectory_name, Name tool_name, const void *arg, double move_time, std::vector<JointValue> present_joint_value = {});
   void makeCustomTrajectory(Name trajectory_name, const void *arg, double move_time, std::vector<JointValue> present_joint_value = {});
 
+  bool compileCustomTrajectory(Name trajectory_name, Name tool_name, const void *arg, double move_time, CompiledJointTrajectory *compiled_trajectory, double sample_time = 0.020, std::vector<JointValue> start_joint_value = {});
+  bool makeCompiledTrajectory(CompiledJointTrajectory *compiled_trajectory, std::vector<JointValue> present_joint_value = {});
+
   void sleepTrajectory(double wait_time, std::vector<JointValue> present_joint_value = {});
 
   void makeToolTrajectory(Name tool_name, double tool_goal_position);
@@ -95,7 +95,9 @@ typedef enum _TrajectoryType
   JOINT_TRAJECTORY,
   TASK_TRAJECTORY,
   CUSTOM_JOINT_TRAJECTORY,
-  CUSTOM_TASK_TRAJECTORY
+  CUSTOM_TASK_TRAJECTORY,
+  BLENDED_JOINT_TRAJECTORY,
+  COMPILED_JOINT_TRAJECTORY
 } TrajectoryType;
 
 typedef struct _Point
@@ -21,6 +21,7 @@
 
 #include <math.h>
 #include <vector>
+#include <algorithm>
 
 #include "robotis_manipulator_manager.h"
 
@@ -92,6 +93,88 @@ public:
   TaskWaypoint getTaskWaypoint(double tick);
 };
 
+/*****************************************************************************
+** Blended Joint Trajectory
+**  Linear segments between a list of joint way points, joined by parabolic
+**  blends. The blends cut the corners: the joints start at the first way
+**  point and stop at the last one, but only pass near the ones between.
+**  Segment times are scaled from the velocity and acceleration limits of
+**  each joint once, and the result is streamed with getJointWaypoint().
+*****************************************************************************/
+typedef struct _BlendSegment
+{
+  double start_time;
+  double position;
+  double velocity;
+  double acceleration;
+} BlendSegment;
+
+class BlendedJointTrajectory
+{
+private:
+  uint8_t joint_size_;
+  double move_time_;
+  std::vector<double> way_point_time_;
+  std::vector<std::vector<BlendSegment> > segment_;
+  std::vector<uint16_t> segment_cursor_;
+
+  bool calcBlendTime(std::vector<double> position,
+                     std::vector<double> duration,
+                     double max_velocity,
+                     double max_acceleration,
+                     std::vector<double> *velocity,
+                     std::vector<double> *blend_time,
+                     std::vector<bool> *stretch_segment);
+
+public:
+  BlendedJointTrajectory();
+  virtual ~BlendedJointTrajectory();
+
+  bool makeJointTrajectory(std::vector<JointWaypoint> way_point_list,
+                           std::vector<double> max_velocity,
+                           std::vector<double> max_acceleration);
+  double getMoveTime();
+  std::vector<double> getWaypointTime();
+  JointWaypoint getJointWaypoint(double tick);
+};
+
+/*****************************************************************************
+** Compiled Joint Trajectory
+**  A custom task trajectory sampled and solved by inverse kinematics ahead of
+**  time. Joint limits and singularities are checked while compiling, and the
+**  joint positions are stored as float samples played back by cubic Hermite
+**  interpolation.
+*****************************************************************************/
+class CompiledJointTrajectory
+{
+private:
+  uint8_t joint_size_;
+  uint32_t sample_size_;
+  double sample_time_;
+  double move_time_;
+  double min_manipulability_;
+  std::vector<float> position_;   // [sample * joint_size_ + joint]
+
+  double calcManipulability(Eigen::MatrixXd jacobian);
+
+public:
+  CompiledJointTrajectory();
+  virtual ~CompiledJointTrajectory();
+
+  bool compileTaskTrajectory(Manipulator manipulator,
+                             Kinematics *kinematics,
+                             Name tool_name,
+                             CustomTaskTrajectory *task_trajectory,
+                             const void *arg,
+                             double move_time,
+                             double sample_time);
+  void setMinManipulability(double min_manipulability);
+  double getMoveTime();
+  uint32_t getSampleSize();
+  JointWaypoint getStartJointWaypoint();
+  JointWaypoint getJointWaypoint(double tick);
+};
+
 
 /*****************************************************************************
 ** Trajectory Class
@@ -105,6 +188,8 @@ private:
 
   JointTrajectory joint_;
   TaskTrajectory task_;
+  BlendedJointTrajectory blended_joint_;
+  CompiledJointTrajectory compiled_joint_;
   std::map<Name, CustomJointTrajectory *> cus_joint_;
   std::map<Name, CustomTaskTrajectory *> cus_task_;
 
@@ -130,6 +215,8 @@ public:
   // Get Trajectory
   JointTrajectory getJointTrajectory();
   TaskTrajectory getTaskTrajectory();
+  BlendedJointTrajectory* getBlendedJointTrajectory();
+  CompiledJointTrajectory* getCompiledJointTrajectory();
   CustomJointTrajectory* getCustomJointTrajectory(Name name);
   CustomTaskTrajectory* getCustomTaskTrajectory(Name name);
 
@@ -159,6 +246,9 @@ public:
   bool checkTrajectoryType(TrajectoryType trajectory_type);
   void makeJointTrajectory(JointWaypoint start_way_point, JointWaypoint goal_way_point);
   void makeTaskTrajectory(TaskWaypoint start_way_point, TaskWaypoint goal_way_point);
+  bool makeBlendedJointTrajectory(std::vector<JointWaypoint> way_point_list, std::vector<double> max_velocity, std::vector<double> max_acceleration);
+  bool compileCustomTrajectory(Name trajectory_name, Name tool_name, Kinematics *kinematics, JointWaypoint start_way_point, const void *arg, double move_time, double sample_time, CompiledJointTrajectory *compiled_trajectory);
+  void makeCompiledTrajectory(CompiledJointTrajectory *compiled_trajectory);
   void makeCustomTrajectory(Name trajectory_name, JointWaypoint start_way_point, const void *arg);
   void makeCustomTrajectory(Name trajectory_name, TaskWaypoint start_way_point, const void *arg);
 
@@ -1048,6 +1048,56 @@ void RobotisManipulator::makeJointTrajectory(Name tool_name, KinematicPose goal_
     log::error("[JOINT_TRAJECTORY] Fail to solve IK");
 }
 
+bool RobotisManipulator::makeBlendedJointTrajectory(std::vector<std::vector<double> > goal_joint_position_list, std::vector<double> max_velocity, std::vector<double> max_acceleration, std::vector<JointValue> present_joint_value)
+{
+  // The motion in progress and its trajectory type are only touched once the new waypoints are valid
+  std::vector<JointWaypoint> way_point_list;
+  for(uint32_t list_index = 0; list_index < goal_joint_position_list.size(); list_index++)
+  {
+    JointValue goal_way_point_temp;
+    JointWaypoint goal_way_point;
+    for (uint8_t index = 0; index < goal_joint_position_list.at(list_index).size(); index++)
+    {
+      goal_way_point_temp.position = goal_joint_position_list.at(list_index).at(index);
+      goal_way_point_temp.velocity = 0.0;
+      goal_way_point_temp.acceleration = 0.0;
+      goal_way_point_temp.effort = 0.0;
+
+      goal_way_point.push_back(goal_way_point_temp);
+    }
+    way_point_list.push_back(goal_way_point);
+  }
+
+  for(uint32_t list_index = 0; list_index < way_point_list.size(); list_index++)
+  {
+    if(!checkJointLimit(trajectory_.getManipulator()->getAllActiveJointComponentName(), way_point_list.at(list_index)))
+      return false;
+  }
+
+  if(getMovingState())
+  {
+    moving_state_=false;
+    while(!step_moving_state_) ;
+  }
+
+  // Starts where the stopped motion left the joints
+  if(present_joint_value.size() != 0)
+  {
+    trajectory_.setPresentJointWaypoint(present_joint_value);
+    trajectory_.updatePresentWaypoint(kinematics_);
+  }
+  way_point_list.insert(way_point_list.begin(), trajectory_.removeWaypointDynamicData(trajectory_.getPresentJointWaypoint()));
+
+  if(!trajectory_.makeBlendedJointTrajectory(way_point_list, max_velocity, max_acceleration))
+  {
+    log::error("[BLENDED_JOINT_TRAJECTORY] Fail to make trajectory");
+    return false;
+  }
+  trajectory_.setTrajectoryType(BLENDED_JOINT_TRAJECTORY);
+  startMoving();
+  return true;
+}
+
 void RobotisManipulator::makeTaskTrajectoryFromPresentPose(Name tool_name, Eigen::Vector3d position_meter, double move_time, std::vector<JointValue> present_joint_value)
 {
   if(present_joint_value.size() != 0)
@@ -1200,6 +1250,60 @@ void RobotisManipulator::makeCustomTrajectory(Name trajectory_name, const void *
   startMoving();
 }
 
+bool RobotisManipulator::compileCustomTrajectory(Name trajectory_name, Name tool_name, const void *arg, double move_time, CompiledJointTrajectory *compiled_trajectory, double sample_time, std::vector<JointValue> start_joint_value)
+{
+  // Compiling re-initializes the custom trajectory, so it must not be the one being played
+  if(getMovingState() && trajectory_.checkTrajectoryType(CUSTOM_TASK_TRAJECTORY) && trajectory_.getPresentCustomTrajectoryName() == trajectory_name)
+  {
+    log::error("[compileCustomTrajectory] The custom trajectory is in use.");
+    return false;
+  }
+
+  if(start_joint_value.size() == 0)
+    start_joint_value = trajectory_.getPresentJointWaypoint();
+
+  return trajectory_.compileCustomTrajectory(trajectory_name, tool_name, kinematics_, trajectory_.removeWaypointDynamicData(start_joint_value),
+                                             arg, move_time, sample_time, compiled_trajectory);
+}
+
+bool RobotisManipulator::makeCompiledTrajectory(CompiledJointTrajectory *compiled_trajectory, std::vector<JointValue> present_joint_value)
+{
+  const double start_tolerance = 0.05;
+
+  if(compiled_trajectory->getSampleSize() == 0)
+  {
+    log::error("[COMPILED_JOINT_TRAJECTORY] Trajectory is not compiled");
+    return false;
+  }
+
+  if(present_joint_value.size() != 0)
+  {
+    trajectory_.setPresentJointWaypoint(present_joint_value);
+    trajectory_.updatePresentWaypoint(kinematics_);
+  }
+
+  JointWaypoint present_way_point = trajectory_.getPresentJointWaypoint();
+  JointWaypoint start_way_point = compiled_trajectory->getStartJointWaypoint();
+  for(uint8_t index = 0; index < start_way_point.size(); index++)
+  {
+    if(fabs(present_way_point.at(index).position - start_way_point.at(index).position) > start_tolerance)
+    {
+      log::error("[COMPILED_JOINT_TRAJECTORY] Present pose is not the compiled start pose");
+      return false;
+    }
+  }
+
+  if(getMovingState())
+  {
+    moving_state_=false;
+    while(!step_moving_state_) ;
+  }
+  trajectory_.setTrajectoryType(COMPILED_JOINT_TRAJECTORY);
+  trajectory_.makeCompiledTrajectory(compiled_trajectory);
+  startMoving();
+  return true;
+}
+
 void RobotisManipulator::sleepTrajectory(double wait_time, std::vector<JointValue> present_joint_value)
 {
   trajectory_.setTrajectoryType(JOINT_TRAJECTORY);
@@ -1261,6 +1365,35 @@ JointWaypoint RobotisManipulator::getTrajectoryJointValue(double tick_time)
   }
   /////////////////////////////////////////////////////////////////
   ///
+  ////////////////////Blended Joint Trajectory/////////////////////
+  else if(trajectory_.checkTrajectoryType(BLENDED_JOINT_TRAJECTORY))
+  {
+    joint_way_point_value = trajectory_.getBlendedJointTrajectory()->getJointWaypoint(tick_time);
+
+    if(!checkJointLimit(trajectory_.getManipulator()->getAllActiveJointComponentName(), joint_way_point_value))
+    {
+      joint_way_point_value = trajectory_.removeWaypointDynamicData(trajectory_.getPresentJointWaypoint());
+      moving_state_ = false;
+    }
+
+    // Set present joint task value to trajectory manipulator
+    trajectory_.setPresentJointWaypoint(joint_way_point_value);
+    trajectory_.updatePresentWaypoint(kinematics_);
+  }
+  /////////////////////////////////////////////////////////////////
+  ///
+  ////////////////////Compiled Joint Trajectory////////////////////
+  else if(trajectory_.checkTrajectoryType(COMPILED_JOINT_TRAJECTORY))
+  {
+    // Limits were checked while compiling
+    joint_way_point_value = trajectory_.getCompiledJointTrajectory()->getJointWaypoint(tick_time);
+
+    // Set present joint task value to trajectory manipulator
+    trajectory_.setPresentJointWaypoint(joint_way_point_value);
+    trajectory_.updatePresentWaypoint(kinematics_);
+  }
+  /////////////////////////////////////////////////////////////////
+  ///
   /////////////////////////Task Trajectory/////////////////////////
   else if(trajectory_.checkTrajectoryType(TASK_TRAJECTORY))
   {
@@ -263,6 +263,423 @@ Eigen::MatrixXd TaskTrajectory::getMinimumJerkCoefficient()
 }
 
 
+//-------------------- Blended joint trajectory --------------------//
+
+BlendedJointTrajectory::BlendedJointTrajectory()
+: joint_size_(0),
+  move_time_(0.0)
+{}
+
+BlendedJointTrajectory::~BlendedJointTrajectory() {}
+
+bool BlendedJointTrajectory::calcBlendTime(std::vector<double> position,
+                                           std::vector<double> duration,
+                                           double max_velocity,
+                                           double max_acceleration,
+                                           std::vector<double> *velocity,
+                                           std::vector<double> *blend_time,
+                                           std::vector<bool> *stretch_segment)
+{
+  // velocity : line 0 (start, at rest) ... line n (goal, at rest)
+  // blend_time : one parabolic blend per way point
+  uint16_t point_size = position.size();
+  uint16_t segment_size = point_size - 1;
+  bool feasible = true;
+
+  velocity->assign(point_size + 1, 0.0);
+  blend_time->assign(point_size, 0.0);
+
+  if(segment_size == 1)
+  {
+    double distance = position.at(1) - position.at(0);
+    if(distance != 0.0)
+    {
+      double discriminant = pow(duration.at(0), 2) - 4.0 * fabs(distance) / max_acceleration;
+      if(discriminant < 0.0)
+      {
+        stretch_segment->at(0) = true;
+        return false;
+      }
+      blend_time->at(0) = (duration.at(0) - sqrt(discriminant)) / 2.0;
+      blend_time->at(1) = blend_time->at(0);
+      velocity->at(1) = distance / (duration.at(0) - blend_time->at(0));
+    }
+  }
+  else
+  {
+    // first segment starts from rest
+    double distance = position.at(1) - position.at(0);
+    if(distance != 0.0)
+    {
+      double discriminant = pow(duration.at(0), 2) - 2.0 * fabs(distance) / max_acceleration;
+      if(discriminant < 0.0)
+      {
+        stretch_segment->at(0) = true;
+        return false;
+      }
+      blend_time->at(0) = duration.at(0) - sqrt(discriminant);
+      velocity->at(1) = distance / (duration.at(0) - blend_time->at(0) / 2.0);
+    }
+
+    // last segment ends at rest
+    distance = position.at(segment_size) - position.at(segment_size - 1);
+    if(distance != 0.0)
+    {
+      double discriminant = pow(duration.at(segment_size - 1), 2) - 2.0 * fabs(distance) / max_acceleration;
+      if(discriminant < 0.0)
+      {
+        stretch_segment->at(segment_size - 1) = true;
+        return false;
+      }
+      blend_time->at(segment_size) = duration.at(segment_size - 1) - sqrt(discriminant);
+      velocity->at(segment_size) = distance / (duration.at(segment_size - 1) - blend_time->at(segment_size) / 2.0);
+    }
+
+    // interior segments and blends
+    for(uint16_t index = 2; index < segment_size; index++)
+      velocity->at(index) = (position.at(index) - position.at(index - 1)) / duration.at(index - 1);
+
+    for(uint16_t index = 1; index < segment_size; index++)
+      blend_time->at(index) = fabs(velocity->at(index + 1) - velocity->at(index)) / max_acceleration;
+  }
+
+  for(uint16_t index = 0; index < segment_size; index++)
+  {
+    double linear_time = duration.at(index);
+    linear_time -= (index == 0) ? blend_time->at(index) : blend_time->at(index) / 2.0;
+    linear_time -= (index == segment_size - 1) ? blend_time->at(index + 1) : blend_time->at(index + 1) / 2.0;
+
+    if(linear_time < -1e-9 || fabs(velocity->at(index + 1)) > max_velocity * (1.0 + 1e-6))
+    {
+      stretch_segment->at(index) = true;
+      feasible = false;
+    }
+  }
+  return feasible;
+}
+
+bool BlendedJointTrajectory::makeJointTrajectory(std::vector<JointWaypoint> way_point_list,
+                                                 std::vector<double> max_velocity,
+                                                 std::vector<double> max_acceleration)
+{
+  const double minimum_segment_time = 0.001;
+  const uint8_t maximum_stretch_count = 100;
+
+  if(way_point_list.size() < 2)
+  {
+    log::error("[BlendedJointTrajectory] At least two way points are required.");
+    return false;
+  }
+
+  joint_size_ = way_point_list.at(0).size();
+  if(max_velocity.size() != joint_size_ || max_acceleration.size() != joint_size_)
+  {
+    log::error("[BlendedJointTrajectory] Limit size does not match the joint size.");
+    return false;
+  }
+  for(uint8_t joint = 0; joint < joint_size_; joint++)
+  {
+    if(max_velocity.at(joint) <= 0.0 || max_acceleration.at(joint) <= 0.0)
+    {
+      log::error("[BlendedJointTrajectory] Limits must be positive.");
+      return false;
+    }
+  }
+  for(uint16_t index = 0; index < way_point_list.size(); index++)
+  {
+    if(way_point_list.at(index).size() != joint_size_)
+    {
+      log::error("[BlendedJointTrajectory] Way point size does not match the joint size.");
+      return false;
+    }
+  }
+
+  uint16_t point_size = way_point_list.size();
+  uint16_t segment_size = point_size - 1;
+
+  std::vector<std::vector<double> > position(joint_size_, std::vector<double>(point_size));
+  for(uint8_t joint = 0; joint < joint_size_; joint++)
+    for(uint16_t index = 0; index < point_size; index++)
+      position.at(joint).at(index) = way_point_list.at(index).at(joint).position;
+
+  // Minimum segment time of the slowest joint (cruise at the velocity limit or bang-bang)
+  std::vector<double> duration(segment_size, minimum_segment_time);
+  for(uint16_t index = 0; index < segment_size; index++)
+  {
+    for(uint8_t joint = 0; joint < joint_size_; joint++)
+    {
+      double distance = fabs(position.at(joint).at(index + 1) - position.at(joint).at(index));
+      duration.at(index) = std::max(duration.at(index), distance / max_velocity.at(joint));
+      duration.at(index) = std::max(duration.at(index), 2.0 * sqrt(distance / max_acceleration.at(joint)));
+    }
+  }
+
+  // Stretch the segments until every blend fits between its neighbours
+  std::vector<std::vector<double> > velocity(joint_size_);
+  std::vector<std::vector<double> > blend_time(joint_size_);
+  std::vector<bool> stretch_segment(segment_size);
+  bool feasible = false;
+  for(uint8_t count = 0; count < maximum_stretch_count && !feasible; count++)
+  {
+    feasible = true;
+    stretch_segment.assign(segment_size, false);
+    for(uint8_t joint = 0; joint < joint_size_; joint++)
+    {
+      if(!calcBlendTime(position.at(joint), duration, max_velocity.at(joint), max_acceleration.at(joint),
+                        &velocity.at(joint), &blend_time.at(joint), &stretch_segment))
+        feasible = false;
+    }
+    for(uint16_t index = 0; index < segment_size; index++)
+      if(stretch_segment.at(index)) duration.at(index) *= 1.1;
+  }
+  if(!feasible)
+  {
+    log::error("[BlendedJointTrajectory] Fail to fit blends within the limits.");
+    return false;
+  }
+
+  way_point_time_.assign(point_size, 0.0);
+  for(uint16_t index = 0; index < segment_size; index++)
+    way_point_time_.at(index + 1) = way_point_time_.at(index) + duration.at(index);
+  move_time_ = way_point_time_.at(segment_size);
+
+  // Convert lines and blends of each joint into time ordered polynomial segments
+  segment_.assign(joint_size_, std::vector<BlendSegment>());
+  segment_cursor_.assign(joint_size_, 0);
+  for(uint8_t joint = 0; joint < joint_size_; joint++)
+  {
+    std::vector<double> anchor_time(point_size + 1);
+    std::vector<double> anchor_position(point_size + 1);
+    anchor_time.at(0) = 0.0;
+    anchor_position.at(0) = position.at(joint).at(0);
+    for(uint16_t line = 1; line <= segment_size; line++)
+    {
+      if(segment_size == 1)
+      {
+        // single segment is symmetric about its midpoint
+        anchor_time.at(line) = move_time_ / 2.0;
+        anchor_position.at(line) = (position.at(joint).at(0) + position.at(joint).at(1)) / 2.0;
+      }
+      else
+      {
+        // the first line passes its end point, the last line its start point
+        uint16_t anchor = (line == segment_size) ? line - 1 : line;
+        anchor_time.at(line) = way_point_time_.at(anchor);
+        anchor_position.at(line) = position.at(joint).at(anchor);
+      }
+    }
+    anchor_time.at(point_size) = move_time_;
+    anchor_position.at(point_size) = position.at(joint).at(segment_size);
+
+    for(uint16_t index = 0; index < point_size; index++)
+    {
+      double blend = blend_time.at(joint).at(index);
+      double center = way_point_time_.at(index);
+      if(index == 0) center = blend / 2.0;
+      else if(index == segment_size) center = move_time_ - blend / 2.0;
+
+      BlendSegment piece;
+      if(blend > 0.0)
+      {
+        piece.start_time = center - blend / 2.0;
+        piece.position = anchor_position.at(index) + velocity.at(joint).at(index) * (piece.start_time - anchor_time.at(index));
+        piece.velocity = velocity.at(joint).at(index);
+        piece.acceleration = (velocity.at(joint).at(index + 1) - velocity.at(joint).at(index)) / blend;
+        segment_.at(joint).push_back(piece);
+      }
+      piece.start_time = center + blend / 2.0;
+      piece.position = anchor_position.at(index + 1) + velocity.at(joint).at(index + 1) * (piece.start_time - anchor_time.at(index + 1));
+      piece.velocity = velocity.at(joint).at(index + 1);
+      piece.acceleration = 0.0;
+      segment_.at(joint).push_back(piece);
+    }
+  }
+  return true;
+}
+
+double BlendedJointTrajectory::getMoveTime()
+{
+  return move_time_;
+}
+
+std::vector<double> BlendedJointTrajectory::getWaypointTime()
+{
+  return way_point_time_;
+}
+
+JointWaypoint BlendedJointTrajectory::getJointWaypoint(double tick)
+{
+  JointWaypoint joint_way_point;
+  for (uint8_t index = 0; index < joint_size_; index++)
+  {
+    std::vector<BlendSegment> &piece = segment_.at(index);
+    uint16_t &cursor = segment_cursor_.at(index);
+
+    // Streaming ticks only move forward, so the cursor is usually already in place
+    if(tick < piece.at(cursor).start_time) cursor = 0;
+    while(cursor + 1 < piece.size() && piece.at(cursor + 1).start_time <= tick) cursor++;
+
+    double dt = tick - piece.at(cursor).start_time;
+    if(dt < 0.0) dt = 0.0;
+
+    JointValue single_joint_way_point;
+    single_joint_way_point.position = piece.at(cursor).position +
+             piece.at(cursor).velocity * dt +
+             0.5 * piece.at(cursor).acceleration * dt * dt;
+    single_joint_way_point.velocity = piece.at(cursor).velocity + piece.at(cursor).acceleration * dt;
+    single_joint_way_point.acceleration = piece.at(cursor).acceleration;
+    single_joint_way_point.effort = 0.0;
+
+    joint_way_point.push_back(single_joint_way_point);
+  }
+
+  return joint_way_point;
+}
+
+
+//-------------------- Compiled joint trajectory --------------------//
+
+CompiledJointTrajectory::CompiledJointTrajectory()
+: joint_size_(0),
+  sample_size_(0),
+  sample_time_(0.0),
+  move_time_(0.0),
+  min_manipulability_(1e-4)
+{}
+
+CompiledJointTrajectory::~CompiledJointTrajectory() {}
+
+double CompiledJointTrajectory::calcManipulability(Eigen::MatrixXd jacobian)
+{
+  if(jacobian.rows() >= jacobian.cols())
+    return sqrt(fabs((jacobian.transpose() * jacobian).determinant()));
+  else
+    return sqrt(fabs((jacobian * jacobian.transpose()).determinant()));
+}
+
+bool CompiledJointTrajectory::compileTaskTrajectory(Manipulator manipulator,
+                                                    Kinematics *kinematics,
+                                                    Name tool_name,
+                                                    CustomTaskTrajectory *task_trajectory,
+                                                    const void *arg,
+                                                    double move_time,
+                                                    double sample_time)
+{
+  if(move_time <= 0.0 || sample_time <= 0.0)
+  {
+    log::error("[CompiledJointTrajectory] Move time and sample time must be positive.");
+    return false;
+  }
+
+  kinematics->solveForwardKinematics(&manipulator);
+  task_trajectory->makeTaskTrajectory(move_time, manipulator.getComponentPoseFromWorld(tool_name), arg);
+
+  std::vector<Name> joint_name = manipulator.getAllActiveJointComponentName();
+  joint_size_ = joint_name.size();
+  move_time_ = move_time;
+  // Evenly spaced from 0 to move_time, no longer apart than sample_time, so
+  // the last segment is as long as the others
+  sample_size_ = (uint32_t)ceil(move_time / sample_time) + 1;
+  sample_time_ = move_time / (sample_size_ - 1);
+  position_.assign(sample_size_ * joint_size_, 0.0f);
+
+  for(uint32_t sample = 0; sample < sample_size_; sample++)
+  {
+    double tick = std::min(sample * sample_time_, move_time);
+    JointWaypoint goal_joint_value;
+
+    // The manipulator keeps the previous solution, so each solve is warm started from it
+    if(!kinematics->solveInverseKinematics(&manipulator, tool_name, task_trajectory->getTaskWaypoint(tick), &goal_joint_value))
+    {
+      log::error("[CompiledJointTrajectory] Fail to solve IK at ", tick);
+      sample_size_ = 0;
+      return false;
+    }
+
+    for(uint8_t index = 0; index < joint_size_; index++)
+    {
+      if(!manipulator.checkJointLimit(joint_name.at(index), goal_joint_value.at(index).position))
+      {
+        log::error("[CompiledJointTrajectory] Goal value exceeded limit at ", tick);
+        sample_size_ = 0;
+        return false;
+      }
+      position_.at(sample * joint_size_ + index) = goal_joint_value.at(index).position;
+    }
+
+    manipulator.setAllActiveJointValue(goal_joint_value);
+    kinematics->solveForwardKinematics(&manipulator);
+    if(calcManipulability(kinematics->jacobian(&manipulator, tool_name)) < min_manipulability_)
+    {
+      log::error("[CompiledJointTrajectory] Too close to a singularity at ", tick);
+      sample_size_ = 0;
+      return false;
+    }
+  }
+  return true;
+}
+
+void CompiledJointTrajectory::setMinManipulability(double min_manipulability)
+{
+  min_manipulability_ = min_manipulability;
+}
+
+double CompiledJointTrajectory::getMoveTime()
+{
+  return move_time_;
+}
+
+uint32_t CompiledJointTrajectory::getSampleSize()
+{
+  return sample_size_;
+}
+
+JointWaypoint CompiledJointTrajectory::getStartJointWaypoint()
+{
+  return getJointWaypoint(0.0);
+}
+
+JointWaypoint CompiledJointTrajectory::getJointWaypoint(double tick)
+{
+  JointWaypoint joint_way_point;
+  if(sample_size_ == 0)
+    return joint_way_point;
+
+  if(tick < 0.0) tick = 0.0;
+  if(tick > move_time_) tick = move_time_;
+
+  uint32_t sample = (uint32_t)(tick / sample_time_);
+  if(sample > sample_size_ - 2) sample = (sample_size_ > 1) ? sample_size_ - 2 : 0;
+  uint32_t next = std::min(sample + 1, sample_size_ - 1);
+  uint32_t prev = (sample > 0) ? sample - 1 : 0;
+  uint32_t after = std::min(sample + 2, sample_size_ - 1);
+  double s = tick / sample_time_ - sample;
+  if(s > 1.0) s = 1.0;
+
+  for (uint8_t index = 0; index < joint_size_; index++)
+  {
+    // Catmull-Rom slopes, zero at both ends
+    double p0 = position_.at(sample * joint_size_ + index);
+    double p1 = position_.at(next * joint_size_ + index);
+    double m0 = (sample == 0) ? 0.0 : (p1 - position_.at(prev * joint_size_ + index)) / 2.0;
+    double m1 = (next == sample_size_ - 1) ? 0.0 : (position_.at(after * joint_size_ + index) - p0) / 2.0;
+
+    double a = 2.0 * p0 - 2.0 * p1 + m0 + m1;
+    double b = -3.0 * p0 + 3.0 * p1 - 2.0 * m0 - m1;
+
+    JointValue single_joint_way_point;
+    single_joint_way_point.position = ((a * s + b) * s + m0) * s + p0;
+    single_joint_way_point.velocity = ((3.0 * a * s + 2.0 * b) * s + m0) / sample_time_;
+    single_joint_way_point.acceleration = (6.0 * a * s + 2.0 * b) / (sample_time_ * sample_time_);
+    single_joint_way_point.effort = 0.0;
+
+    joint_way_point.push_back(single_joint_way_point);
+  }
+
+  return joint_way_point;
+}
+
+
 /*****************************************************************************
 ** Trajectory Class
 *****************************************************************************/
@@ -316,6 +733,16 @@ TaskTrajectory Trajectory::getTaskTrajectory()
   return task_;
 }
 
+BlendedJointTrajectory *Trajectory::getBlendedJointTrajectory()
+{
+  return &blended_joint_;
+}
+
+CompiledJointTrajectory *Trajectory::getCompiledJointTrajectory()
+{
+  return &compiled_joint_;
+}
+
 CustomJointTrajectory *Trajectory::getCustomJointTrajectory(Name name)
 {
   return cus_joint_.at(name);
@@ -440,6 +867,36 @@ void Trajectory::makeTaskTrajectory(TaskWaypoint start_way_point, TaskWaypoint g
   task_.makeTaskTrajectory(trajectory_time_.total_move_time, start_way_point, goal_way_point);
 }
 
+bool Trajectory::makeBlendedJointTrajectory(std::vector<JointWaypoint> way_point_list, std::vector<double> max_velocity, std::vector<double> max_acceleration)
+{
+  if(!blended_joint_.makeJointTrajectory(way_point_list, max_velocity, max_acceleration))
+    return false;
+
+  trajectory_time_.total_move_time = blended_joint_.getMoveTime();
+  return true;
+}
+
+bool Trajectory::compileCustomTrajectory(Name trajectory_name, Name tool_name, Kinematics *kinematics, JointWaypoint start_way_point, const void *arg, double move_time, double sample_time, CompiledJointTrajectory *compiled_trajectory)
+{
+  if(cus_task_.find(trajectory_name) == cus_task_.end())
+  {
+    log::error("[compileCustomTrajectory] Wrong way point type.");
+    return false;
+  }
+
+  Manipulator manipulator = manipulator_;
+  manipulator.setAllActiveJointValue(start_way_point);
+  return compiled_trajectory->compileTaskTrajectory(manipulator, kinematics, tool_name, cus_task_.at(trajectory_name),
+                                                    arg, move_time, sample_time);
+}
+
+void Trajectory::makeCompiledTrajectory(CompiledJointTrajectory *compiled_trajectory)
+{
+  // Played from a copy, the caller may compile the next one meanwhile
+  compiled_joint_ = *compiled_trajectory;
+  trajectory_time_.total_move_time = compiled_trajectory->getMoveTime();
+}
+
 void Trajectory::makeCustomTrajectory(Name trajectory_name, JointWaypoint start_way_point, const void *arg)
 {
   if(cus_joint_.find(trajectory_name) != cus_joint_.end())
@@ -43,6 +43,16 @@ void setup()
   nh.advertise(battery_state_pub);
   nh.advertise(mag_pub);
 
+  // Frames wait in the transmit queue when USB is busy, only the latest sensor data is kept
+  nh.setTxPriority(cmd_vel_rc100_pub, ros::TX_PRIORITY_HIGH);
+  nh.setTxPriority(imu_pub, ros::TX_PRIORITY_NORMAL, true);
+  nh.setTxPriority(mag_pub, ros::TX_PRIORITY_NORMAL, true);
+  nh.setTxPriority(odom_pub, ros::TX_PRIORITY_NORMAL, true);
+  nh.setTxPriority(joint_states_pub, ros::TX_PRIORITY_NORMAL, true);
+  nh.setTxPriority(sensor_state_pub, ros::TX_PRIORITY_LOW, true);
+  nh.setTxPriority(battery_state_pub, ros::TX_PRIORITY_LOW, true);
+  nh.setTxPriority(version_info_pub, ros::TX_PRIORITY_LOW);
+
   tf_broadcaster.init(nh);
 
   // Setting for Dynamixel motors
@@ -58,14 +68,21 @@ void setup()
   controllers.init(MAX_LINEAR_VELOCITY, MAX_ANGULAR_VELOCITY);
 
   // Setting for SLAM and navigation (odometry, joint states, TF)
+  odometry.init(WHEEL_RADIUS, WHEEL_SEPARATION, TICK2RAD);
+  odometry.setFusion(ODOMETRY_FUSION);
   initOdom();
 
   initJointStates();
 
-  prev_update_time = millis();
-
   pinMode(LED_WORKING_CHECK, OUTPUT);
 
+  // Start motor control and odometry at a fixed rate
+  control_timer.pause();
+  control_timer.setPeriod(CONTROL_MOTOR_PERIOD);  // in microseconds
+  control_timer.attachInterrupt(controlMotorTask);
+  control_timer.refresh();
+  control_timer.resume();
+
   setup_end = true;
 }
 
@@ -75,22 +92,11 @@ void setup()
 void loop()
 {
   uint32_t t = millis();
-  updateTime();
   updateVariable(nh.connected());
   updateTFPrefix(nh.connected());
 
-  if ((t-tTime[0]) >= (1000 / CONTROL_MOTOR_SPEED_FREQUENCY))
-  {
-    updateGoalVelocity();
-    if ((t-tTime[6]) > CONTROL_MOTOR_TIMEOUT) 
-    {
-      motor_driver.controlMotor(WHEEL_RADIUS, WHEEL_SEPARATION, zero_velocity);
-    } 
-    else {
-      motor_driver.controlMotor(WHEEL_RADIUS, WHEEL_SEPARATION, goal_velocity);
-    }
-    tTime[0] = t;
-  }
+  // Goal velocity is applied to the motors by controlMotorTask()
+  updateGoalVelocity();
 
   if ((t-tTime[1]) >= (1000 / CMD_VEL_PUBLISH_FREQUENCY))
   {
@@ -140,6 +146,7 @@ void loop()
 
   // Update the IMU unit
   sensors.updateIMU();
+  updateImuState();
 
   // TODO
   // Update sonar data
@@ -161,6 +168,58 @@ void loop()
   waitForSerialLink(nh.connected());
 }
 
+/*******************************************************************************
+* Motor control and odometry task (HardwareTimer interrupt)
+*******************************************************************************/
+void controlMotorTask(void)
+{
+  uint32_t start_time = micros();
+  uint32_t interval   = start_time - control_loop_stat.prev_start_time;
+  uint32_t exec_time  = 0;
+  int32_t  encoder[WHEEL_NUM] = {0, 0};
+
+  if (control_loop_stat.count > 0)
+  {
+    uint32_t jitter = (interval > CONTROL_MOTOR_PERIOD) ? (interval - CONTROL_MOTOR_PERIOD) : (CONTROL_MOTOR_PERIOD - interval);
+    if (jitter > control_loop_stat.max_jitter)
+      control_loop_stat.max_jitter = jitter;
+  }
+  control_loop_stat.prev_start_time = start_time;
+
+  // Dynamixels are only accessed here, so torque requests from callbacks are applied in this task
+  if (torque_request.updated == true)
+  {
+    motor_driver.setTorque(torque_request.onoff);
+    torque_request.updated = false;
+  }
+
+  encoder_valid = motor_driver.readEncoder(encoder[LEFT], encoder[RIGHT]);
+  if (encoder_valid == true)
+  {
+    // loop() does not run until this returns, so imu_state is read whole
+    float imu_yaw = atan2f(imu_state.orientation[1]*imu_state.orientation[2] + imu_state.orientation[0]*imu_state.orientation[3],
+                           0.5f - imu_state.orientation[2]*imu_state.orientation[2] - imu_state.orientation[3]*imu_state.orientation[3]);
+
+    odometry.update(encoder[LEFT], encoder[RIGHT], imu_state.yaw_rate, imu_yaw, start_time);
+
+    present_encoder[LEFT]  = encoder[LEFT];
+    present_encoder[RIGHT] = encoder[RIGHT];
+  }
+
+  if ((millis()-tTime[6]) > CONTROL_MOTOR_TIMEOUT)
+    motor_driver.controlMotor(WHEEL_RADIUS, WHEEL_SEPARATION, zero_velocity);
+  else
+    motor_driver.controlMotor(WHEEL_RADIUS, WHEEL_SEPARATION, goal_velocity);
+
+  exec_time = micros() - start_time;
+  if (exec_time > control_loop_stat.max_exec_time)
+    control_loop_stat.max_exec_time = exec_time;
+  if (exec_time >= CONTROL_MOTOR_PERIOD)
+    control_loop_stat.overrun++;
+
+  control_loop_stat.count++;
+}
+
 /*******************************************************************************
 * Callback function for cmd_vel msg
 *******************************************************************************/
@@ -189,7 +248,8 @@ void motorPowerCallback(const std_msgs::Bool& power_msg)
 {
   bool dxl_power = power_msg.data;
 
-  motor_driver.setTorque(dxl_power);
+  torque_request.onoff   = dxl_power;
+  torque_request.updated = true;
 }
 
 /*******************************************************************************
@@ -206,9 +266,6 @@ void resetCallback(const std_msgs::Empty& reset_msg)
 
   sensors.calibrationGyro();
 
-  sprintf(log_msg, "Calibration End");
-  nh.loginfo(log_msg);
-
   initOdom();
 
   sprintf(log_msg, "Reset Odometry");
@@ -231,12 +288,38 @@ void publishCmdVelFromRC100Msg(void)
 *******************************************************************************/
 void publishImuMsg(void)
 {
+  static int offset_orientation         = 0;
+  static int offset_angular_velocity    = 0;
+  static int offset_linear_acceleration = 0;
+
   imu_msg = sensors.getIMU();
 
-  imu_msg.header.stamp    = rosNow();
+  imu_msg.header.stamp    = rosTime(sensors.getIMUStamp());
   imu_msg.header.frame_id = imu_frame_id;
 
-  imu_pub.publish(&imu_msg);
+  // Frame id and covariances do not change, only the measurements are written again
+  if (imu_prepared.isPrepared() == false)
+  {
+    if (imu_pub.prepare(imu_prepared, &imu_msg) == false)
+    {
+      imu_pub.publish(&imu_msg);
+      return;
+    }
+
+    // header | orientation | covariance[9] | angular_velocity | covariance[9] | linear_acceleration | covariance[9]
+    offset_orientation         = headerLength(imu_frame_id);
+    offset_angular_velocity    = offset_orientation + 32 + 72;
+    offset_linear_acceleration = offset_angular_velocity + 24 + 72;
+  }
+  else
+  {
+    imu_prepared.setTime(HEADER_STAMP_OFFSET, imu_msg.header.stamp);
+    imu_prepared.setMsg(offset_orientation, imu_msg.orientation);
+    imu_prepared.setMsg(offset_angular_velocity, imu_msg.angular_velocity);
+    imu_prepared.setMsg(offset_linear_acceleration, imu_msg.linear_acceleration);
+  }
+
+  imu_pub.publish(imu_prepared);
 }
 
 /*******************************************************************************
@@ -246,7 +329,7 @@ void publishMagMsg(void)
 {
   mag_msg = sensors.getMag();
 
-  mag_msg.header.stamp    = rosNow();
+  mag_msg.header.stamp    = rosTime(sensors.getIMUStamp());
   mag_msg.header.frame_id = mag_frame_id;
 
   mag_pub.publish(&mag_msg);
@@ -257,17 +340,16 @@ void publishMagMsg(void)
 *******************************************************************************/
 void publishSensorStateMsg(void)
 {
-  bool dxl_comm_result = false;
+  if (encoder_valid == false)
+    return;
 
   sensor_state_msg.header.stamp = rosNow();
   sensor_state_msg.battery = sensors.checkVoltage();
 
-  dxl_comm_result = motor_driver.readEncoder(sensor_state_msg.left_encoder, sensor_state_msg.right_encoder);
-
-  if (dxl_comm_result == true)
-    updateMotorInfo(sensor_state_msg.left_encoder, sensor_state_msg.right_encoder);
-  else
-    return;
+  noInterrupts();
+  sensor_state_msg.left_encoder  = present_encoder[LEFT];
+  sensor_state_msg.right_encoder = present_encoder[RIGHT];
+  interrupts();
 
   sensor_state_msg.bumper = sensors.checkPushBumper();
 
@@ -320,19 +402,24 @@ void publishBatteryStateMsg(void)
 *******************************************************************************/
 void publishDriveInformation(void)
 {
-  unsigned long time_now = millis();
-  unsigned long step_time = time_now - prev_update_time;
+  ros::Time stamp_now;
 
-  prev_update_time = time_now;
-  ros::Time stamp_now = rosNow();
+  // odometry is integrated by controlMotorTask(), take the latest state
+  noInterrupts();
+  odom_pose = odometry.getPose();
+  updateJointStates();
+  interrupts();
 
-  // calculate odometry
-  calcOdometry((double)(step_time * 0.001));
+  // Stamp with the time the encoders were read, not the time of publishing
+  if (encoder_valid == true)
+    stamp_now = rosTime(odom_pose.stamp);
+  else
+    stamp_now = rosNow();
 
   // odometry
   updateOdometry();
   odom.header.stamp = stamp_now;
-  odom_pub.publish(&odom);
+  publishOdomMsg();
 
   // odometry tf
   updateTF(odom_tf);
@@ -340,9 +427,82 @@ void publishDriveInformation(void)
   tf_broadcaster.sendTransform(odom_tf);
 
   // joint states
-  updateJointStates();
   joint_states.header.stamp = stamp_now;
-  joint_states_pub.publish(&joint_states);
+  publishJointStatesMsg();
+}
+
+/*******************************************************************************
+* Publish msgs (odometry, only pose and twist are written again)
+*******************************************************************************/
+void publishOdomMsg(void)
+{
+  static int offset_pose  = 0;
+  static int offset_twist = 0;
+
+  if (odom_prepared.isPrepared() == false)
+  {
+    if (odom_pub.prepare(odom_prepared, &odom) == false)
+    {
+      odom_pub.publish(&odom);
+      return;
+    }
+
+    // header | child_frame_id | pose | covariance[36] | twist | covariance[36]
+    offset_pose  = headerLength(odom_header_frame_id) + 4 + strlen(odom_child_frame_id);
+    offset_twist = offset_pose + 56 + 288;
+  }
+  else
+  {
+    odom_prepared.setTime(HEADER_STAMP_OFFSET, odom.header.stamp);
+    odom_prepared.setMsg(offset_pose, odom.pose.pose);
+    odom_prepared.setMsg(offset_twist, odom.twist.twist);
+  }
+
+  odom_pub.publish(odom_prepared);
+}
+
+/*******************************************************************************
+* Publish msgs (joint states, only positions and velocities are written again)
+*******************************************************************************/
+void publishJointStatesMsg(void)
+{
+  static int offset_position = 0;
+  static int offset_velocity = 0;
+
+  if (joint_states_prepared.isPrepared() == false)
+  {
+    if (joint_states_pub.prepare(joint_states_prepared, &joint_states) == false)
+    {
+      joint_states_pub.publish(&joint_states);
+      return;
+    }
+
+    // header | name[] | position[] | velocity[] | effort[], each array starts with its length
+    offset_position = headerLength(joint_state_header_frame_id) + 4;
+    for (uint32_t index = 0; index < joint_states.name_length; index++)
+      offset_position += 4 + strlen(joint_states.name[index]);
+    offset_position += 4;
+    offset_velocity = offset_position + 8 * joint_states.position_length + 4;
+  }
+  else
+  {
+    joint_states_prepared.setTime(HEADER_STAMP_OFFSET, joint_states.header.stamp);
+    for (uint32_t index = 0; index < WHEEL_NUM; index++)
+    {
+      joint_states_prepared.setFloat64(offset_position + 8 * index, joint_states.position[index]);
+      joint_states_prepared.setFloat64(offset_velocity + 8 * index, joint_states.velocity[index]);
+    }
+  }
+
+  joint_states_pub.publish(joint_states_prepared);
+}
+
+/*******************************************************************************
+* Serialized length of std_msgs/Header (seq, stamp, frame_id)
+*******************************************************************************/
+int headerLength(const char* frame_id)
+{
+  return 4 + 8 + 4 + strlen(frame_id);
 }
 
 /*******************************************************************************
@@ -385,6 +545,11 @@ void updateTFPrefix(bool isConnected)
         strcat(joint_state_header_frame_id, "/base_link");
       }
 
+      // Frame ids are serialized in the prepared messages
+      imu_prepared.invalidate();
+      odom_prepared.invalidate();
+      joint_states_prepared.invalidate();
+
       sprintf(log_msg, "Setup TF on Odometry [%s]", odom_header_frame_id);
       nh.loginfo(log_msg); 
 
@@ -414,13 +579,13 @@ void updateOdometry(void)
   odom.header.frame_id = odom_header_frame_id;
   odom.child_frame_id  = odom_child_frame_id;
 
-  odom.pose.pose.position.x = odom_pose[0];
-  odom.pose.pose.position.y = odom_pose[1];
+  odom.pose.pose.position.x = odom_pose.x;
+  odom.pose.pose.position.y = odom_pose.y;
   odom.pose.pose.position.z = 0;
-  odom.pose.pose.orientation = tf::createQuaternionFromYaw(odom_pose[2]);
+  odom.pose.pose.orientation = tf::createQuaternionFromYaw(odom_pose.theta);
 
-  odom.twist.twist.linear.x  = odom_vel[0];
-  odom.twist.twist.angular.z = odom_vel[2];
+  odom.twist.twist.linear.x  = odom_pose.linear_velocity;
+  odom.twist.twist.angular.z = odom_pose.angular_velocity;
 }
 
 /*******************************************************************************
@@ -432,11 +597,7 @@ void updateJointStates(void)
   static float joint_states_vel[WHEEL_NUM] = {0.0, 0.0};
   //static float joint_states_eff[WHEEL_NUM] = {0.0, 0.0};
 
-  joint_states_pos[LEFT]  = last_rad[LEFT];
-  joint_states_pos[RIGHT] = last_rad[RIGHT];
-
-  joint_states_vel[LEFT]  = last_velocity[LEFT];
-  joint_states_vel[RIGHT] = last_velocity[RIGHT];
+  odometry.getWheelState(joint_states_pos, joint_states_vel);
 
   joint_states.position = joint_states_pos;
   joint_states.velocity = joint_states_vel;
@@ -455,105 +616,6 @@ void updateTF(geometry_msgs::TransformStamped& odom_tf)
   odom_tf.transform.rotation      = odom.pose.pose.orientation;
 }
 
-/*******************************************************************************
-* Update motor information
-*******************************************************************************/
-void updateMotorInfo(int32_t left_tick, int32_t right_tick)
-{
-  int32_t current_tick = 0;
-  static int32_t last_tick[WHEEL_NUM] = {0, 0};
-  
-  if (init_encoder)
-  {
-    for (int index = 0; index < WHEEL_NUM; index++)
-    {
-      last_diff_tick[index] = 0;
-      last_tick[index]      = 0;
-      last_rad[index]       = 0.0;
-
-      last_velocity[index]  = 0.0;
-    }  
-
-    last_tick[LEFT] = left_tick;
-    last_tick[RIGHT] = right_tick;
-
-    init_encoder = false;
-    return;
-  }
-
-  current_tick = left_tick;
-
-  last_diff_tick[LEFT] = current_tick - last_tick[LEFT];
-  last_tick[LEFT]      = current_tick;
-  last_rad[LEFT]       += TICK2RAD * (double)last_diff_tick[LEFT];
-
-  current_tick = right_tick;
-
-  last_diff_tick[RIGHT] = current_tick - last_tick[RIGHT];
-  last_tick[RIGHT]      = current_tick;
-  last_rad[RIGHT]       += TICK2RAD * (double)last_diff_tick[RIGHT];
-}
-
-/*******************************************************************************
-* Calculate the odometry
-*******************************************************************************/
-bool calcOdometry(double diff_time)
-{
-  float* orientation;
-  double wheel_l, wheel_r;      // rotation value of wheel [rad]
-  double delta_s, theta, delta_theta;
-  static double last_theta = 0.0;
-  double v, w;                  // v = translational velocity [m/s], w = rotational velocity [rad/s]
-  double step_time;
-
-  wheel_l = wheel_r = 0.0;
-  delta_s = delta_theta = theta = 0.0;
-  v = w = 0.0;
-  step_time = 0.0;
-
-  step_time = diff_time;
-
-  if (step_time == 0)
-    return false;
-
-  wheel_l = TICK2RAD * (double)last_diff_tick[LEFT];
-  wheel_r = TICK2RAD * (double)last_diff_tick[RIGHT];
-
-  if (isnan(wheel_l))
-    wheel_l = 0.0;
-
-  if (isnan(wheel_r))
-    wheel_r = 0.0;
-
-  delta_s     = WHEEL_RADIUS * (wheel_r + wheel_l) / 2.0;
-  // theta = WHEEL_RADIUS * (wheel_r - wheel_l) / WHEEL_SEPARATION;  
-  orientation = sensors.getOrientation();
-  theta       = atan2f(orientation[1]*orientation[2] + orientation[0]*orientation[3], 
-                0.5f - orientation[2]*orientation[2] - orientation[3]*orientation[3]);
-
-  delta_theta = theta - last_theta;
-
-  // compute odometric pose
-  odom_pose[0] += delta_s * cos(odom_pose[2] + (delta_theta / 2.0));
-  odom_pose[1] += delta_s * sin(odom_pose[2] + (delta_theta / 2.0));
-  odom_pose[2] += delta_theta;
-
-  // compute odometric instantaneouse velocity
-
-  v = delta_s / step_time;
-  w = delta_theta / step_time;
-
-  odom_vel[0] = v;
-  odom_vel[1] = 0.0;
-  odom_vel[2] = w;
-
-  last_velocity[LEFT]  = wheel_l / step_time;
-  last_velocity[RIGHT] = wheel_r / step_time;
-  last_theta = theta;
-
-  return true;
-}
-
 /*******************************************************************************
 * Turtlebot3 test drive using push buttons
 *******************************************************************************/
@@ -565,7 +627,10 @@ void driveTest(uint8_t buttons)
 
   int32_t current_tick[2] = {0, 0};
 
-  motor_driver.readEncoder(current_tick[LEFT], current_tick[RIGHT]);
+  noInterrupts();
+  current_tick[LEFT]  = present_encoder[LEFT];
+  current_tick[RIGHT] = present_encoder[RIGHT];
+  interrupts();
 
   if (buttons & (1<<0))  
   {
@@ -657,15 +722,6 @@ void waitForSerialLink(bool isConnected)
   }
 }
 
-/*******************************************************************************
-* Update the base time for interpolation
-*******************************************************************************/
-void updateTime()
-{
-  current_offset = millis();
-  current_time = nh.now();
-}
-
 /*******************************************************************************
 * ros::Time::now() implementation
 *******************************************************************************/
@@ -675,16 +731,11 @@ ros::Time rosNow()
 }
 
 /*******************************************************************************
-* Time Interpolation function (deprecated)
+* ROS time of a local timestamp (micros) taken when the data was sampled
 *******************************************************************************/
-ros::Time addMicros(ros::Time & t, uint32_t _micros)
+ros::Time rosTime(uint32_t stamp_us)
 {
-  uint32_t sec, nsec;
-
-  sec  = _micros / 1000 + t.sec;
-  nsec = _micros % 1000000000 + t.nsec;
-
-  return ros::Time(sec, nsec);
+  return nh.toTime(stamp_us);
 }
 
 /*******************************************************************************
@@ -692,29 +743,41 @@ ros::Time addMicros(ros::Time & t, uint32_t _micros)
 *******************************************************************************/
 void updateGyroCali(bool isConnected)
 {
-  static bool isEnded = false;
+  static bool isStarted = false;
+  static bool isCalibrating = false;
   char log_msg[50];
 
   (void)(isConnected);
 
   if (nh.connected())
   {
-    if (isEnded == false)
+    if (isStarted == false)
     {
       sprintf(log_msg, "Start Calibration of Gyro");
       nh.loginfo(log_msg);
 
+      // Goes on with the IMU samples, ROS and the motors are serviced meanwhile
       sensors.calibrationGyro();
 
-      sprintf(log_msg, "Calibration End");
-      nh.loginfo(log_msg);
-
-      isEnded = true;
+      isStarted = true;
     }
   }
   else
   {
-    isEnded = false;
+    isStarted = false;
+  }
+
+  // Also the end of the calibration started by resetCallback()
+  if (sensors.isCalibratingGyro() == true)
+  {
+    isCalibrating = true;
+  }
+  else if (isCalibrating == true)
+  {
+    sprintf(log_msg, "Calibration End");
+    nh.loginfo(log_msg);
+
+    isCalibrating = false;
   }
 }
 
@@ -762,13 +825,10 @@ void sendLogMsg(void)
 *******************************************************************************/
 void initOdom(void)
 {
-  init_encoder = true;
+  noInterrupts();
 
-  for (int index = 0; index < 3; index++)
-  {
-    odom_pose[index] = 0.0;
-    odom_vel[index]  = 0.0;
-  }
+  odometry.reset();
+  odom_pose = odometry.getPose();
 
   odom.pose.pose.position.x = 0.0;
   odom.pose.pose.position.y = 0.0;
@@ -781,6 +841,8 @@ void initOdom(void)
 
   odom.twist.twist.linear.x  = 0.0;
   odom.twist.twist.angular.z = 0.0;
+
+  interrupts();
 }
 
 /*******************************************************************************
@@ -804,10 +866,33 @@ void initJointStates(void)
 *******************************************************************************/
 void updateGoalVelocity(void)
 {
-  goal_velocity[LINEAR]  = goal_velocity_from_button[LINEAR]  + goal_velocity_from_cmd[LINEAR]  + goal_velocity_from_rc100[LINEAR];
-  goal_velocity[ANGULAR] = goal_velocity_from_button[ANGULAR] + goal_velocity_from_cmd[ANGULAR] + goal_velocity_from_rc100[ANGULAR];
+  float linear  = goal_velocity_from_button[LINEAR]  + goal_velocity_from_cmd[LINEAR]  + goal_velocity_from_rc100[LINEAR];
+  float angular = goal_velocity_from_button[ANGULAR] + goal_velocity_from_cmd[ANGULAR] + goal_velocity_from_rc100[ANGULAR];
+
+  // controlMotorTask() must not see a new linear with an old angular velocity
+  noInterrupts();
+  goal_velocity[LINEAR]  = linear;
+  goal_velocity[ANGULAR] = angular;
+  interrupts();
+
+  sensors.setLedPattern(linear, angular);
+}
 
-  sensors.setLedPattern(goal_velocity[LINEAR], goal_velocity[ANGULAR]);
+/*******************************************************************************
+* Copy the IMU values used by controlMotorTask()
+*******************************************************************************/
+void updateImuState(void)
+{
+  float* orientation = sensors.getOrientation();
+  float  yaw_rate    = sensors.getYawRate();
+
+  noInterrupts();
+  imu_state.orientation[0] = orientation[0];
+  imu_state.orientation[1] = orientation[1];
+  imu_state.orientation[2] = orientation[2];
+  imu_state.orientation[3] = orientation[3];
+  imu_state.yaw_rate       = yaw_rate;
+  interrupts();
 }
 
 /*******************************************************************************
@@ -843,16 +928,45 @@ void sendDebuglog(void)
   DEBUG_SERIAL.println("Torque : " + String(motor_driver.getTorque()));
 
   int32_t encoder[WHEEL_NUM] = {0, 0};
-  motor_driver.readEncoder(encoder[LEFT], encoder[RIGHT]);
+  noInterrupts();
+  encoder[LEFT]  = present_encoder[LEFT];
+  encoder[RIGHT] = present_encoder[RIGHT];
+  interrupts();
   
   DEBUG_SERIAL.println("Encoder(left) : " + String(encoder[LEFT]));
   DEBUG_SERIAL.println("Encoder(right) : " + String(encoder[RIGHT]));
 
+  DEBUG_SERIAL.println("---------------------------------------");
+  DEBUG_SERIAL.println("Control Loop");
+  DEBUG_SERIAL.println("---------------------------------------");
+  DEBUG_SERIAL.println("Count : " + String(control_loop_stat.count));
+  DEBUG_SERIAL.println("Overrun : " + String(control_loop_stat.overrun));
+  DEBUG_SERIAL.println("Max jitter(us) : " + String(control_loop_stat.max_jitter));
+  DEBUG_SERIAL.println("Max exec time(us) : " + String(control_loop_stat.max_exec_time));
+
+  DEBUG_SERIAL.println("---------------------------------------");
+  DEBUG_SERIAL.println("Time Sync");
+  DEBUG_SERIAL.println("---------------------------------------");
+  DEBUG_SERIAL.println("Round trip(us) : " + String(nh.getSyncRoundTrip()));
+  DEBUG_SERIAL.println("Drift(ppm) : " + String(nh.getSyncDrift() * 1000000.0f));
+  DEBUG_SERIAL.println("Rejected : " + String(nh.getSyncRejectCount()));
+
+  DEBUG_SERIAL.println("---------------------------------------");
+  DEBUG_SERIAL.println("Transmit Queue");
+  DEBUG_SERIAL.println("---------------------------------------");
+  DEBUG_SERIAL.println("Queued(byte) : " + String(nh.getTxQueueLength()));
+  DEBUG_SERIAL.println("Max queued(byte) : " + String(nh.getTxQueueMaxLength()));
+  DEBUG_SERIAL.println("Replaced : " + String(nh.getTxReplaceCount()));
+  DEBUG_SERIAL.println("Dropped : " + String(nh.getTxDropCount()));
+
+  control_loop_stat.max_jitter    = 0;
+  control_loop_stat.max_exec_time = 0;
+
   DEBUG_SERIAL.println("---------------------------------------");
   DEBUG_SERIAL.println("TurtleBot3");
   DEBUG_SERIAL.println("---------------------------------------");
   DEBUG_SERIAL.println("Odometry : ");   
-  DEBUG_SERIAL.print("         x : "); DEBUG_SERIAL.println(odom_pose[0]);
-  DEBUG_SERIAL.print("         y : "); DEBUG_SERIAL.println(odom_pose[1]);
-  DEBUG_SERIAL.print("     theta : "); DEBUG_SERIAL.println(odom_pose[2]);
+  DEBUG_SERIAL.print("         x : "); DEBUG_SERIAL.println(odom_pose.x);
+  DEBUG_SERIAL.print("         y : "); DEBUG_SERIAL.println(odom_pose.y);
+  DEBUG_SERIAL.print("     theta : "); DEBUG_SERIAL.println(odom_pose.theta);
 }
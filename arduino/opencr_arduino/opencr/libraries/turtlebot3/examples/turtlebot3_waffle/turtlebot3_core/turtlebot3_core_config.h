@@ -42,7 +42,8 @@
 
 #define FIRMWARE_VER "1.2.6"
 
-#define CONTROL_MOTOR_SPEED_FREQUENCY          30   //hz
+#define CONTROL_MOTOR_SPEED_FREQUENCY          100  //hz (HardwareTimer, up to 200)
+#define CONTROL_MOTOR_PERIOD                   (1000000 / CONTROL_MOTOR_SPEED_FREQUENCY)  //us
 #define CONTROL_MOTOR_TIMEOUT                  500  //ms
 #define IMU_PUBLISH_FREQUENCY                  200  //hz
 #define CMD_VEL_PUBLISH_FREQUENCY              30   //hz
@@ -63,12 +64,18 @@
 
 #define TICK2RAD                         0.001533981  // 0.087890625[deg] * 3.14159265359 / 180 = 0.001533981f
 
+#define ODOMETRY_FUSION                  ODOMETRY_FUSION_IMU_YAW  // WHEEL, IMU_YAW, COMPLEMENTARY or EKF
+
 #define TEST_DISTANCE                    0.300     // meter
 #define TEST_RADIAN                      3.14      // 180 degree
 
 // #define DEBUG                            
 #define DEBUG_SERIAL                     SerialBT2
 
+#if CONTROL_MOTOR_SPEED_FREQUENCY > 200
+#error "CONTROL_MOTOR_SPEED_FREQUENCY should be 200hz or lower"
+#endif
+
 // Callback function prototypes
 void commandVelocityCallback(const geometry_msgs::Twist& cmd_vel_msg);
 void soundCallback(const turtlebot3_msgs::Sound& sound_msg);
@@ -83,34 +90,34 @@ void publishSensorStateMsg(void);
 void publishVersionInfoMsg(void);
 void publishBatteryStateMsg(void);
 void publishDriveInformation(void);
+void publishOdomMsg(void);
+void publishJointStatesMsg(void);
+int  headerLength(const char* frame_id);
 
 ros::Time rosNow(void);
-ros::Time addMicros(ros::Time & t, uint32_t _micros); // deprecated
+ros::Time rosTime(uint32_t stamp_us);
 
 void updateVariable(bool isConnected);
-void updateMotorInfo(int32_t left_tick, int32_t right_tick);
-void updateTime(void);
 void updateOdometry(void);
 void updateJoint(void);
 void updateTF(geometry_msgs::TransformStamped& odom_tf);
 void updateGyroCali(bool isConnected);
 void updateGoalVelocity(void);
+void updateImuState(void);
 void updateTFPrefix(bool isConnected);
 
 void initOdom(void);
 void initJointStates(void);
 
-bool calcOdometry(double diff_time);
-
 void sendLogMsg(void);
 void waitForSerialLink(bool isConnected);
 
+void controlMotorTask(void);
+
 /*******************************************************************************
 * ROS NodeHandle
 *******************************************************************************/
 ros::NodeHandle nh;
-ros::Time current_time;
-uint32_t current_offset;
 
 /*******************************************************************************
 * ROS Parameter
@@ -176,6 +183,15 @@ ros::Publisher battery_state_pub("battery_state", &battery_state_msg);
 sensor_msgs::MagneticField mag_msg;
 ros::Publisher mag_pub("magnetic_field", &mag_msg);
 
+/*******************************************************************************
+* Prepared messages (serialized once, then only the measurements are written)
+*******************************************************************************/
+#define HEADER_STAMP_OFFSET                4    // std_msgs/Header : seq, stamp, frame_id
+
+ros::PreparedMsg<384> imu_prepared;             // 349 bytes with 29 bytes frame id
+ros::PreparedMsg<800> odom_prepared;            // 766 bytes with 29 bytes frame ids
+ros::PreparedMsg<192> joint_states_prepared;    // 158 bytes with 29 bytes frame id
+
 /*******************************************************************************
 * Transform Broadcaster
 *******************************************************************************/
@@ -188,6 +204,39 @@ tf::TransformBroadcaster tf_broadcaster;
 *******************************************************************************/
 static uint32_t tTime[10];
 
+/*******************************************************************************
+* HardwareTimer of Turtlebot3 (motor control and odometry)
+*******************************************************************************/
+HardwareTimer control_timer(TIMER_CH1);
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t overrun;         // ticks longer than CONTROL_MOTOR_PERIOD
+  uint32_t max_jitter;      // us
+  uint32_t max_exec_time;   // us
+  uint32_t prev_start_time; // us
+} ControlLoopStat;
+
+volatile ControlLoopStat control_loop_stat = {0, 0, 0, 0, 0};
+
+typedef struct
+{
+  bool updated;
+  bool onoff;
+} TorqueRequest;
+
+volatile TorqueRequest torque_request = {false, false};
+
+// IMU values used by controlMotorTask(), copied by loop() with interrupts disabled
+typedef struct
+{
+  float orientation[4];  // w, x, y, z
+  float yaw_rate;        // rad/s
+} ImuState;
+
+volatile ImuState imu_state = {{1.0, 0.0, 0.0, 0.0}, 0.0};
+
 /*******************************************************************************
 * Declaration for motor
 *******************************************************************************/
@@ -196,14 +245,10 @@ Turtlebot3MotorDriver motor_driver;
 /*******************************************************************************
 * Calculation for odometry
 *******************************************************************************/
-bool init_encoder = true;
-int32_t last_diff_tick[WHEEL_NUM] = {0, 0};
-double  last_rad[WHEEL_NUM]       = {0.0, 0.0};
+Turtlebot3Odometry odometry;
 
-/*******************************************************************************
-* Update Joint State
-*******************************************************************************/
-double  last_velocity[WHEEL_NUM]  = {0.0, 0.0};
+volatile bool    encoder_valid               = false;
+volatile int32_t present_encoder[WHEEL_NUM]  = {0, 0};
 
 /*******************************************************************************
 * Declaration for sensors
@@ -228,9 +273,7 @@ Turtlebot3Diagnosis diagnosis;
 /*******************************************************************************
 * Declaration for SLAM and navigation
 *******************************************************************************/
-unsigned long prev_update_time;
-float odom_pose[3];
-double odom_vel[3];
+OdometryPose odom_pose;
 
 /*******************************************************************************
 * Declaration for Battery
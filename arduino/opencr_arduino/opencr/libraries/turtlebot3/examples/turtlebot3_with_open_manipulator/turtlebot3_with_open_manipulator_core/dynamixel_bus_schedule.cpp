@@ -0,0 +1,218 @@
+/*******************************************************************************
+* Copyright 2016 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include "dynamixel_bus_schedule.h"
+
+DynamixelBusSchedule::DynamixelBusSchedule()
+  :portHandler_(NULL),
+   packetHandler_(NULL),
+   groupSyncWriteGoal_(NULL),
+   groupSyncReadState_(NULL),
+   id_num_(0),
+   state_stamp_(0)
+{
+}
+
+DynamixelBusSchedule::~DynamixelBusSchedule()
+{
+}
+
+bool DynamixelBusSchedule::init(dynamixel::PortHandler *port_handler, uint8_t *id, uint8_t id_num)
+{
+  bool result = true;
+
+  if (port_handler == NULL || id_num > BUS_SCHEDULE_DXL_MAX)
+    return false;
+
+  // A new PortHandler would switch the DYNAMIXEL power off, the opened one is shared
+  portHandler_   = port_handler;
+  packetHandler_ = dynamixel::PacketHandler::getPacketHandler(BUS_SCHEDULE_PROTOCOL_VERSION);
+
+  if (portHandler_->setBaudRate(BUS_SCHEDULE_BAUDRATE) == false)
+    return false;
+
+  groupSyncWriteGoal_ = new dynamixel::GroupSyncWrite(portHandler_, packetHandler_, ADDR_BUS_GOAL, LEN_BUS_GOAL);
+  groupSyncReadState_ = new dynamixel::GroupSyncRead(portHandler_, packetHandler_, ADDR_BUS_STATE, LEN_BUS_STATE);
+
+  id_num_ = id_num;
+  for (uint8_t num = 0; num < id_num_; num++)
+  {
+    id_[num] = id[num];
+
+    // The wheels keep their profile acceleration and the joints their goal velocity
+    if (packetHandler_->readTxRx(portHandler_, id_[num], ADDR_BUS_GOAL, LEN_BUS_GOAL, goal_[num]) != COMM_SUCCESS)
+    {
+      memset(goal_[num], 0, LEN_BUS_GOAL);
+      result = false;
+    }
+    goal_changed_[num] = false;
+
+    state_available_[num]  = false;
+    present_current_[num]  = 0;
+    present_velocity_[num] = 0;
+    present_position_[num] = 0;
+  }
+
+  if (groupSyncReadState_->setParam(id_, id_num_) == false)
+    return false;
+
+  return result;
+}
+
+int8_t DynamixelBusSchedule::findIndex(uint8_t id)
+{
+  for (uint8_t num = 0; num < id_num_; num++)
+  {
+    if (id_[num] == id)
+      return num;
+  }
+
+  return -1;
+}
+
+void DynamixelBusSchedule::setGoalData(uint8_t index, uint16_t address, int32_t value)
+{
+  uint8_t *data = &goal_[index][address - ADDR_BUS_GOAL];
+
+  data[0] = DXL_LOBYTE(DXL_LOWORD(value));
+  data[1] = DXL_HIBYTE(DXL_LOWORD(value));
+  data[2] = DXL_LOBYTE(DXL_HIWORD(value));
+  data[3] = DXL_HIBYTE(DXL_HIWORD(value));
+}
+
+bool DynamixelBusSchedule::setGoalVelocity(uint8_t id, int32_t velocity)
+{
+  int8_t index = findIndex(id);
+  if (index < 0)
+    return false;
+
+  // Profile and goal position keep the values read at init()
+  setGoalData(index, ADDR_BUS_GOAL_VELOCITY, velocity);
+  goal_changed_[index] = true;
+
+  return true;
+}
+
+bool DynamixelBusSchedule::setGoalPosition(uint8_t id, int32_t position, int32_t profile_acceleration, int32_t profile_velocity)
+{
+  int8_t index = findIndex(id);
+  if (index < 0)
+    return false;
+
+  // Writing the same goal position again restarts the profile, so it is sent only once
+  setGoalData(index, ADDR_BUS_PROFILE_ACCELERATION, profile_acceleration);
+  setGoalData(index, ADDR_BUS_PROFILE_VELOCITY, profile_velocity);
+  setGoalData(index, ADDR_BUS_GOAL_POSITION, position);
+  goal_changed_[index] = true;
+
+  return true;
+}
+
+bool DynamixelBusSchedule::write(void)
+{
+  int dxl_comm_result = COMM_TX_FAIL;
+  uint8_t param_num = 0;
+
+  groupSyncWriteGoal_->clearParam();
+
+  for (uint8_t num = 0; num < id_num_; num++)
+  {
+    if (goal_changed_[num] == false)
+      continue;
+
+    if (groupSyncWriteGoal_->addParam(id_[num], goal_[num]) == false)
+      return false;
+
+    goal_changed_[num] = false;
+    param_num++;
+  }
+
+  if (param_num == 0)
+    return true;
+
+  dxl_comm_result = groupSyncWriteGoal_->txPacket();
+  if (dxl_comm_result != COMM_SUCCESS)
+    return false;
+
+  return true;
+}
+
+bool DynamixelBusSchedule::read(void)
+{
+  int dxl_comm_result = COMM_TX_FAIL;
+  bool result = true;
+  uint32_t stamp = micros();
+
+  dxl_comm_result = groupSyncReadState_->txRxPacket();
+  if (dxl_comm_result != COMM_SUCCESS)
+    result = false;
+
+  // Keep the last state of DYNAMIXELs which did not respond
+  for (uint8_t num = 0; num < id_num_; num++)
+  {
+    if (groupSyncReadState_->isAvailable(id_[num], ADDR_BUS_STATE, LEN_BUS_STATE) == false)
+      continue;
+
+    present_current_[num]  = (int16_t)groupSyncReadState_->getData(id_[num], ADDR_BUS_PRESENT_CURRENT, 2);
+    present_velocity_[num] = (int32_t)groupSyncReadState_->getData(id_[num], ADDR_BUS_PRESENT_VELOCITY, 4);
+    present_position_[num] = (int32_t)groupSyncReadState_->getData(id_[num], ADDR_BUS_PRESENT_POSITION, 4);
+    state_available_[num]  = true;
+    state_stamp_           = stamp;
+  }
+
+  return result;
+}
+
+bool DynamixelBusSchedule::isAvailable(uint8_t id)
+{
+  int8_t index = findIndex(id);
+  if (index < 0)
+    return false;
+
+  return state_available_[index];
+}
+
+uint32_t DynamixelBusSchedule::getStateStamp(void)
+{
+  return state_stamp_;
+}
+
+int32_t DynamixelBusSchedule::getPresentCurrent(uint8_t id)
+{
+  int8_t index = findIndex(id);
+  if (index < 0)
+    return 0;
+
+  return present_current_[index];
+}
+
+int32_t DynamixelBusSchedule::getPresentVelocity(uint8_t id)
+{
+  int8_t index = findIndex(id);
+  if (index < 0)
+    return 0;
+
+  return present_velocity_[index];
+}
+
+int32_t DynamixelBusSchedule::getPresentPosition(uint8_t id)
+{
+  int8_t index = findIndex(id);
+  if (index < 0)
+    return 0;
+
+  return present_position_[index];
+}
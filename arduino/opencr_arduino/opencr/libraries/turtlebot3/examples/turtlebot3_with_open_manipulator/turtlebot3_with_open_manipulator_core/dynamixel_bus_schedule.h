@@ -0,0 +1,92 @@
+/*******************************************************************************
+* Copyright 2016 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef DYNAMIXEL_BUS_SCHEDULE_H_
+#define DYNAMIXEL_BUS_SCHEDULE_H_
+
+#include <DynamixelSDK.h>
+
+#define BUS_SCHEDULE_DXL_MAX             10
+#define BUS_SCHEDULE_BAUDRATE            1000000
+#define BUS_SCHEDULE_PROTOCOL_VERSION    2.0
+
+// Control table address (Dynamixel X-series)
+#define ADDR_BUS_GOAL_VELOCITY           104
+#define ADDR_BUS_PROFILE_ACCELERATION    108
+#define ADDR_BUS_PROFILE_VELOCITY        112
+#define ADDR_BUS_GOAL_POSITION           116
+#define ADDR_BUS_PRESENT_CURRENT         126
+#define ADDR_BUS_PRESENT_VELOCITY        128
+#define ADDR_BUS_PRESENT_POSITION        132
+
+// Goal Velocity ~ Goal Position
+// Items a goal does not set are written back with what the DYNAMIXEL held at init()
+#define ADDR_BUS_GOAL                    ADDR_BUS_GOAL_VELOCITY
+#define LEN_BUS_GOAL                     16
+
+// Present Current ~ Present Position
+#define ADDR_BUS_STATE                   ADDR_BUS_PRESENT_CURRENT
+#define LEN_BUS_STATE                    10
+
+// Wheels and manipulator share one DYNAMIXEL bus.
+// Each control tick sends all goals with one sync write and reads all states with one sync read.
+class DynamixelBusSchedule
+{
+ public:
+  DynamixelBusSchedule();
+  ~DynamixelBusSchedule();
+
+  // port_handler is already opened and powered, by the wheel driver
+  bool init(dynamixel::PortHandler *port_handler, uint8_t *id, uint8_t id_num);
+
+  // Velocity mode (wheels) : written every tick
+  bool setGoalVelocity(uint8_t id, int32_t velocity);
+  // Position mode (manipulator) : written once, profile is sent with the goal position
+  bool setGoalPosition(uint8_t id, int32_t position, int32_t profile_acceleration, int32_t profile_velocity);
+
+  bool write(void);
+  bool read(void);
+
+  bool isAvailable(uint8_t id);
+  uint32_t getStateStamp(void);
+  int32_t getPresentCurrent(uint8_t id);
+  int32_t getPresentVelocity(uint8_t id);
+  int32_t getPresentPosition(uint8_t id);
+
+ private:
+  dynamixel::PortHandler *portHandler_;
+  dynamixel::PacketHandler *packetHandler_;
+
+  dynamixel::GroupSyncWrite *groupSyncWriteGoal_;
+  dynamixel::GroupSyncRead *groupSyncReadState_;
+
+  uint8_t id_[BUS_SCHEDULE_DXL_MAX];
+  uint8_t id_num_;
+
+  uint8_t goal_[BUS_SCHEDULE_DXL_MAX][LEN_BUS_GOAL];
+  bool goal_changed_[BUS_SCHEDULE_DXL_MAX];
+
+  uint32_t state_stamp_;  // micros() when the last state was read
+  bool state_available_[BUS_SCHEDULE_DXL_MAX];
+  int32_t present_current_[BUS_SCHEDULE_DXL_MAX];
+  int32_t present_velocity_[BUS_SCHEDULE_DXL_MAX];
+  int32_t present_position_[BUS_SCHEDULE_DXL_MAX];
+
+  int8_t findIndex(uint8_t id);
+  void setGoalData(uint8_t index, uint16_t address, int32_t value);
+};
+
+#endif // DYNAMIXEL_BUS_SCHEDULE_H_
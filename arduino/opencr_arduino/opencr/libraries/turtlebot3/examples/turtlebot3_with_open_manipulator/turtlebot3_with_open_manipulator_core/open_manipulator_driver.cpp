@@ -19,8 +19,11 @@
 #include "open_manipulator_driver.h"
 
 OpenManipulatorDriver::OpenManipulatorDriver()
-  :torque_state_(false)
+  :bus_schedule_(NULL),
+   torque_state_(false)
 {
+  joint_profile_[0] = joint_profile_[1] = 0;
+  gripper_profile_[0] = gripper_profile_[1] = 0;
 }
 
 OpenManipulatorDriver::~OpenManipulatorDriver()
@@ -28,7 +31,7 @@ OpenManipulatorDriver::~OpenManipulatorDriver()
   closeDynamixel();
 }
 
-bool OpenManipulatorDriver::init(uint8_t *joint_id, uint8_t joint_cnt, uint8_t *gripper_id, uint8_t gripper_cnt)
+bool OpenManipulatorDriver::init(uint8_t *joint_id, uint8_t joint_cnt, uint8_t *gripper_id, uint8_t gripper_cnt, DynamixelBusSchedule *bus_schedule)
 {
   DEBUG_SERIAL.begin(57600);
 
@@ -88,6 +91,11 @@ bool OpenManipulatorDriver::init(uint8_t *joint_id, uint8_t joint_cnt, uint8_t *
           DEBUG_SERIAL.println("Succeeded to set velocity based profile mode");
         }
       }
+      else
+      {
+        // The bus schedule sends Protocol 2.0 packets only, as the wheels need
+        DEBUG_SERIAL.println("Protocol 1.0 is not supported");
+      }
 
       result = dxl_wb_.jointMode(joint_id[num], 0, 0, &log);
       if (result == false)
@@ -121,6 +129,11 @@ bool OpenManipulatorDriver::init(uint8_t *joint_id, uint8_t joint_cnt, uint8_t *
       DEBUG_SERIAL.print(" model_number : ");
       DEBUG_SERIAL.println(model_number);
 
+      if (dxl_wb_.getProtocolVersion() != 2.0f)
+      {
+        DEBUG_SERIAL.println("Protocol 1.0 is not supported");
+      }
+
       result = dxl_wb_.currentBasedPositionMode(gripper_id[num], 100, &log);
       if (result == false)
       {
@@ -152,36 +165,8 @@ bool OpenManipulatorDriver::init(uint8_t *joint_id, uint8_t joint_cnt, uint8_t *
 
   torque_state_ = true;
 
-  result = dxl_wb_.addSyncWriteHandler(joint_.id[0], "Goal_Position", &log);
-  if (result == false)
-  {
-    DEBUG_SERIAL.println(log);
-    DEBUG_SERIAL.println("Failed to add sync write handler");
-  }
-
-  if (dxl_wb_.getProtocolVersion() == 2.0f)
-  {
-    const uint8_t ADDR_PROFILE_ACCELERATION = 108;
-    const uint8_t LEN_PROFILE_ACCELERATION_PROFILE_VELOCITY = 4+4;
-    const uint8_t ADDR_PRESENT_CURRENT = 126;
-    const uint8_t LEN_PROFILE_CURRENT_VELOCITY_POSITION = 2+4+4;
-
-    result = dxl_wb_.addSyncWriteHandler(ADDR_PROFILE_ACCELERATION, LEN_PROFILE_ACCELERATION_PROFILE_VELOCITY, &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-      DEBUG_SERIAL.println("Failed to add sync write handler");
-    }
-
-    result = dxl_wb_.addSyncReadHandler(ADDR_PRESENT_CURRENT, 
-                                         LEN_PROFILE_CURRENT_VELOCITY_POSITION, 
-                                         &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-      DEBUG_SERIAL.println("Failed to add sync read handler");
-    }
-  }
+  // Goals and states are sent and read by the bus schedule, together with the wheels
+  bus_schedule_ = bus_schedule;
 
   double init_joint_position[4] = {0.0, -1.57, 1.20, 0.6};
   double init_gripper_position[1] = {0.0};
@@ -249,99 +234,20 @@ bool OpenManipulatorDriver::getTorqueState()
 
 bool OpenManipulatorDriver::syncReadDynamixelInfo(void)
 {
-  const char *log;
-  bool result = false;
-  const uint8_t HANDLER_INDEX = 0;
-
-  if (dxl_wb_.getProtocolVersion() == 2.0f)
-  {
-    result = dxl_wb_.syncRead(HANDLER_INDEX, &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-      DEBUG_SERIAL.println("Failed to sync read position");
-    }
-  }
-
+  // States are read every control tick by DynamixelBusSchedule::read()
   return true;
 }
 
 bool OpenManipulatorDriver::getPosition(double *get_data)
 {
-  const char *log;
-  bool result = false;
-  const uint8_t HANDLER_INDEX = 0;
-  const uint8_t ADDR_PRESENT_POSITION_2 = 132;
-  const uint8_t LENGTH_PRESENT_POSITION_2 = 4;
-
-  int32_t get_present_joint_position[joint_.cnt];
-  int32_t get_present_gripper_position[gripper_.cnt];
-
-  if (dxl_wb_.getProtocolVersion() == 2.0f)
+  for (uint8_t num = 0; num < joint_.cnt; num++)
   {
-    result = dxl_wb_.getSyncReadData(HANDLER_INDEX, 
-                                    &joint_.id[0], 
-                                    joint_.cnt, 
-                                    ADDR_PRESENT_POSITION_2,
-                                    LENGTH_PRESENT_POSITION_2,
-                                    &get_present_joint_position[0], 
-                                    &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-    }
-
-    result = dxl_wb_.getSyncReadData(HANDLER_INDEX, 
-                                &gripper_.id[0], 
-                                gripper_.cnt, 
-                                ADDR_PRESENT_POSITION_2,
-                                LENGTH_PRESENT_POSITION_2,
-                                &get_present_gripper_position[0], 
-                                &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-    }
-
-    for (uint8_t num = 0; num < joint_.cnt; num++)
-    {
-      get_data[num] = dxl_wb_.convertValue2Radian(joint_.id[num], get_present_joint_position[num]);
-    }
-
-    for (uint8_t num = 0; num < gripper_.cnt; num++)
-    {
-      get_data[joint_.cnt + num] = dxl_wb_.convertValue2Radian(gripper_.id[num], get_present_gripper_position[num]);
-    }  
+    get_data[num] = dxl_wb_.convertValue2Radian(joint_.id[num], bus_schedule_->getPresentPosition(joint_.id[num]));
   }
-  else if (dxl_wb_.getProtocolVersion() == 1.0f)
-  {
-    for (uint8_t num = 0; num < joint_.cnt; num++)
-    {
-      result = dxl_wb_.itemRead(joint_.id[num], "Present_Position", &get_present_joint_position[num], &log);
-      if (result == false)
-      {
-        DEBUG_SERIAL.println(log);
-        DEBUG_SERIAL.println("Failed to get joint present position");
-      }
-      else
-      {
-        get_data[num] = dxl_wb_.convertValue2Radian(joint_.id[num], get_present_joint_position[num]);
-      }
-    }
 
-    for (uint8_t num = 0; num < gripper_.cnt; num++)
-    {
-      result = dxl_wb_.itemRead(gripper_.id[num], "Present_Position", &get_present_gripper_position[num], &log);
-      if (result == false)
-      {
-        DEBUG_SERIAL.println(log);
-        DEBUG_SERIAL.println("Failed to get gripper present position");
-      }
-      else
-      {
-        get_data[joint_.cnt + num] = dxl_wb_.convertValue2Radian(gripper_.id[num], get_present_gripper_position[num]);
-      }
-    }
+  for (uint8_t num = 0; num < gripper_.cnt; num++)
+  {
+    get_data[joint_.cnt + num] = dxl_wb_.convertValue2Radian(gripper_.id[num], bus_schedule_->getPresentPosition(gripper_.id[num]));
   }
 
   return true;
@@ -349,54 +255,14 @@ bool OpenManipulatorDriver::getPosition(double *get_data)
 
 bool OpenManipulatorDriver::getVelocity(double *get_data)
 {
-  const char *log;
-  bool result = false;
-  const uint8_t HANDLER_INDEX = 0;
-  const uint8_t ADDR_PRESENT_VELOCITY_2 = 128;
-  const uint8_t LENGTH_PRESENT_VELOCITY_2 = 4;
-
-  int32_t get_present_joint_velocity[joint_.cnt];
-  int32_t get_present_gripper_velocity[gripper_.cnt];
-
-  if (dxl_wb_.getProtocolVersion() == 2.0f)
+  for (uint8_t num = 0; num < joint_.cnt; num++)
   {
-    result = dxl_wb_.getSyncReadData(HANDLER_INDEX, 
-                                    &joint_.id[0], 
-                                    joint_.cnt, 
-                                    ADDR_PRESENT_VELOCITY_2,
-                                    LENGTH_PRESENT_VELOCITY_2,
-                                    &get_present_joint_velocity[0], 
-                                    &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-    }
-
-    result = dxl_wb_.getSyncReadData(HANDLER_INDEX, 
-                                &gripper_.id[0], 
-                                gripper_.cnt, 
-                                ADDR_PRESENT_VELOCITY_2,
-                                LENGTH_PRESENT_VELOCITY_2,
-                                &get_present_gripper_velocity[0], 
-                                &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-    }
-
-    for (uint8_t num = 0; num < joint_.cnt; num++)
-    {
-      get_data[num] = dxl_wb_.convertValue2Velocity(joint_.id[num], get_present_joint_velocity[num]);
-    }
-
-    for (uint8_t num = 0; num < gripper_.cnt; num++)
-    {
-      get_data[joint_.cnt + num] = dxl_wb_.convertValue2Velocity(gripper_.id[num], get_present_gripper_velocity[num]);
-    } 
+    get_data[num] = dxl_wb_.convertValue2Velocity(joint_.id[num], bus_schedule_->getPresentVelocity(joint_.id[num]));
   }
-  else
+
+  for (uint8_t num = 0; num < gripper_.cnt; num++)
   {
-    return false;
+    get_data[joint_.cnt + num] = dxl_wb_.convertValue2Velocity(gripper_.id[num], bus_schedule_->getPresentVelocity(gripper_.id[num]));
   }
 
   return true;
@@ -404,54 +270,14 @@ bool OpenManipulatorDriver::getVelocity(double *get_data)
 
 bool OpenManipulatorDriver::getCurrent(double *get_data)
 {
-  const char *log;
-  bool result = false;
-  const uint8_t HANDLER_INDEX = 0;
-  const uint8_t ADDR_PRESENT_CURRENT_2 = 126;
-  const uint8_t LENGTH_PRESENT_CURRENT_2 = 2;
-
-  int32_t get_present_joint_current[joint_.cnt];
-  int32_t get_present_gripper_current[gripper_.cnt];
-
-  if (dxl_wb_.getProtocolVersion() == 2.0f)
+  for (uint8_t num = 0; num < joint_.cnt; num++)
   {
-    result = dxl_wb_.getSyncReadData(HANDLER_INDEX, 
-                                    &joint_.id[0], 
-                                    joint_.cnt, 
-                                    ADDR_PRESENT_CURRENT_2,
-                                    LENGTH_PRESENT_CURRENT_2,
-                                    &get_present_joint_current[0], 
-                                    &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-    }
-
-    result = dxl_wb_.getSyncReadData(HANDLER_INDEX, 
-                                &gripper_.id[0], 
-                                gripper_.cnt, 
-                                ADDR_PRESENT_CURRENT_2,
-                                LENGTH_PRESENT_CURRENT_2,
-                                &get_present_gripper_current[0], 
-                                &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-    }
-
-    for (uint8_t num = 0; num < joint_.cnt; num++)
-    {
-      get_data[num] = dxl_wb_.convertValue2Current(get_present_joint_current[num]);
-    }
-
-    for (uint8_t num = 0; num < gripper_.cnt; num++)
-    {
-      get_data[joint_.cnt + num] = dxl_wb_.convertValue2Current(get_present_gripper_current[num]);
-    }  
+    get_data[num] = dxl_wb_.convertValue2Current(bus_schedule_->getPresentCurrent(joint_.id[num]));
   }
-  else
+
+  for (uint8_t num = 0; num < gripper_.cnt; num++)
   {
-    return false;
+    get_data[joint_.cnt + num] = dxl_wb_.convertValue2Current(bus_schedule_->getPresentCurrent(gripper_.id[num]));
   }
 
   return true;
@@ -459,51 +285,27 @@ bool OpenManipulatorDriver::getCurrent(double *get_data)
 
 bool OpenManipulatorDriver::writeJointProfileControlParam(double set_time, double acc)
 {
-  const char *log;
-  bool result = false;
-  const uint8_t HANDLER_INDEX = 1;
-  int32_t goal_data[joint_.cnt*2];
-
-  for (uint8_t num = 0; num < joint_.cnt * 2; num = num + 2)
-  {
-    goal_data[num] = acc * 1000;
-    goal_data[num+1] = set_time * 1000;
-  }
-
-  if (dxl_wb_.getProtocolVersion() == 2.0f)
-  {
-    result = dxl_wb_.syncWrite(HANDLER_INDEX, joint_.id, joint_.cnt, &goal_data[0], 2, &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-      DEBUG_SERIAL.println("Failed to sync write param for profile");
-    }
-  }
-  else
-  {
-    return false;
-  }
+  // Sent with the next goal position
+  joint_profile_[0] = acc * 1000;
+  joint_profile_[1] = set_time * 1000;
 
   return true;
 }
 
 bool OpenManipulatorDriver::writeJointPosition(double *set_data)
 {
-  const char *log;
   bool result = false;
-  const uint8_t HANDLER_INDEX = 0;
-  int32_t goal_position[joint_.cnt];
 
   for (int num = 0; num < joint_.cnt; num++)
   {
-    goal_position[num] = dxl_wb_.convertRadian2Value(joint_.id[num], set_data[num]);
-  }
-
-  result = dxl_wb_.syncWrite(HANDLER_INDEX, joint_.id, joint_.cnt, &goal_position[0], 1, &log);
-  if (result == false)
-  {
-    DEBUG_SERIAL.println(log);
-    DEBUG_SERIAL.println("Failed to sync write position");
+    result = bus_schedule_->setGoalPosition(joint_.id[num],
+                                            dxl_wb_.convertRadian2Value(joint_.id[num], set_data[num]),
+                                            joint_profile_[0],
+                                            joint_profile_[1]);
+    if (result == false)
+    {
+      DEBUG_SERIAL.println("Failed to set goal position");
+    }
   }
 
   return true;
@@ -511,52 +313,28 @@ bool OpenManipulatorDriver::writeJointPosition(double *set_data)
 
 bool OpenManipulatorDriver::writeGripperProfileControlParam(double set_time)
 {
-  const char *log;
-  bool result = false;
-  const uint8_t HANDLER_INDEX = 1;
-  int32_t goal_data[gripper_.cnt*2];
-
-  for (uint8_t num = 0; num < gripper_.cnt; num++)
-  {
-    goal_data[num] = (set_time * 1000) / 4;
-    goal_data[num+1] = set_time * 1000;
-  }
-
-  if (dxl_wb_.getProtocolVersion() == 2.0f)
-  {
-    result = dxl_wb_.syncWrite(HANDLER_INDEX, gripper_.id, gripper_.cnt, &goal_data[0], 2, &log);
-    if (result == false)
-    {
-      DEBUG_SERIAL.println(log);
-      DEBUG_SERIAL.println("Failed to sync write param for profile");
-    }
-  }
-  else
-  {
-    return false;
-  }
+  // Sent with the next goal position
+  gripper_profile_[0] = (set_time * 1000) / 4;
+  gripper_profile_[1] = set_time * 1000;
 
   return true;
 }
 
 bool OpenManipulatorDriver::writeGripperPosition(double *set_data)
 {
-  const char *log;
   bool result = false;
-  const uint8_t HANDLER_INDEX = 0;
-  int32_t goal_position[gripper_.cnt];
 
   for (int num = 0; num < gripper_.cnt; num++)
   {
-    goal_position[num] = dxl_wb_.convertRadian2Value(gripper_.id[num], set_data[num]);
-  }
-
-  result = dxl_wb_.syncWrite(HANDLER_INDEX, gripper_.id, gripper_.cnt, &goal_position[0], 1, &log);
-  if (result == false)
-  {
-    DEBUG_SERIAL.println(log);
-    DEBUG_SERIAL.println("Failed to sync write position");
+    result = bus_schedule_->setGoalPosition(gripper_.id[num],
+                                            dxl_wb_.convertRadian2Value(gripper_.id[num], set_data[num]),
+                                            gripper_profile_[0],
+                                            gripper_profile_[1]);
+    if (result == false)
+    {
+      DEBUG_SERIAL.println("Failed to set goal position");
+    }
   }
 
   return true;
-}
\ No newline at end of file
+}
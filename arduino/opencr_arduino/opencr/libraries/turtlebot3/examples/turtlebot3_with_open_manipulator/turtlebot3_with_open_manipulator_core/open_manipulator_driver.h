@@ -20,6 +20,7 @@
 #define OPEN_MANIPULATOR_DRIVER_H_
 
 #include <DynamixelWorkbench.h>
+#include "dynamixel_bus_schedule.h"
 
 #define BAUDRATE                        1000000 // baurd rate of Dynamixel
 #define DEVICENAME                      ""      // no need setting on OpenCR
@@ -47,7 +48,7 @@ class OpenManipulatorDriver
   OpenManipulatorDriver();
   ~OpenManipulatorDriver();
 
-  bool init(uint8_t *joint_id, uint8_t joint_cnt, uint8_t *gripper_id, uint8_t gripper_cnt);
+  bool init(uint8_t *joint_id, uint8_t joint_cnt, uint8_t *gripper_id, uint8_t gripper_cnt, DynamixelBusSchedule *bus_schedule);
   void closeDynamixel(void);
   bool setTorque(bool onoff);
   bool getTorqueState(void);
@@ -62,11 +63,16 @@ class OpenManipulatorDriver
 
  private:
   DynamixelWorkbench dxl_wb_;
+  DynamixelBusSchedule *bus_schedule_;
 
   Dynamixel joint_;
   Dynamixel gripper_;
 
   bool torque_state_;
+
+  // Profile Acceleration and Profile Velocity sent with the next goal position
+  int32_t joint_profile_[2];
+  int32_t gripper_profile_[2];
 };
 
 #endif // OPEN_MANIPULATOR_DRIVER_H_
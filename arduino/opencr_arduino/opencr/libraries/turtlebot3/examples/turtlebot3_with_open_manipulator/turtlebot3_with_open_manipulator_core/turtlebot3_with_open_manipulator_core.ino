@@ -47,11 +47,22 @@ void setup()
   nh.advertise(battery_state_pub);
   nh.advertise(mag_pub);
 
+  // Frames wait in the transmit queue when USB is busy, only the latest sensor data is kept
+  nh.setTxPriority(cmd_vel_rc100_pub, ros::TX_PRIORITY_HIGH);
+  nh.setTxPriority(imu_pub, ros::TX_PRIORITY_NORMAL, true);
+  nh.setTxPriority(mag_pub, ros::TX_PRIORITY_NORMAL, true);
+  nh.setTxPriority(odom_pub, ros::TX_PRIORITY_NORMAL, true);
+  nh.setTxPriority(joint_states_pub, ros::TX_PRIORITY_NORMAL, true);
+  nh.setTxPriority(sensor_state_pub, ros::TX_PRIORITY_LOW, true);
+  nh.setTxPriority(battery_state_pub, ros::TX_PRIORITY_LOW, true);
+  nh.setTxPriority(version_info_pub, ros::TX_PRIORITY_LOW);
+
   tf_broadcaster.init(nh);
 
   // Setting for Dynamixel motors
   motor_driver.init(NAME);
-  manipulator_driver.init(&joint_id[0], joint_cnt, &gripper_id[0], gripper_cnt);
+  bus_schedule.init(motor_driver.getPortHandler(), &bus_id[0], WHEEL_NUM + joint_cnt + gripper_cnt);
+  manipulator_driver.init(&joint_id[0], joint_cnt, &gripper_id[0], gripper_cnt, &bus_schedule);
 
   // Setting for IMU
   sensors.init();
@@ -80,14 +91,13 @@ void setup()
 void loop()
 {
   uint32_t t = millis();
-  updateTime();
   updateVariable(nh.connected());
   updateTFPrefix(nh.connected());
 
   if ((t-tTime[0]) >= (1000 / CONTROL_MOTOR_SPEED_FREQUENCY))
   {
     updateGoalVelocity();
-    motor_driver.controlMotor(WHEEL_RADIUS, WHEEL_SEPARATION, goal_velocity);
+    controlDynamixel();
     tTime[0] = t;
   }
 
@@ -255,9 +265,6 @@ void resetCallback(const std_msgs::Empty& reset_msg)
 
   sensors.calibrationGyro();
 
-  sprintf(log_msg, "Calibration End");
-  nh.loginfo(log_msg);
-
   initOdom();
 
   sprintf(log_msg, "Reset Odometry");
@@ -280,12 +287,38 @@ void publishCmdVelFromRC100Msg(void)
 *******************************************************************************/
 void publishImuMsg(void)
 {
+  static int offset_orientation         = 0;
+  static int offset_angular_velocity    = 0;
+  static int offset_linear_acceleration = 0;
+
   imu_msg = sensors.getIMU();
 
-  imu_msg.header.stamp    = rosNow();
+  imu_msg.header.stamp    = rosTime(sensors.getIMUStamp());
   imu_msg.header.frame_id = imu_frame_id;
 
-  imu_pub.publish(&imu_msg);
+  // Frame id and covariances do not change, only the measurements are written again
+  if (imu_prepared.isPrepared() == false)
+  {
+    if (imu_pub.prepare(imu_prepared, &imu_msg) == false)
+    {
+      imu_pub.publish(&imu_msg);
+      return;
+    }
+
+    // header | orientation | covariance[9] | angular_velocity | covariance[9] | linear_acceleration | covariance[9]
+    offset_orientation         = headerLength(imu_frame_id);
+    offset_angular_velocity    = offset_orientation + 32 + 72;
+    offset_linear_acceleration = offset_angular_velocity + 24 + 72;
+  }
+  else
+  {
+    imu_prepared.setTime(HEADER_STAMP_OFFSET, imu_msg.header.stamp);
+    imu_prepared.setMsg(offset_orientation, imu_msg.orientation);
+    imu_prepared.setMsg(offset_angular_velocity, imu_msg.angular_velocity);
+    imu_prepared.setMsg(offset_linear_acceleration, imu_msg.linear_acceleration);
+  }
+
+  imu_pub.publish(imu_prepared);
 }
 
 /*******************************************************************************
@@ -295,7 +328,7 @@ void publishMagMsg(void)
 {
   mag_msg = sensors.getMag();
 
-  mag_msg.header.stamp    = rosNow();
+  mag_msg.header.stamp    = rosTime(sensors.getIMUStamp());
   mag_msg.header.frame_id = mag_frame_id;
 
   mag_pub.publish(&mag_msg);
@@ -311,7 +344,7 @@ void publishSensorStateMsg(void)
   sensor_state_msg.header.stamp = rosNow();
   sensor_state_msg.battery = sensors.checkVoltage();
 
-  dxl_comm_result = motor_driver.readEncoder(sensor_state_msg.left_encoder, sensor_state_msg.right_encoder);
+  dxl_comm_result = readWheelEncoder(sensor_state_msg.left_encoder, sensor_state_msg.right_encoder);
 
   if (dxl_comm_result == true)
     updateMotorInfo(sensor_state_msg.left_encoder, sensor_state_msg.right_encoder);
@@ -373,7 +406,13 @@ void publishDriveInformation(void)
   unsigned long step_time = time_now - prev_update_time;
 
   prev_update_time = time_now;
-  ros::Time stamp_now = rosNow();
+
+  // Stamp with the time the DYNAMIXELs were read, not the time of publishing
+  ros::Time stamp_now;
+  if (bus_schedule.getStateStamp() != 0)
+    stamp_now = rosTime(bus_schedule.getStateStamp());
+  else
+    stamp_now = rosNow();
 
   // calculate odometry
   calcOdometry((double)(step_time * 0.001));
@@ -381,7 +420,7 @@ void publishDriveInformation(void)
   // odometry
   updateOdometry();
   odom.header.stamp = stamp_now;
-  odom_pub.publish(&odom);
+  publishOdomMsg();
 
   // odometry tf
   updateTF(odom_tf);
@@ -394,6 +433,44 @@ void publishDriveInformation(void)
   joint_states_pub.publish(&joint_states);
 }
 
+/*******************************************************************************
+* Publish msgs (odometry, only pose and twist are written again)
+*******************************************************************************/
+void publishOdomMsg(void)
+{
+  static int offset_pose  = 0;
+  static int offset_twist = 0;
+
+  if (odom_prepared.isPrepared() == false)
+  {
+    if (odom_pub.prepare(odom_prepared, &odom) == false)
+    {
+      odom_pub.publish(&odom);
+      return;
+    }
+
+    // header | child_frame_id | pose | covariance[36] | twist | covariance[36]
+    offset_pose  = headerLength(odom_header_frame_id) + 4 + strlen(odom_child_frame_id);
+    offset_twist = offset_pose + 56 + 288;
+  }
+  else
+  {
+    odom_prepared.setTime(HEADER_STAMP_OFFSET, odom.header.stamp);
+    odom_prepared.setMsg(offset_pose, odom.pose.pose);
+    odom_prepared.setMsg(offset_twist, odom.twist.twist);
+  }
+
+  odom_pub.publish(odom_prepared);
+}
+
+/*******************************************************************************
+* Serialized length of std_msgs/Header (seq, stamp, frame_id)
+*******************************************************************************/
+int headerLength(const char* frame_id)
+{
+  return 4 + 8 + 4 + strlen(frame_id);
+}
+
 /*******************************************************************************
 * Update TF Prefix
 *******************************************************************************/
@@ -434,6 +511,10 @@ void updateTFPrefix(bool isConnected)
         strcat(joint_state_header_frame_id, "/base_link");
       }
 
+      // Frame ids are serialized in the prepared messages
+      imu_prepared.invalidate();
+      odom_prepared.invalidate();
+
       sprintf(log_msg, "Setup TF on Odometry [%s]", odom_header_frame_id);
       nh.loginfo(log_msg); 
 
@@ -487,7 +568,6 @@ void updateJointStates(void)
   double get_joint_velocity[joint_cnt + gripper_cnt];
   double get_joint_current[joint_cnt + gripper_cnt];
 
-  manipulator_driver.syncReadDynamixelInfo();
   manipulator_driver.getPosition(get_joint_position);
   manipulator_driver.getVelocity(get_joint_velocity);
   manipulator_driver.getCurrent(get_joint_current);
@@ -690,6 +770,32 @@ void jointControl(void)
   }
 }
 
+/*******************************************************************************
+* Wheels and manipulator bus tick (one sync write of goals, one sync read of states)
+*******************************************************************************/
+void controlDynamixel(void)
+{
+  int32_t wheel_goal_velocity[WHEEL_NUM] = {0, 0};
+
+  motor_driver.calcGoalVelocity(WHEEL_RADIUS, WHEEL_SEPARATION, goal_velocity, wheel_goal_velocity[LEFT], wheel_goal_velocity[RIGHT]);
+  bus_schedule.setGoalVelocity(DXL_LEFT_ID, wheel_goal_velocity[LEFT]);
+  bus_schedule.setGoalVelocity(DXL_RIGHT_ID, wheel_goal_velocity[RIGHT]);
+
+  bus_schedule.write();
+  bus_schedule.read();
+}
+
+bool readWheelEncoder(int32_t &left_value, int32_t &right_value)
+{
+  if (bus_schedule.isAvailable(DXL_LEFT_ID) == false || bus_schedule.isAvailable(DXL_RIGHT_ID) == false)
+    return false;
+
+  left_value  = bus_schedule.getPresentPosition(DXL_LEFT_ID);
+  right_value = bus_schedule.getPresentPosition(DXL_RIGHT_ID);
+
+  return true;
+}
+
 /*******************************************************************************
 * Turtlebot3 test drive using push buttons
 *******************************************************************************/
@@ -701,7 +807,7 @@ void driveTest(uint8_t buttons)
 
   int32_t current_tick[2] = {0, 0};
 
-  motor_driver.readEncoder(current_tick[LEFT], current_tick[RIGHT]);
+  readWheelEncoder(current_tick[LEFT], current_tick[RIGHT]);
 
   if (buttons & (1<<0))  
   {
@@ -789,15 +895,6 @@ void waitForSerialLink(bool isConnected)
   }
 }
 
-/*******************************************************************************
-* Update the base time for interpolation
-*******************************************************************************/
-void updateTime()
-{
-  current_offset = millis();
-  current_time = nh.now();
-}
-
 /*******************************************************************************
 * ros::Time::now() implementation
 *******************************************************************************/
@@ -807,16 +904,11 @@ ros::Time rosNow()
 }
 
 /*******************************************************************************
-* Time Interpolation function (deprecated)
+* ROS time of a local timestamp (micros) taken when the data was sampled
 *******************************************************************************/
-ros::Time addMicros(ros::Time & t, uint32_t _micros)
+ros::Time rosTime(uint32_t stamp_us)
 {
-  uint32_t sec, nsec;
-
-  sec  = _micros / 1000 + t.sec;
-  nsec = _micros % 1000000000 + t.nsec;
-
-  return ros::Time(sec, nsec);
+  return nh.toTime(stamp_us);
 }
 
 /*******************************************************************************
@@ -824,27 +916,39 @@ ros::Time addMicros(ros::Time & t, uint32_t _micros)
 *******************************************************************************/
 void updateGyroCali(void)
 {
-  static bool isEnded = false;
+  static bool isStarted = false;
+  static bool isCalibrating = false;
   char log_msg[50];
 
   if (nh.connected())
   {
-    if (isEnded == false)
+    if (isStarted == false)
     {
       sprintf(log_msg, "Start Calibration of Gyro");
       nh.loginfo(log_msg);
 
+      // Goes on with the IMU samples, ROS and the motors are serviced meanwhile
       sensors.calibrationGyro();
 
-      sprintf(log_msg, "Calibration End");
-      nh.loginfo(log_msg);
-
-      isEnded = true;
+      isStarted = true;
     }
   }
   else
   {
-    isEnded = false;
+    isStarted = false;
+  }
+
+  // Also the end of the calibration started by resetCallback()
+  if (sensors.isCalibratingGyro() == true)
+  {
+    isCalibrating = true;
+  }
+  else if (isCalibrating == true)
+  {
+    sprintf(log_msg, "Calibration End");
+    nh.loginfo(log_msg);
+
+    isCalibrating = false;
   }
 }
 
@@ -979,7 +1083,7 @@ void sendDebuglog(void)
   DEBUG_SERIAL.println("Torque(joint) : " + String(manipulator_driver.getTorqueState()));
 
   int32_t encoder[WHEEL_NUM] = {0, 0};
-  motor_driver.readEncoder(encoder[LEFT], encoder[RIGHT]);
+  readWheelEncoder(encoder[LEFT], encoder[RIGHT]);
   
   DEBUG_SERIAL.println("Encoder(left) : " + String(encoder[LEFT]));
   DEBUG_SERIAL.println("Encoder(right) : " + String(encoder[RIGHT]));
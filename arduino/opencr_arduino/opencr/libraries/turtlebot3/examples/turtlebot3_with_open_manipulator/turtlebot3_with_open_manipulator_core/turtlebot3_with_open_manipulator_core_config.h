@@ -45,7 +45,7 @@
 
 #define FIRMWARE_VER "2.0.2"
 
-#define CONTROL_MOTOR_SPEED_FREQUENCY          30   //hz
+#define CONTROL_MOTOR_SPEED_FREQUENCY          100  //hz, wheels and manipulator share this bus tick
 #define IMU_PUBLISH_FREQUENCY                  200  //hz
 #define CMD_VEL_PUBLISH_FREQUENCY              30   //hz
 #define DRIVE_INFORMATION_PUBLISH_FREQUENCY    30   //hz
@@ -90,13 +90,14 @@ void publishSensorStateMsg(void);
 void publishVersionInfoMsg(void);
 void publishBatteryStateMsg(void);
 void publishDriveInformation(void);
+void publishOdomMsg(void);
+int  headerLength(const char* frame_id);
 
 ros::Time rosNow(void);
-ros::Time addMicros(ros::Time & t, uint32_t _micros); // deprecated
+ros::Time rosTime(uint32_t stamp_us);
 
 void updateVariable(bool isConnected);
 void updateMotorInfo(int32_t left_tick, int32_t right_tick);
-void updateTime(void);
 void updateOdometry(void);
 void updateJoint(void);
 void updateTF(geometry_msgs::TransformStamped& odom_tf);
@@ -110,6 +111,8 @@ void initJointStates(void);
 bool calcOdometry(double diff_time);
 
 void jointControl(void);
+void controlDynamixel(void);
+bool readWheelEncoder(int32_t &left_value, int32_t &right_value);
 
 void sendLogMsg(void);
 void waitForSerialLink(bool isConnected);
@@ -120,8 +123,6 @@ double mapd(double x, double in_min, double in_max, double out_min, double out_m
 * ROS NodeHandle
 *******************************************************************************/
 ros::NodeHandle nh;
-ros::Time current_time;
-uint32_t current_offset;
 
 /*******************************************************************************
 * ROS Parameter
@@ -195,6 +196,14 @@ ros::Publisher battery_state_pub("battery_state", &battery_state_msg);
 sensor_msgs::MagneticField mag_msg;
 ros::Publisher mag_pub("magnetic_field", &mag_msg);
 
+/*******************************************************************************
+* Prepared messages (serialized once, then only the measurements are written)
+*******************************************************************************/
+#define HEADER_STAMP_OFFSET                4    // std_msgs/Header : seq, stamp, frame_id
+
+ros::PreparedMsg<384> imu_prepared;             // 349 bytes with 29 bytes frame id
+ros::PreparedMsg<800> odom_prepared;            // 766 bytes with 29 bytes frame ids
+
 /*******************************************************************************
 * Transform Broadcaster
 *******************************************************************************/
@@ -212,6 +221,7 @@ static uint32_t tTime[10];
 *******************************************************************************/
 Turtlebot3MotorDriver motor_driver;
 OpenManipulatorDriver manipulator_driver;
+DynamixelBusSchedule bus_schedule;
 
 uint8_t joint_id[JOINT_CNT] = {JOINT_ID_1, JOINT_ID_2, JOINT_ID_3, JOINT_ID_4};
 uint8_t joint_cnt = JOINT_CNT;
@@ -219,6 +229,8 @@ uint8_t joint_cnt = JOINT_CNT;
 uint8_t gripper_id[GRIPPER_CNT] = {GRIPPER_ID_1};
 uint8_t gripper_cnt = GRIPPER_CNT;
 
+uint8_t bus_id[WHEEL_NUM + JOINT_CNT + GRIPPER_CNT] = {DXL_LEFT_ID, DXL_RIGHT_ID, JOINT_ID_1, JOINT_ID_2, JOINT_ID_3, JOINT_ID_4, GRIPPER_ID_1};
+
 /*******************************************************************************
 * Calculation for odometry
 *******************************************************************************/
@@ -2,3 +2,4 @@
 #include "turtlebot3_sensor.h"
 #include "turtlebot3_controller.h"
 #include "turtlebot3_diagnosis.h"
+#include "turtlebot3_odometry.h"
@@ -20,6 +20,7 @@
 #define TURTLEBOT3_DIAGNOSIS_H_
 
 #include <Arduino.h>
+#include <SignalFilter.h>
 
 #define LED_TXD                          0
 #define LED_RXD                          1
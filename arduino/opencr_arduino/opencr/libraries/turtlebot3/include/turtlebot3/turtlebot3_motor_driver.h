@@ -72,8 +72,10 @@ class Turtlebot3MotorDriver
   void close(void);
   bool setTorque(bool onoff);
   bool getTorque();
+  dynamixel::PortHandler *getPortHandler(void);
   bool readEncoder(int32_t &left_value, int32_t &right_value);
   bool writeVelocity(int64_t left_value, int64_t right_value);
+  void calcGoalVelocity(const float wheel_radius, const float wheel_separation, float* value, int32_t &left_value, int32_t &right_value);
   bool controlMotor(const float wheel_radius, const float wheel_separation, float* value);
 
  private:
@@ -0,0 +1,106 @@
+/*******************************************************************************
+* Copyright 2016 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Yoonseok Pyo, Leon Jung, Darby Lim, HanCheol Cho, Gilbert */
+
+#ifndef TURTLEBOT3_ODOMETRY_H_
+#define TURTLEBOT3_ODOMETRY_H_
+
+#include <stdint.h>
+#include <math.h>
+
+#define ODOMETRY_HISTORY_SIZE            32
+
+#define ODOMETRY_WHEEL_NUM               2
+#define ODOMETRY_WHEEL_LEFT              0
+#define ODOMETRY_WHEEL_RIGHT             1
+
+typedef enum ODOMETRY_FUSION
+{
+  ODOMETRY_FUSION_WHEEL = 0,       // heading from wheel ticks only
+  ODOMETRY_FUSION_IMU_YAW,         // heading from IMU orientation
+  ODOMETRY_FUSION_COMPLEMENTARY,   // gyro rate blended with wheel heading rate
+  ODOMETRY_FUSION_EKF              // heading and gyro bias, corrected by wheel heading rate
+}OdometryFusion;
+
+typedef struct ODOMETRY_POSE
+{
+  uint32_t stamp;           // us
+  float x;                  // m
+  float y;                  // m
+  float theta;              // rad, -pi ~ pi
+  float linear_velocity;    // m/s
+  float angular_velocity;   // rad/s
+}OdometryPose;
+
+class Turtlebot3Odometry
+{
+ public:
+  Turtlebot3Odometry();
+  ~Turtlebot3Odometry();
+
+  bool init(float wheel_radius, float wheel_separation, float tick_to_rad);
+  void reset(void);
+
+  // gain : weight of gyro rate for ODOMETRY_FUSION_COMPLEMENTARY
+  void setFusion(OdometryFusion fusion, float gain = 0.98f);
+  // Standard deviations of gyro rate [rad/s], gyro bias random walk [rad/s/sqrt(s)] and wheel heading rate [rad/s]
+  void setEkfNoise(float gyro_noise, float bias_noise, float wheel_noise);
+
+  // Called every control tick. Ticks may wrap around int32_t.
+  bool update(int32_t left_tick, int32_t right_tick, float gyro_z, float imu_yaw, uint32_t stamp);
+
+  OdometryPose getPose(void);
+  bool getPose(uint32_t stamp, OdometryPose *pose);
+
+  void getWheelState(float *angle, float *velocity);
+  float getGyroBias(void);
+
+ private:
+  float wheel_radius_;
+  float wheel_separation_;
+  float tick_to_rad_;
+
+  OdometryFusion fusion_;
+  float complementary_gain_;
+
+  bool init_tick_;
+  int32_t last_tick_[ODOMETRY_WHEEL_NUM];
+  uint32_t last_stamp_;
+  float last_imu_yaw_;
+
+  float wheel_angle_[ODOMETRY_WHEEL_NUM];
+  float wheel_velocity_[ODOMETRY_WHEEL_NUM];
+
+  OdometryPose pose_;
+
+  // EKF state [theta, gyro bias] and covariance
+  float gyro_bias_;
+  float cov_[2][2];
+  float gyro_noise_;
+  float bias_noise_;
+  float wheel_noise_;
+
+  OdometryPose history_[ODOMETRY_HISTORY_SIZE];
+  uint8_t history_head_;
+  uint8_t history_count_;
+
+  float updateHeadingEKF(float gyro_z, float wheel_rate, float dt);
+  void pushHistory(void);
+  float normalizeAngle(float angle);
+};
+
+#endif // TURTLEBOT3_ODOMETRY_H_
@@ -67,9 +67,12 @@ class Turtlebot3Sensor
   void initIMU(void);
   sensor_msgs::Imu getIMU(void);
   void updateIMU(void);
+  uint32_t getIMUStamp(void);
   void calibrationGyro(void);
+  bool isCalibratingGyro(void);
 
   float* getOrientation(void);
+  float getYawRate(void);
   sensor_msgs::MagneticField getMag(void);
 
   // Battery
@@ -111,6 +114,7 @@ class Turtlebot3Sensor
   sensor_msgs::MagneticField mag_msg_;
 
   cIMU imu_;
+  uint32_t imu_stamp_;  // micros() when the last IMU sample was taken
   OLLO ollo_;
 
   LedPinArray led_pin_array_;
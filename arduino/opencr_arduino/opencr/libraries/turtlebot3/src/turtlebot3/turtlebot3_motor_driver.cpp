@@ -58,7 +58,15 @@ bool Turtlebot3MotorDriver::init(String turtlebot3)
 
   groupSyncWriteVelocity_ = new dynamixel::GroupSyncWrite(portHandler_, packetHandler_, ADDR_X_GOAL_VELOCITY, LEN_X_GOAL_VELOCITY);
   groupSyncReadEncoder_   = new dynamixel::GroupSyncRead(portHandler_, packetHandler_, ADDR_X_PRESENT_POSITION, LEN_X_PRESENT_POSITION);
-  
+
+  // Register wheels once, readEncoder only re-sends the sync read packet
+  uint8_t wheel_id[2] = {left_wheel_id_, right_wheel_id_};
+  if (groupSyncReadEncoder_->setParam(wheel_id, 2) == false)
+  {
+    DEBUG_SERIAL.println("Failed to add sync read param(Motor Driver)");
+    return false;
+  }
+
   if (turtlebot3 == "Burger")
     dynamixel_limit_max_velocity_ = BURGER_DXL_LIMIT_MAX_VELOCITY;
   else if (turtlebot3 == "Waffle or Waffle Pi")
@@ -80,24 +88,24 @@ bool Turtlebot3MotorDriver::setTorque(bool onoff)
   dxl_comm_result = packetHandler_->write1ByteTxRx(portHandler_, DXL_LEFT_ID, ADDR_X_TORQUE_ENABLE, onoff, &dxl_error);
   if(dxl_comm_result != COMM_SUCCESS)
   {
-    Serial.println(packetHandler_->getTxRxResult(dxl_comm_result));
+    DEBUG_SERIAL.println(packetHandler_->getTxRxResult(dxl_comm_result));
     return false;
   }
   else if(dxl_error != 0)
   {
-    Serial.println(packetHandler_->getRxPacketError(dxl_error));
+    DEBUG_SERIAL.println(packetHandler_->getRxPacketError(dxl_error));
     return false;
   }
 
   dxl_comm_result = packetHandler_->write1ByteTxRx(portHandler_, DXL_RIGHT_ID, ADDR_X_TORQUE_ENABLE, onoff, &dxl_error);
   if(dxl_comm_result != COMM_SUCCESS)
   {
-    Serial.println(packetHandler_->getTxRxResult(dxl_comm_result));
+    DEBUG_SERIAL.println(packetHandler_->getTxRxResult(dxl_comm_result));
     return false;
   }
   else if(dxl_error != 0)
   {
-    Serial.println(packetHandler_->getRxPacketError(dxl_error));
+    DEBUG_SERIAL.println(packetHandler_->getRxPacketError(dxl_error));
     return false;
   }
 
@@ -109,6 +117,12 @@ bool Turtlebot3MotorDriver::getTorque()
   return torque_;
 }
 
+// Opened and powered by init()
+dynamixel::PortHandler *Turtlebot3MotorDriver::getPortHandler(void)
+{
+  return portHandler_;
+}
+
 void Turtlebot3MotorDriver::close(void)
 {
   // Disable Dynamixel Torque
@@ -122,22 +136,12 @@ void Turtlebot3MotorDriver::close(void)
 bool Turtlebot3MotorDriver::readEncoder(int32_t &left_value, int32_t &right_value)
 {
   int dxl_comm_result = COMM_TX_FAIL;              // Communication result
-  bool dxl_addparam_result = false;                // addParam result
   bool dxl_getdata_result = false;                 // GetParam result
 
-  // Set parameter
-  dxl_addparam_result = groupSyncReadEncoder_->addParam(left_wheel_id_);
-  if (dxl_addparam_result != true)
-    return false;
-
-  dxl_addparam_result = groupSyncReadEncoder_->addParam(right_wheel_id_);
-  if (dxl_addparam_result != true)
-    return false;
-
   // Syncread present position
   dxl_comm_result = groupSyncReadEncoder_->txRxPacket();
   if (dxl_comm_result != COMM_SUCCESS)
-    Serial.println(packetHandler_->getTxRxResult(dxl_comm_result));
+    DEBUG_SERIAL.println(packetHandler_->getTxRxResult(dxl_comm_result));
 
   // Check if groupSyncRead data of Dynamixels are available
   dxl_getdata_result = groupSyncReadEncoder_->isAvailable(left_wheel_id_, ADDR_X_PRESENT_POSITION, LEN_X_PRESENT_POSITION);
@@ -152,7 +156,6 @@ bool Turtlebot3MotorDriver::readEncoder(int32_t &left_value, int32_t &right_valu
   left_value  = groupSyncReadEncoder_->getData(left_wheel_id_,  ADDR_X_PRESENT_POSITION, LEN_X_PRESENT_POSITION);
   right_value = groupSyncReadEncoder_->getData(right_wheel_id_, ADDR_X_PRESENT_POSITION, LEN_X_PRESENT_POSITION);
 
-  groupSyncReadEncoder_->clearParam();
   return true;
 }
 
@@ -186,7 +189,7 @@ bool Turtlebot3MotorDriver::writeVelocity(int64_t left_value, int64_t right_valu
   dxl_comm_result = groupSyncWriteVelocity_->txPacket();
   if (dxl_comm_result != COMM_SUCCESS)
   {
-    Serial.println(packetHandler_->getTxRxResult(dxl_comm_result));
+    DEBUG_SERIAL.println(packetHandler_->getTxRxResult(dxl_comm_result));
     return false;
   }
 
@@ -194,10 +197,8 @@ bool Turtlebot3MotorDriver::writeVelocity(int64_t left_value, int64_t right_valu
   return true;
 }
 
-bool Turtlebot3MotorDriver::controlMotor(const float wheel_radius, const float wheel_separation, float* value)
+void Turtlebot3MotorDriver::calcGoalVelocity(const float wheel_radius, const float wheel_separation, float* value, int32_t &left_value, int32_t &right_value)
 {
-  bool dxl_comm_result = false;
-  
   float wheel_velocity_cmd[2];
 
   float lin_vel = value[LEFT];
@@ -209,6 +210,18 @@ bool Turtlebot3MotorDriver::controlMotor(const float wheel_radius, const float w
   wheel_velocity_cmd[LEFT]  = constrain(wheel_velocity_cmd[LEFT]  * VELOCITY_CONSTANT_VALUE / wheel_radius, -dynamixel_limit_max_velocity_, dynamixel_limit_max_velocity_);
   wheel_velocity_cmd[RIGHT] = constrain(wheel_velocity_cmd[RIGHT] * VELOCITY_CONSTANT_VALUE / wheel_radius, -dynamixel_limit_max_velocity_, dynamixel_limit_max_velocity_);
 
+  left_value  = (int32_t)wheel_velocity_cmd[LEFT];
+  right_value = (int32_t)wheel_velocity_cmd[RIGHT];
+}
+
+bool Turtlebot3MotorDriver::controlMotor(const float wheel_radius, const float wheel_separation, float* value)
+{
+  bool dxl_comm_result = false;
+  
+  int32_t wheel_velocity_cmd[2];
+
+  calcGoalVelocity(wheel_radius, wheel_separation, value, wheel_velocity_cmd[LEFT], wheel_velocity_cmd[RIGHT]);
+
   dxl_comm_result = writeVelocity((int64_t)wheel_velocity_cmd[LEFT], (int64_t)wheel_velocity_cmd[RIGHT]);
   if (dxl_comm_result == false)
     return false;
@@ -0,0 +1,295 @@
+/*******************************************************************************
+* Copyright 2016 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Yoonseok Pyo, Leon Jung, Darby Lim, HanCheol Cho, Gilbert */
+
+#include "../../include/turtlebot3/turtlebot3_odometry.h"
+
+#define ODOMETRY_PI                      3.14159265f
+
+Turtlebot3Odometry::Turtlebot3Odometry()
+: wheel_radius_(0.033f),
+  wheel_separation_(0.160f),
+  tick_to_rad_(0.001533981f),
+  fusion_(ODOMETRY_FUSION_IMU_YAW),
+  complementary_gain_(0.98f),
+  gyro_noise_(0.02f),
+  bias_noise_(0.0005f),
+  wheel_noise_(0.05f)
+{
+  reset();
+}
+
+Turtlebot3Odometry::~Turtlebot3Odometry()
+{
+}
+
+bool Turtlebot3Odometry::init(float wheel_radius, float wheel_separation, float tick_to_rad)
+{
+  if (wheel_radius <= 0.0f || wheel_separation <= 0.0f || tick_to_rad <= 0.0f)
+    return false;
+
+  wheel_radius_     = wheel_radius;
+  wheel_separation_ = wheel_separation;
+  tick_to_rad_      = tick_to_rad;
+
+  reset();
+  return true;
+}
+
+void Turtlebot3Odometry::reset(void)
+{
+  init_tick_    = true;
+  last_stamp_   = 0;
+  last_imu_yaw_ = 0.0f;
+
+  for (int index = 0; index < ODOMETRY_WHEEL_NUM; index++)
+  {
+    last_tick_[index]      = 0;
+    wheel_angle_[index]    = 0.0f;
+    wheel_velocity_[index] = 0.0f;
+  }
+
+  pose_.stamp            = 0;
+  pose_.x                = 0.0f;
+  pose_.y                = 0.0f;
+  pose_.theta            = 0.0f;
+  pose_.linear_velocity  = 0.0f;
+  pose_.angular_velocity = 0.0f;
+
+  gyro_bias_  = 0.0f;
+  cov_[0][0]  = 0.0f;
+  cov_[0][1]  = 0.0f;
+  cov_[1][0]  = 0.0f;
+  cov_[1][1]  = 0.01f * 0.01f;
+
+  history_head_  = 0;
+  history_count_ = 0;
+}
+
+void Turtlebot3Odometry::setFusion(OdometryFusion fusion, float gain)
+{
+  fusion_ = fusion;
+
+  if (gain < 0.0f)      gain = 0.0f;
+  else if (gain > 1.0f) gain = 1.0f;
+  complementary_gain_ = gain;
+}
+
+void Turtlebot3Odometry::setEkfNoise(float gyro_noise, float bias_noise, float wheel_noise)
+{
+  gyro_noise_  = gyro_noise;
+  bias_noise_  = bias_noise;
+  wheel_noise_ = wheel_noise;
+}
+
+bool Turtlebot3Odometry::update(int32_t left_tick, int32_t right_tick, float gyro_z, float imu_yaw, uint32_t stamp)
+{
+  if (init_tick_)
+  {
+    last_tick_[ODOMETRY_WHEEL_LEFT]  = left_tick;
+    last_tick_[ODOMETRY_WHEEL_RIGHT] = right_tick;
+    last_stamp_   = stamp;
+    last_imu_yaw_ = imu_yaw;
+
+    pose_.stamp = stamp;
+    pushHistory();
+
+    init_tick_ = false;
+    return false;
+  }
+
+  float dt = (float)(stamp - last_stamp_) * 0.000001f;
+  if (dt <= 0.0f)
+    return false;
+
+  // Differences in uint32_t stay correct when the present position wraps around
+  int32_t diff_tick[ODOMETRY_WHEEL_NUM];
+  diff_tick[ODOMETRY_WHEEL_LEFT]  = (int32_t)((uint32_t)left_tick  - (uint32_t)last_tick_[ODOMETRY_WHEEL_LEFT]);
+  diff_tick[ODOMETRY_WHEEL_RIGHT] = (int32_t)((uint32_t)right_tick - (uint32_t)last_tick_[ODOMETRY_WHEEL_RIGHT]);
+
+  last_tick_[ODOMETRY_WHEEL_LEFT]  = left_tick;
+  last_tick_[ODOMETRY_WHEEL_RIGHT] = right_tick;
+  last_stamp_ = stamp;
+
+  float wheel[ODOMETRY_WHEEL_NUM];
+  for (int index = 0; index < ODOMETRY_WHEEL_NUM; index++)
+  {
+    wheel[index] = tick_to_rad_ * (float)diff_tick[index];
+
+    wheel_angle_[index]   += wheel[index];
+    wheel_velocity_[index] = wheel[index] / dt;
+  }
+
+  float delta_s           = wheel_radius_ * (wheel[ODOMETRY_WHEEL_RIGHT] + wheel[ODOMETRY_WHEEL_LEFT]) / 2.0f;
+  float delta_theta_wheel = wheel_radius_ * (wheel[ODOMETRY_WHEEL_RIGHT] - wheel[ODOMETRY_WHEEL_LEFT]) / wheel_separation_;
+  float delta_theta       = 0.0f;
+
+  switch (fusion_)
+  {
+    case ODOMETRY_FUSION_WHEEL:
+      delta_theta = delta_theta_wheel;
+      break;
+
+    case ODOMETRY_FUSION_IMU_YAW:
+      delta_theta = normalizeAngle(imu_yaw - last_imu_yaw_);
+      break;
+
+    case ODOMETRY_FUSION_COMPLEMENTARY:
+      delta_theta = complementary_gain_ * gyro_z * dt + (1.0f - complementary_gain_) * delta_theta_wheel;
+      break;
+
+    case ODOMETRY_FUSION_EKF:
+      delta_theta = updateHeadingEKF(gyro_z, delta_theta_wheel / dt, dt);
+      break;
+  }
+  last_imu_yaw_ = imu_yaw;
+
+  // Exact arc integration : chord = delta_s * sin(delta_theta/2) / (delta_theta/2)
+  float half_theta = delta_theta / 2.0f;
+  float chord_ratio;
+  if (fabsf(half_theta) < 1.0e-3f)
+    chord_ratio = 1.0f - half_theta * half_theta / 6.0f;
+  else
+    chord_ratio = sinf(half_theta) / half_theta;
+
+  float heading = pose_.theta + half_theta;
+  pose_.x     += delta_s * chord_ratio * cosf(heading);
+  pose_.y     += delta_s * chord_ratio * sinf(heading);
+  pose_.theta  = normalizeAngle(pose_.theta + delta_theta);
+
+  pose_.linear_velocity  = delta_s / dt;
+  pose_.angular_velocity = delta_theta / dt;
+  pose_.stamp            = stamp;
+
+  pushHistory();
+  return true;
+}
+
+float Turtlebot3Odometry::updateHeadingEKF(float gyro_z, float wheel_rate, float dt)
+{
+  // Predict : theta += (gyro_z - bias) * dt, bias is a random walk
+  float delta_theta = (gyro_z - gyro_bias_) * dt;
+
+  float p00 = cov_[0][0] - dt * (cov_[0][1] + cov_[1][0]) + dt * dt * cov_[1][1] + gyro_noise_ * gyro_noise_ * dt * dt;
+  float p01 = cov_[0][1] - dt * cov_[1][1];
+  float p10 = cov_[1][0] - dt * cov_[1][1];
+  float p11 = cov_[1][1] + bias_noise_ * bias_noise_ * dt;
+
+  // Update with wheel heading rate : z = gyro_z - bias, H = [0 -1]
+  float innovation = wheel_rate - (gyro_z - gyro_bias_);
+  float s          = p11 + wheel_noise_ * wheel_noise_;
+
+  // Skip the update when the wheels slip (3 sigma gate)
+  if (innovation * innovation <= 9.0f * s)
+  {
+    float k0 = -p01 / s;
+    float k1 = -p11 / s;
+
+    delta_theta += k0 * innovation;
+    gyro_bias_  += k1 * innovation;
+
+    cov_[0][0] = p00 + k0 * p10;
+    cov_[0][1] = p01 + k0 * p11;
+    cov_[1][0] = p10 + k1 * p10;
+    cov_[1][1] = p11 + k1 * p11;
+  }
+  else
+  {
+    cov_[0][0] = p00;
+    cov_[0][1] = p01;
+    cov_[1][0] = p10;
+    cov_[1][1] = p11;
+  }
+
+  return delta_theta;
+}
+
+OdometryPose Turtlebot3Odometry::getPose(void)
+{
+  return pose_;
+}
+
+bool Turtlebot3Odometry::getPose(uint32_t stamp, OdometryPose *pose)
+{
+  if (history_count_ == 0)
+    return false;
+
+  uint8_t newer = history_head_;
+
+  // No extrapolation : newer stamps get the latest pose
+  if ((int32_t)(stamp - history_[newer].stamp) >= 0)
+  {
+    *pose = history_[newer];
+    return true;
+  }
+
+  for (uint8_t num = 1; num < history_count_; num++)
+  {
+    uint8_t older = (newer + ODOMETRY_HISTORY_SIZE - 1) % ODOMETRY_HISTORY_SIZE;
+
+    if ((int32_t)(stamp - history_[older].stamp) >= 0)
+    {
+      float ratio = (float)(stamp - history_[older].stamp) / (float)(history_[newer].stamp - history_[older].stamp);
+
+      pose->stamp            = stamp;
+      pose->x                = history_[older].x + ratio * (history_[newer].x - history_[older].x);
+      pose->y                = history_[older].y + ratio * (history_[newer].y - history_[older].y);
+      pose->theta            = normalizeAngle(history_[older].theta + ratio * normalizeAngle(history_[newer].theta - history_[older].theta));
+      pose->linear_velocity  = history_[newer].linear_velocity;
+      pose->angular_velocity = history_[newer].angular_velocity;
+      return true;
+    }
+
+    newer = older;
+  }
+
+  // Older than the history
+  return false;
+}
+
+void Turtlebot3Odometry::getWheelState(float *angle, float *velocity)
+{
+  for (int index = 0; index < ODOMETRY_WHEEL_NUM; index++)
+  {
+    angle[index]    = wheel_angle_[index];
+    velocity[index] = wheel_velocity_[index];
+  }
+}
+
+float Turtlebot3Odometry::getGyroBias(void)
+{
+  return gyro_bias_;
+}
+
+void Turtlebot3Odometry::pushHistory(void)
+{
+  if (history_count_ > 0)
+    history_head_ = (history_head_ + 1) % ODOMETRY_HISTORY_SIZE;
+
+  history_[history_head_] = pose_;
+
+  if (history_count_ < ODOMETRY_HISTORY_SIZE)
+    history_count_++;
+}
+
+float Turtlebot3Odometry::normalizeAngle(float angle)
+{
+  while (angle > ODOMETRY_PI)   angle -= 2.0f * ODOMETRY_PI;
+  while (angle <= -ODOMETRY_PI) angle += 2.0f * ODOMETRY_PI;
+
+  return angle;
+}
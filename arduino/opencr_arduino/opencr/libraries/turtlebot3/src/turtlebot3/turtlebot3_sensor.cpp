@@ -19,6 +19,7 @@
 #include "../../include/turtlebot3/turtlebot3_sensor.h"
 
 Turtlebot3Sensor::Turtlebot3Sensor()
+: imu_stamp_(0)
 {
 }
 
@@ -65,35 +66,26 @@ void Turtlebot3Sensor::initIMU(void)
 
 void Turtlebot3Sensor::updateIMU(void)
 {
-  imu_.update();
+  // cIMU::update() returns 0 if there is no new sample
+  if (imu_.update() > 0)
+    imu_stamp_ = imu_.getSampleStamp();
 }
 
-void Turtlebot3Sensor::calibrationGyro()
+uint32_t Turtlebot3Sensor::getIMUStamp(void)
 {
-  uint32_t pre_time;
-  uint32_t t_time;
-
-  const uint8_t led_ros_connect = 3;
+  return imu_stamp_;
+}
 
+void Turtlebot3Sensor::calibrationGyro()
+{
+  // Returns at once, updateIMU() calibrates on the samples until the robot stays still for a while.
+  // The biases are stored and used at the next boot.
   imu_.SEN.gyro_cali_start();
-  
-  t_time   = millis();
-  pre_time = millis();
-
-  while(!imu_.SEN.gyro_cali_get_done())
-  {
-    imu_.update();
+}
 
-    if (millis()-pre_time > 5000)
-    {
-      break;
-    }
-    if (millis()-t_time > 100)
-    {
-      t_time = millis();
-      setLedToggle(led_ros_connect);
-    }
-  }
+bool Turtlebot3Sensor::isCalibratingGyro(void)
+{
+  return imu_.SEN.gyro_cali_get_done() == false;
 }
 
 sensor_msgs::Imu Turtlebot3Sensor::getIMU(void)
@@ -155,6 +147,11 @@ float* Turtlebot3Sensor::getOrientation(void)
   return orientation;
 }
 
+float Turtlebot3Sensor::getYawRate(void)
+{
+  return imu_.SEN.gyroADC[2] * GYRO_FACTOR;
+}
+
 sensor_msgs::MagneticField Turtlebot3Sensor::getMag(void)
 {
   mag_msg_.magnetic_field.x = imu_.SEN.magADC[0] * MAG_FACTOR;
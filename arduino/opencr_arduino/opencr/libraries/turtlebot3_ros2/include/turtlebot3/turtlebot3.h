@@ -22,6 +22,7 @@
 #include "turtlebot3_sensor.h"
 #include "turtlebot3_controller.h"
 #include "turtlebot3_diagnosis.h"
+#include "turtlebot3_telemetry.h"
 
 #define DEBUG_ENABLE 1
 
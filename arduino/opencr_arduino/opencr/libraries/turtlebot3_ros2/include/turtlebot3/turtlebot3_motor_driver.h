@@ -33,6 +33,15 @@ enum VelocityType{
   TYPE_NUM_MAX
 };
 
+typedef struct WheelState{
+  uint32_t stamp_us;
+  bool torque_enable[MortorLocation::MOTOR_NUM_MAX];
+  uint8_t hardware_error_status[MortorLocation::MOTOR_NUM_MAX];
+  int16_t present_current[MortorLocation::MOTOR_NUM_MAX];
+  int32_t present_velocity[MortorLocation::MOTOR_NUM_MAX];
+  int32_t present_position[MortorLocation::MOTOR_NUM_MAX];
+}WheelState;
+
 
 class Turtlebot3MotorDriver
 {
@@ -51,6 +60,7 @@ class Turtlebot3MotorDriver
   bool read_present_position(int32_t &left_value, int32_t &right_value);
   bool read_present_velocity(int32_t &left_value, int32_t &right_value);
   bool read_present_current(int16_t &left_value, int16_t &right_value);
+  bool read_wheel_state(WheelState &state);
   bool read_profile_acceleration(uint32_t &left_value, uint32_t &right_value);
   
   bool write_velocity(int32_t left_value, int32_t right_value);
@@ -62,6 +72,9 @@ class Turtlebot3MotorDriver
   uint8_t left_wheel_id_;
   uint8_t right_wheel_id_;
   bool torque_;
+  bool indirect_ready_;
+
+  bool init_wheel_state_indirect_address();
 };
 
 #endif // TURTLEBOT3_MOTOR_DRIVER_H_
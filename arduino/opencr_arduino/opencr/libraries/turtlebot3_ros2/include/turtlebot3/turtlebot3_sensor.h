@@ -55,6 +55,7 @@ class Turtlebot3Sensor
   float* getIMU(void);
   void updateIMU(void);
   void calibrationGyro(void);
+  bool isCalibratingGyro(void);
 
   float* getImuAngularVelocity(void);
   float* getImuLinearAcc(void);
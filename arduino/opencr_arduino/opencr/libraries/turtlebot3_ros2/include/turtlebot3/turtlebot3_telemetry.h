@@ -0,0 +1,109 @@
+/*******************************************************************************
+* Copyright 2016 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef TURTLEBOT3_TELEMETRY_H_
+#define TURTLEBOT3_TELEMETRY_H_
+
+// This file does not depend on Arduino, so the ROS2 node can build the same decoder.
+#include <stdint.h>
+#include <string.h>
+
+// Frame : 0xFF 0xFF 0xFC | version | seq | length(2) | payload | CRC16(2)
+// Bytes after the header are stuffed like DYNAMIXEL Protocol 2.0 (0xFF 0xFF 0xFD -> 0xFF 0xFF 0xFD 0xFD),
+// so a DYNAMIXEL packet parser on the same port never finds a packet header inside a frame.
+const uint8_t TELEMETRY_VERSION = 1;
+const uint16_t TELEMETRY_PAYLOAD_LENGTH = 86;
+const uint16_t TELEMETRY_FRAME_MAX_SIZE = 128;
+
+typedef struct TelemetryData{
+  uint32_t stamp_us;
+  float angular_vel[3];
+  float linear_acc[3];
+  float magnetic[3];
+  float orientation[4];
+  int32_t present_position[2];
+  int32_t present_velocity[2];
+  int32_t present_current[2];
+  uint8_t torque_enable;
+  uint8_t buttons; // bit 0,1 : push buttons, bit 2,3 : bumpers
+  uint32_t bat_voltage_x100;
+}TelemetryData;
+
+// Returns the frame length, or 0 if 'frame_size' is too small.
+uint16_t encode_telemetry_frame(const TelemetryData &data, uint8_t seq, uint8_t *p_frame, uint16_t frame_size);
+
+// The frame waiting between the main loop and the slave interrupt (OpenCR).
+// put() runs with interrupts off, send() in the interrupt.
+class Turtlebot3TelemetrySlot
+{
+ public:
+  Turtlebot3TelemetrySlot();
+
+  // Returns false when it replaced a frame that was not sent yet.
+  bool put(const uint8_t *p_frame, uint16_t length);
+
+  // Writes the whole frame if 'port' has room for it, else it waits for the next call.
+  // 'port' is the USBSerial of the slave on OpenCR.
+  template <class Port>
+  bool send(Port &port)
+  {
+    if(length_ == 0 || port.availableForWrite() < (int)length_)
+      return false;
+
+    port.write(frame_, length_);
+    length_ = 0;
+    return true;
+  }
+
+ private:
+  uint8_t frame_[TELEMETRY_FRAME_MAX_SIZE];
+  volatile uint16_t length_;
+};
+
+class Turtlebot3TelemetryDecoder
+{
+ public:
+  Turtlebot3TelemetryDecoder();
+  ~Turtlebot3TelemetryDecoder();
+
+  void reset();
+
+  // Returns true when 'byte' completes a valid frame.
+  bool parse(uint8_t byte);
+
+  const TelemetryData& get_data();
+  uint8_t get_seq();
+  uint32_t get_frame_count();
+  uint32_t get_error_count();
+  uint32_t get_lost_count();
+
+ private:
+  uint8_t header_[3];
+  bool is_in_frame_;
+  uint8_t body_[4 + TELEMETRY_PAYLOAD_LENGTH + 2];
+  uint16_t body_length_;
+  uint8_t stuff_[3];
+
+  TelemetryData data_;
+  uint8_t seq_;
+  uint32_t frame_count_;
+  uint32_t error_count_;
+  uint32_t lost_count_;
+
+  bool decode_body();
+};
+
+#endif // TURTLEBOT3_TELEMETRY_H_
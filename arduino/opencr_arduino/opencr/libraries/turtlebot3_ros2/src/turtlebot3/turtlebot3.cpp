@@ -89,23 +89,68 @@ const uint8_t ID_DXL_SLAVE = 200;
 const uint16_t MODEL_NUM_DXL_SLAVE = 0x5000;
 const float PROTOCOL_VERSION_DXL_SLAVE = 2.0;
 const uint32_t HEARTBEAT_TIMEOUT_MS = 500;
+const uint32_t INTERVAL_US_TO_PROCESS_DXL_SLAVE = 250;
+const uint32_t POLLING_TIMEOUT_MS = 1000;
 
+static void dxl_slave_read_callback_func(uint16_t addr, uint8_t &dxl_err_code, void* arg);
 static void dxl_slave_write_callback_func(uint16_t addr, uint8_t &dxl_err_code, void* arg);
+static void dxl_slave_timer_handler(void);
+static void process_dxl_slave_write(uint16_t item_addr);
+static void publish_control_items(void);
+static void update_telemetry(void);
 
 static bool get_connection_state_with_ros2_node();
 static void set_connection_state_with_ros2_node(bool is_connected);
 static void update_connection_state_with_ros2_node();
 
-static void update_imu(uint32_t interval_ms);
-static void update_times(uint32_t interval_ms);
-static void update_gpios(uint32_t interval_ms);
-static void update_motor_status(uint32_t interval_ms);
-static void update_battery_status(uint32_t interval_ms);
-static void update_analog_sensors(uint32_t interval_ms);
+static void update_imu(void);
+static void update_times(void);
+static void update_gpios(void);
+static void update_motor_status(void);
+static void read_motor_status(void);
+static void update_battery_status(void);
+static void update_analog_sensors(void);
+
+// The slave runs in a timer interrupt, where millis() does not advance and USBSerial::write()
+// would wait forever for a full CDC buffer. A status packet that does not fit is dropped,
+// the ROS2 node sends the instruction again after its timeout.
+class USBSerialPortHandlerNoWait : public DYNAMIXEL::USBSerialPortHandler
+{
+  public:
+    USBSerialPortHandlerNoWait(USBSerial& port)
+    : DYNAMIXEL::USBSerialPortHandler(port), port_(port), drop_cnt_(0)
+    {}
+
+    virtual size_t write(uint8_t c) override
+    {
+      return write(&c, 1);
+    }
+
+    virtual size_t write(uint8_t *buf, size_t len) override
+    {
+      if(port_.availableForWrite() < (int)len){
+        drop_cnt_++;
+        return 0;
+      }
+      return port_.write(buf, len);
+    }
 
-DYNAMIXEL::USBSerialPortHandler port_dxl_slave(SERIAL_DXL_SLAVE);
+    uint32_t getDropCount(void)
+    {
+      return drop_cnt_;
+    }
+
+  private:
+    USBSerial& port_;
+    volatile uint32_t drop_cnt_;
+};
+
+USBSerialPortHandlerNoWait port_dxl_slave(SERIAL_DXL_SLAVE);
 DYNAMIXEL::Slave dxl_slave(port_dxl_slave, MODEL_NUM_DXL_SLAVE);
 
+// Packets from the ROS2 node are processed in this timer interrupt, independent of run() loop time.
+HardwareTimer dxl_slave_timer(TIMER_CH1);
+
 enum ControlTableItemAddr{
   ADDR_MODEL_INFORM    = 2,
   
@@ -147,6 +192,10 @@ enum ControlTableItemAddr{
   ADDR_ORIENTATION_X      = 100,
   ADDR_ORIENTATION_Y      = 104,
   ADDR_ORIENTATION_Z      = 108,
+
+  ADDR_TELEMETRY_INTERVAL = 112,
+  ADDR_TELEMETRY_VERSION  = 114,
+  ADDR_TELEMETRY_DROP     = 116,
   
   ADDR_PRESENT_CURRENT_L  = 120,
   ADDR_PRESENT_CURRENT_R  = 124,
@@ -194,6 +243,10 @@ typedef struct ControlItemVariables{
   float magnetic[3];
   float orientation[4];
 
+  uint16_t telemetry_interval_ms;
+  uint8_t telemetry_version;
+  uint32_t telemetry_drop_cnt;
+
   int32_t present_position[MortorLocation::MOTOR_NUM_MAX];
   int32_t present_velocity[MortorLocation::MOTOR_NUM_MAX];
   int32_t present_current[MortorLocation::MOTOR_NUM_MAX];
@@ -204,7 +257,116 @@ typedef struct ControlItemVariables{
   uint32_t profile_acceleration[MortorLocation::MOTOR_NUM_MAX];
 }ControlItemVariables;
 
+// 'control_items' is updated by run(). 'control_items_slave' is what the ROS2 node reads and writes,
+// it is refreshed from 'control_items' at once by publish_control_items().
 static ControlItemVariables control_items;
+static ControlItemVariables control_items_slave;
+
+typedef struct ControlItemRange{
+  uint16_t addr;
+  uint16_t offset;
+  uint16_t length;
+}ControlItemRange;
+
+const uint8_t CONTROL_ITEM_NUM_MAX = 64;
+static ControlItemRange control_item_range[CONTROL_ITEM_NUM_MAX];
+static uint8_t control_item_cnt = 0;
+
+// Written item addresses, queued by the slave interrupt and processed in run()
+const uint8_t DXL_SLAVE_WRITE_QUEUE_SIZE = 32;
+static volatile uint16_t dxl_slave_write_queue[DXL_SLAVE_WRITE_QUEUE_SIZE];
+static volatile uint8_t dxl_slave_write_queue_head = 0;
+static volatile uint8_t dxl_slave_write_queue_tail = 0;
+static volatile uint32_t dxl_slave_write_queue_overflow = 0;
+
+template <typename T>
+static void add_control_item(uint16_t addr, T &item)
+{
+  uint16_t offset = (uint8_t*)&item - (uint8_t*)&control_items;
+
+  if(control_item_cnt >= CONTROL_ITEM_NUM_MAX)
+    return;
+
+  control_item_range[control_item_cnt].addr = addr;
+  control_item_range[control_item_cnt].offset = offset;
+  control_item_range[control_item_cnt].length = sizeof(T);
+  control_item_cnt++;
+
+  dxl_slave.addControlItem(addr, *(T*)((uint8_t*)&control_items_slave + offset));
+}
+
+// Latest wheel feedback, read once per update and shared by the control table and the test drive
+static WheelState wheel_state;
+
+/*******************************************************************************
+* Refresh policy of control item groups
+*******************************************************************************/
+enum ControlItemGroup{
+  GROUP_TIMES = 0,
+  GROUP_GPIOS,
+  GROUP_ANALOG_SENSORS,
+  GROUP_BATTERY,
+  GROUP_IMU,
+  GROUP_MOTOR,
+  GROUP_NUM_MAX
+};
+
+enum RefreshPolicy{
+  REFRESH_ALWAYS = 0,   // every run() loop
+  REFRESH_ON_READ       // every interval_ms, only while the ROS2 node reads the group
+};
+
+typedef struct ControlItemGroupInfo{
+  uint16_t start_addr;
+  uint16_t end_addr;
+  RefreshPolicy policy;
+  uint32_t interval_ms;
+  uint32_t pre_time;
+  volatile uint32_t read_time;
+  volatile uint32_t read_cnt;
+}ControlItemGroupInfo;
+
+static ControlItemGroupInfo control_item_group[GROUP_NUM_MAX] = {
+  {ADDR_MILLIS,             ADDR_MICROS + 3,             REFRESH_ALWAYS,       0,                                  0, 0, 0},
+  {ADDR_USER_LED_1,         ADDR_BUMPER_2,               REFRESH_ON_READ,      INTERVAL_MS_TO_UPDATE_CONTROL_ITEM, 0, 0, 0},
+  {ADDR_ILLUMINATION,       ADDR_SORNA + 3,              REFRESH_ON_READ,      INTERVAL_MS_TO_UPDATE_CONTROL_ITEM, 0, 0, 0},
+  {ADDR_BATTERY_VOLTAGE,    ADDR_BATTERY_PERCENT + 3,    REFRESH_ON_READ,      100,                                0, 0, 0},
+  {ADDR_ANGULAR_VELOCITY_X, ADDR_ORIENTATION_Z + 3,      REFRESH_ON_READ,      INTERVAL_MS_TO_UPDATE_CONTROL_ITEM, 0, 0, 0},
+  {ADDR_PRESENT_CURRENT_L,  ADDR_PRESENT_POSITION_R + 3, REFRESH_ON_READ,      INTERVAL_MS_TO_UPDATE_CONTROL_ITEM, 0, 0, 0}
+};
+
+// Telemetry frame waiting to be sent by the slave interrupt
+const uint16_t TELEMETRY_INTERVAL_MS_MIN = 2;
+static Turtlebot3TelemetrySlot telemetry_slot;
+
+// Marks the group as read, so that an ON_READ group is refreshed for POLLING_TIMEOUT_MS.
+static void request_control_item_group(uint8_t group)
+{
+  control_item_group[group].read_time = millis();
+  control_item_group[group].read_cnt++;
+}
+
+static bool is_control_item_group_to_update(uint8_t group)
+{
+  ControlItemGroupInfo *p_group = &control_item_group[group];
+
+  switch(p_group->policy)
+  {
+    case REFRESH_ALWAYS:
+      return true;
+
+    case REFRESH_ON_READ:
+      if(p_group->read_cnt == 0 || millis() - p_group->read_time >= POLLING_TIMEOUT_MS)
+        return false;
+      if(millis() - p_group->pre_time >= p_group->interval_ms){
+        p_group->pre_time = millis();
+        return true;
+      }
+      break;
+  }
+
+  return false;
+}
 
 
 /*******************************************************************************
@@ -253,67 +415,76 @@ void TurtleBot3Core::begin(const char* model_name)
   /* Add control items for Slave */
   // Items for model information of device
   control_items.model_inform = p_tb3_model_info->model_info;
-  dxl_slave.addControlItem(ADDR_MODEL_INFORM, control_items.model_inform);
+  add_control_item(ADDR_MODEL_INFORM, control_items.model_inform);
   // Items for Timer of device
-  dxl_slave.addControlItem(ADDR_MILLIS, control_items.dev_time_millis);
-  dxl_slave.addControlItem(ADDR_MICROS, control_items.dev_time_micros);
+  add_control_item(ADDR_MILLIS, control_items.dev_time_millis);
+  add_control_item(ADDR_MICROS, control_items.dev_time_micros);
   // Items to inform device status
-  dxl_slave.addControlItem(ADDR_DEVICE_STATUS, control_items.device_status);
+  add_control_item(ADDR_DEVICE_STATUS, control_items.device_status);
   // Items to check connection state with node
-  dxl_slave.addControlItem(ADDR_HEARTBEAT, control_items.heart_beat);
+  add_control_item(ADDR_HEARTBEAT, control_items.heart_beat);
   // Items for GPIO
-  dxl_slave.addControlItem(ADDR_USER_LED_1, control_items.user_led[0]);
-  dxl_slave.addControlItem(ADDR_USER_LED_2, control_items.user_led[1]);
-  dxl_slave.addControlItem(ADDR_USER_LED_3, control_items.user_led[2]);
-  dxl_slave.addControlItem(ADDR_USER_LED_4, control_items.user_led[3]);
-  dxl_slave.addControlItem(ADDR_BUTTON_1, control_items.push_button[0]);
-  dxl_slave.addControlItem(ADDR_BUTTON_2, control_items.push_button[1]);
-  dxl_slave.addControlItem(ADDR_BUMPER_1, control_items.bumper[0]);
-  dxl_slave.addControlItem(ADDR_BUMPER_2, control_items.bumper[1]);
+  add_control_item(ADDR_USER_LED_1, control_items.user_led[0]);
+  add_control_item(ADDR_USER_LED_2, control_items.user_led[1]);
+  add_control_item(ADDR_USER_LED_3, control_items.user_led[2]);
+  add_control_item(ADDR_USER_LED_4, control_items.user_led[3]);
+  add_control_item(ADDR_BUTTON_1, control_items.push_button[0]);
+  add_control_item(ADDR_BUTTON_2, control_items.push_button[1]);
+  add_control_item(ADDR_BUMPER_1, control_items.bumper[0]);
+  add_control_item(ADDR_BUMPER_2, control_items.bumper[1]);
   // Items for Analog sensors
-  dxl_slave.addControlItem(ADDR_ILLUMINATION, control_items.illumination);
-  dxl_slave.addControlItem(ADDR_IR, control_items.ir_sensor);
-  dxl_slave.addControlItem(ADDR_SORNA, control_items.sornar);
+  add_control_item(ADDR_ILLUMINATION, control_items.illumination);
+  add_control_item(ADDR_IR, control_items.ir_sensor);
+  add_control_item(ADDR_SORNA, control_items.sornar);
   // Items for Battery
-  dxl_slave.addControlItem(ADDR_BATTERY_VOLTAGE, control_items.bat_voltage_x100);
-  dxl_slave.addControlItem(ADDR_BATTERY_PERCENT, control_items.bat_percent_x100);
+  add_control_item(ADDR_BATTERY_VOLTAGE, control_items.bat_voltage_x100);
+  add_control_item(ADDR_BATTERY_PERCENT, control_items.bat_percent_x100);
   // Items for Buzzer
-  dxl_slave.addControlItem(ADDR_SOUND, control_items.buzzer_sound);
+  add_control_item(ADDR_SOUND, control_items.buzzer_sound);
   // Items for IMU
-  dxl_slave.addControlItem(ADDR_IMU_RECALIBRATION, control_items.imu_recalibration);
-  dxl_slave.addControlItem(ADDR_ANGULAR_VELOCITY_X, control_items.angular_vel[0]);
-  dxl_slave.addControlItem(ADDR_ANGULAR_VELOCITY_Y, control_items.angular_vel[1]);
-  dxl_slave.addControlItem(ADDR_ANGULAR_VELOCITY_Z, control_items.angular_vel[2]);
-  dxl_slave.addControlItem(ADDR_LINEAR_ACC_X, control_items.linear_acc[0]);
-  dxl_slave.addControlItem(ADDR_LINEAR_ACC_Y, control_items.linear_acc[1]);
-  dxl_slave.addControlItem(ADDR_LINEAR_ACC_Z, control_items.linear_acc[2]);
-  dxl_slave.addControlItem(ADDR_MAGNETIC_X, control_items.magnetic[0]);
-  dxl_slave.addControlItem(ADDR_MAGNETIC_Y, control_items.magnetic[1]);
-  dxl_slave.addControlItem(ADDR_MAGNETIC_Z, control_items.magnetic[2]);
-  dxl_slave.addControlItem(ADDR_ORIENTATION_W, control_items.orientation[0]);
-  dxl_slave.addControlItem(ADDR_ORIENTATION_X, control_items.orientation[1]);
-  dxl_slave.addControlItem(ADDR_ORIENTATION_Y, control_items.orientation[2]);
-  dxl_slave.addControlItem(ADDR_ORIENTATION_Z, control_items.orientation[3]);
+  add_control_item(ADDR_IMU_RECALIBRATION, control_items.imu_recalibration);
+  add_control_item(ADDR_ANGULAR_VELOCITY_X, control_items.angular_vel[0]);
+  add_control_item(ADDR_ANGULAR_VELOCITY_Y, control_items.angular_vel[1]);
+  add_control_item(ADDR_ANGULAR_VELOCITY_Z, control_items.angular_vel[2]);
+  add_control_item(ADDR_LINEAR_ACC_X, control_items.linear_acc[0]);
+  add_control_item(ADDR_LINEAR_ACC_Y, control_items.linear_acc[1]);
+  add_control_item(ADDR_LINEAR_ACC_Z, control_items.linear_acc[2]);
+  add_control_item(ADDR_MAGNETIC_X, control_items.magnetic[0]);
+  add_control_item(ADDR_MAGNETIC_Y, control_items.magnetic[1]);
+  add_control_item(ADDR_MAGNETIC_Z, control_items.magnetic[2]);
+  add_control_item(ADDR_ORIENTATION_W, control_items.orientation[0]);
+  add_control_item(ADDR_ORIENTATION_X, control_items.orientation[1]);
+  add_control_item(ADDR_ORIENTATION_Y, control_items.orientation[2]);
+  add_control_item(ADDR_ORIENTATION_Z, control_items.orientation[3]);
+
+  // Items for telemetry stream
+  control_items.telemetry_interval_ms = 0;
+  control_items.telemetry_version = TELEMETRY_VERSION;
+  add_control_item(ADDR_TELEMETRY_INTERVAL, control_items.telemetry_interval_ms);
+  add_control_item(ADDR_TELEMETRY_VERSION, control_items.telemetry_version);
+  add_control_item(ADDR_TELEMETRY_DROP, control_items.telemetry_drop_cnt);
   // Items to check status of motors
-  dxl_slave.addControlItem(ADDR_PRESENT_POSITION_L, control_items.present_position[MortorLocation::LEFT]);
-  dxl_slave.addControlItem(ADDR_PRESENT_POSITION_R, control_items.present_position[MortorLocation::RIGHT]);
-  dxl_slave.addControlItem(ADDR_PRESENT_VELOCITY_L, control_items.present_velocity[MortorLocation::LEFT]);
-  dxl_slave.addControlItem(ADDR_PRESENT_VELOCITY_R, control_items.present_velocity[MortorLocation::RIGHT]);
-  dxl_slave.addControlItem(ADDR_PRESENT_CURRENT_L, control_items.present_current[MortorLocation::LEFT]);
-  dxl_slave.addControlItem(ADDR_PRESENT_CURRENT_R, control_items.present_current[MortorLocation::RIGHT]);
+  add_control_item(ADDR_PRESENT_POSITION_L, control_items.present_position[MortorLocation::LEFT]);
+  add_control_item(ADDR_PRESENT_POSITION_R, control_items.present_position[MortorLocation::RIGHT]);
+  add_control_item(ADDR_PRESENT_VELOCITY_L, control_items.present_velocity[MortorLocation::LEFT]);
+  add_control_item(ADDR_PRESENT_VELOCITY_R, control_items.present_velocity[MortorLocation::RIGHT]);
+  add_control_item(ADDR_PRESENT_CURRENT_L, control_items.present_current[MortorLocation::LEFT]);
+  add_control_item(ADDR_PRESENT_CURRENT_R, control_items.present_current[MortorLocation::RIGHT]);
   // Items to control motors
-  dxl_slave.addControlItem(ADDR_MOTOR_TORQUE, control_items.motor_torque_enable_state);
-  dxl_slave.addControlItem(ADDR_CMD_VEL_LINEAR_X, control_items.cmd_vel_linear[0]);
-  dxl_slave.addControlItem(ADDR_CMD_VEL_LINEAR_Y, control_items.cmd_vel_linear[1]);
-  dxl_slave.addControlItem(ADDR_CMD_VEL_LINEAR_Z, control_items.cmd_vel_linear[2]);
-  dxl_slave.addControlItem(ADDR_CMD_VEL_ANGULAR_X, control_items.cmd_vel_angular[0]);
-  dxl_slave.addControlItem(ADDR_CMD_VEL_ANGULAR_Y, control_items.cmd_vel_angular[1]);
-  dxl_slave.addControlItem(ADDR_CMD_VEL_ANGULAR_Z, control_items.cmd_vel_angular[2]);  
-  dxl_slave.addControlItem(ADDR_PROFILE_ACC_L, control_items.profile_acceleration[MortorLocation::LEFT]);
-  dxl_slave.addControlItem(ADDR_PROFILE_ACC_R, control_items.profile_acceleration[MortorLocation::RIGHT]);
+  add_control_item(ADDR_MOTOR_TORQUE, control_items.motor_torque_enable_state);
+  add_control_item(ADDR_CMD_VEL_LINEAR_X, control_items.cmd_vel_linear[0]);
+  add_control_item(ADDR_CMD_VEL_LINEAR_Y, control_items.cmd_vel_linear[1]);
+  add_control_item(ADDR_CMD_VEL_LINEAR_Z, control_items.cmd_vel_linear[2]);
+  add_control_item(ADDR_CMD_VEL_ANGULAR_X, control_items.cmd_vel_angular[0]);
+  add_control_item(ADDR_CMD_VEL_ANGULAR_Y, control_items.cmd_vel_angular[1]);
+  add_control_item(ADDR_CMD_VEL_ANGULAR_Z, control_items.cmd_vel_angular[2]);  
+  add_control_item(ADDR_PROFILE_ACC_L, control_items.profile_acceleration[MortorLocation::LEFT]);
+  add_control_item(ADDR_PROFILE_ACC_R, control_items.profile_acceleration[MortorLocation::RIGHT]);
 
   // Set user callback function for processing write command from master.
   dxl_slave.setWriteCallbackFunc(dxl_slave_write_callback_func);
+  // Set user callback function to track which items the master reads.
+  dxl_slave.setReadCallbackFunc(dxl_slave_read_callback_func);
 
   // Check connection state with motors.
   if(motor_driver.is_connected() == true){
@@ -332,6 +503,14 @@ void TurtleBot3Core::begin(const char* model_name)
   sensors.initIMU();
   sensors.calibrationGyro();
 
+  // Start processing packets from the ROS2 node.
+  publish_control_items();
+  dxl_slave_timer.pause();
+  dxl_slave_timer.setPeriod(INTERVAL_US_TO_PROCESS_DXL_SLAVE);
+  dxl_slave_timer.attachInterrupt(dxl_slave_timer_handler);
+  dxl_slave_timer.refresh();
+  dxl_slave_timer.resume();
+
   //To indicate that the initialization is complete.
   sensors.makeMelody(1); 
 }
@@ -357,6 +536,10 @@ void TurtleBot3Core::run()
   /* For sensing and run buzzer */
   // Update the IMU unit
   sensors.updateIMU();
+  // The ROS2 node reads IMU recalibration back as 0 when the calibration has ended.
+  if(control_items.imu_recalibration == true && sensors.isCalibratingGyro() == false){
+    control_items.imu_recalibration = false;
+  }
   // Update sonar data
   // TODO: sensors.updateSonar(t);
   // Run buzzer if there is still melody to play.
@@ -368,15 +551,18 @@ void TurtleBot3Core::run()
 
   /* For processing DYNAMIXEL slave function */
   // Update control table of OpenCR to communicate with ROS2 node
-  update_imu(INTERVAL_MS_TO_UPDATE_CONTROL_ITEM);
-  update_times(INTERVAL_MS_TO_UPDATE_CONTROL_ITEM);
-  update_gpios(INTERVAL_MS_TO_UPDATE_CONTROL_ITEM);
-  update_motor_status(INTERVAL_MS_TO_UPDATE_CONTROL_ITEM);
-  update_battery_status(INTERVAL_MS_TO_UPDATE_CONTROL_ITEM);
-  update_analog_sensors(INTERVAL_MS_TO_UPDATE_CONTROL_ITEM);
+  // Each group is refreshed according to its policy in 'control_item_group'.
+  update_imu();
+  update_times();
+  update_gpios();
+  update_motor_status();
+  update_battery_status();
+  update_analog_sensors();
+  // Push telemetry frame to ROS2 node if it is enabled.
+  update_telemetry();
   
-  // Packet processing with ROS2 Node.
-  dxl_slave.processPacket();
+  // Apply writes from ROS2 Node and publish updated items to it.
+  publish_control_items();
 
   /* For controlling DYNAMIXEL motors (Wheels) */  
   if (millis()-pre_time_to_control_motor >= INTERVAL_MS_TO_CONTROL_MOTOR)
@@ -414,25 +600,17 @@ float map_float(float x, float in_min, float in_max, float out_min, float out_ma
   return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
-void update_times(uint32_t interval_ms)
+void update_times(void)
 {
-  static uint32_t pre_time = 0;
-
-  if(millis() - pre_time >= interval_ms){
-    pre_time = millis();
-
+  if(is_control_item_group_to_update(GROUP_TIMES) == true){
     control_items.dev_time_millis = millis();
     control_items.dev_time_micros = micros();
   } 
 }
 
-void update_gpios(uint32_t interval_ms)
+void update_gpios(void)
 {
-  static uint32_t pre_time = 0;
-
-  if(millis() - pre_time >= interval_ms){
-    pre_time = millis();
-
+  if(is_control_item_group_to_update(GROUP_GPIOS) == true){
     control_items.user_led[0] = digitalRead(BDPIN_GPIO_4);
     control_items.user_led[1] = digitalRead(BDPIN_GPIO_6);
     control_items.user_led[2] = digitalRead(BDPIN_GPIO_8);
@@ -446,14 +624,11 @@ void update_gpios(uint32_t interval_ms)
   }  
 }
 
-void update_battery_status(uint32_t interval_ms)
+void update_battery_status(void)
 {
-  static uint32_t pre_time = 0;
   float bat_voltage, bat_percent;
 
-  if(millis() - pre_time >= interval_ms){
-    pre_time = millis();
-
+  if(is_control_item_group_to_update(GROUP_BATTERY) == true){
     bat_voltage = sensors.checkVoltage();
     control_items.bat_voltage_x100 = (uint32_t)(bat_voltage*100);
 
@@ -464,27 +639,20 @@ void update_battery_status(uint32_t interval_ms)
   }
 }
 
-void update_analog_sensors(uint32_t interval_ms)
+void update_analog_sensors(void)
 {
-  static uint32_t pre_time = 0;
-
-  if(millis() - pre_time >= interval_ms){
-    pre_time = millis();
-
+  if(is_control_item_group_to_update(GROUP_ANALOG_SENSORS) == true){
     control_items.illumination = (uint16_t)sensors.getIlluminationData();
     control_items.ir_sensor = (uint32_t)sensors.getIRsensorData();
     control_items.sornar = (float)sensors.getSonarData();
   }
 }
 
-void update_imu(uint32_t interval_ms)
+void update_imu(void)
 {
-  static uint32_t pre_time = 0;
   float* p_imu_data;
 
-  if(millis() - pre_time >= interval_ms){
-    pre_time = millis();
-
+  if(is_control_item_group_to_update(GROUP_IMU) == true){
     p_imu_data = sensors.getImuAngularVelocity();
     memcpy(control_items.angular_vel, p_imu_data, sizeof(control_items.angular_vel));
 
@@ -499,23 +667,27 @@ void update_imu(uint32_t interval_ms)
   }  
 }
 
-void update_motor_status(uint32_t interval_ms)
+void update_motor_status(void)
 {
-  static uint32_t pre_time;
-  int16_t current_l, current_r;
+  if(is_control_item_group_to_update(GROUP_MOTOR) == true){
+    read_motor_status();
+  }
+}
 
-  if(millis() - pre_time >= interval_ms){
-    pre_time = millis();
+// Reads the wheels now, whatever the policy of the group.
+void read_motor_status(void)
+{
+  control_item_group[GROUP_MOTOR].pre_time = millis();
 
-    if(get_connection_state_with_motors() == true){
-      motor_driver.read_present_position(control_items.present_position[MortorLocation::LEFT], control_items.present_position[MortorLocation::RIGHT]);
-      motor_driver.read_present_velocity(control_items.present_velocity[MortorLocation::LEFT], control_items.present_velocity[MortorLocation::RIGHT]);
-      if(motor_driver.read_present_current(current_l, current_r) == true){
-        control_items.present_current[MortorLocation::LEFT] = current_l;
-        control_items.present_current[MortorLocation::RIGHT] = current_r;
+  if(get_connection_state_with_motors() == true){
+    if(motor_driver.read_wheel_state(wheel_state) == true){
+      for(uint8_t i = 0; i < MortorLocation::MOTOR_NUM_MAX; i++){
+        control_items.present_position[i] = wheel_state.present_position[i];
+        control_items.present_velocity[i] = wheel_state.present_velocity[i];
+        control_items.present_current[i] = wheel_state.present_current[i];
       }
-
-      control_items.motor_torque_enable_state = motor_driver.get_torque();
+      control_items.motor_torque_enable_state = wheel_state.torque_enable[MortorLocation::LEFT]
+                                             && wheel_state.torque_enable[MortorLocation::RIGHT];
     }
   }
 }
@@ -524,25 +696,100 @@ void update_motor_status(uint32_t interval_ms)
 /*******************************************************************************
 * Callback function definition to be used in communication with the ROS2 node.
 *******************************************************************************/
+static void dxl_slave_timer_handler(void)
+{
+  // Dynamixel2Arduino parses only the bytes already received, so this does not wait for the rest of a packet.
+  if(SERIAL_DXL_SLAVE.available() > 0){
+    dxl_slave.processPacket();
+  }
+
+  // Sent here so that a frame never splits a status packet. If USB is busy, it is sent next time.
+  telemetry_slot.send(SERIAL_DXL_SLAVE);
+}
+
+// Called in the slave interrupt for each item the master reads.
+static void dxl_slave_read_callback_func(uint16_t item_addr, uint8_t &dxl_err_code, void* arg)
+{
+  (void)dxl_err_code;
+  (void)arg;
+
+  for(uint8_t i = 0; i < GROUP_NUM_MAX; i++){
+    if(item_addr >= control_item_group[i].start_addr && item_addr <= control_item_group[i].end_addr){
+      request_control_item_group(i);
+      break;
+    }
+  }
+}
+
+// Called in the slave interrupt. The item is only queued here, it is processed by run().
 static void dxl_slave_write_callback_func(uint16_t item_addr, uint8_t &dxl_err_code, void* arg)
 {
   (void)arg;
+  uint8_t next_head;
+
+  if(item_addr == ADDR_MODEL_INFORM){
+    control_items_slave.model_inform = p_tb3_model_info->model_info;
+    dxl_err_code = DXL_ERR_ACCESS;
+    return;
+  }
+  if(item_addr == ADDR_TELEMETRY_VERSION){
+    control_items_slave.telemetry_version = TELEMETRY_VERSION;
+    dxl_err_code = DXL_ERR_ACCESS;
+    return;
+  }
+
+  next_head = (dxl_slave_write_queue_head + 1) % DXL_SLAVE_WRITE_QUEUE_SIZE;
+  if(next_head == dxl_slave_write_queue_tail){
+    // run() has not taken the previous writes yet, the ROS2 node has to write this item again.
+    dxl_slave_write_queue_overflow++;
+    dxl_err_code = DXL_ERR_RESULT_FAIL;
+    return;
+  }
+  dxl_slave_write_queue[dxl_slave_write_queue_head] = item_addr;
+  dxl_slave_write_queue_head = next_head;
+}
 
+static void publish_control_items(void)
+{
+  uint16_t written_addr[DXL_SLAVE_WRITE_QUEUE_SIZE];
+  uint8_t written_cnt = 0;
+
+  noInterrupts();
+  // Take written items first, so that they are not overwritten by the snapshot.
+  while(dxl_slave_write_queue_tail != dxl_slave_write_queue_head){
+    uint16_t addr = dxl_slave_write_queue[dxl_slave_write_queue_tail];
+    dxl_slave_write_queue_tail = (dxl_slave_write_queue_tail + 1) % DXL_SLAVE_WRITE_QUEUE_SIZE;
+
+    for(uint8_t i = 0; i < control_item_cnt; i++){
+      if(control_item_range[i].addr == addr){
+        memcpy((uint8_t*)&control_items + control_item_range[i].offset,
+               (uint8_t*)&control_items_slave + control_item_range[i].offset,
+               control_item_range[i].length);
+        written_addr[written_cnt++] = addr;
+        break;
+      }
+    }
+  }
+  memcpy(&control_items_slave, &control_items, sizeof(control_items));
+  interrupts();
+
+  for(uint8_t i = 0; i < written_cnt; i++){
+    process_dxl_slave_write(written_addr[i]);
+  }
+}
+
+static void process_dxl_slave_write(uint16_t item_addr)
+{
   switch(item_addr)
   {
-    case ADDR_MODEL_INFORM:
-      control_items.model_inform = p_tb3_model_info->model_info;
-      dxl_err_code = DXL_ERR_ACCESS;
-      break;
-
     case ADDR_SOUND:
       sensors.makeMelody(control_items.buzzer_sound);
       break;
 
     case ADDR_IMU_RECALIBRATION:
       if(control_items.imu_recalibration == true){
+        // Runs in the background, run() clears the item when it has ended.
         sensors.calibrationGyro();
-        control_items.imu_recalibration = false;
       }
       break;
 
@@ -564,10 +811,67 @@ static void dxl_slave_write_callback_func(uint16_t item_addr, uint8_t &dxl_err_c
       if(get_connection_state_with_motors() == true)
         motor_driver.write_profile_acceleration(control_items.profile_acceleration[MortorLocation::LEFT], control_items.profile_acceleration[MortorLocation::RIGHT]);
       break;
+
+    case ADDR_TELEMETRY_INTERVAL:
+      if(control_items.telemetry_interval_ms > 0 && control_items.telemetry_interval_ms < TELEMETRY_INTERVAL_MS_MIN)
+        control_items.telemetry_interval_ms = TELEMETRY_INTERVAL_MS_MIN;
+      break;
   }
 }
 
 
+/*******************************************************************************
+* Function definition to push telemetry frames to the ROS2 node.
+*******************************************************************************/
+void update_telemetry(void)
+{
+  static uint32_t pre_time = 0;
+  static uint8_t seq = 0;
+  TelemetryData data;
+  uint8_t frame[TELEMETRY_FRAME_MAX_SIZE];
+  uint16_t length;
+
+  // A new ROS2 node has to enable it again.
+  if(get_connection_state_with_ros2_node() == false)
+    control_items.telemetry_interval_ms = 0;
+
+  if(control_items.telemetry_interval_ms == 0)
+    return;
+
+  // Keep the streamed items refreshed, the ROS2 node does not read them while streaming.
+  request_control_item_group(GROUP_GPIOS);
+  request_control_item_group(GROUP_BATTERY);
+  request_control_item_group(GROUP_MOTOR);
+
+  if(millis() - pre_time < control_items.telemetry_interval_ms)
+    return;
+  pre_time = millis();
+
+  data.stamp_us = micros();
+  // IMU is read from the sensor directly, so the stream is not limited by the IMU group interval.
+  memcpy(data.angular_vel, sensors.getImuAngularVelocity(), sizeof(data.angular_vel));
+  memcpy(data.linear_acc, sensors.getImuLinearAcc(), sizeof(data.linear_acc));
+  memcpy(data.magnetic, sensors.getImuMagnetic(), sizeof(data.magnetic));
+  memcpy(data.orientation, sensors.getOrientation(), sizeof(data.orientation));
+  for(uint8_t i = 0; i < MortorLocation::MOTOR_NUM_MAX; i++){
+    data.present_position[i] = control_items.present_position[i];
+    data.present_velocity[i] = control_items.present_velocity[i];
+    data.present_current[i] = control_items.present_current[i];
+  }
+  data.torque_enable = control_items.motor_torque_enable_state;
+  data.buttons = (control_items.push_button[0] << 0) | (control_items.push_button[1] << 1)
+               | (control_items.bumper[0] << 2) | (control_items.bumper[1] << 3);
+  data.bat_voltage_x100 = control_items.bat_voltage_x100;
+
+  length = encode_telemetry_frame(data, seq++, frame, sizeof(frame));
+
+  noInterrupts();
+  if(telemetry_slot.put(frame, length) == false)
+    control_items.telemetry_drop_cnt++;
+  interrupts();
+}
+
+
 /*******************************************************************************
 * Function definition to check the connection status with the ROS2 node.
 *******************************************************************************/
@@ -640,8 +944,20 @@ void test_motors_with_buttons(uint8_t buttons)
 
   int32_t current_tick[2] = {0, 0};
 
+  // The test drive uses wheel feedback even when the ROS2 node does not read it.
+  if(buttons != 0 || move[VelocityType::LINEAR] || move[VelocityType::ANGULAR]){
+    request_control_item_group(GROUP_MOTOR);
+  }
+
+  // The start tick is latched from this read, not from one up to an interval old
+  // or from before the group was requested.
+  if(buttons & ((1<<0) | (1<<1))){
+    read_motor_status();
+  }
+
   if(get_connection_state_with_motors() == true){
-    motor_driver.read_present_position(current_tick[MortorLocation::LEFT], current_tick[MortorLocation::RIGHT]);
+    current_tick[MortorLocation::LEFT] = wheel_state.present_position[MortorLocation::LEFT];
+    current_tick[MortorLocation::RIGHT] = wheel_state.present_position[MortorLocation::RIGHT];
   }
 
   if (buttons & (1<<0))  
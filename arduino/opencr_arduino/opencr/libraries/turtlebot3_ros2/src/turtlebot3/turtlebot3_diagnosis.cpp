@@ -118,17 +118,15 @@ uint8_t Turtlebot3Diagnosis::updateVoltageCheck(bool check_setup)
   static uint8_t battery_state       = BATTERY_POWER_OFF;
 
   static bool startup = false;
-  static int vol_index = 0;
   static int prev_state = 0;
   static int alram_state = 0;
   static int check_index = 0;
 
   int i;
-  float vol_sum;
   float vol_value;
 
-  static uint32_t process_time[8] = {0,};
-  static float    vol_value_tbl[10] = {0,};
+  static uint32_t     process_time[8] = {0,};
+  static SignalFilter vol_filter;
 
   float voltage_ref       = 11.0 + 0.0;
   float voltage_ref_warn  = 11.0 + 0.0;
@@ -141,23 +139,14 @@ uint8_t Turtlebot3Diagnosis::updateVoltageCheck(bool check_setup)
     {
       process_time[i] = millis();
     }
+    vol_filter.setAverage(10);
   }
 
   if (millis()-process_time[0] > 100)
   {
     process_time[0] = millis();
 
-    vol_value_tbl[vol_index] = getPowerInVoltage();
-
-    vol_index++;
-    vol_index %= 10;
-
-    vol_sum = 0;
-    for(i=0; i<10; i++)
-    {
-      vol_sum += vol_value_tbl[i];
-    }
-    vol_value = vol_sum/10;
+    vol_value = vol_filter.apply(getPowerInVoltage());
     battery_voltage_raw = vol_value;
 
     //Serial.println(vol_value);
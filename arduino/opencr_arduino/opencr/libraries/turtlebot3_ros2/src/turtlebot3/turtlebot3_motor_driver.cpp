@@ -32,6 +32,17 @@ const float DXL_PORT_PROTOCOL_VERSION = 2.0; // Dynamixel protocol version 2.0
 const uint32_t DXL_PORT_BAUDRATE = 1000000; // baurd rate of Dynamixel
 const int OPENCR_DXL_DIR_PIN = 84; // Arduino pin number of DYNAMIXEL direction pin on OpenCR.
 
+/* Wheel state registers mapped to the indirect data area to read them with one sync read */
+const uint16_t ADDR_INDIRECT_ADDRESS = 168;
+const uint16_t ADDR_INDIRECT_DATA = 224;
+const uint16_t WHEEL_STATE_ADDRESS[] = {
+  64,                                     // Torque Enable
+  70,                                     // Hardware Error Status
+  126, 127,                               // Present Current
+  128, 129, 130, 131,                     // Present Velocity
+  132, 133, 134, 135};                    // Present Position
+const uint16_t WHEEL_STATE_LENGTH = sizeof(WHEEL_STATE_ADDRESS)/sizeof(WHEEL_STATE_ADDRESS[0]);
+
 ParamForSyncReadInst_t sync_read_param;
 ParamForSyncWriteInst_t sync_write_param;
 RecvInfoFromStatusInst_t read_result;
@@ -42,7 +53,8 @@ Dynamixel2Arduino dxl(Serial3, OPENCR_DXL_DIR_PIN);
 Turtlebot3MotorDriver::Turtlebot3MotorDriver()
 : left_wheel_id_(DXL_MOTOR_ID_LEFT),
   right_wheel_id_(DXL_MOTOR_ID_RIGHT),
-  torque_(false)
+  torque_(false),
+  indirect_ready_(false)
 {
 }
 
@@ -71,6 +83,10 @@ bool Turtlebot3MotorDriver::init(void)
   sync_read_param.xel[LEFT].id = left_wheel_id_;
   sync_read_param.xel[RIGHT].id = right_wheel_id_;
 
+  // Indirect address can be changed while torque is off
+  set_torque(false);
+  indirect_ready_ = init_wheel_state_indirect_address();
+
   // Enable Dynamixel Torque
   set_torque(true);
 
@@ -165,6 +181,62 @@ bool Turtlebot3MotorDriver::read_present_current(int16_t &left_value, int16_t &r
   return ret;
 }
 
+bool Turtlebot3MotorDriver::init_wheel_state_indirect_address()
+{
+  sync_write_param.length = 2;
+
+  for(uint16_t i = 0; i < WHEEL_STATE_LENGTH; i++){
+    sync_write_param.addr = ADDR_INDIRECT_ADDRESS + i*2;
+    memcpy(sync_write_param.xel[LEFT].data, &WHEEL_STATE_ADDRESS[i], sync_write_param.length);
+    memcpy(sync_write_param.xel[RIGHT].data, &WHEEL_STATE_ADDRESS[i], sync_write_param.length);
+
+    if(dxl.syncWrite(sync_write_param) == false){
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool Turtlebot3MotorDriver::read_wheel_state(WheelState &state)
+{
+  bool ret = false;
+  uint8_t offset = 0;
+
+  // Without the indirect map, read only the contiguous Present Current..Present Position
+  if(indirect_ready_ == true){
+    sync_read_param.addr = ADDR_INDIRECT_DATA;
+    sync_read_param.length = WHEEL_STATE_LENGTH;
+    offset = 2;
+  }else{
+    sync_read_param.addr = 126;
+    sync_read_param.length = 10;
+    offset = 0;
+  }
+
+  if(dxl.syncRead(sync_read_param, read_result)){
+    state.stamp_us = micros();
+
+    for(uint8_t i = 0; i < MortorLocation::MOTOR_NUM_MAX; i++){
+      uint8_t *p_data = read_result.xel[i].data;
+
+      if(indirect_ready_ == true){
+        state.torque_enable[i] = p_data[0];
+        state.hardware_error_status[i] = p_data[1];
+      }else{
+        state.torque_enable[i] = torque_;
+        state.hardware_error_status[i] = 0;
+      }
+      memcpy(&state.present_current[i], &p_data[offset], 2);
+      memcpy(&state.present_velocity[i], &p_data[offset+2], 4);
+      memcpy(&state.present_position[i], &p_data[offset+6], 4);
+    }
+    ret = true;
+  }
+
+  return ret;
+}
+
 bool Turtlebot3MotorDriver::read_profile_acceleration(uint32_t &left_value, uint32_t &right_value)
 {
   bool ret = false;
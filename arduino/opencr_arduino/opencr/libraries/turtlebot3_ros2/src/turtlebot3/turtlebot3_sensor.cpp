@@ -52,30 +52,14 @@ void Turtlebot3Sensor::updateIMU(void)
 
 void Turtlebot3Sensor::calibrationGyro()
 {
-  uint32_t pre_time;
-  uint32_t t_time;
-
-  const uint8_t led_ros_connect = 3;
-
+  // Returns at once, updateIMU() calibrates on the samples until the robot stays still for a while.
+  // The biases are stored and used at the next boot.
   imu_.SEN.gyro_cali_start();
-  
-  t_time   = millis();
-  pre_time = millis();
-
-  while(!imu_.SEN.gyro_cali_get_done())
-  {
-    imu_.update();
+}
 
-    if (millis()-pre_time > 5000)
-    {
-      break;
-    }
-    if (millis()-t_time > 100)
-    {
-      t_time = millis();
-      setLedToggle(led_ros_connect);
-    }
-  }
+bool Turtlebot3Sensor::isCalibratingGyro(void)
+{
+  return imu_.SEN.gyro_cali_get_done() == false;
 }
 
 float* Turtlebot3Sensor::getImuAngularVelocity(void)
@@ -0,0 +1,236 @@
+/*******************************************************************************
+* Copyright 2016 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include "../../include/turtlebot3/turtlebot3_telemetry.h"
+
+const uint8_t TELEMETRY_HEADER[3] = {0xFF, 0xFF, 0xFC};
+const uint16_t TELEMETRY_BODY_LENGTH = 4 + TELEMETRY_PAYLOAD_LENGTH + 2;
+
+// Same CRC as DYNAMIXEL Protocol 2.0 (polynomial 0x8005)
+static uint16_t update_crc(uint16_t crc, const uint8_t *p_data, uint16_t length)
+{
+  for(uint16_t i = 0; i < length; i++){
+    crc ^= (uint16_t)p_data[i] << 8;
+    for(uint8_t bit = 0; bit < 8; bit++){
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x8005 : (crc << 1);
+    }
+  }
+
+  return crc;
+}
+
+static uint16_t pack_data(uint8_t *p_buf, uint16_t index, const void *p_data, uint16_t length)
+{
+  memcpy(&p_buf[index], p_data, length);
+  return index + length;
+}
+
+static uint16_t unpack_data(const uint8_t *p_buf, uint16_t index, void *p_data, uint16_t length)
+{
+  memcpy(p_data, &p_buf[index], length);
+  return index + length;
+}
+
+
+/*******************************************************************************
+* Encoder (OpenCR)
+*******************************************************************************/
+uint16_t encode_telemetry_frame(const TelemetryData &data, uint8_t seq, uint8_t *p_frame, uint16_t frame_size)
+{
+  uint8_t body[TELEMETRY_BODY_LENGTH];
+  uint16_t index = 0;
+  uint16_t crc;
+  uint16_t length = 0;
+
+  if(frame_size < TELEMETRY_FRAME_MAX_SIZE)
+    return 0;
+
+  body[index++] = TELEMETRY_VERSION;
+  body[index++] = seq;
+  body[index++] = (uint8_t)(TELEMETRY_PAYLOAD_LENGTH & 0xFF);
+  body[index++] = (uint8_t)(TELEMETRY_PAYLOAD_LENGTH >> 8);
+
+  // Both OpenCR and the ROS2 node (x86, ARM) are little-endian.
+  index = pack_data(body, index, &data.stamp_us, 4);
+  index = pack_data(body, index, data.angular_vel, 12);
+  index = pack_data(body, index, data.linear_acc, 12);
+  index = pack_data(body, index, data.magnetic, 12);
+  index = pack_data(body, index, data.orientation, 16);
+  index = pack_data(body, index, data.present_position, 8);
+  index = pack_data(body, index, data.present_velocity, 8);
+  index = pack_data(body, index, data.present_current, 8);
+  index = pack_data(body, index, &data.torque_enable, 1);
+  index = pack_data(body, index, &data.buttons, 1);
+  index = pack_data(body, index, &data.bat_voltage_x100, 4);
+
+  crc = update_crc(0, body, index);
+  body[index++] = (uint8_t)(crc & 0xFF);
+  body[index++] = (uint8_t)(crc >> 8);
+
+  memcpy(p_frame, TELEMETRY_HEADER, sizeof(TELEMETRY_HEADER));
+  length = sizeof(TELEMETRY_HEADER);
+
+  for(uint16_t i = 0; i < index; i++){
+    p_frame[length++] = body[i];
+    if(length >= sizeof(TELEMETRY_HEADER) + 3
+       && p_frame[length-3] == 0xFF && p_frame[length-2] == 0xFF && p_frame[length-1] == 0xFD){
+      p_frame[length++] = 0xFD;
+    }
+  }
+
+  return length;
+}
+
+
+Turtlebot3TelemetrySlot::Turtlebot3TelemetrySlot()
+: length_(0)
+{
+}
+
+bool Turtlebot3TelemetrySlot::put(const uint8_t *p_frame, uint16_t length)
+{
+  bool is_free = (length_ == 0);
+
+  memcpy(frame_, p_frame, length);
+  length_ = length;
+
+  return is_free;
+}
+
+
+/*******************************************************************************
+* Decoder (ROS2 node)
+*******************************************************************************/
+Turtlebot3TelemetryDecoder::Turtlebot3TelemetryDecoder()
+: seq_(0), frame_count_(0), error_count_(0), lost_count_(0)
+{
+  memset(&data_, 0, sizeof(data_));
+  reset();
+}
+
+Turtlebot3TelemetryDecoder::~Turtlebot3TelemetryDecoder()
+{
+}
+
+void Turtlebot3TelemetryDecoder::reset()
+{
+  memset(header_, 0, sizeof(header_));
+  memset(stuff_, 0, sizeof(stuff_));
+  is_in_frame_ = false;
+  body_length_ = 0;
+}
+
+bool Turtlebot3TelemetryDecoder::parse(uint8_t byte)
+{
+  if(is_in_frame_ == false){
+    header_[0] = header_[1];
+    header_[1] = header_[2];
+    header_[2] = byte;
+    if(memcmp(header_, TELEMETRY_HEADER, sizeof(header_)) == 0){
+      reset();
+      is_in_frame_ = true;
+    }
+    return false;
+  }
+
+  // Remove stuffing. Any other byte after 0xFF 0xFF 0xFD is a DYNAMIXEL packet, so the frame was cut.
+  if(stuff_[0] == 0xFF && stuff_[1] == 0xFF && stuff_[2] == 0xFD){
+    memset(stuff_, 0, sizeof(stuff_));
+    if(byte == 0xFD){
+      return false;
+    }
+    error_count_++;
+    reset();
+    return false;
+  }
+  stuff_[0] = stuff_[1];
+  stuff_[1] = stuff_[2];
+  stuff_[2] = byte;
+
+  body_[body_length_++] = byte;
+
+  if(body_length_ == 4){
+    uint16_t payload_length = body_[2] | (body_[3] << 8);
+    if(body_[0] != TELEMETRY_VERSION || payload_length != TELEMETRY_PAYLOAD_LENGTH){
+      error_count_++;
+      reset();
+      return false;
+    }
+  }
+
+  if(body_length_ < TELEMETRY_BODY_LENGTH)
+    return false;
+
+  bool result = decode_body();
+  reset();
+
+  return result;
+}
+
+bool Turtlebot3TelemetryDecoder::decode_body()
+{
+  uint16_t index = 4;
+  uint16_t crc = body_[TELEMETRY_BODY_LENGTH-2] | (body_[TELEMETRY_BODY_LENGTH-1] << 8);
+
+  if(update_crc(0, body_, TELEMETRY_BODY_LENGTH-2) != crc){
+    error_count_++;
+    return false;
+  }
+
+  if(frame_count_ > 0)
+    lost_count_ += (uint8_t)(body_[1] - seq_ - 1);
+  seq_ = body_[1];
+  frame_count_++;
+
+  index = unpack_data(body_, index, &data_.stamp_us, 4);
+  index = unpack_data(body_, index, data_.angular_vel, 12);
+  index = unpack_data(body_, index, data_.linear_acc, 12);
+  index = unpack_data(body_, index, data_.magnetic, 12);
+  index = unpack_data(body_, index, data_.orientation, 16);
+  index = unpack_data(body_, index, data_.present_position, 8);
+  index = unpack_data(body_, index, data_.present_velocity, 8);
+  index = unpack_data(body_, index, data_.present_current, 8);
+  index = unpack_data(body_, index, &data_.torque_enable, 1);
+  index = unpack_data(body_, index, &data_.buttons, 1);
+  index = unpack_data(body_, index, &data_.bat_voltage_x100, 4);
+
+  return true;
+}
+
+const TelemetryData& Turtlebot3TelemetryDecoder::get_data()
+{
+  return data_;
+}
+
+uint8_t Turtlebot3TelemetryDecoder::get_seq()
+{
+  return seq_;
+}
+
+uint32_t Turtlebot3TelemetryDecoder::get_frame_count()
+{
+  return frame_count_;
+}
+
+uint32_t Turtlebot3TelemetryDecoder::get_error_count()
+{
+  return error_count_;
+}
+
+uint32_t Turtlebot3TelemetryDecoder::get_lost_count()
+{
+  return lost_count_;
+}
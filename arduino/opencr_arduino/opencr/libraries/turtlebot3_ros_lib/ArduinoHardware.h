@@ -97,6 +97,32 @@ class ArduinoHardware {
     }
 
     int read(){return iostream->read();};
+
+    // Reads the received data at once, returns the read length
+    int read(uint8_t* data, int length)
+    {
+#if defined(ARDUINO_OpenCR)
+      return iostream->read(data, length);
+#else
+      int count = 0;
+      int ch;
+
+      while (count < length && (ch = iostream->read()) >= 0)
+        data[count++] = ch;
+
+      return count;
+#endif
+    }
+    // Bytes write() takes without waiting
+    int availableForWrite()
+    {
+#if defined(ARDUINO_OpenCR)
+      return iostream->availableForWrite();
+#else
+      return 0x7FFF;
+#endif
+    }
+
     void write(uint8_t* data, int length)
     {
       //for(int i=0; i<length; i++)
@@ -125,6 +151,9 @@ class ArduinoHardware {
 
     unsigned long time(){return millis();}
 
+    // Free running 1MHz hardware timer (TIM5 on OpenCR), usable in interrupts
+    unsigned long time_us(){return micros();}
+
   protected:
     SERIAL_CLASS* iostream;
     long baud_;
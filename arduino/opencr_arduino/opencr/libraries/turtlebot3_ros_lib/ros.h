@@ -50,7 +50,7 @@ namespace ros
 
 #else
   /* Publishers, Subscribers, Buffer Sizes for OpenCR*/
-  typedef NodeHandle_<ArduinoHardware, 25, 25, 1024, 1024> NodeHandle;
+  typedef NodeHandle_<ArduinoHardware, 25, 25, 1024, 1024, 2048> NodeHandle;
 
 #endif
 }
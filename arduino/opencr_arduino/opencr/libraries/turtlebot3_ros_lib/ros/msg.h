@@ -37,6 +37,16 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
+
+/*
+ * Little-endian targets with cheap unaligned access (OpenCR : Cortex-M7) copy
+ * the wire format with whole words instead of byte by byte. ROS_MSG_BYTEWISE
+ * keeps the byte copies, the host benchmark (tests/host/ros) compares both.
+ */
+#if !defined(ROS_MSG_BYTEWISE) && !defined(__AVR__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define ROS_MSG_NATIVE_LITTLE_ENDIAN
+#endif
 
 namespace ros
 {
@@ -63,6 +73,26 @@ public:
    */
   static int serializeAvrFloat64(unsigned char* outbuffer, const float f)
   {
+#if defined(ROS_MSG_NATIVE_LITTLE_ENDIAN)
+    // The double is built in two words, float fields are kept since the
+    // OpenCR FPU is single precision.
+    uint32_t val;
+    uint32_t word[2];
+
+    memcpy(&val, &f, 4);
+
+    uint32_t exp = (val >> 23) & 0xff;
+    if (exp == 0xff)
+      exp = 0x7ff;                    // inf, nan
+    else if (exp != 0)
+      exp += 1023 - 127;
+
+    word[0] = val << 29;
+    word[1] = (val & 0x80000000) | (exp << 20) | ((val >> 3) & 0x000fffff);
+    memcpy(outbuffer, word, 8);
+
+    return 8;
+#else
     const int32_t* val = (int32_t*) &f;
     int32_t exp = ((*val >> 23) & 255);
     if (exp != 0)
@@ -87,6 +117,7 @@ public:
     }
 
     return 8;
+#endif
   }
 
   /**
@@ -101,6 +132,27 @@ public:
    */
   static int deserializeAvrFloat64(const unsigned char* inbuffer, float* f)
   {
+#if defined(ROS_MSG_NATIVE_LITTLE_ENDIAN)
+    uint32_t word[2];
+    uint32_t val;
+
+    memcpy(word, inbuffer, 8);
+
+    uint32_t exp = (word[1] >> 20) & 0x7ff;
+    val = (word[1] & 0x80000000) | ((word[1] & 0x000fffff) << 3) | (word[0] >> 29);
+    if (exp == 0x7ff)
+      val |= 0xffUL << 23;            // inf, nan
+    else if (exp > 1023 + 127)
+      val = (val & 0x80000000) | (0xffUL << 23);  // too large for float : inf
+    else if (exp > 1023 - 127)
+      val |= (exp - 1023 + 127) << 23;
+    else
+      val &= 0x80000000;              // too small for float : 0
+
+    memcpy(f, &val, 4);
+
+    return 8;
+#else
     uint32_t* val = (uint32_t*)f;
     inbuffer += 3;
 
@@ -122,23 +174,32 @@ public:
     *val |= ((uint32_t)(*(inbuffer++)) & 0x80) << 24;
 
     return 8;
+#endif
   }
 
   // Copy data from variable into a byte array
   template<typename A, typename V>
   static void varToArr(A arr, const V var)
   {
+#if defined(ROS_MSG_NATIVE_LITTLE_ENDIAN)
+    memcpy(&arr[0], &var, sizeof(V));
+#else
     for (size_t i = 0; i < sizeof(V); i++)
       arr[i] = (var >> (8 * i));
+#endif
   }
 
   // Copy data from a byte array into variable
   template<typename V, typename A>
   static void arrToVar(V& var, const A arr)
   {
+#if defined(ROS_MSG_NATIVE_LITTLE_ENDIAN)
+    memcpy(&var, &arr[0], sizeof(V));
+#else
     var = 0;
     for (size_t i = 0; i < sizeof(V); i++)
       var |= (arr[i] << (8 * i));
+#endif
   }
 
 };
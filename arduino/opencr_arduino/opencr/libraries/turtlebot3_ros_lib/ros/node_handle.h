@@ -36,6 +36,7 @@
 #define ROS_NODE_HANDLE_H_
 
 #include <stdint.h>
+#include <string.h>
 
 #include "std_msgs/Time.h"
 #include "rosserial_msgs/TopicInfo.h"
@@ -43,6 +44,7 @@
 #include "rosserial_msgs/RequestParam.h"
 
 #include "ros/msg.h"
+#include "ros/prepared_msg.h"
 
 namespace ros
 {
@@ -51,6 +53,8 @@ class NodeHandleBase_
 {
 public:
   virtual int publish(int id, const Msg* msg) = 0;
+  virtual bool prepare(int id, const Msg* msg, PreparedMsgBase_* prepared) = 0;
+  virtual int publish(PreparedMsgBase_* prepared) = 0;
   virtual int spinOnce() = 0;
   virtual bool connected() = 0;
 };
@@ -93,6 +97,35 @@ const uint8_t MODE_MSG_CHECKSUM   = 8;    // checksum for msg and topic id
 
 const uint8_t SERIAL_MSG_TIMEOUT  = 20;   // 20 milliseconds to recieve all of message data
 
+const int RX_CHUNK_SIZE           = 128;  // bytes taken from the serial port at once
+
+/*
+ * Transmit queue : frames of topics are queued and written only when the
+ * serial port can take the whole frame, so publish() does not wait for the
+ * host. Frames written back to back leave in the same USB transfer.
+ * Higher priority frames are written first and dropped last. A topic set to
+ * latest only keeps one frame in the queue, a newer frame replaces it.
+ * Control frames (negotiation, time sync, log, parameters) are not queued.
+ */
+const int TX_QUEUE_FRAMES         = 16;
+const uint8_t TX_PRIORITY_LOW     = 0;
+const uint8_t TX_PRIORITY_NORMAL  = 1;
+const uint8_t TX_PRIORITY_HIGH    = 2;
+
+/*
+ * Time sync : the host stamps its reply somewhere between the request and the
+ * reply, so the reply is taken as the host time at the middle of the round trip
+ * (as NTP does). Replies with a round trip much longer than the shortest recent
+ * one are delayed by the link or the host and are not used. Accepted replies
+ * correct the offset and the drift of the local clock (micros()).
+ */
+const uint32_t SYNC_RTT_MARGIN_US = 2000;     // accepted round trip : 2 * shortest + margin
+const uint32_t SYNC_RTT_AGING_US  = 1000;     // the shortest round trip grows by this per reply
+const uint32_t SYNC_STEP_US       = 100000;   // errors larger than this set the clock again
+const float    SYNC_PHASE_GAIN    = 0.5f;
+const float    SYNC_DRIFT_GAIN    = 0.25f;
+const float    SYNC_DRIFT_MAX     = 0.0005f;  // 500 ppm
+
 using rosserial_msgs::TopicInfo;
 
 /* Node Handle */
@@ -100,7 +133,8 @@ template<class Hardware,
          int MAX_SUBSCRIBERS = 25,
          int MAX_PUBLISHERS = 25,
          int INPUT_SIZE = 512,
-         int OUTPUT_SIZE = 512>
+         int OUTPUT_SIZE = 512,
+         int TX_QUEUE_SIZE = 0>
 class NodeHandle_ : public NodeHandleBase_
 {
 protected:
@@ -108,9 +142,18 @@ protected:
 
   /* time used for syncing */
   uint32_t rt_time;
+  uint32_t rt_time_us;
 
   /* used for computing current time */
   uint32_t sec_offset, nsec_offset;
+  uint32_t base_time_us;          // local time at sec_offset, nsec_offset
+  float drift_;                   // (host clock rate / local clock rate) - 1
+
+  /* time sync statistics */
+  uint32_t sync_count_;
+  uint32_t sync_reject_count_;
+  uint32_t sync_rtt_us_;
+  uint32_t sync_min_rtt_us_;
 
   /* Spinonce maximum work timeout */
   uint32_t spin_timeout_;
@@ -118,6 +161,32 @@ protected:
   uint8_t message_in[INPUT_SIZE];
   uint8_t message_out[OUTPUT_SIZE];
 
+  /* received data not parsed yet */
+  uint8_t rx_buffer_[RX_CHUNK_SIZE];
+  int rx_index_;
+  int rx_length_;
+
+  /* frames waiting for the serial port, in the order they were published */
+  struct TxFrame
+  {
+    int id;
+    int offset;
+    int length;
+    uint8_t priority;
+  };
+  uint8_t tx_buffer_[TX_QUEUE_SIZE > 0 ? TX_QUEUE_SIZE : 1];
+  TxFrame tx_frames_[TX_QUEUE_FRAMES];
+  int tx_frame_count_;
+  int tx_length_;
+
+  uint8_t tx_priority_[MAX_PUBLISHERS];
+  bool tx_latest_only_[MAX_PUBLISHERS];
+
+  /* transmit queue statistics */
+  uint32_t tx_drop_count_;
+  uint32_t tx_replace_count_;
+  int tx_max_length_;
+
   Publisher * publishers[MAX_PUBLISHERS];
   Subscriber_ * subscribers[MAX_SUBSCRIBERS];
 
@@ -129,7 +198,11 @@ public:
   {
 
     for (unsigned int i = 0; i < MAX_PUBLISHERS; i++)
+    {
       publishers[i] = 0;
+      tx_priority_[i] = TX_PRIORITY_NORMAL;
+      tx_latest_only_[i] = false;
+    }
 
     for (unsigned int i = 0; i < MAX_SUBSCRIBERS; i++)
       subscribers[i] = 0;
@@ -140,6 +213,15 @@ public:
     for (unsigned int i = 0; i < OUTPUT_SIZE; i++)
       message_out[i] = 0;
 
+    rx_index_ = 0;
+    rx_length_ = 0;
+
+    tx_frame_count_ = 0;
+    tx_length_ = 0;
+    tx_drop_count_ = 0;
+    tx_replace_count_ = 0;
+    tx_max_length_ = 0;
+
     req_param_resp.ints_length = 0;
     req_param_resp.ints = NULL;
     req_param_resp.floats_length = 0;
@@ -148,6 +230,18 @@ public:
     req_param_resp.ints = NULL;
 
     spin_timeout_ = 0;
+
+    rt_time = 0;
+    rt_time_us = 0;
+    sec_offset = 0;
+    nsec_offset = 0;
+    base_time_us = 0;
+    drift_ = 0.0f;
+
+    sync_count_ = 0;
+    sync_reject_count_ = 0;
+    sync_rtt_us_ = 0;
+    sync_min_rtt_us_ = 0;
   }
 
   Hardware* getHardware()
@@ -211,6 +305,9 @@ public:
 
   virtual int spinOnce()
   {
+    /* write queued frames the serial port can take now */
+    flushTx();
+
     /* restart if timed out */
     uint32_t c_time = hardware_.time();
     if ((c_time - last_sync_receive_time) > (SYNC_SECONDS * 2200))
@@ -243,18 +340,37 @@ public:
           return SPIN_TIMEOUT;
         }
       }
-      int data = hardware_.read();
-      if (data < 0)
-        break;
-      checksum_ += data;
+      /* take all received data at once, bytes left by an early return are parsed first */
+      if (rx_index_ >= rx_length_)
+      {
+        rx_index_ = 0;
+        rx_length_ = hardware_.read(rx_buffer_, RX_CHUNK_SIZE);
+        if (rx_length_ <= 0)
+        {
+          rx_length_ = 0;
+          break;
+        }
+      }
+
       if (mode_ == MODE_MESSAGE)          /* message data being recieved */
       {
-        message_in[index_++] = data;
-        bytes_--;
+        int length = rx_length_ - rx_index_;
+        if (length > bytes_)
+          length = bytes_;
+
+        memcpy(&message_in[index_], &rx_buffer_[rx_index_], length);
+        checksum_ += sumBytes(&rx_buffer_[rx_index_], length);
+        rx_index_ += length;
+        index_ += length;
+        bytes_ -= length;
         if (bytes_ == 0)                 /* is message complete? if so, checksum */
           mode_ = MODE_MSG_CHECKSUM;
+        continue;
       }
-      else if (mode_ == MODE_FIRST_FF)
+
+      int data = rx_buffer_[rx_index_++];
+      checksum_ += data;
+      if (mode_ == MODE_FIRST_FF)
       {
         if (data == 0xff)
         {
@@ -295,10 +411,10 @@ public:
       }
       else if (mode_ == MODE_SIZE_CHECKSUM)
       {
-        if ((checksum_ % 256) == 255)
+        if ((checksum_ % 256) == 255 && bytes_ <= INPUT_SIZE)
           mode_++;
         else
-          mode_ = MODE_FIRST_FF;          /* Abandon the frame if the msg len is wrong */
+          mode_ = MODE_FIRST_FF;          /* Abandon the frame if the msg len is wrong or too long */
       }
       else if (mode_ == MODE_TOPIC_L)     /* bottom half of topic id */
       {
@@ -320,6 +436,7 @@ public:
         {
           if (topic_ == TopicInfo::ID_PUBLISHER)
           {
+            clearTx();
             requestSyncTime();
             negotiateTopics();
             last_sync_time = c_time;
@@ -374,39 +491,142 @@ public:
     std_msgs::Time t;
     publish(TopicInfo::ID_TIME, &t);
     rt_time = hardware_.time();
+    rt_time_us = hardware_.time_us();
   }
 
   void syncTime(uint8_t * data)
   {
     std_msgs::Time t;
-    uint32_t offset = hardware_.time() - rt_time;
+    uint32_t receive_time_us = hardware_.time_us();
+    uint32_t rtt_us = receive_time_us - rt_time_us;
+    uint32_t stamp_us = rt_time_us + rtt_us / 2;
 
     t.deserialize(data);
-    t.data.sec += offset / 1000;
-    t.data.nsec += (offset % 1000) * 1000000UL;
-
-    this->setNow(t.data);
+    normalizeSecNSec(t.data.sec, t.data.nsec);
     last_sync_receive_time = hardware_.time();
+
+    if (sync_count_ > 0)
+    {
+      sync_min_rtt_us_ += SYNC_RTT_AGING_US;
+      if (rtt_us < sync_min_rtt_us_)
+        sync_min_rtt_us_ = rtt_us;
+
+      if (rtt_us > sync_min_rtt_us_ * 2 + SYNC_RTT_MARGIN_US)
+      {
+        sync_reject_count_++;
+        return;
+      }
+    }
+    else
+    {
+      sync_min_rtt_us_ = rtt_us;
+    }
+    sync_rtt_us_ = rtt_us;
+
+    int64_t error_ns = diffNSec(t.data, toTime(stamp_us));
+    int32_t elapsed_us = (int32_t)(stamp_us - base_time_us);
+
+    if (sync_count_ == 0 || error_ns > (int64_t)SYNC_STEP_US * 1000 || error_ns < -(int64_t)SYNC_STEP_US * 1000)
+    {
+      drift_ = 0.0f;
+    }
+    else
+    {
+      if (elapsed_us > 0)
+      {
+        drift_ += SYNC_DRIFT_GAIN * (float)error_ns / ((float)elapsed_us * 1000.0f);
+        if (drift_ > SYNC_DRIFT_MAX)
+          drift_ = SYNC_DRIFT_MAX;
+        else if (drift_ < -SYNC_DRIFT_MAX)
+          drift_ = -SYNC_DRIFT_MAX;
+      }
+
+      /* move the offset part of the way, the rest of the error is jitter of the link */
+      t.data = addNSec(t.data, -(int64_t)((1.0f - SYNC_PHASE_GAIN) * (float)error_ns));
+    }
+
+    sec_offset = t.data.sec;
+    nsec_offset = t.data.nsec;
+    base_time_us = stamp_us;
+    sync_count_++;
   }
 
   Time now()
   {
-    uint32_t ms = hardware_.time()-last_sync_receive_time;
-    Time current_time;
-    current_time.sec = ms / 1000 + sec_offset;
-    current_time.nsec = (ms % 1000) * 1000000UL + nsec_offset;
-    normalizeSecNSec(current_time.sec, current_time.nsec);
-    return current_time;
+    return toTime(hardware_.time_us());
+  }
+
+  /* ROS time of a local timestamp taken with micros(), e.g. when a sensor was sampled */
+  Time toTime(uint32_t stamp_us)
+  {
+    Time base_time(sec_offset, nsec_offset);
+    int32_t elapsed_us = (int32_t)(stamp_us - base_time_us);
+    int64_t elapsed_ns = (int64_t)elapsed_us * 1000 + (int64_t)((float)elapsed_us * drift_ * 1000.0f);
+
+    return addNSec(base_time, elapsed_ns);
   }
 
   void setNow(Time & new_now)
   {
-    //uint32_t ms = hardware_.time();
     sec_offset = new_now.sec;
     nsec_offset = new_now.nsec;
     normalizeSecNSec(sec_offset, nsec_offset);
+    base_time_us = hardware_.time_us();
+  }
+
+  uint32_t getSyncRoundTrip()
+  {
+    return sync_rtt_us_;
+  }
+
+  float getSyncDrift()
+  {
+    return drift_;
+  }
+
+  uint32_t getSyncRejectCount()
+  {
+    return sync_reject_count_;
+  }
+
+protected:
+  static int sumBytes(const uint8_t * data, int length)
+  {
+    int sum = 0;
+    for (int i = 0; i < length; i++)
+      sum += data[i];
+    return sum;
+  }
+
+  static Time addNSec(const Time & t, int64_t nsec)
+  {
+    int64_t sec = (int64_t)t.sec + nsec / 1000000000;
+    nsec = (int64_t)t.nsec + nsec % 1000000000;
+
+    if (nsec < 0)
+    {
+      nsec += 1000000000;
+      sec--;
+    }
+    else if (nsec >= 1000000000)
+    {
+      nsec -= 1000000000;
+      sec++;
+    }
+
+    Time result;
+    result.sec = (uint32_t)sec;
+    result.nsec = (uint32_t)nsec;
+    return result;
+  }
+
+  static int64_t diffNSec(const Time & a, const Time & b)
+  {
+    return ((int64_t)a.sec - (int64_t)b.sec) * 1000000000 + ((int64_t)a.nsec - (int64_t)b.nsec);
   }
 
+public:
+
   /********************************************************************
    * Topic Management
    */
@@ -513,6 +733,216 @@ public:
     if (id >= 100 && !configured_)
       return 0;
 
+    int l = serializeFrame(id, msg);
+
+    if (l <= OUTPUT_SIZE)
+    {
+      if (id >= 100)
+        return queueTx(id, message_out, l);
+
+      hardware_.write(message_out, l);
+      return l;
+    }
+    else
+    {
+      logerror("Message from device dropped: message larger than buffer.");
+      return -1;
+    }
+  }
+
+  /* Serialize a message once, then only changed fields are written before each publish */
+  virtual bool prepare(int id, const Msg * msg, PreparedMsgBase_ * prepared)
+  {
+    int l = serializeFrame(id, msg);
+
+    if (l > OUTPUT_SIZE || l > prepared->getSize())
+    {
+      prepared->invalidate();
+      return false;
+    }
+
+    memcpy(prepared->getFrame(), message_out, l);
+    prepared->setFrame(l);
+    return true;
+  }
+
+  virtual int publish(PreparedMsgBase_ * prepared)
+  {
+    if (!configured_ || !prepared->isPrepared())
+      return 0;
+
+    uint8_t * frame = prepared->getFrame();
+    return queueTx(frame[5] | (frame[6] << 8), frame, prepared->getLength());
+  }
+
+  /********************************************************************
+   * Transmit queue
+   */
+
+  /* Frames of a topic are written first with a higher priority, a latest only topic keeps only its newest frame */
+  bool setTxPriority(Publisher & p, uint8_t priority, bool latest_only = false)
+  {
+    int index = p.id_ - 100 - MAX_SUBSCRIBERS;
+    if (index < 0 || index >= MAX_PUBLISHERS)
+      return false;
+
+    tx_priority_[index] = priority;
+    tx_latest_only_[index] = latest_only;
+    return true;
+  }
+
+  /* Writes queued frames while the serial port can take them, does not wait */
+  void flushTx()
+  {
+    while (tx_frame_count_ > 0)
+    {
+      /* the oldest frame of the highest priority, and the frames of the same priority after it */
+      int first = 0;
+      for (int i = 1; i < tx_frame_count_; i++)
+      {
+        if (tx_frames_[i].priority > tx_frames_[first].priority)
+          first = i;
+      }
+
+      int available = hardware_.availableForWrite();
+      int last = first;
+      int length = tx_frames_[first].length;
+      if (available < length)
+        break;
+
+      while (last + 1 < tx_frame_count_
+             && tx_frames_[last + 1].priority == tx_frames_[first].priority
+             && length + tx_frames_[last + 1].length <= available)
+      {
+        last++;
+        length += tx_frames_[last].length;
+      }
+
+      hardware_.write(&tx_buffer_[tx_frames_[first].offset], length);
+      removeTx(first, last - first + 1);
+    }
+  }
+
+  /* Discards the queued frames */
+  void clearTx()
+  {
+    tx_frame_count_ = 0;
+    tx_length_ = 0;
+  }
+
+  int getTxQueueLength()
+  {
+    return tx_length_;
+  }
+
+  int getTxQueueMaxLength()
+  {
+    return tx_max_length_;
+  }
+
+  int getTxQueueFrames()
+  {
+    return tx_frame_count_;
+  }
+
+  uint32_t getTxDropCount()
+  {
+    return tx_drop_count_;
+  }
+
+  uint32_t getTxReplaceCount()
+  {
+    return tx_replace_count_;
+  }
+
+protected:
+  int queueTx(int id, const uint8_t * frame, int length)
+  {
+    if (TX_QUEUE_SIZE == 0 || length > TX_QUEUE_SIZE)
+    {
+      flushTx();
+      hardware_.write((uint8_t *)frame, length);
+      return length;
+    }
+
+    int index = id - 100 - MAX_SUBSCRIBERS;
+    uint8_t priority = TX_PRIORITY_NORMAL;
+    bool latest_only = false;
+    if (index >= 0 && index < MAX_PUBLISHERS)
+    {
+      priority = tx_priority_[index];
+      latest_only = tx_latest_only_[index];
+    }
+
+    /* the queued frame is older than this one and was not sent yet */
+    if (latest_only)
+    {
+      for (int i = 0; i < tx_frame_count_; i++)
+      {
+        if (tx_frames_[i].id == id)
+        {
+          removeTx(i, 1);
+          tx_replace_count_++;
+          break;
+        }
+      }
+    }
+
+    flushTx();
+
+    /* make room by dropping the oldest frame of the lowest priority, up to the priority of this frame */
+    while (tx_frame_count_ >= TX_QUEUE_FRAMES || tx_length_ + length > TX_QUEUE_SIZE)
+    {
+      int lowest = -1;
+      for (int i = 0; i < tx_frame_count_; i++)
+      {
+        if (tx_frames_[i].priority <= priority
+            && (lowest < 0 || tx_frames_[i].priority < tx_frames_[lowest].priority))
+          lowest = i;
+      }
+
+      tx_drop_count_++;
+      if (lowest < 0)
+        return -1;
+
+      removeTx(lowest, 1);
+    }
+
+    TxFrame & tx_frame = tx_frames_[tx_frame_count_++];
+    tx_frame.id = id;
+    tx_frame.offset = tx_length_;
+    tx_frame.length = length;
+    tx_frame.priority = priority;
+    memcpy(&tx_buffer_[tx_length_], frame, length);
+    tx_length_ += length;
+    if (tx_length_ > tx_max_length_)
+      tx_max_length_ = tx_length_;
+
+    flushTx();
+    return length;
+  }
+
+  /* Removes 'count' frames from 'index' and moves the frames after them to the front */
+  void removeTx(int index, int count)
+  {
+    int offset = tx_frames_[index].offset;
+    int end = tx_frames_[index + count - 1].offset + tx_frames_[index + count - 1].length;
+    int length = end - offset;
+
+    memmove(&tx_buffer_[offset], &tx_buffer_[end], tx_length_ - end);
+    tx_length_ -= length;
+
+    for (int i = index; i + count < tx_frame_count_; i++)
+    {
+      tx_frames_[i] = tx_frames_[i + count];
+      tx_frames_[i].offset -= length;
+    }
+    tx_frame_count_ -= count;
+  }
+
+  /* Serialize a message with the frame header and the checksum into message_out */
+  int serializeFrame(int id, const Msg * msg)
+  {
     /* serialize message */
     int l = msg->serialize(message_out + 7);
 
@@ -532,18 +962,11 @@ public:
     l += 7;
     message_out[l++] = 255 - (chk % 256);
 
-    if (l <= OUTPUT_SIZE)
-    {
-      hardware_.write(message_out, l);
-      return l;
-    }
-    else
-    {
-      logerror("Message from device dropped: message larger than buffer.");
-      return -1;
-    }
+    return l;
   }
 
+public:
+
   /********************************************************************
    * Logging
    */
@@ -0,0 +1,189 @@
+/*******************************************************************************
+* Copyright 2016 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef _ROS_PREPARED_MSG_H_
+#define _ROS_PREPARED_MSG_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ros/msg.h"
+#include "ros/time.h"
+
+namespace ros
+{
+
+const int PREPARED_FRAME_HEADER_SIZE = 7;    // 0xff, protocol, length(2), length checksum, topic id(2)
+
+/*
+ * A message serialized once into a complete frame by NodeHandle::prepare().
+ * Fields that change are written over at their byte offset in the message
+ * and the frame checksum is corrected by the difference, so publishing the
+ * frame sends the same bytes as serializing the whole message again.
+ * Strings and array lengths must not change, prepare the message again
+ * (or invalidate() it) when they do.
+ */
+class PreparedMsgBase_
+{
+public:
+  PreparedMsgBase_(uint8_t * frame, int size) :
+    frame_(frame),
+    size_(size),
+    length_(0),
+    checksum_(0) {};
+
+  bool isPrepared() const
+  {
+    return length_ > 0;
+  }
+
+  void invalidate()
+  {
+    length_ = 0;
+  }
+
+  uint8_t * getFrame()
+  {
+    return frame_;
+  }
+
+  int getSize() const
+  {
+    return size_;
+  }
+
+  int getLength() const
+  {
+    return length_;
+  }
+
+  /* Called by NodeHandle after the frame is copied in */
+  void setFrame(int length)
+  {
+    length_ = length;
+    checksum_ = 0;
+    for (int i = 5; i < length_ - 1; i++)
+      checksum_ += frame_[i];
+  }
+
+  bool setUint32(int offset, uint32_t value)
+  {
+    uint8_t data[4];
+    Msg::varToArr(data, value);
+    return patch(offset, data, 4);
+  }
+
+  bool setTime(int offset, const Time & t)
+  {
+    uint8_t data[8];
+    Msg::varToArr(data, t.sec);
+    Msg::varToArr(data + 4, t.nsec);
+    return patch(offset, data, 8);
+  }
+
+  bool setFloat64(int offset, const float value)
+  {
+    uint8_t data[8];
+    Msg::serializeAvrFloat64(data, value);
+    return patch(offset, data, 8);
+  }
+
+  /* Fixed size sub-messages only (Vector3, Point, Quaternion, Pose, Twist).
+     The size is known from the type, so the message is serialized straight
+     into the frame once it is known to fit. */
+  bool setMsg(int offset, const Msg & msg)
+  {
+    int length = fixedMsgSize(const_cast<Msg &>(msg).getType());
+    if (length == 0 || !fits(offset, length))
+      return false;
+
+    uint8_t * dest = frame_ + PREPARED_FRAME_HEADER_SIZE + offset;
+    for (int i = 0; i < length; i++)
+      checksum_ -= dest[i];
+    msg.serialize(dest);
+    for (int i = 0; i < length; i++)
+      checksum_ += dest[i];
+    frame_[length_ - 1] = 255 - (checksum_ % 256);
+
+    return true;
+  }
+
+  /* Serialized size of the types setMsg() takes, 0 for any other */
+  static int fixedMsgSize(const char * type)
+  {
+    static const struct
+    {
+      const char * type;
+      int size;
+    } sizes[] =
+    {
+      { "geometry_msgs/Vector3",    24 },
+      { "geometry_msgs/Point",      24 },
+      { "geometry_msgs/Quaternion", 32 },
+      { "geometry_msgs/Pose",       56 },
+      { "geometry_msgs/Twist",      48 },
+    };
+
+    for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+      if (strcmp(type, sizes[i].type) == 0)
+        return sizes[i].size;
+    }
+    return 0;
+  }
+
+private:
+  uint8_t * frame_;
+  int size_;
+  int length_;
+  int checksum_;
+
+  /* offset is counted from the start of the serialized message, the checksum byte is not part of it */
+  bool fits(int offset, int length) const
+  {
+    return offset >= 0 && offset <= length_ - 1 - PREPARED_FRAME_HEADER_SIZE - length;
+  }
+
+  bool patch(int offset, const uint8_t * data, int length)
+  {
+    if (!fits(offset, length))
+      return false;
+
+    uint8_t * dest = frame_ + PREPARED_FRAME_HEADER_SIZE + offset;
+    for (int i = 0; i < length; i++)
+    {
+      checksum_ += data[i] - dest[i];
+      dest[i] = data[i];
+    }
+    frame_[length_ - 1] = 255 - (checksum_ % 256);
+
+    return true;
+  }
+};
+
+template<int SIZE>
+class PreparedMsg : public PreparedMsgBase_
+{
+public:
+  PreparedMsg() : PreparedMsgBase_(buffer_, SIZE) {};
+
+private:
+  uint8_t buffer_[SIZE];
+};
+
+}
+
+#endif
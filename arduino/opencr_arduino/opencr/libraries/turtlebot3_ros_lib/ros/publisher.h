@@ -54,6 +54,16 @@ public:
   {
     return nh_->publish(id_, msg);
   };
+
+  /* Prepared message : serialized once by prepare(), fields are updated with its set functions */
+  bool prepare(PreparedMsgBase_ & prepared, const Msg * msg)
+  {
+    return nh_->prepare(id_, msg, &prepared);
+  };
+  int publish(PreparedMsgBase_ & prepared)
+  {
+    return nh_->publish(&prepared);
+  };
   int getEndpointType()
   {
     return endpoint_;
@@ -63,6 +63,12 @@ uint8_t vcp_getch(void)
 }
 
 
+uint32_t vcp_read(uint8_t *p_data, uint32_t length)
+{
+  return CDC_Itf_Read( p_data, length );
+}
+
+
 int32_t vcp_write(uint8_t *p_data, uint32_t length)
 {
   int32_t  ret;
@@ -125,4 +131,16 @@ int32_t vcp_printf( const char *fmt, ...)
 BOOL vcp_is_transmitted( void )
 {
   return CDC_Itf_IsTxTransmitted();
+}
+
+
+uint32_t vcp_tx_available(void)
+{
+  uint32_t length;
+
+  // CDC_Itf_Write() needs one more byte than the data length.
+  length = CDC_Itf_TxAvailable();
+  if (length > 0) length--;
+
+  return length;
 }
\ No newline at end of file
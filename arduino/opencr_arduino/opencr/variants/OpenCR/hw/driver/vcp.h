@@ -26,7 +26,9 @@ int32_t  vcp_peek(void);
 BOOL     vcp_is_connected(void);
 void     vcp_putch(uint8_t ch);
 uint8_t  vcp_getch(void);
+uint32_t vcp_read(uint8_t *p_data, uint32_t length);
 int32_t  vcp_write(uint8_t *p_data, uint32_t length);
+uint32_t vcp_tx_available(void);
 
 int32_t  vcp_printf( const char *fmt, ...);
 
@@ -89,7 +89,6 @@ static int8_t CDC_Itf_DeInit(void);
 static int8_t CDC_Itf_Control(uint8_t cmd, uint8_t* pbuf, uint16_t length);
        void   CDC_Itf_TxISR(void);
 static int8_t CDC_Itf_Receive(uint8_t* pbuf, uint32_t *Len);
-static uint32_t CDC_Itf_TxAvailable( void );
 
 
 
@@ -555,6 +554,48 @@ uint8_t CDC_Itf_Getch( void )
 }
 
 
+/*---------------------------------------------------------------------------
+     TITLE   : CDC_Itf_Read
+     WORK    : copies up to length received bytes, returns the copied length
+---------------------------------------------------------------------------*/
+uint32_t CDC_Itf_Read( uint8_t *p_buf, uint32_t length )
+{
+  uint32_t buffptr;
+  uint32_t buffsize;
+  uint32_t available;
+
+
+  available = CDC_Itf_Available();
+  if (length > available)
+  {
+    length = available;
+  }
+
+  buffptr  = rxd_BufPtrOut;
+  buffsize = APP_RX_BUF_SIZE - buffptr;
+  if (buffsize > length)
+  {
+    buffsize = length;
+  }
+
+  // The data can wrap around the end of the ring buffer
+  memcpy(p_buf, &rxd_buffer[buffptr], buffsize);
+  memcpy(&p_buf[buffsize], &rxd_buffer[0], length - buffsize);
+
+  buffptr += length;
+  if (buffptr >= APP_RX_BUF_SIZE)
+  {
+    buffptr -= APP_RX_BUF_SIZE;
+  }
+
+  __disable_irq();
+  rxd_BufPtrOut = buffptr;
+  __enable_irq();
+
+  return length;
+}
+
+
 BOOL CDC_Itf_IsTxTransmitted( void )
 {
   return (UserTxBufPtrIn == UserTxBufPtrOut) ? TRUE : FALSE;
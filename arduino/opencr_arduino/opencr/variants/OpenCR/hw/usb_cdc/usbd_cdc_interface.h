@@ -47,9 +47,11 @@ int32_t  CDC_Itf_Write( uint8_t *p_buf, uint32_t length );
 BOOL     CDC_Itf_IsAvailable( void );
 uint32_t CDC_Itf_Available( void );
 uint8_t  CDC_Itf_Getch( void );
+uint32_t CDC_Itf_Read( uint8_t *p_buf, uint32_t length );
 int32_t  CDC_Itf_Peek( void );
 BOOL     CDC_Itf_IsConnected( void );
 BOOL     CDC_Itf_IsTxTransmitted( void );
+uint32_t CDC_Itf_TxAvailable( void );
 
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
@@ -0,0 +1,92 @@
+/*
+  bench_signal_filter.cpp - cost of SignalFilter::apply() per sample
+
+  Prints the time of one sample for each filter type, from the fastest of
+  a few runs over all the samples. An average includes the samples that
+  re-sum its ring. Host times only compare the types with each other, on
+  the board use the DWT cycle counter as cIMU::getFilterCycles() does.
+
+    bench_signal_filter [samples]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "SignalFilter.h"
+
+
+#define BENCH_RUNS  5
+
+
+typedef std::chrono::steady_clock bench_clock;
+
+static volatile float bench_sink;
+
+
+static void bench( const char *name, SignalFilter &filter, uint32_t samples )
+{
+  bench_clock::time_point start;
+  double   elapsed;
+  double   best = -1.;
+  float    input;
+  uint32_t run;
+  uint32_t n;
+
+  for (run = 0; run < BENCH_RUNS; run++)
+  {
+    filter.reset();
+    input = 0.0f;
+
+    start = bench_clock::now();
+    for (n = 0; n < samples; n++)
+    {
+      input += 0.37f;
+      if (input > 100.0f) input -= 200.0f;
+
+      bench_sink = filter.apply(input);
+    }
+    elapsed = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+
+    if (best < 0. || elapsed < best)
+    {
+      best = elapsed;
+    }
+  }
+
+  printf("%-12s %8.2f ns/sample\n", name, best / samples);
+}
+
+int main( int argc, char **argv )
+{
+  SignalFilter filter;
+  uint32_t samples = 100000;
+
+  if (argc > 1)
+  {
+    samples = strtoul(argv[1], NULL, 0);
+  }
+  if (samples == 0)
+  {
+    return 2;
+  }
+
+  filter.setNone();
+  bench("none", filter, samples);
+
+  filter.setAverage(3);
+  bench("average 3", filter, samples);
+
+  filter.setAverage(SIGNAL_FILTER_AVERAGE_MAX);
+  bench("average 16", filter, samples);
+
+  filter.setLowPass1(10.0f, 200.0f);
+  bench("lowpass1", filter, samples);
+
+  filter.setLowPass2(10.0f, 200.0f);
+  bench("lowpass2", filter, samples);
+
+  filter.setNotch(50.0f, 200.0f);
+  bench("notch", filter, samples);
+
+  return 0;
+}
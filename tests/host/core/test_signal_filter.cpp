@@ -0,0 +1,141 @@
+/*
+  test_signal_filter.cpp - responses of the SignalFilter types
+*/
+
+#include <math.h>
+#include "SignalFilter.h"
+#include "host_test.h"
+
+
+#define FS_HZ     200.0f
+
+static const double test_pi = 3.14159265358979323846;
+
+
+// Peak output of a unit sine once the filter settled
+static float gain( SignalFilter &filter, float freq_hz )
+{
+  float peak = 0.0f;
+  float out;
+  int   n;
+
+  filter.reset();
+  for (n = 0; n < 8000; n++)
+  {
+    out = filter.apply((float)sin(2. * test_pi * freq_hz * n / FS_HZ));
+    if (n >= 6000 && fabsf(out) > peak)
+    {
+      peak = out;
+    }
+  }
+
+  return peak;
+}
+
+static void test_lowpass1( void )
+{
+  SignalFilter filter;
+
+  CHECK(filter.setLowPass1(10.0f, FS_HZ) == true);
+  CHECK(filter.getType() == SIGNAL_FILTER_LOWPASS1);
+  CHECK_NEAR(gain(filter, 0.5f), 1.0, 0.01);
+  CHECK_NEAR(gain(filter, 10.0f), 0.7071, 0.02);
+  CHECK(gain(filter, 50.0f) < 0.25f);
+
+  CHECK(filter.setLowPass1(0.0f, FS_HZ) == false);
+  CHECK(filter.setLowPass1(100.0f, FS_HZ) == false);
+}
+
+static void test_lowpass2( void )
+{
+  SignalFilter filter;
+
+  CHECK(filter.setLowPass2(10.0f, FS_HZ) == true);
+  CHECK(filter.getType() == SIGNAL_FILTER_LOWPASS2);
+  CHECK_NEAR(gain(filter, 0.5f), 1.0, 0.01);
+  CHECK_NEAR(gain(filter, 10.0f), 0.7071, 0.02);
+  // 40 dB per decade, a first order would still pass 0.2
+  CHECK(gain(filter, 50.0f) < 0.05f);
+
+  CHECK(filter.setLowPass2(10.0f, FS_HZ, 0.0f) == false);
+}
+
+static void test_notch( void )
+{
+  SignalFilter filter;
+
+  CHECK(filter.setNotch(50.0f, FS_HZ) == true);
+  CHECK(filter.getType() == SIGNAL_FILTER_NOTCH);
+  CHECK(gain(filter, 50.0f) < 0.01f);
+  CHECK_NEAR(gain(filter, 5.0f), 1.0, 0.02);
+  CHECK_NEAR(gain(filter, 95.0f), 1.0, 0.02);
+}
+
+static void test_average( void )
+{
+  SignalFilter filter;
+  int n;
+
+  CHECK(filter.setAverage(0) == false);
+  CHECK(filter.setAverage(SIGNAL_FILTER_AVERAGE_MAX + 1) == false);
+  CHECK(filter.setAverage(4) == true);
+
+  // Starts at the first input, then the mean of the last 4
+  CHECK_NEAR(filter.apply(8.0f), 8.0, 1e-6);
+  CHECK_NEAR(filter.apply(0.0f), 6.0, 1e-6);
+  CHECK_NEAR(filter.apply(0.0f), 4.0, 1e-6);
+  CHECK_NEAR(filter.apply(0.0f), 2.0, 1e-6);
+  CHECK_NEAR(filter.apply(0.0f), 0.0, 1e-6);
+
+  // Averaging over its length removes a sine of that period entirely
+  CHECK(filter.setAverage(8) == true);
+  CHECK(gain(filter, FS_HZ / 8.0f) < 1e-4f);
+
+  // The running sum does not drift over a long run
+  filter.reset();
+  for (n = 0; n < 1000000; n++)
+  {
+    filter.apply((n & 1) ? 1000.1f : -999.7f);
+  }
+  CHECK_NEAR(filter.apply(0.2f), (4 * 1000.1 + 3 * -999.7 + 0.2) / 8.0, 1e-3);
+}
+
+static void test_priming( void )
+{
+  SignalFilter filter;
+
+  // A constant input comes out as it is from the first sample on
+  CHECK(filter.setLowPass2(5.0f, FS_HZ) == true);
+  CHECK_NEAR(filter.apply(11.5f), 11.5, 1e-4);
+  CHECK_NEAR(filter.apply(11.5f), 11.5, 1e-4);
+
+  filter.reset();
+  CHECK_NEAR(filter.apply(-3.0f), -3.0, 1e-4);
+
+  filter.setNone();
+  CHECK(filter.getType() == SIGNAL_FILTER_NONE);
+  CHECK(filter.apply(42.0f) == 42.0f);
+}
+
+static void test_deadband( void )
+{
+  SignalFilter filter;
+
+  filter.setDeadband(4.0f);
+  CHECK(filter.apply(3.99f) == 0.0f);
+  CHECK(filter.apply(-3.99f) == 0.0f);
+  CHECK(filter.apply(4.0f) == 4.0f);
+  CHECK(filter.apply(-4.5f) == -4.5f);
+}
+
+int main( void )
+{
+  test_lowpass1();
+  test_lowpass2();
+  test_notch();
+  test_average();
+  test_priming();
+  test_deadband();
+
+  return 0;
+}
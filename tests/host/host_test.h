@@ -0,0 +1,34 @@
+/*
+  host_test.h - checks of the host tests, a test fails with the first one
+*/
+
+#ifndef _HOST_TEST_H_
+#define _HOST_TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) \
+    { \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      exit(1); \
+    } \
+  } while (0)
+
+#define CHECK_NEAR(a, b, tol) \
+  do { \
+    double check_a_ = (a); \
+    double check_b_ = (b); \
+    if (!(fabs(check_a_ - check_b_) <= (tol))) \
+    { \
+      fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s, %s) failed: %g vs %g\n", \
+              __FILE__, __LINE__, #a, #b, #tol, check_a_, check_b_); \
+      exit(1); \
+    } \
+  } while (0)
+
+#endif /* _HOST_TEST_H_ */
@@ -0,0 +1,189 @@
+/*
+  bench_ahrs.cpp - host time of one update of each AHRS filter, next to its
+  orientation error, on logs of a known motion
+
+  An update is one replaySample(): the sample through the calibration and
+  the filter, as the board processes a sample of the sensor. Host ns only
+  compare the filters with each other.
+
+    bench_ahrs [samples]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "IMU.h"
+#include "imu_log.h"
+#include "imu_synth.h"
+#include "host_stub.h"
+
+
+#define BENCH_RUNS      5
+#define SETTLE_SAMPLES  200
+
+
+typedef std::chrono::steady_clock bench_clock;
+
+typedef struct
+{
+  const char *name;
+  float rate_dps[3];
+  float rate_hz[3];
+} bench_motion_t;
+
+typedef struct
+{
+  double ns;                // per update, fastest run
+  float  rms;               // deg, without the first SETTLE_SAMPLES
+  float  max;
+} bench_result_t;
+
+
+static const bench_motion_t motions[] =
+{
+  // name          rate_dps                rate_hz
+  { "still",       {  0.0f,  0.0f,  0.0f }, { 0.0f, 0.0f, 0.0f } },
+  { "yaw 10 dps",  {  0.0f,  0.0f, 10.0f }, { 0.0f, 0.0f, 0.0f } },
+  { "tumble",      { 40.0f, 30.0f, 90.0f }, { 0.3f, 0.7f, 0.2f } },
+};
+
+static const struct
+{
+  const char *name;
+  uint8_t     type;
+} filters[] =
+{
+  { "madgwick", IMU_FILTER_MADGWICK },
+  { "mahony",   IMU_FILTER_MAHONY   },
+  { "ekf",      IMU_FILTER_EKF      },
+};
+
+
+static bench_result_t bench( uint8_t filter, const imu_log_header_t &header,
+                             const std::vector<imu_log_sample_t> &samples,
+                             const std::vector<imu_synth_truth_t> &truth )
+{
+  static cIMU imu;
+  std::vector<imu_synth_truth_t> quat(samples.size());
+  bench_result_t result = { -1.0, 0.0f, 0.0f };
+  bench_clock::time_point start;
+  double   ns;
+  double   sum = 0.;
+  float    deg;
+  uint32_t run;
+  size_t   i;
+
+  imu.setFilter(filter);
+
+  for (run = 0; run < BENCH_RUNS; run++)
+  {
+    imu.replayBegin(&header);
+    start = bench_clock::now();
+    for (i = 0; i < samples.size(); i++)
+    {
+      imu.replaySample(&samples[i]);
+      memcpy(quat[i].q, imu.quat, sizeof(quat[i].q));
+    }
+    ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+    imu.replayEnd();
+
+    ns /= samples.size();
+    if (result.ns < 0. || ns < result.ns)
+    {
+      result.ns = ns;
+    }
+  }
+
+  // Every run gives the same orientations
+  for (i = SETTLE_SAMPLES; i < samples.size(); i++)
+  {
+    deg  = imu_synth_error_deg(quat[i].q, truth[i].q);
+    sum += deg * deg;
+    if (deg > result.max)
+    {
+      result.max = deg;
+    }
+  }
+  result.rms = (float)sqrt(sum / (samples.size() - SETTLE_SAMPLES));
+
+  return result;
+}
+
+int main( int argc, char **argv )
+{
+  std::vector<uint8_t> log;
+  std::vector<imu_synth_truth_t> truth;
+  std::vector<imu_log_sample_t>  samples;
+  imu_log_header_t header;
+  cIMULogReader    reader;
+  imu_synth_t      cfg;
+  bench_result_t   result;
+  uint32_t count = 20000;
+  size_t   m;
+  size_t   f;
+  size_t   i;
+
+  if (argc > 1)
+  {
+    count = strtoul(argv[1], NULL, 0);
+  }
+  if (count <= SETTLE_SAMPLES)
+  {
+    return 2;
+  }
+
+  host_eeprom_erase();
+
+  printf("%-12s %-10s %10s %10s %10s\n", "motion", "filter", "ns/update", "deg rms", "deg max");
+  for (m = 0; m < sizeof(motions) / sizeof(motions[0]); m++)
+  {
+    imu_synth_default(&cfg);
+    cfg.samples = count;
+    for (f = 0; f < 3; f++)
+    {
+      cfg.rate_dps[f] = motions[m].rate_dps[f];
+      cfg.rate_hz[f]  = motions[m].rate_hz[f];
+    }
+    cfg.gyro_bias[0] = -12;
+    cfg.gyro_bias[2] = 20;
+    cfg.seed         = m + 1;
+
+    log.clear();
+    truth.clear();
+    imu_synth_log(&cfg, log, &truth);
+
+    // Decoded once, the log reader is not timed
+    samples.clear();
+    for (i = 0; i < log.size(); i++)
+    {
+      switch (reader.feed(log[i]))
+      {
+        case IMU_LOG_TYPE_HEADER:
+          header = reader.header;
+          break;
+
+        case IMU_LOG_TYPE_SAMPLE:
+          samples.push_back(reader.sample);
+          break;
+
+        default:
+          break;
+      }
+    }
+    if (reader.getErrorCount() != 0 || samples.size() != truth.size())
+    {
+      return 1;
+    }
+
+    for (f = 0; f < sizeof(filters) / sizeof(filters[0]); f++)
+    {
+      result = bench(filters[f].type, header, samples, truth);
+      printf("%-12s %-10s %10.1f %10.2f %10.2f\n",
+             motions[m].name, filters[f].name, result.ns, result.rms, result.max);
+    }
+  }
+
+  return 0;
+}
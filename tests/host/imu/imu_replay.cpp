@@ -0,0 +1,135 @@
+/*
+  imu_replay.cpp - runs an IMU log captured with cIMU::startCapture()
+  through the filters of the IMU library
+
+    imu_replay [-f madgwick|mahony|ekf] [-v] <log>   prints the orientation
+    imu_replay --synth <log>                        writes a log of a known turn
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "IMU.h"
+#include "imu_log.h"
+#include "imu_synth.h"
+
+
+static int usage( void )
+{
+  fprintf(stderr, "usage: imu_replay [-f madgwick|mahony|ekf] [-v] <log>\n"
+                  "       imu_replay --synth <log>\n");
+  return 2;
+}
+
+static int write_synth( const char *path )
+{
+  std::vector<uint8_t> log;
+  imu_synth_t cfg;
+  FILE *fp;
+
+  imu_synth_default(&cfg);
+  cfg.rate_dps[2]  = 10.0f;
+  cfg.gyro_bias[2] = 20;
+  imu_synth_log(&cfg, log, NULL);
+
+  fp = fopen(path, "wb");
+  if (fp == NULL)
+  {
+    perror(path);
+    return 1;
+  }
+  fwrite(log.data(), 1, log.size(), fp);
+  fclose(fp);
+
+  return 0;
+}
+
+int main( int argc, char **argv )
+{
+  static cIMU   imu;
+  cIMULogReader reader;
+  uint8_t  filter  = IMU_FILTER_MADGWICK;
+  bool     verbose = false;
+  bool     header  = false;
+  uint32_t samples = 0;
+  const char *path = NULL;
+  FILE *fp;
+  int   c;
+  int   i;
+
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--synth") == 0 && i + 1 < argc)
+    {
+      return write_synth(argv[i + 1]);
+    }
+    else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+    {
+      i++;
+      if      (strcmp(argv[i], "madgwick") == 0) filter = IMU_FILTER_MADGWICK;
+      else if (strcmp(argv[i], "mahony") == 0)   filter = IMU_FILTER_MAHONY;
+      else if (strcmp(argv[i], "ekf") == 0)      filter = IMU_FILTER_EKF;
+      else return usage();
+    }
+    else if (strcmp(argv[i], "-v") == 0)
+    {
+      verbose = true;
+    }
+    else if (path == NULL)
+    {
+      path = argv[i];
+    }
+    else
+    {
+      return usage();
+    }
+  }
+  if (path == NULL)
+  {
+    return usage();
+  }
+
+  fp = fopen(path, "rb");
+  if (fp == NULL)
+  {
+    perror(path);
+    return 1;
+  }
+
+  imu.setFilter(filter);
+  while ((c = fgetc(fp)) != EOF)
+  {
+    switch (reader.feed((uint8_t)c))
+    {
+      case IMU_LOG_TYPE_HEADER:
+        imu.replayBegin(&reader.header);
+        header = true;
+        break;
+
+      case IMU_LOG_TYPE_SAMPLE:
+        if (header == false)
+        {
+          break;
+        }
+        imu.replaySample(&reader.sample);
+        samples++;
+        if (verbose == true)
+        {
+          printf("%10u %9.3f %9.3f %9.3f\n", (unsigned)reader.sample.stamp_us,
+                 imu.rpy[0], imu.rpy[1], imu.rpy[2]);
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+  fclose(fp);
+  imu.replayEnd();
+
+  printf("samples %u errors %u roll %.3f pitch %.3f yaw %.3f\n",
+         (unsigned)samples, (unsigned)reader.getErrorCount(),
+         imu.rpy[0], imu.rpy[1], imu.rpy[2]);
+
+  return (header == true && samples > 0) ? 0 : 1;
+}
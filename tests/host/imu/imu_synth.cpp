@@ -0,0 +1,183 @@
+/*
+  imu_synth.cpp - IMU logs of a known motion
+*/
+
+#include <math.h>
+#include <string.h>
+#include "imu_log.h"
+#include "imu_synth.h"
+
+
+#define SYNTH_SUBSTEPS    16      // integration steps of the true motion per sample
+#define SYNTH_PI          3.14159265358979323846
+
+
+// Same sequence on every host, rand() is not
+static uint32_t synth_random( uint32_t *p_state )
+{
+  *p_state = *p_state * 1664525u + 1013904223u;
+  return *p_state >> 8;
+}
+
+static float synth_noise( uint32_t *p_state, float amplitude )
+{
+  return amplitude * (2.0f * (float)synth_random(p_state) / (float)(1u << 24) - 1.0f);
+}
+
+static int16_t synth_lsb( double value )
+{
+  value = floor(value + 0.5);
+  if (value >  32767.) value =  32767.;
+  if (value < -32768.) value = -32768.;
+  return (int16_t)value;
+}
+
+static void synth_rate( const imu_synth_t *p_cfg, double t, double *p_rate_rad )
+{
+  uint8_t axis;
+
+  for (axis = 0; axis < 3; axis++)
+  {
+    p_rate_rad[axis] = p_cfg->rate_dps[axis] * SYNTH_PI / 180.;
+    if (p_cfg->rate_hz[axis] > 0.0f)
+    {
+      p_rate_rad[axis] *= sin(2. * SYNTH_PI * p_cfg->rate_hz[axis] * t);
+    }
+  }
+}
+
+// q = q * (rotation of rate during dt), as the filters integrate the gyro
+static void synth_rotate( double *q, const double *rate, double dt )
+{
+  double angle = sqrt(rate[0]*rate[0] + rate[1]*rate[1] + rate[2]*rate[2]) * dt;
+  double r[4];
+  double p[4];
+  double s;
+  double n;
+
+  if (angle <= 0.)
+  {
+    return;
+  }
+  s    = sin(angle / 2.) / angle * dt;
+  r[0] = cos(angle / 2.);
+  r[1] = rate[0] * s;
+  r[2] = rate[1] * s;
+  r[3] = rate[2] * s;
+
+  p[0] = q[0]*r[0] - q[1]*r[1] - q[2]*r[2] - q[3]*r[3];
+  p[1] = q[0]*r[1] + q[1]*r[0] + q[2]*r[3] - q[3]*r[2];
+  p[2] = q[0]*r[2] - q[1]*r[3] + q[2]*r[0] + q[3]*r[1];
+  p[3] = q[0]*r[3] + q[1]*r[2] - q[2]*r[1] + q[3]*r[0];
+
+  n = sqrt(p[0]*p[0] + p[1]*p[1] + p[2]*p[2] + p[3]*p[3]);
+  q[0] = p[0] / n;
+  q[1] = p[1] / n;
+  q[2] = p[2] / n;
+  q[3] = p[3] / n;
+}
+
+template <typename T>
+static void synth_append( std::vector<uint8_t> &log, T *p_record )
+{
+  p_record->checksum = imu_log_checksum(p_record, sizeof(T) - 1);
+  log.insert(log.end(), (uint8_t *)p_record, (uint8_t *)p_record + sizeof(T));
+}
+
+
+
+void imu_synth_default( imu_synth_t *p_cfg )
+{
+  memset(p_cfg, 0, sizeof(imu_synth_t));
+
+  p_cfg->period_us  = 5000;
+  p_cfg->samples    = 2000;
+  p_cfg->gyro_noise = 2.0f;
+  p_cfg->acc_noise  = 20.0f;
+  p_cfg->seed       = 1;
+}
+
+void imu_synth_log( const imu_synth_t *p_cfg, std::vector<uint8_t> &log,
+                    std::vector<imu_synth_truth_t> *p_truth )
+{
+  imu_log_header_t  header;
+  imu_log_sample_t  sample;
+  imu_synth_truth_t truth;
+  uint32_t state = p_cfg->seed;
+  double   q[4]  = { 1., 0., 0., 0. };
+  double   rate[3];
+  double   dt    = p_cfg->period_us / 1000000.;
+  double   t     = 0.;
+  double   gravity[3];
+  uint32_t i;
+  uint32_t step;
+  uint8_t  axis;
+
+  memset(&header, 0, sizeof(header));
+  header.sync      = IMU_LOG_SYNC;
+  header.type      = IMU_LOG_TYPE_HEADER;
+  header.version   = IMU_LOG_VERSION;
+  header.fifo      = 1;
+  header.period_us = p_cfg->period_us;
+  header.aRes      = 1.0f / IMU_SYNTH_ACC_LSB_PER_G;
+  header.gRes      = 1.0f / IMU_SYNTH_GYRO_LSB_PER_DPS;
+  header.mRes      = 1.0f;
+  for (axis = 0; axis < 3; axis++)
+  {
+    header.gyroZero[axis] = p_cfg->gyro_bias[axis];
+  }
+  synth_append(log, &header);
+
+  for (i = 0; i < p_cfg->samples; i++)
+  {
+    // The sensor measures the rate at the end of the period it integrates
+    for (step = 0; step < SYNTH_SUBSTEPS; step++)
+    {
+      synth_rate(p_cfg, t + dt * (step + 0.5) / SYNTH_SUBSTEPS, rate);
+      synth_rotate(q, rate, dt / SYNTH_SUBSTEPS);
+    }
+    t += dt;
+    synth_rate(p_cfg, t, rate);
+
+    // Earth z (up) in the body frame, a still sensor reads +1 g on it
+    gravity[0] = 2. * (q[1]*q[3] - q[0]*q[2]);
+    gravity[1] = 2. * (q[0]*q[1] + q[2]*q[3]);
+    gravity[2] = q[0]*q[0] - q[1]*q[1] - q[2]*q[2] + q[3]*q[3];
+
+    memset(&sample, 0, sizeof(sample));
+    sample.sync     = IMU_LOG_SYNC;
+    sample.type     = IMU_LOG_TYPE_SAMPLE;
+    sample.stamp_us = (i + 1) * p_cfg->period_us;
+    for (axis = 0; axis < 3; axis++)
+    {
+      sample.acc[axis]  = synth_lsb(gravity[axis] * IMU_SYNTH_ACC_LSB_PER_G
+                                    + synth_noise(&state, p_cfg->acc_noise));
+      sample.gyro[axis] = synth_lsb(rate[axis] * 180. / SYNTH_PI * IMU_SYNTH_GYRO_LSB_PER_DPS
+                                    + p_cfg->gyro_bias[axis]
+                                    + synth_noise(&state, p_cfg->gyro_noise));
+    }
+    synth_append(log, &sample);
+
+    if (p_truth != NULL)
+    {
+      for (axis = 0; axis < 4; axis++)
+      {
+        truth.q[axis] = (float)q[axis];
+      }
+      p_truth->push_back(truth);
+    }
+  }
+}
+
+float imu_synth_error_deg( const float *q_a, const float *q_b )
+{
+  double dot = q_a[0]*q_b[0] + q_a[1]*q_b[1] + q_a[2]*q_b[2] + q_a[3]*q_b[3];
+
+  dot = fabs(dot);
+  if (dot > 1.)
+  {
+    dot = 1.;
+  }
+
+  return (float)(2. * acos(dot) * 180. / SYNTH_PI);
+}
@@ -0,0 +1,47 @@
+/*
+  imu_synth.h - IMU logs of a known motion
+
+  The body turns at a rate given per axis, the log holds what the sensor
+  would have measured (gravity and rate plus bias and noise) and the true
+  orientation of every sample is kept aside to compare the filters with.
+*/
+
+#ifndef _IMU_SYNTH_H_
+#define _IMU_SYNTH_H_
+
+#include <stdint.h>
+#include <vector>
+
+
+typedef struct
+{
+  uint32_t period_us;
+  uint32_t samples;
+  float    rate_dps[3];     // rate of each axis, its amplitude if rate_hz is not 0
+  float    rate_hz[3];      // 0 for a constant rate
+  int16_t  gyro_bias[3];    // LSB, the header tells the replay about them
+  float    gyro_noise;      // LSB, uniform noise of +/- this much
+  float    acc_noise;       // LSB
+  uint32_t seed;
+} imu_synth_t;
+
+typedef struct
+{
+  float    q[4];            // w, x, y, z, body to earth as the AHRS filters
+} imu_synth_truth_t;
+
+
+#define IMU_SYNTH_ACC_LSB_PER_G     4096.0f   // +/-8 g
+#define IMU_SYNTH_GYRO_LSB_PER_DPS  16.384f   // +/-2000 dps
+
+
+void imu_synth_default( imu_synth_t *p_cfg );
+
+// Appends a header and p_cfg->samples sample records to log
+void imu_synth_log( const imu_synth_t *p_cfg, std::vector<uint8_t> &log,
+                    std::vector<imu_synth_truth_t> *p_truth );
+
+// Angle in degrees between two orientations
+float imu_synth_error_deg( const float *q_a, const float *q_b );
+
+#endif /* _IMU_SYNTH_H_ */
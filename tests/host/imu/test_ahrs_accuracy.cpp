@@ -0,0 +1,156 @@
+/*
+  test_ahrs_accuracy.cpp - orientation error of each filter on logs of a
+  known motion, replayed as the board would
+
+  Prints the RMS and the largest error of every filter and motion, the
+  first second is left out while the filters settle.
+*/
+
+#include <stdio.h>
+#include <vector>
+#include "IMU.h"
+#include "imu_log.h"
+#include "imu_synth.h"
+#include "host_stub.h"
+#include "host_test.h"
+
+
+#define SETTLE_SAMPLES  200
+
+
+typedef struct
+{
+  const char *name;
+  float rate_dps[3];
+  float rate_hz[3];
+  float limit_rms[3];     // Madgwick, Mahony, EKF
+} motion_t;
+
+typedef struct
+{
+  float rms;
+  float max;
+} ahrs_error_t;
+
+
+static const motion_t motions[] =
+{
+  // name          rate_dps                rate_hz              limit_rms
+  { "still",       {  0.0f,  0.0f,  0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.5f } },
+  { "yaw 10 dps",  {  0.0f,  0.0f, 10.0f }, { 0.0f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.5f } },
+  { "roll swing",  { 60.0f,  0.0f,  0.0f }, { 0.5f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } },
+  { "tumble",      { 40.0f, 30.0f, 90.0f }, { 0.3f, 0.7f, 0.2f }, { 1.0f, 1.0f, 3.0f } },
+};
+
+static const struct
+{
+  const char *name;
+  uint8_t     type;
+} filters[] =
+{
+  { "madgwick", IMU_FILTER_MADGWICK },
+  { "mahony",   IMU_FILTER_MAHONY   },
+  { "ekf",      IMU_FILTER_EKF      },
+};
+
+
+static ahrs_error_t replay( uint8_t filter, const std::vector<uint8_t> &log,
+                            const std::vector<imu_synth_truth_t> &truth )
+{
+  static cIMU   imu;
+  cIMULogReader reader;
+  ahrs_error_t  error = { 0.0f, 0.0f };
+  double        sum   = 0.;
+  uint32_t      count = 0;
+  uint32_t      index = 0;
+  float         deg;
+  size_t        i;
+
+  CHECK(imu.setFilter(filter) == true);
+
+  for (i = 0; i < log.size(); i++)
+  {
+    switch (reader.feed(log[i]))
+    {
+      case IMU_LOG_TYPE_HEADER:
+        imu.replayBegin(&reader.header);
+        break;
+
+      case IMU_LOG_TYPE_SAMPLE:
+        imu.replaySample(&reader.sample);
+        if (index >= SETTLE_SAMPLES)
+        {
+          deg  = imu_synth_error_deg(imu.quat, truth[index].q);
+          sum += deg * deg;
+          count++;
+          if (deg > error.max)
+          {
+            error.max = deg;
+          }
+        }
+        index++;
+        break;
+
+      default:
+        break;
+    }
+  }
+  imu.replayEnd();
+
+  CHECK(reader.getErrorCount() == 0);
+  CHECK(index == truth.size());
+
+  error.rms = (float)sqrt(sum / count);
+
+  return error;
+}
+
+int main( void )
+{
+  std::vector<uint8_t> log;
+  std::vector<imu_synth_truth_t> truth;
+  imu_synth_t  cfg;
+  ahrs_error_t error;
+  size_t       m;
+  size_t       f;
+
+  host_eeprom_erase();
+
+  printf("%-12s", "deg rms/max");
+  for (f = 0; f < sizeof(filters) / sizeof(filters[0]); f++)
+  {
+    printf(" %16s", filters[f].name);
+  }
+  printf("\n");
+
+  for (m = 0; m < sizeof(motions) / sizeof(motions[0]); m++)
+  {
+    imu_synth_default(&cfg);
+    cfg.samples = 4000;
+    for (f = 0; f < 3; f++)
+    {
+      cfg.rate_dps[f] = motions[m].rate_dps[f];
+      cfg.rate_hz[f]  = motions[m].rate_hz[f];
+    }
+    cfg.gyro_bias[0] = -12;
+    cfg.gyro_bias[2] = 20;
+    cfg.seed         = m + 1;
+
+    log.clear();
+    truth.clear();
+    imu_synth_log(&cfg, log, &truth);
+
+    printf("%-12s", motions[m].name);
+    for (f = 0; f < sizeof(filters) / sizeof(filters[0]); f++)
+    {
+      error = replay(filters[f].type, log, truth);
+      printf("    %5.2f / %5.2f", error.rms, error.max);
+      fflush(stdout);
+
+      CHECK(error.rms <= motions[m].limit_rms[f]);
+    }
+    printf("\n");
+  }
+
+  return 0;
+}
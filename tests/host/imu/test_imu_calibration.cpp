@@ -0,0 +1,317 @@
+/*
+  test_imu_calibration.cpp - biases of cIMUCalibration from still and moving
+  sample streams, their tracking and their record in the emulated EEPROM
+
+  Samples go through the same steps as cIMUDevice::cali_update(), which
+  stores the biases only when a requested calibration ended still.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "imu_calibration.h"
+#include "drv_eeprom.h"
+#include "host_stub.h"
+#include "host_test.h"
+
+
+#define TEST_MODEL          1     // cIMUDevice::MPU9250
+#define TEST_OTHER_MODEL    2
+
+#define TEST_ACC_1G         4096
+
+
+typedef struct
+{
+  float gyro[3];          // mean of the samples
+  float acc[3];
+  float gyro_noise;       // uniform, +/- this much
+  float acc_noise;
+} test_motion_t;
+
+
+static uint32_t test_state = 1;
+
+static float noise( float amplitude )
+{
+  test_state = test_state * 1664525u + 1013904223u;
+  return amplitude * ((float)(test_state >> 8) / (float)(1u << 24) * 2.0f - 1.0f);
+}
+
+// One window of samples as cIMUDevice::cali_update() hands them over.
+// Returns true if a bias changed, the biases are stored as there.
+static bool window( cIMUCalibration &cali, const test_motion_t &motion )
+{
+  int32_t gyro[3];
+  int32_t acc[3];
+  uint8_t pending;
+  bool    changed = false;
+  int     n;
+  int     axis;
+
+  for (n = 0; n < IMU_CALI_WINDOW; n++)
+  {
+    for (axis = 0; axis < 3; axis++)
+    {
+      gyro[axis] = (int32_t)lroundf(motion.gyro[axis] + noise(motion.gyro_noise));
+      acc[axis]  = (int32_t)lroundf(motion.acc[axis] + noise(motion.acc_noise));
+    }
+
+    pending = cali.pending();
+    if (cali.update(gyro, acc) == true)
+    {
+      CHECK(n == IMU_CALI_WINDOW - 1);
+      changed = true;
+      if (pending != 0 && cali.pending() == 0 && cali.endedStill() == true)
+      {
+        CHECK(cali.save(TEST_MODEL));
+      }
+    }
+  }
+
+  return changed;
+}
+
+static void read_record( uint8_t *p_data )
+{
+  int i;
+
+  for (i = 0; i < IMU_CALI_EEPROM_LENGTH; i++)
+  {
+    p_data[i] = drv_eeprom_read_byte(IMU_CALI_EEPROM_ADDR + i);
+  }
+}
+
+static void test_still( void )
+{
+  static const test_motion_t still = { { 30.0f, -20.0f, 10.0f }, { 100.0f, -50.0f, TEST_ACC_1G + 40.0f }, 3.0f, 20.0f };
+  cIMUCalibration cali;
+  uint8_t  record[IMU_CALI_EEPROM_LENGTH];
+  uint8_t  checksum = 0;
+  uint32_t writes;
+  int16_t  zero[3];
+  int      i;
+
+  host_eeprom_erase();
+  CHECK(cali.load(TEST_MODEL) == false);
+
+  cali.start(IMU_CALI_GYRO | IMU_CALI_ACC);
+  CHECK(cali.pending() == (IMU_CALI_GYRO | IMU_CALI_ACC));
+  CHECK(cali.calibrated() == 0);
+
+  // The first still window ends the calibration
+  CHECK(window(cali, still));
+  CHECK(cali.isStill() && cali.endedStill());
+  CHECK(cali.pending() == 0);
+  CHECK(cali.calibrated() == (IMU_CALI_GYRO | IMU_CALI_ACC));
+  for (i = 0; i < 3; i++)
+  {
+    CHECK_NEAR(cali.gyroBias[i], still.gyro[i], 0.5);
+    CHECK(cali.gyroVar[i] <= IMU_CALI_GYRO_VAR);
+  }
+  CHECK_NEAR(cali.accBias[0], still.acc[0], 3.0);
+  CHECK_NEAR(cali.accBias[1], still.acc[1], 3.0);
+  CHECK(cali.accBias[2] == 0.0f);     // gravity stays
+
+  // and is stored, magic byte, model, biases and checksum at 0x0F00
+  writes = host_eeprom_write_count();
+  CHECK(writes > 0 && writes <= IMU_CALI_EEPROM_LENGTH);
+  read_record(record);
+  CHECK(record[0] == 0xCA);
+  CHECK(record[1] == TEST_MODEL);
+  cali.getGyroZero(zero);
+  for (i = 0; i < 3; i++)
+  {
+    CHECK((int16_t)(record[2 + i*2] | (record[3 + i*2] << 8)) == zero[i]);
+  }
+  cali.getAccZero(zero);
+  for (i = 0; i < 3; i++)
+  {
+    CHECK((int16_t)(record[8 + i*2] | (record[9 + i*2] << 8)) == zero[i]);
+  }
+  for (i = 0; i < IMU_CALI_EEPROM_LENGTH - 1; i++)
+  {
+    checksum += record[i];
+  }
+  CHECK(record[IMU_CALI_EEPROM_LENGTH - 1] == checksum);
+
+  // Saving the same biases again writes nothing
+  CHECK(cali.save(TEST_MODEL));
+  CHECK(host_eeprom_write_count() == writes);
+}
+
+static void test_moving( void )
+{
+  test_motion_t   motion = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, TEST_ACC_1G }, 0.0f, 30.0f };
+  cIMUCalibration stored;
+  cIMUCalibration cali;
+  uint32_t writes;
+  int      n;
+  int      i;
+
+  // Biases of an earlier still calibration are stored
+  host_eeprom_erase();
+  for (i = 0; i < 3; i++)
+  {
+    stored.gyroBias[i] = 5.0f * (i + 1);
+  }
+  CHECK(stored.save(TEST_MODEL));
+  writes = host_eeprom_write_count();
+
+  // A robot that keeps turning: every window is too noisy, the seventh the
+  // least so, each one with its own mean
+  cali.start(IMU_CALI_GYRO);
+  for (n = 0; n < IMU_CALI_WINDOW_MAX; n++)
+  {
+    for (i = 0; i < 3; i++)
+    {
+      motion.gyro[i] = 40.0f + n * 3.0f + i;
+    }
+    motion.gyro_noise = (n == 6) ? 12.0f : 40.0f + n;
+
+    CHECK(window(cali, motion) == (n == IMU_CALI_WINDOW_MAX - 1));
+    CHECK(cali.isStill() == false);
+    if (n < IMU_CALI_WINDOW_MAX - 1)
+    {
+      CHECK(cali.pending() == IMU_CALI_GYRO);
+    }
+  }
+
+  // After the last window the quietest one is taken, but not stored
+  CHECK(cali.pending() == 0);
+  CHECK(cali.calibrated() == IMU_CALI_GYRO);
+  CHECK(cali.endedStill() == false);
+  for (i = 0; i < 3; i++)
+  {
+    CHECK_NEAR(cali.gyroBias[i], 40.0f + 6 * 3.0f + i, 1.5);
+  }
+  CHECK(host_eeprom_write_count() == writes);
+  CHECK(cali.load(TEST_MODEL));
+  for (i = 0; i < 3; i++)
+  {
+    CHECK(cali.gyroBias[i] == 5.0f * (i + 1));
+  }
+}
+
+static void test_tracking( void )
+{
+  static const test_motion_t still = { { 20.0f, 20.0f, 20.0f }, { 0.0f, 0.0f, TEST_ACC_1G }, 2.0f, 10.0f };
+  test_motion_t   motion = still;
+  cIMUCalibration cali;
+  float    bias[3];
+  uint32_t writes;
+  int      i;
+
+  host_eeprom_erase();
+  cali.start(IMU_CALI_GYRO);
+  CHECK(window(cali, still));
+  CHECK(cali.endedStill());
+  writes = host_eeprom_write_count();
+  memcpy(bias, cali.gyroBias, sizeof(bias));
+
+  // Drift within the limit is followed by a share of it in each still window
+  for (i = 0; i < 3; i++)
+  {
+    motion.gyro[i] = bias[i] + 5.0f;
+  }
+  CHECK(window(cali, motion));
+  for (i = 0; i < 3; i++)
+  {
+    CHECK_NEAR(cali.gyroBias[i] - bias[i], IMU_CALI_TRACK_GAIN * 5.0f, 0.2);
+  }
+
+  // A change larger than the limit is a slow turn, not drift
+  memcpy(bias, cali.gyroBias, sizeof(bias));
+  motion.gyro[2] = bias[2] + IMU_CALI_TRACK_LIMIT + 4.0f;
+  CHECK(window(cali, motion) == false);
+  CHECK(cali.isStill());
+  CHECK(memcmp(bias, cali.gyroBias, sizeof(bias)) == 0);
+
+  // Windows that are not still are not followed
+  motion.gyro[2]    = bias[2] + 3.0f;
+  motion.gyro_noise = 20.0f;
+  CHECK(window(cali, motion) == false);
+  CHECK(memcmp(bias, cali.gyroBias, sizeof(bias)) == 0);
+
+  // Nor anything with tracking off
+  motion.gyro_noise = still.gyro_noise;
+  cali.setTracking(false);
+  CHECK(window(cali, motion) == false);
+  CHECK(memcmp(bias, cali.gyroBias, sizeof(bias)) == 0);
+
+  // Tracked drift is never stored
+  cali.setTracking(true);
+  CHECK(window(cali, motion));
+  CHECK(host_eeprom_write_count() == writes);
+}
+
+static void test_record( void )
+{
+  cIMUCalibration cali;
+  cIMUCalibration loaded;
+  uint8_t record[IMU_CALI_EEPROM_LENGTH];
+  uint8_t bad[IMU_CALI_EEPROM_LENGTH];
+  int16_t zero[3];
+  int16_t loaded_zero[3];
+  int     i;
+
+  host_eeprom_erase();
+  cali.gyroBias[0] = -1234.4f;
+  cali.gyroBias[1] = 0.6f;
+  cali.gyroBias[2] = 32767.0f;
+  cali.accBias[0]  = -32768.0f;
+  cali.accBias[1]  = 255.5f;
+  cali.accBias[2]  = -1.0f;
+  CHECK(cali.save(TEST_MODEL));
+  read_record(record);
+
+  // The rounded biases come back, for the sensor they were stored for
+  CHECK(loaded.load(TEST_MODEL));
+  CHECK(loaded.calibrated() == (IMU_CALI_GYRO | IMU_CALI_ACC));
+  cali.getGyroZero(zero);
+  loaded.getGyroZero(loaded_zero);
+  CHECK(memcmp(zero, loaded_zero, sizeof(zero)) == 0);
+  cali.getAccZero(zero);
+  loaded.getAccZero(loaded_zero);
+  CHECK(memcmp(zero, loaded_zero, sizeof(zero)) == 0);
+  CHECK(loaded.gyroBias[0] == -1234.0f && loaded.accBias[0] == -32768.0f);
+  CHECK(cIMUCalibration().load(TEST_OTHER_MODEL) == false);
+
+  // A wrong magic byte, a wrong checksum or any changed byte is not loaded
+  for (i = 0; i < IMU_CALI_EEPROM_LENGTH; i++)
+  {
+    cIMUCalibration other;
+
+    memcpy(bad, record, sizeof(bad));
+    bad[i] ^= 0x01;
+    drv_eeprom_write_byte(IMU_CALI_EEPROM_ADDR + i, bad[i]);
+    CHECK(other.load(TEST_MODEL) == false);
+    CHECK(other.calibrated() == 0);
+    CHECK(other.gyroBias[0] == 0.0f);
+    drv_eeprom_write_byte(IMU_CALI_EEPROM_ADDR + i, record[i]);
+  }
+  CHECK(cIMUCalibration().load(TEST_MODEL));
+
+  // An EEPROM that ends before the end of the record is neither read nor
+  // written
+  host_eeprom_set_length(IMU_CALI_EEPROM_ADDR + IMU_CALI_EEPROM_LENGTH - 1);
+  CHECK(cIMUCalibration().load(TEST_MODEL) == false);
+  i = host_eeprom_write_count();
+  cali.gyroBias[1] = 100.0f;
+  CHECK(cali.save(TEST_MODEL) == false);
+  CHECK(host_eeprom_write_count() == (uint32_t)i);
+
+  host_eeprom_set_length(IMU_CALI_EEPROM_ADDR + IMU_CALI_EEPROM_LENGTH);
+  CHECK(cIMUCalibration().load(TEST_MODEL));
+}
+
+
+int main( void )
+{
+  test_still();
+  test_moving();
+  test_tracking();
+  test_record();
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+/*
+  test_imu_replay.cpp - a replay only depends on the log
+*/
+
+#include <vector>
+#include "IMU.h"
+#include "imu_log.h"
+#include "imu_synth.h"
+#include "host_stub.h"
+#include "host_test.h"
+
+
+static void replay( cIMU &imu, const std::vector<uint8_t> &log, float *p_quat, float *p_rpy )
+{
+  cIMULogReader reader;
+  size_t i;
+
+  for (i = 0; i < log.size(); i++)
+  {
+    switch (reader.feed(log[i]))
+    {
+      case IMU_LOG_TYPE_HEADER: imu.replayBegin(&reader.header); break;
+      case IMU_LOG_TYPE_SAMPLE: imu.replaySample(&reader.sample); break;
+      default:                  break;
+    }
+  }
+  imu.replayEnd();
+  CHECK(reader.getErrorCount() == 0);
+
+  for (i = 0; i < 4; i++) p_quat[i] = imu.quat[i];
+  for (i = 0; i < 3; i++) p_rpy[i]  = imu.rpy[i];
+}
+
+int main( void )
+{
+  static cIMU imu;
+  std::vector<uint8_t> log;
+  std::vector<uint8_t> moving;
+  imu_synth_t cfg;
+  float quat[3][4];
+  float rpy[3][3];
+  int   run;
+  int   i;
+
+  host_eeprom_erase();
+
+  // Still, turning at 10 dps about z for 10 s with a gyro bias
+  imu_synth_default(&cfg);
+  cfg.rate_dps[2]  = 10.0f;
+  cfg.gyro_bias[2] = 20;
+  imu_synth_log(&cfg, log, NULL);
+
+  // A robot that never stays still
+  imu_synth_default(&cfg);
+  cfg.rate_dps[0] = 30.0f;
+  cfg.rate_hz[0]  = 0.5f;
+  cfg.seed        = 2;
+  imu_synth_log(&cfg, moving, NULL);
+
+  // A calibration pending on the device and samples before the replay must
+  // not change the result nor end up in the EEPROM
+  imu.SEN.gyro_cali_start();
+  for (run = 0; run < 3; run++)
+  {
+    replay(imu, log, quat[run], rpy[run]);
+    if (run == 0)
+    {
+      replay(imu, moving, quat[1], rpy[1]);
+    }
+  }
+
+  for (i = 0; i < 4; i++)
+  {
+    CHECK(quat[0][i] == quat[1][i]);
+    CHECK(quat[0][i] == quat[2][i]);
+  }
+  CHECK_NEAR(rpy[0][2], 100.0, 1.0);
+  CHECK(imu.SEN.gyro_cali_get_done() == false);
+  CHECK(host_eeprom_write_count() == 0);
+
+  return 0;
+}
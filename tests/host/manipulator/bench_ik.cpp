@@ -0,0 +1,131 @@
+/*
+  bench_ik.cpp - the inverse kinematics solvers of the OpenManipulator-X on
+  reachable poses, a solve starting OM_CHAIN_START_OFFSET away from each
+
+  Prints how many poses each solver reached and the time of one solve. The
+  DLS solver runs cold and warm started from the pose before, as it does
+  from tick to tick. Host times only compare the solvers with each other.
+
+    bench_ik [poses]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <chrono>
+#include "om_chain.h"
+
+using namespace kinematics;
+
+
+#define BENCH_SEED  1
+
+
+typedef std::chrono::steady_clock bench_clock;
+
+typedef struct
+{
+  uint32_t reached;
+  double   us;
+} bench_result_t;
+
+
+static bench_result_t bench( Kinematics *p_kinematics, const std::vector<om_chain_pose_t> &poses, bool warm )
+{
+  SolverUsingCRAndDLSJacobian *p_dls = dynamic_cast<SolverUsingCRAndDLSJacobian *>(p_kinematics);
+  std::vector<std::vector<JointValue> > goals(poses.size());
+  std::vector<double>     angle;
+  Manipulator             manipulator;
+  bench_clock::time_point start;
+  bench_result_t result = { 0, 0.0 };
+  uint32_t n;
+  int      i;
+  int      out;
+  int      null;
+
+  om_chain_add(&manipulator);
+  if (p_dls != NULL)
+  {
+    p_dls->clearWarmStart();
+  }
+
+  // The solvers print every failure, they would be timed too
+  fflush(stdout);
+  out = dup(STDOUT_FILENO);
+  null = open("/dev/null", O_WRONLY);
+  dup2(null, STDOUT_FILENO);
+  close(null);
+
+  for (n = 0; n < poses.size(); n++)
+  {
+    manipulator.setAllActiveJointPosition(poses[n].start);
+    p_kinematics->solveForwardKinematics(&manipulator);
+    if (p_dls != NULL && warm == false)
+    {
+      p_dls->clearWarmStart();
+    }
+
+    start = bench_clock::now();
+    p_kinematics->solveInverseKinematics(&manipulator, OM_CHAIN_TOOL, poses[n].target, &goals[n]);
+    result.us += std::chrono::duration<double, std::micro>(bench_clock::now() - start).count();
+  }
+
+  fflush(stdout);
+  dup2(out, STDOUT_FILENO);
+  close(out);
+
+  // A solver is right when the forward kinematics agree, whatever it returned
+  for (n = 0; n < poses.size(); n++)
+  {
+    if (goals[n].size() != OM_CHAIN_DOF)
+    {
+      continue;
+    }
+    angle.clear();
+    for (i = 0; i < OM_CHAIN_DOF; i++)
+    {
+      angle.push_back(goals[n].at(i).position);
+    }
+    if (om_chain_reached(p_kinematics, &manipulator, angle, poses[n].target))
+    {
+      result.reached++;
+    }
+  }
+
+  result.us /= poses.size();
+  return result;
+}
+
+static void print( const char *name, const bench_result_t &result, uint32_t count )
+{
+  printf("%-12s %5u/%-5u %10.1f\n", name, result.reached, count, result.us);
+}
+
+int main( int argc, char **argv )
+{
+  SolverUsingCRAndJacobian     jacobian;
+  SolverUsingCRAndSRJacobian   sr;
+  SolverUsingCRAndDLSJacobian  dls;
+  std::vector<om_chain_pose_t> poses;
+  uint32_t count = 200;
+
+  if (argc > 1)
+  {
+    count = strtoul(argv[1], NULL, 0);
+  }
+  if (count == 0)
+  {
+    return 2;
+  }
+
+  om_chain_poses(count, BENCH_SEED, &poses);
+
+  printf("%-12s %11s %10s\n", "solver", "reached", "us/solve");
+  print("jacobian", bench(&jacobian, poses, false), count);
+  print("sr", bench(&sr, poses, false), count);
+  print("dls", bench(&dls, poses, false), count);
+  print("dls warm", bench(&dls, poses, true), count);
+
+  return 0;
+}
@@ -0,0 +1,572 @@
+/*
+  bench_manipulator.cpp - kinematics and trajectories of the OpenManipulator
+  models the host builds, with the heap allocations of every call
+
+  The kinematics run for every solver of the OpenManipulator-X chain and for
+  the Delta and the Stewart platform: forward kinematics and Jacobian at a
+  home pose, inverse kinematics to poses around it. The trajectories run on
+  the chain through RobotisManipulator without actuators, each control tick
+  takes the goal of the trajectory, sets it as the present value and solves
+  the forward kinematics.
+
+  An allocation is one malloc, calloc, realloc or operator new. Eigen calls
+  malloc itself, so off Apple the linker wraps the C allocator as well.
+  Host times only compare the calls with each other, the allocations are
+  the same on the board.
+
+    bench_manipulator [repeat]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include <open_manipulator_libs/custom_trajectory.h>
+#include "om_chain.h"
+#include "parallel_platform.h"
+
+
+#define BENCH_TARGET_SIZE   4
+#define BENCH_MOVE_TIME     1.0       // s
+#define BENCH_CONTROL_TIME  0.010     // s
+
+#define BENCH_LINE          "custom_trajectory_line"
+#define BENCH_CIRCLE        "custom_trajectory_circle"
+#define BENCH_RHOMBUS       "custom_trajectory_rhombus"
+#define BENCH_HEART         "custom_trajectory_heart"
+
+
+typedef std::chrono::steady_clock bench_clock;
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t fails;
+  double   total_us;
+  double   max_us;
+  uint64_t allocs;
+  double   max_error;
+} bench_result_t;
+
+typedef struct
+{
+  bench_clock::time_point start;
+  uint64_t                allocs;
+} bench_measure_t;
+
+typedef struct
+{
+  const char *name;
+  Kinematics *p_kinematics;
+  const char *tool;
+  double      offset[BENCH_TARGET_SIZE][3];   // m, of the inverse kinematics targets
+} bench_model_t;
+
+
+/*****************************************************************************
+** Allocation counter
+*****************************************************************************/
+static volatile uint64_t bench_allocs = 0;
+
+#ifdef BENCH_WRAP_MALLOC
+extern "C"
+{
+void *__real_malloc( size_t size );
+void *__real_calloc( size_t count, size_t size );
+void *__real_realloc( void *ptr, size_t size );
+void  __real_free( void *ptr );
+
+void *__wrap_malloc( size_t size )
+{
+  bench_allocs++;
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc( size_t count, size_t size )
+{
+  bench_allocs++;
+  return __real_calloc(count, size);
+}
+
+void *__wrap_realloc( void *ptr, size_t size )
+{
+  bench_allocs++;
+  return __real_realloc(ptr, size);
+}
+
+void __wrap_free( void *ptr )
+{
+  __real_free(ptr);
+}
+}
+
+#define bench_malloc  __real_malloc
+#define bench_free    __real_free
+#else
+#define bench_malloc  malloc
+#define bench_free    free
+#endif
+
+void *operator new( size_t size )
+{
+  void *ptr;
+
+  bench_allocs++;
+  ptr = bench_malloc(size > 0 ? size : 1);
+  if (ptr == NULL)
+  {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *operator new[]( size_t size )
+{
+  return operator new(size);
+}
+
+void operator delete( void *ptr ) noexcept
+{
+  bench_free(ptr);
+}
+
+void operator delete[]( void *ptr ) noexcept
+{
+  bench_free(ptr);
+}
+
+void operator delete( void *ptr, size_t ) noexcept
+{
+  bench_free(ptr);
+}
+
+void operator delete[]( void *ptr, size_t ) noexcept
+{
+  bench_free(ptr);
+}
+
+
+/*****************************************************************************
+** Measure
+*****************************************************************************/
+static int bench_stdout = -1;
+
+static void bench_init( bench_result_t *p_result )
+{
+  p_result->count     = 0;
+  p_result->fails     = 0;
+  p_result->total_us  = 0.0;
+  p_result->max_us    = 0.0;
+  p_result->allocs    = 0;
+  p_result->max_error = 0.0;
+}
+
+static void bench_start( bench_measure_t *p_measure )
+{
+  p_measure->allocs = bench_allocs;
+  p_measure->start  = bench_clock::now();
+}
+
+static void bench_stop( const bench_measure_t *p_measure, bench_result_t *p_result )
+{
+  double us = std::chrono::duration<double, std::micro>(bench_clock::now() - p_measure->start).count();
+
+  p_result->allocs   += bench_allocs - p_measure->allocs;
+  p_result->total_us += us;
+  p_result->max_us    = fmax(p_result->max_us, us);
+  p_result->count++;
+}
+
+static void bench_error( bench_result_t *p_result, double error, bool success )
+{
+  if (success == false || error != error)
+  {
+    p_result->fails++;
+  }
+  else
+  {
+    p_result->max_error = fmax(p_result->max_error, error);
+  }
+}
+
+// RobotisManipulator and the solvers print every failure, they would be timed too
+static void bench_quiet( bool quiet )
+{
+  int null;
+
+  fflush(stdout);
+  if (quiet == true)
+  {
+    bench_stdout = dup(STDOUT_FILENO);
+    null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+  }
+  else
+  {
+    dup2(bench_stdout, STDOUT_FILENO);
+    close(bench_stdout);
+  }
+}
+
+static void bench_print( const char *model, const char *call, const bench_result_t &result, const char *unit )
+{
+  if (result.count == 0)
+  {
+    return;
+  }
+
+  printf("%-12s %-26s %7u %10.2f %10.2f %11.1f %6u",
+         model, call, result.count, result.total_us / result.count, result.max_us,
+         (double)result.allocs / result.count, result.fails);
+  if (unit != NULL)
+  {
+    printf(" %12.2e %s\n", result.max_error, unit);
+  }
+  else
+  {
+    printf(" %12s\n", "-");
+  }
+}
+
+
+/*****************************************************************************
+** Kinematics
+*****************************************************************************/
+static void bench_kinematics( const bench_model_t &model, const Manipulator &home, uint32_t repeat )
+{
+  bench_result_t  forward;
+  bench_result_t  jacobian;
+  bench_result_t  inverse;
+  bench_measure_t measure;
+  Pose     home_pose;
+  Pose     goal;
+  uint32_t n;
+  int      i;
+
+  bench_init(&forward);
+  bench_init(&jacobian);
+  bench_init(&inverse);
+
+  bench_quiet(true);
+  for (n = 0; n < repeat; n++)
+  {
+    Manipulator manipulator = home;
+
+    bench_start(&measure);
+    model.p_kinematics->solveForwardKinematics(&manipulator);
+    bench_stop(&measure, &forward);
+
+    bench_start(&measure);
+    model.p_kinematics->jacobian(&manipulator, model.tool);
+    bench_stop(&measure, &jacobian);
+
+    home_pose.kinematic = manipulator.getComponentKinematicPoseFromWorld(model.tool);
+  }
+
+  for (i = 0; i < BENCH_TARGET_SIZE; i++)
+  {
+    goal = home_pose;
+    goal.kinematic.position += math::vector3(model.offset[i][0], model.offset[i][1], model.offset[i][2]);
+
+    for (n = 0; n < repeat; n++)
+    {
+      Manipulator manipulator = home;
+      std::vector<JointValue> goal_joint_value;
+      bool solved;
+
+      bench_start(&measure);
+      solved = model.p_kinematics->solveInverseKinematics(&manipulator, model.tool, goal, &goal_joint_value);
+      bench_stop(&measure, &inverse);
+
+      // The parallel solvers already set the joints of the model, the chain ones only return them
+      if (goal_joint_value.size() == (uint32_t)manipulator.getDOF())
+      {
+        manipulator.setAllActiveJointValue(goal_joint_value);
+      }
+      model.p_kinematics->solveForwardKinematics(&manipulator);
+      bench_error(&inverse, (manipulator.getComponentPositionFromWorld(model.tool) - goal.kinematic.position).norm(), solved);
+    }
+  }
+  bench_quiet(false);
+
+  bench_print(model.name, "forward_kinematics", forward, NULL);
+  bench_print(model.name, "jacobian", jacobian, NULL);
+  bench_print(model.name, "inverse_kinematics", inverse, "m");
+}
+
+static void bench_chain( uint32_t repeat )
+{
+  kinematics::SolverUsingCRAndJacobian               jacobian;
+  kinematics::SolverUsingCRAndSRJacobian             sr;
+  kinematics::SolverUsingCRAndSRPositionOnlyJacobian sr_position;
+  kinematics::SolverUsingCRAndDLSJacobian            dls;
+  kinematics::SolverCustomizedforOMChain             customized;
+  const double home[OM_CHAIN_DOF] = { 0.0, -1.05, 0.35, 0.70 };
+  bench_model_t model[] =
+  {
+    { "jacobian",    &jacobian,    OM_CHAIN_TOOL, { { -0.02, 0.0, 0.0 }, { 0.0, 0.0, 0.02 }, { 0.0, 0.0, -0.02 }, { -0.02, 0.0, 0.02 } } },
+    { "sr",          &sr,          OM_CHAIN_TOOL, { { -0.02, 0.0, 0.0 }, { 0.0, 0.0, 0.02 }, { 0.0, 0.0, -0.02 }, { -0.02, 0.0, 0.02 } } },
+    { "sr_position", &sr_position, OM_CHAIN_TOOL, { { -0.02, 0.0, 0.0 }, { 0.0, 0.0, 0.02 }, { 0.0, 0.0, -0.02 }, { -0.02, 0.0, 0.02 } } },
+    { "dls",         &dls,         OM_CHAIN_TOOL, { { -0.02, 0.0, 0.0 }, { 0.0, 0.0, 0.02 }, { 0.0, 0.0, -0.02 }, { -0.02, 0.0, 0.02 } } },
+    { "customized",  &customized,  OM_CHAIN_TOOL, { { -0.02, 0.0, 0.0 }, { 0.0, 0.0, 0.02 }, { 0.0, 0.0, -0.02 }, { -0.02, 0.0, 0.02 } } },
+  };
+  Manipulator manipulator;
+  uint32_t    i;
+
+  om_chain_add(&manipulator);
+  manipulator.setAllActiveJointPosition(std::vector<double>(home, home + OM_CHAIN_DOF));
+
+  for (i = 0; i < sizeof(model) / sizeof(model[0]); i++)
+  {
+    bench_kinematics(model[i], manipulator, repeat);
+  }
+}
+
+// The home pose of a platform is the one its inverse kinematics solve for
+template <class Solver>
+static void bench_platform( const char *name, int joints, const Pose &home_pose, const double offset[BENCH_TARGET_SIZE][3], uint32_t repeat )
+{
+  Solver        kinematics;
+  Manipulator   manipulator;
+  bench_model_t model;
+  std::vector<JointValue> home;
+  int i;
+
+  parallel_platform_add(&manipulator, joints);
+  kinematics.solveInverseKinematics(&manipulator, PARALLEL_PLATFORM_TOOL, home_pose, &home);
+  manipulator.setAllActiveJointValue(home);
+
+  model.name         = name;
+  model.p_kinematics = &kinematics;
+  model.tool         = PARALLEL_PLATFORM_TOOL;
+  for (i = 0; i < BENCH_TARGET_SIZE; i++)
+  {
+    model.offset[i][0] = offset[i][0];
+    model.offset[i][1] = offset[i][1];
+    model.offset[i][2] = offset[i][2];
+  }
+  bench_kinematics(model, manipulator, repeat);
+}
+
+
+/*****************************************************************************
+** Trajectory
+*****************************************************************************/
+static const double bench_home[OM_CHAIN_DOF] = { 0.0, -1.05, 0.35, 0.70 };
+
+static const char *bench_trajectory_name[] =
+{
+  "joint", "blended_joint", "task", "custom_line", "custom_circle", "custom_rhombus", "custom_heart", "compiled_circle"
+};
+
+class BenchArm
+{
+ public:
+  kinematics::SolverCustomizedforOMChain kinematics_;
+  custom_trajectory::Line    line_;
+  custom_trajectory::Circle  circle_;
+  custom_trajectory::Rhombus rhombus_;
+  custom_trajectory::Heart   heart_;
+  RobotisManipulator robotis_;
+  double             time_;
+
+  BenchArm() : time_(0.0)
+  {
+    om_chain_add(robotis_.getManipulator());
+    robotis_.addKinematics(&kinematics_);
+    robotis_.addCustomTrajectory(BENCH_LINE, &line_);
+    robotis_.addCustomTrajectory(BENCH_CIRCLE, &circle_);
+    robotis_.addCustomTrajectory(BENCH_RHOMBUS, &rhombus_);
+    robotis_.addCustomTrajectory(BENCH_HEART, &heart_);
+  }
+
+  // The control loop of the chain without actuators, the goal is the present value
+  void tick( void )
+  {
+    JointWaypoint goal = robotis_.getJointGoalValueFromTrajectory(time_);
+
+    if (goal.size() != 0)
+    {
+      robotis_.sendAllJointActuatorValue(goal);
+    }
+    robotis_.solveForwardKinematics();
+  }
+
+  // A one tick joint trajectory moves the present waypoint of the trajectory home too
+  void home( void )
+  {
+    std::vector<double> home(bench_home, bench_home + OM_CHAIN_DOF);
+
+    robotis_.getManipulator()->setAllActiveJointPosition(home);
+    tick();
+    robotis_.makeJointTrajectory(home, BENCH_CONTROL_TIME, robotis_.getAllActiveJointValue());
+    while (robotis_.getMovingState())
+    {
+      time_ += BENCH_CONTROL_TIME;
+      tick();
+    }
+  }
+};
+
+static bool bench_make( BenchArm *p_arm, int index, CompiledJointTrajectory *p_compiled,
+                        std::vector<double> *p_goal_angle, Eigen::Vector3d *p_goal_position )
+{
+  std::vector<double> home(bench_home, bench_home + OM_CHAIN_DOF);
+  RobotisManipulator *p_robotis = &p_arm->robotis_;
+  double       draw[3] = { 0.010, 1.0, 0.0 };   // radius m, revolutions, start angle rad
+  TaskWaypoint line;
+  uint32_t     i;
+
+  *p_goal_angle    = home;
+  *p_goal_position = p_robotis->getManipulator()->getComponentPositionFromWorld(OM_CHAIN_TOOL);
+  line.kinematic.position = math::vector3(-0.02, 0.0, 0.0);
+
+  switch (index)
+  {
+    case 0:
+      for (i = 0; i < p_goal_angle->size(); i++)
+      {
+        p_goal_angle->at(i) += 0.05;
+      }
+      p_robotis->makeJointTrajectory(*p_goal_angle, BENCH_MOVE_TIME);
+      return true;
+
+    case 1:
+    {
+      std::vector<std::vector<double> > way_point;
+      const double offset[3] = { 0.05, -0.05, 0.0 };
+
+      for (i = 0; i < 3; i++)
+      {
+        std::vector<double> angle = home;
+        for (uint32_t j = 0; j < angle.size(); j++)
+        {
+          angle[j] += offset[i];
+        }
+        way_point.push_back(angle);
+      }
+      return p_robotis->makeBlendedJointTrajectory(way_point, std::vector<double>(OM_CHAIN_DOF, 1.0),
+                                                   std::vector<double>(OM_CHAIN_DOF, 4.0));
+    }
+
+    case 2:
+      *p_goal_position += line.kinematic.position;
+      p_robotis->makeTaskTrajectory(OM_CHAIN_TOOL, *p_goal_position, BENCH_MOVE_TIME);
+      return true;
+
+    case 3:
+      *p_goal_position += line.kinematic.position;
+      p_robotis->makeCustomTrajectory(BENCH_LINE, OM_CHAIN_TOOL, &line, BENCH_MOVE_TIME);
+      return true;
+
+    case 4:
+      p_robotis->makeCustomTrajectory(BENCH_CIRCLE, OM_CHAIN_TOOL, draw, BENCH_MOVE_TIME);
+      return true;
+
+    case 5:
+      p_robotis->makeCustomTrajectory(BENCH_RHOMBUS, OM_CHAIN_TOOL, draw, BENCH_MOVE_TIME);
+      return true;
+
+    case 6:
+      p_robotis->makeCustomTrajectory(BENCH_HEART, OM_CHAIN_TOOL, draw, BENCH_MOVE_TIME);
+      return true;
+
+    case 7:
+      if (p_robotis->compileCustomTrajectory(BENCH_CIRCLE, OM_CHAIN_TOOL, draw, BENCH_MOVE_TIME, p_compiled) == false)
+      {
+        return false;
+      }
+      return p_robotis->makeCompiledTrajectory(p_compiled);
+  }
+  return false;
+}
+
+static void bench_trajectory( int index )
+{
+  BenchArm                arm;
+  CompiledJointTrajectory compiled;
+  bench_result_t  make;
+  bench_result_t  tick;
+  bench_measure_t measure;
+  std::vector<double>     goal_angle;
+  std::vector<JointValue> angle;
+  Eigen::Vector3d goal_position;
+  double   error = 0.0;
+  bool     made;
+  uint32_t i;
+
+  bench_init(&make);
+  bench_init(&tick);
+
+  bench_quiet(true);
+  arm.home();
+
+  bench_start(&measure);
+  made = bench_make(&arm, index, &compiled, &goal_angle, &goal_position);
+  bench_stop(&measure, &make);
+  bench_error(&make, 0.0, made);
+
+  while (made == true && arm.robotis_.getMovingState())
+  {
+    arm.time_ += BENCH_CONTROL_TIME;
+    bench_start(&measure);
+    arm.tick();
+    bench_stop(&measure, &tick);
+  }
+  bench_quiet(false);
+
+  // Joint trajectories end at the goal angles, the others at the tool position
+  if (index < 2)
+  {
+    angle = arm.robotis_.getAllActiveJointValue();
+    for (i = 0; i < angle.size(); i++)
+    {
+      error = fmax(error, fabs(angle[i].position - goal_angle[i]));
+    }
+  }
+  else
+  {
+    error = (arm.robotis_.getManipulator()->getComponentPositionFromWorld(OM_CHAIN_TOOL) - goal_position).norm();
+  }
+  bench_error(&tick, error, made);
+
+  std::string name = std::string(bench_trajectory_name[index]);
+  bench_print("trajectory", (name + " make").c_str(), make, NULL);
+  bench_print("trajectory", (name + " tick").c_str(), tick, index < 2 ? "rad" : "m");
+}
+
+
+int main( int argc, char **argv )
+{
+  const double delta_offset[BENCH_TARGET_SIZE][3]   = { { 0.02, 0.0, 0.0 }, { 0.0, 0.02, 0.0 }, { 0.0, 0.0, 0.015 }, { 0.0, 0.0, -0.01 } };
+  const double stewart_offset[BENCH_TARGET_SIZE][3] = { { 0.01, 0.0, 0.0 }, { 0.0, 0.01, 0.0 }, { 0.0, 0.0, 0.01 }, { 0.0, 0.0, -0.01 } };
+  uint32_t repeat = 1000;
+  uint32_t i;
+
+  if (argc > 1)
+  {
+    repeat = strtoul(argv[1], NULL, 0);
+  }
+  if (repeat == 0)
+  {
+    return 2;
+  }
+
+  printf("%-12s %-26s %7s %10s %10s %11s %6s %12s\n",
+         "model", "call", "calls", "mean us", "max us", "allocs/call", "fails", "max error");
+  bench_chain(repeat);
+  bench_platform<delta_kinematics::SolverUsingGeometry>("delta", DELTA_JOINTS, parallel_platform_pose(0.0, 0.0, 0.02, 0.0, 0.0, 0.0), delta_offset, repeat);
+  bench_platform<stewart_kinematics::SolverUsingGeometry>("stewart", STEWART_JOINTS, parallel_platform_pose(0.0, 0.0, 0.0, 0.0, 0.0, 0.0), stewart_offset, repeat);
+
+  for (i = 0; i < sizeof(bench_trajectory_name) / sizeof(bench_trajectory_name[0]); i++)
+  {
+    bench_trajectory(i);
+  }
+
+  return 0;
+}
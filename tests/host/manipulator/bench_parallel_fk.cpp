@@ -0,0 +1,171 @@
+/*
+  bench_parallel_fk.cpp - time of the forward kinematics, the Jacobian and
+  the inverse kinematics of the Delta and the Stewart platform
+
+  The forward kinematics run warm, following a path with one solver as the
+  control loop does, and cold, a new solver for every solve. Before the
+  Newton-Raphson solver it was an empty function, the inverse kinematics
+  are the cost to compare it with. Host times only compare the calls with
+  each other.
+
+    bench_parallel_fk [poses]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "parallel_platform.h"
+
+
+typedef std::chrono::steady_clock bench_clock;
+
+typedef struct
+{
+  double   us;            // per call
+  double   max_error;     // m, of the forward kinematics
+} bench_result_t;
+
+
+static double bench_us( bench_clock::time_point start, uint32_t count )
+{
+  return std::chrono::duration<double, std::micro>(bench_clock::now() - start).count() / count;
+}
+
+static double position_error( Manipulator *p_manipulator, const Pose &pose )
+{
+  return (p_manipulator->getComponentPositionFromWorld(PARALLEL_PLATFORM_TOOL) - pose.kinematic.position).norm();
+}
+
+// Actuated angles of each pose
+template <class Solver>
+static void solve_ik( const std::vector<Pose> &path, int joints, std::vector<std::vector<double> > *p_angle, bench_result_t *p_result )
+{
+  Solver      kinematics;
+  Manipulator manipulator;
+  std::vector<JointValue> goal;
+  bench_clock::time_point start;
+  uint32_t n;
+  int      i;
+
+  parallel_platform_add(&manipulator, joints);
+  p_angle->assign(path.size(), std::vector<double>(joints));
+
+  start = bench_clock::now();
+  for (n = 0; n < path.size(); n++)
+  {
+    kinematics.solveInverseKinematics(&manipulator, PARALLEL_PLATFORM_TOOL, path[n], &goal);
+    for (i = 0; i < joints; i++)
+    {
+      (*p_angle)[n][i] = goal.at(i).position;
+    }
+  }
+  p_result->us        = bench_us(start, path.size());
+  p_result->max_error = 0.0;
+}
+
+template <class Solver>
+static void bench_fk( const std::vector<Pose> &path, int joints, const std::vector<std::vector<double> > &angle, bool warm, bench_result_t *p_result )
+{
+  Solver      kinematics;
+  Manipulator manipulator;
+  bench_clock::time_point start;
+  double   us = 0.0;
+  uint32_t n;
+
+  parallel_platform_add(&manipulator, joints);
+  p_result->max_error = 0.0;
+
+  for (n = 0; n < path.size(); n++)
+  {
+    Solver cold;
+    Solver *p_kinematics = (warm == true) ? &kinematics : &cold;
+
+    manipulator.setAllActiveJointPosition(angle[n]);
+    start = bench_clock::now();
+    p_kinematics->solveForwardKinematics(&manipulator);
+    us += bench_us(start, 1);
+
+    p_result->max_error = fmax(p_result->max_error, position_error(&manipulator, path[n]));
+  }
+  p_result->us = us / path.size();
+}
+
+template <class Solver>
+static void bench_jacobian( const std::vector<Pose> &path, int joints, const std::vector<std::vector<double> > &angle, bench_result_t *p_result )
+{
+  Solver      kinematics;
+  Manipulator manipulator;
+  bench_clock::time_point start;
+  double   us = 0.0;
+  uint32_t n;
+
+  parallel_platform_add(&manipulator, joints);
+
+  for (n = 0; n < path.size(); n++)
+  {
+    manipulator.setAllActiveJointPosition(angle[n]);
+    kinematics.solveForwardKinematics(&manipulator);
+
+    start = bench_clock::now();
+    kinematics.jacobian(&manipulator, PARALLEL_PLATFORM_TOOL);
+    us += bench_us(start, 1);
+  }
+  p_result->us        = us / path.size();
+  p_result->max_error = 0.0;
+}
+
+template <class Solver>
+static void bench_platform( const char *name, const std::vector<Pose> &path, int joints )
+{
+  std::vector<std::vector<double> > angle;
+  bench_result_t result;
+
+  solve_ik<Solver>(path, joints, &angle, &result);
+  printf("%-8s %-16s %10.2f\n", name, "ik", result.us);
+
+  bench_fk<Solver>(path, joints, angle, true, &result);
+  printf("%-8s %-16s %10.2f %12.2e\n", name, "fk warm", result.us, result.max_error);
+
+  bench_fk<Solver>(path, joints, angle, false, &result);
+  printf("%-8s %-16s %10.2f %12.2e\n", name, "fk cold", result.us, result.max_error);
+
+  bench_jacobian<Solver>(path, joints, angle, &result);
+  printf("%-8s %-16s %10.2f\n", name, "jacobian", result.us);
+}
+
+int main( int argc, char **argv )
+{
+  std::vector<Pose> delta_path;
+  std::vector<Pose> stewart_path;
+  uint32_t count = 20000;
+  uint32_t n;
+  double   t;
+
+  if (argc > 1)
+  {
+    count = strtoul(argv[1], NULL, 0);
+  }
+  if (count == 0)
+  {
+    return 2;
+  }
+
+  // Circles through the workspaces of the tests, a millimeter or less apart.
+  // The Stewart one does not pitch, its inverse kinematics drop an
+  // orientation without a zero entry.
+  for (n = 0; n < count; n++)
+  {
+    t = 2.0 * M_PI * n / 1000.0;
+    delta_path.push_back(parallel_platform_pose(0.04 * cos(t), 0.04 * sin(t), 0.03 + 0.02 * sin(0.5 * t), 0.0, 0.0, 0.0));
+    stewart_path.push_back(parallel_platform_pose(0.01 * cos(t), 0.01 * sin(t), 0.0025 + 0.0025 * sin(0.5 * t),
+                                                  0.05 * sin(t), 0.0, 0.1 * sin(0.5 * t)));
+  }
+
+  printf("%-8s %-16s %10s %12s\n", "platform", "call", "us/call", "fk error m");
+  bench_platform<delta_kinematics::SolverUsingGeometry>("delta", delta_path, DELTA_JOINTS);
+  bench_platform<stewart_kinematics::SolverUsingGeometry>("stewart", stewart_path, STEWART_JOINTS);
+
+  return 0;
+}
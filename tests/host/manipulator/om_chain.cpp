@@ -0,0 +1,99 @@
+/*
+  om_chain.cpp - the chain of the OpenManipulator-X and reachable poses of it
+*/
+
+#include <math.h>
+#include "om_chain.h"
+
+
+static const double om_chain_max[OM_CHAIN_DOF] = { M_PI, M_PI_2, 1.53, 2.0 };
+static const double om_chain_min[OM_CHAIN_DOF] = { -M_PI, -2.05, -M_PI_2, -1.8 };
+
+static uint32_t om_chain_seed;
+
+
+// Uniform in [0, 1)
+static double om_chain_random( void )
+{
+  om_chain_seed = om_chain_seed * 1664525u + 1013904223u;
+  return (double)(om_chain_seed >> 8) / (double)(1u << 24);
+}
+
+void om_chain_add( Manipulator *p_manipulator )
+{
+  p_manipulator->addWorld("world", "joint1");
+  p_manipulator->addJoint("joint1", "world", "joint2",
+                          math::vector3(0.012, 0.0, 0.017), Eigen::Matrix3d::Identity(), math::vector3(0.0, 0.0, 1.0),
+                          11, om_chain_max[0], om_chain_min[0]);
+  p_manipulator->addJoint("joint2", "joint1", "joint3",
+                          math::vector3(0.0, 0.0, 0.0595), Eigen::Matrix3d::Identity(), math::vector3(0.0, 1.0, 0.0),
+                          12, om_chain_max[1], om_chain_min[1]);
+  p_manipulator->addJoint("joint3", "joint2", "joint4",
+                          math::vector3(0.024, 0.0, 0.128), Eigen::Matrix3d::Identity(), math::vector3(0.0, 1.0, 0.0),
+                          13, om_chain_max[2], om_chain_min[2]);
+  p_manipulator->addJoint("joint4", "joint3", OM_CHAIN_TOOL,
+                          math::vector3(0.124, 0.0, 0.0), Eigen::Matrix3d::Identity(), math::vector3(0.0, 1.0, 0.0),
+                          14, om_chain_max[3], om_chain_min[3]);
+  p_manipulator->addTool(OM_CHAIN_TOOL, "joint4", math::vector3(0.126, 0.0, 0.0), Eigen::Matrix3d::Identity());
+}
+
+void om_chain_poses( uint32_t count, uint32_t seed, std::vector<om_chain_pose_t> *p_poses )
+{
+  kinematics::SolverUsingCRAndDLSJacobian kinematics;
+  Manipulator     manipulator;
+  om_chain_pose_t pose;
+  uint32_t n;
+  int      i;
+
+  om_chain_add(&manipulator);
+  om_chain_seed = seed;
+  p_poses->clear();
+
+  for (n = 0; n < count; n++)
+  {
+    // The start stays within the limits too
+    pose.angle.resize(OM_CHAIN_DOF);
+    pose.start.resize(OM_CHAIN_DOF);
+    for (i = 0; i < OM_CHAIN_DOF; i++)
+    {
+      pose.angle[i] = om_chain_min[i] + (om_chain_max[i] - om_chain_min[i] - OM_CHAIN_START_OFFSET) * om_chain_random();
+      pose.start[i] = pose.angle[i] + OM_CHAIN_START_OFFSET;
+    }
+
+    manipulator.setAllActiveJointPosition(pose.angle);
+    kinematics.solveForwardKinematics(&manipulator);
+    pose.target.kinematic.position    = manipulator.getComponentPositionFromWorld(OM_CHAIN_TOOL);
+    pose.target.kinematic.orientation = manipulator.getComponentOrientationFromWorld(OM_CHAIN_TOOL);
+
+    p_poses->push_back(pose);
+  }
+}
+
+bool om_chain_reached( Kinematics *p_kinematics, Manipulator *p_manipulator, const std::vector<double> &angle, const Pose &target )
+{
+  Eigen::Vector3d position;
+  Eigen::Matrix3d orientation;
+  int i;
+  int j;
+
+  p_manipulator->setAllActiveJointPosition(angle);
+  p_kinematics->solveForwardKinematics(p_manipulator);
+  position    = p_manipulator->getComponentPositionFromWorld(OM_CHAIN_TOOL);
+  orientation = p_manipulator->getComponentOrientationFromWorld(OM_CHAIN_TOOL);
+
+  for (i = 0; i < 3; i++)
+  {
+    if (!(fabs(position(i) - target.kinematic.position(i)) <= OM_CHAIN_POSITION_TOL))
+    {
+      return false;
+    }
+    for (j = 0; j < 3; j++)
+    {
+      if (!(fabs(orientation(i, j) - target.kinematic.orientation(i, j)) <= OM_CHAIN_ORIENTATION_TOL))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,40 @@
+/*
+  om_chain.h - the chain of the OpenManipulator-X and reachable poses of it
+
+  A pose is the tool pose of random joint angles within the limits, the
+  solve starts from those angles moved by OM_CHAIN_START_OFFSET.
+*/
+
+#ifndef _OM_CHAIN_H_
+#define _OM_CHAIN_H_
+
+#include <stdint.h>
+#include <vector>
+#include <open_manipulator_libs/kinematics.h>
+
+
+#define OM_CHAIN_TOOL           "gripper"
+#define OM_CHAIN_DOF            4
+#define OM_CHAIN_START_OFFSET   0.2       // rad
+
+#define OM_CHAIN_POSITION_TOL   1e-5      // m
+#define OM_CHAIN_ORIENTATION_TOL 1e-4     // each element of the rotation matrix
+
+
+typedef struct
+{
+  std::vector<double> angle;    // angles of the pose
+  std::vector<double> start;    // angles the solve starts from
+  Pose                target;
+} om_chain_pose_t;
+
+
+// Joints of open_manipulator.cpp, the ids are 11 to 14
+void om_chain_add( Manipulator *p_manipulator );
+
+void om_chain_poses( uint32_t count, uint32_t seed, std::vector<om_chain_pose_t> *p_poses );
+
+// The tool pose of angles is within the tolerances of target
+bool om_chain_reached( Kinematics *p_kinematics, Manipulator *p_manipulator, const std::vector<double> &angle, const Pose &target );
+
+#endif /* _OM_CHAIN_H_ */
@@ -0,0 +1,31 @@
+/*
+  parallel_platform.cpp - Delta and Stewart platforms for their kinematics
+*/
+
+#include <stdio.h>
+#include "parallel_platform.h"
+
+
+void parallel_platform_add( Manipulator *p_manipulator, int joints )
+{
+  char name[16];
+  int  i;
+
+  p_manipulator->addWorld("world", "joint1");
+  for (i = 1; i <= joints; i++)
+  {
+    snprintf(name, sizeof(name), "joint%d", i);
+    p_manipulator->addJoint(name, "world", PARALLEL_PLATFORM_TOOL, math::vector3(0.0, 0.0, 0.0), Eigen::Matrix3d::Identity(), math::vector3(0.0, 0.0, 1.0), i);
+  }
+  snprintf(name, sizeof(name), "joint%d", joints);
+  p_manipulator->addTool(PARALLEL_PLATFORM_TOOL, name, math::vector3(0.0, 0.0, 0.0), Eigen::Matrix3d::Identity());
+}
+
+Pose parallel_platform_pose( double x, double y, double z, double roll, double pitch, double yaw )
+{
+  Pose pose;
+
+  pose.kinematic.position    = math::vector3(x, y, z);
+  pose.kinematic.orientation = math::convertRPYToRotationMatrix(roll, pitch, yaw);
+  return pose;
+}
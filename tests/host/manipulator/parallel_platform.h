@@ -0,0 +1,24 @@
+/*
+  parallel_platform.h - Delta and Stewart platforms for their kinematics
+
+  Only the actuated joints and the tool, the passive joints do not enter
+  the kinematics.
+*/
+
+#ifndef _PARALLEL_PLATFORM_H_
+#define _PARALLEL_PLATFORM_H_
+
+#include <delta_libs/delta_kinematics.h>
+#include <stewart_libs/stewart_kinematics.h>
+
+
+#define PARALLEL_PLATFORM_TOOL    "tool"
+#define DELTA_JOINTS              3
+#define STEWART_JOINTS            6
+
+
+void parallel_platform_add( Manipulator *p_manipulator, int joints );
+
+Pose parallel_platform_pose( double x, double y, double z, double roll, double pitch, double yaw );
+
+#endif /* _PARALLEL_PLATFORM_H_ */
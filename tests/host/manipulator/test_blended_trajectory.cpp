@@ -0,0 +1,155 @@
+/*
+  test_blended_trajectory.cpp - the blended joint trajectory starts and stops
+  at its end points, keeps its limits and has no velocity step at a blend
+*/
+
+#include <vector>
+#include <robotis_manipulator/robotis_manipulator.h>
+#include "host_test.h"
+
+using namespace robotis_manipulator;
+
+
+#define TEST_JOINTS     3
+#define TEST_STEP       1e-4      // s
+#define TEST_LIMIT_TOL  1e-6      // relative
+
+
+static JointWaypoint make_waypoint( double a, double b, double c )
+{
+  JointWaypoint waypoint(TEST_JOINTS);
+
+  waypoint[0].position = a;
+  waypoint[1].position = b;
+  waypoint[2].position = c;
+  return waypoint;
+}
+
+static void check_profile( const std::vector<JointWaypoint> &list, const std::vector<double> &max_velocity, const std::vector<double> &max_acceleration )
+{
+  BlendedJointTrajectory trajectory;
+  JointWaypoint       now;
+  JointWaypoint       next;
+  std::vector<double> time;
+  double move_time;
+  double tick;
+  double corner;
+  uint32_t i;
+  int      j;
+
+  CHECK(trajectory.makeJointTrajectory(list, max_velocity, max_acceleration));
+  move_time = trajectory.getMoveTime();
+  time      = trajectory.getWaypointTime();
+  CHECK(time.size() == list.size());
+  CHECK(time.front() == 0.0 && time.back() == move_time);
+
+  // Exactly at the end points, at rest
+  now  = trajectory.getJointWaypoint(0.0);
+  next = trajectory.getJointWaypoint(move_time);
+  for (j = 0; j < TEST_JOINTS; j++)
+  {
+    CHECK_NEAR(now[j].position, list.front()[j].position, 1e-12);
+    CHECK_NEAR(now[j].velocity, 0.0, 1e-12);
+    CHECK_NEAR(next[j].position, list.back()[j].position, 1e-9);
+    CHECK_NEAR(next[j].velocity, 0.0, 1e-9);
+  }
+
+  // Within the limits, and the velocity only changes as fast as the
+  // acceleration limit allows, so no blend leaves a step
+  now = trajectory.getJointWaypoint(0.0);
+  for (tick = TEST_STEP; tick <= move_time; tick += TEST_STEP)
+  {
+    next = trajectory.getJointWaypoint(tick);
+    for (j = 0; j < TEST_JOINTS; j++)
+    {
+      CHECK(fabs(next[j].velocity) <= max_velocity[j] * (1.0 + TEST_LIMIT_TOL));
+      CHECK(fabs(next[j].acceleration) <= max_acceleration[j] * (1.0 + TEST_LIMIT_TOL));
+      CHECK(fabs(next[j].velocity - now[j].velocity) <= max_acceleration[j] * TEST_STEP * (1.0 + TEST_LIMIT_TOL) + 1e-12);
+      CHECK(fabs(next[j].position - now[j].position) <= max_velocity[j] * TEST_STEP * (1.0 + TEST_LIMIT_TOL) + 1e-12);
+    }
+    now = next;
+  }
+
+  // Both sides of each blend, the positions meet too
+  for (i = 1; i + 1 < time.size(); i++)
+  {
+    now  = trajectory.getJointWaypoint(time[i] - 1e-9);
+    next = trajectory.getJointWaypoint(time[i] + 1e-9);
+    for (j = 0; j < TEST_JOINTS; j++)
+    {
+      CHECK_NEAR(now[j].velocity, next[j].velocity, 1e-6);
+      CHECK_NEAR(now[j].position, next[j].position, 1e-6);
+
+      // The corner is cut by no more than the blend can reach
+      corner = fabs(trajectory.getJointWaypoint(time[i])[j].position - list[i][j].position);
+      CHECK(corner <= max_velocity[j] * max_velocity[j] / (2.0 * max_acceleration[j]) + 1e-9);
+    }
+  }
+}
+
+static void test_profiles( void )
+{
+  std::vector<JointWaypoint> list;
+  std::vector<double> max_velocity(TEST_JOINTS, 1.0);
+  std::vector<double> max_acceleration(TEST_JOINTS, 4.0);
+
+  // One segment, a joint that does not move
+  list.push_back(make_waypoint(0.0, 0.0, 0.5));
+  list.push_back(make_waypoint(0.5, 0.0, -0.2));
+  check_profile(list, max_velocity, max_acceleration);
+
+  // Turning back, a short segment and a long one
+  list.push_back(make_waypoint(0.6, 0.3, -0.2));
+  list.push_back(make_waypoint(-0.4, 0.3, 0.8));
+  list.push_back(make_waypoint(-0.4, -1.0, 0.0));
+  check_profile(list, max_velocity, max_acceleration);
+
+  // Limits of each joint
+  max_velocity[1]     = 0.3;
+  max_acceleration[2] = 0.5;
+  check_profile(list, max_velocity, max_acceleration);
+}
+
+static void test_corner( void )
+{
+  BlendedJointTrajectory trajectory;
+  std::vector<JointWaypoint> list;
+  std::vector<double> max_velocity(TEST_JOINTS, 1.0);
+  std::vector<double> max_acceleration(TEST_JOINTS, 4.0);
+  std::vector<double> time;
+
+  list.push_back(make_waypoint(0.0, 0.0, 0.0));
+  list.push_back(make_waypoint(1.0, 0.0, 0.0));
+  list.push_back(make_waypoint(0.0, 0.0, 0.0));
+  CHECK(trajectory.makeJointTrajectory(list, max_velocity, max_acceleration));
+  time = trajectory.getWaypointTime();
+
+  // The blend turns back before the via point
+  CHECK(trajectory.getJointWaypoint(time[1])[0].position < 1.0 - 1e-3);
+}
+
+static void test_invalid( void )
+{
+  BlendedJointTrajectory trajectory;
+  std::vector<JointWaypoint> list;
+  std::vector<double> max_velocity(TEST_JOINTS, 1.0);
+  std::vector<double> max_acceleration(TEST_JOINTS, 4.0);
+
+  list.push_back(make_waypoint(0.0, 0.0, 0.0));
+  CHECK(trajectory.makeJointTrajectory(list, max_velocity, max_acceleration) == false);
+
+  list.push_back(make_waypoint(1.0, 0.0, 0.0));
+  CHECK(trajectory.makeJointTrajectory(list, std::vector<double>(TEST_JOINTS - 1, 1.0), max_acceleration) == false);
+
+  max_acceleration[1] = 0.0;
+  CHECK(trajectory.makeJointTrajectory(list, max_velocity, max_acceleration) == false);
+}
+
+int main( void )
+{
+  test_profiles();
+  test_corner();
+  test_invalid();
+
+  return 0;
+}
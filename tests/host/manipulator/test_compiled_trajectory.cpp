@@ -0,0 +1,136 @@
+/*
+  test_compiled_trajectory.cpp - a line of the OpenManipulator-X compiled to
+  joint samples plays back along the line and ends where the line ends
+*/
+
+#include <vector>
+#include <open_manipulator_libs/custom_trajectory.h>
+#include "om_chain.h"
+#include "host_test.h"
+
+using namespace kinematics;
+
+
+#define TEST_MOVE_TIME      2.0       // s
+#define TEST_SAMPLE_TIME    0.15      // s, 2.0 is not a multiple of it
+#define TEST_PLAYBACK_STEP  0.01      // s
+
+#define TEST_END_TOL        1e-5      // m
+#define TEST_PATH_TOL       1e-4      // m
+
+
+static const double test_start[OM_CHAIN_DOF] = { 0.0, -0.6, 0.3, 0.6 };
+
+
+// Tool position of a waypoint of the compiled trajectory
+static Eigen::Vector3d play( Kinematics *p_kinematics, Manipulator *p_manipulator, CompiledJointTrajectory *p_compiled, double tick )
+{
+  JointWaypoint       waypoint = p_compiled->getJointWaypoint(tick);
+  std::vector<double> angle;
+  uint32_t i;
+
+  CHECK(waypoint.size() == OM_CHAIN_DOF);
+  for (i = 0; i < waypoint.size(); i++)
+  {
+    angle.push_back(waypoint.at(i).position);
+  }
+  p_manipulator->setAllActiveJointPosition(angle);
+  p_kinematics->solveForwardKinematics(p_manipulator);
+
+  return p_manipulator->getComponentPositionFromWorld(OM_CHAIN_TOOL);
+}
+
+static void test_line( void )
+{
+  SolverUsingCRAndDLSJacobian kinematics;
+  Manipulator                 manipulator;
+  Manipulator                 player;
+  CompiledJointTrajectory     compiled;
+  custom_trajectory::Line     line;
+  TaskWaypoint    delta;
+  TaskWaypoint    goal;
+  Eigen::Vector3d position;
+  double   tick;
+  int      i;
+
+  om_chain_add(&manipulator);
+  om_chain_add(&player);
+  manipulator.setAllActiveJointPosition(std::vector<double>(test_start, test_start + OM_CHAIN_DOF));
+
+  // Forward and down in the plane of joint1, the orientation stays reachable
+  delta.kinematic.position = math::vector3(0.05, 0.0, -0.03);
+  CHECK(compiled.compileTaskTrajectory(manipulator, &kinematics, OM_CHAIN_TOOL, &line, &delta,
+                                       TEST_MOVE_TIME, TEST_SAMPLE_TIME));
+
+  // No further apart than the sample time, the last one at the move time
+  CHECK(compiled.getSampleSize() == (uint32_t)ceil(TEST_MOVE_TIME / TEST_SAMPLE_TIME) + 1);
+  CHECK(compiled.getMoveTime() == TEST_MOVE_TIME);
+
+  goal = line.getTaskWaypoint(TEST_MOVE_TIME);
+  position = play(&kinematics, &player, &compiled, TEST_MOVE_TIME);
+  for (i = 0; i < 3; i++)
+  {
+    CHECK_NEAR(position(i), goal.kinematic.position(i), TEST_END_TOL);
+  }
+
+  // Samples and the interpolation between them follow the line
+  for (tick = 0.0; tick <= TEST_MOVE_TIME; tick += TEST_PLAYBACK_STEP)
+  {
+    goal = line.getTaskWaypoint(tick);
+    position = play(&kinematics, &player, &compiled, tick);
+    for (i = 0; i < 3; i++)
+    {
+      CHECK_NEAR(position(i), goal.kinematic.position(i), TEST_PATH_TOL);
+    }
+  }
+
+  // It stops there
+  for (i = 0; i < OM_CHAIN_DOF; i++)
+  {
+    CHECK_NEAR(compiled.getJointWaypoint(TEST_MOVE_TIME).at(i).velocity, 0.0, 1e-9);
+  }
+}
+
+// The trajectory plays its own copy, copies of it do not share one
+static void test_owned( void )
+{
+  SolverUsingCRAndDLSJacobian kinematics;
+  Manipulator                 manipulator;
+  CompiledJointTrajectory     compiled;
+  custom_trajectory::Line     line;
+  TaskWaypoint  delta;
+  JointWaypoint end;
+  Trajectory   *p_trajectory = new Trajectory;
+  Trajectory    copy;
+  int i;
+
+  om_chain_add(&manipulator);
+  manipulator.setAllActiveJointPosition(std::vector<double>(test_start, test_start + OM_CHAIN_DOF));
+  delta.kinematic.position = math::vector3(0.05, 0.0, -0.03);
+  CHECK(compiled.compileTaskTrajectory(manipulator, &kinematics, OM_CHAIN_TOOL, &line, &delta,
+                                       TEST_MOVE_TIME, TEST_SAMPLE_TIME));
+
+  p_trajectory->makeCompiledTrajectory(&compiled);
+  end = compiled.getJointWaypoint(TEST_MOVE_TIME);
+
+  // A shorter one compiled into the same table
+  CHECK(compiled.compileTaskTrajectory(manipulator, &kinematics, OM_CHAIN_TOOL, &line, &delta,
+                                       TEST_MOVE_TIME / 2.0, TEST_SAMPLE_TIME));
+  CHECK(p_trajectory->getCompiledJointTrajectory()->getMoveTime() == TEST_MOVE_TIME);
+
+  copy = *p_trajectory;
+  delete p_trajectory;
+  CHECK(copy.getCompiledJointTrajectory()->getMoveTime() == TEST_MOVE_TIME);
+  for (i = 0; i < OM_CHAIN_DOF; i++)
+  {
+    CHECK(copy.getCompiledJointTrajectory()->getJointWaypoint(TEST_MOVE_TIME).at(i).position == end.at(i).position);
+  }
+}
+
+int main( void )
+{
+  test_line();
+  test_owned();
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+/*
+  test_dls_kinematics.cpp - the damped least-squares solver reaches poses of
+  the OpenManipulator-X and reports how it got there
+*/
+
+#include <vector>
+#include "om_chain.h"
+#include "host_test.h"
+
+using namespace kinematics;
+
+
+#define TEST_POSES    200
+#define TEST_SEED     1
+
+
+// Angles of a solve, the manipulator is left at start
+static bool solve( SolverUsingCRAndDLSJacobian *p_kinematics, Manipulator *p_manipulator,
+                   const std::vector<double> &start, const Pose &target, std::vector<double> *p_angle )
+{
+  std::vector<JointValue> goal;
+  bool result;
+  int  i;
+
+  p_manipulator->setAllActiveJointPosition(start);
+  p_kinematics->solveForwardKinematics(p_manipulator);
+
+  result = p_kinematics->solveInverseKinematics(p_manipulator, OM_CHAIN_TOOL, target, &goal);
+  CHECK(result == p_kinematics->getSolveInfo().success);
+
+  p_angle->clear();
+  for (i = 0; i < (int)goal.size(); i++)
+  {
+    p_angle->push_back(goal.at(i).position);
+  }
+  return result;
+}
+
+static void test_reachable( void )
+{
+  SolverUsingCRAndDLSJacobian  kinematics;
+  Manipulator                  manipulator;
+  std::vector<om_chain_pose_t> poses;
+  std::vector<double>          angle;
+  IKSolveInfo info;
+  DLSOption   option = { 0.01, 1E-12, 1E-8, 20 };
+  uint32_t    n;
+
+  om_chain_add(&manipulator);
+  om_chain_poses(TEST_POSES, TEST_SEED, &poses);
+  kinematics.setOption(&option);
+
+  for (n = 0; n < poses.size(); n++)
+  {
+    kinematics.clearWarmStart();
+    CHECK(solve(&kinematics, &manipulator, poses[n].start, poses[n].target, &angle));
+    CHECK(angle.size() == OM_CHAIN_DOF);
+
+    info = kinematics.getSolveInfo();
+    CHECK(info.warm_started == false);
+    CHECK(info.iteration >= 1 && info.iteration <= option.max_iteration);
+    CHECK(info.residual < option.error_tolerance);
+    CHECK(info.manipulability > 0.0);
+
+    CHECK(om_chain_reached(&kinematics, &manipulator, angle, poses[n].target));
+  }
+}
+
+static void test_warm_start( void )
+{
+  SolverUsingCRAndDLSJacobian  kinematics;
+  Manipulator                  manipulator;
+  std::vector<om_chain_pose_t> poses;
+  std::vector<double>          angle;
+  std::vector<double>          far_start;
+  uint8_t cold_iteration;
+
+  om_chain_add(&manipulator);
+  om_chain_poses(1, TEST_SEED, &poses);
+
+  // Cold from far away, then from the solution of the same pose
+  far_start = poses[0].start;
+  far_start[1] -= 0.5;
+  far_start[2] += 0.5;
+  CHECK(solve(&kinematics, &manipulator, far_start, poses[0].target, &angle));
+  cold_iteration = kinematics.getSolveInfo().iteration;
+  CHECK(kinematics.getSolveInfo().warm_started == false);
+
+  CHECK(solve(&kinematics, &manipulator, far_start, poses[0].target, &angle));
+  CHECK(kinematics.getSolveInfo().warm_started == true);
+  CHECK(kinematics.getSolveInfo().iteration < cold_iteration);
+  CHECK(om_chain_reached(&kinematics, &manipulator, angle, poses[0].target));
+
+  // A warm start further away than the present pose is not used
+  kinematics.setWarmStart(far_start);
+  CHECK(solve(&kinematics, &manipulator, poses[0].start, poses[0].target, &angle));
+  CHECK(kinematics.getSolveInfo().warm_started == false);
+
+  // Nor one of another number of joints
+  kinematics.setWarmStart(std::vector<double>(OM_CHAIN_DOF - 1, 0.0));
+  CHECK(solve(&kinematics, &manipulator, far_start, poses[0].target, &angle));
+  CHECK(kinematics.getSolveInfo().warm_started == false);
+
+  kinematics.clearWarmStart();
+  CHECK(solve(&kinematics, &manipulator, far_start, poses[0].target, &angle));
+  CHECK(kinematics.getSolveInfo().warm_started == false);
+  CHECK(kinematics.getSolveInfo().iteration == cold_iteration);
+}
+
+static void test_unreachable( void )
+{
+  SolverUsingCRAndDLSJacobian  kinematics;
+  Manipulator                  manipulator;
+  std::vector<om_chain_pose_t> poses;
+  std::vector<double>          angle;
+  Pose        target;
+  DLSOption   option = { 0.01, 1E-12, 1E-8, 20 };
+
+  om_chain_add(&manipulator);
+  om_chain_poses(1, TEST_SEED, &poses);
+  kinematics.setOption(&option);
+
+  // Half a meter beyond the reach of the arm
+  target = poses[0].target;
+  target.kinematic.position(0) += 0.5;
+  CHECK(solve(&kinematics, &manipulator, poses[0].start, target, &angle) == false);
+  CHECK(angle.empty());
+  CHECK(kinematics.getSolveInfo().iteration <= option.max_iteration);
+  CHECK(kinematics.getSolveInfo().residual >= option.error_tolerance);
+
+  // A failed solve does not become the warm start
+  CHECK(solve(&kinematics, &manipulator, poses[0].start, poses[0].target, &angle));
+  CHECK(kinematics.getSolveInfo().warm_started == false);
+
+  // The iterations stop at the option
+  option.max_iteration = 2;
+  kinematics.setOption(&option);
+  kinematics.clearWarmStart();
+  solve(&kinematics, &manipulator, poses[0].start, poses[0].target, &angle);
+  CHECK(kinematics.getSolveInfo().iteration <= 2);
+}
+
+int main( void )
+{
+  test_reachable();
+  test_warm_start();
+  test_unreachable();
+
+  return 0;
+}
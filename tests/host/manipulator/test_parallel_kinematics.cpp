@@ -0,0 +1,170 @@
+/*
+  test_parallel_kinematics.cpp - the forward kinematics and the Jacobian of
+  the Delta and the Stewart platform agree with their inverse kinematics
+*/
+
+#include <vector>
+#include "parallel_platform.h"
+#include "host_test.h"
+
+using namespace robotis_manipulator;
+
+
+#define POSITION_TOLERANCE  1e-6    // m
+// The forward kinematics stops within about 1e-9 m, a smaller step ends in its noise
+#define JACOBIAN_STEP       1e-4    // rad
+#define JACOBIAN_TOLERANCE  1e-4    // m/rad, rad/rad
+
+
+// Actuated angles of the inverse kinematics, the first values of its result
+static std::vector<double> solve_ik( Kinematics *p_kinematics, Manipulator *p_manipulator, const Pose &pose, int joints )
+{
+  std::vector<JointValue> goal;
+  std::vector<double>     angle;
+  int i;
+
+  CHECK(p_kinematics->solveInverseKinematics(p_manipulator, PARALLEL_PLATFORM_TOOL, pose, &goal));
+  CHECK((int)goal.size() >= joints);
+
+  for (i = 0; i < joints; i++)
+  {
+    CHECK(goal.at(i).position == goal.at(i).position);
+    angle.push_back(goal.at(i).position);
+  }
+  return angle;
+}
+
+static void check_fk( Kinematics *p_kinematics, Manipulator *p_manipulator, const Pose &pose, int joints )
+{
+  Eigen::Matrix3d orientation;
+  int i;
+  int j;
+
+  p_manipulator->setAllActiveJointPosition(solve_ik(p_kinematics, p_manipulator, pose, joints));
+  p_kinematics->solveForwardKinematics(p_manipulator);
+
+  for (i = 0; i < 3; i++)
+  {
+    CHECK_NEAR(p_manipulator->getComponentPositionFromWorld(PARALLEL_PLATFORM_TOOL)(i), pose.kinematic.position(i), POSITION_TOLERANCE);
+  }
+
+  if (joints < 6)
+  {
+    return;
+  }
+  orientation = p_manipulator->getComponentOrientationFromWorld(PARALLEL_PLATFORM_TOOL);
+  for (i = 0; i < 3; i++)
+  {
+    for (j = 0; j < 3; j++)
+    {
+      CHECK_NEAR(orientation(i, j), pose.kinematic.orientation(i, j), POSITION_TOLERANCE);
+    }
+  }
+}
+
+// Columns of the Jacobian against the pose moved by one joint at a time
+static void check_jacobian( Kinematics *p_kinematics, Manipulator *p_manipulator, const Pose &pose, int joints )
+{
+  std::vector<double> angle = solve_ik(p_kinematics, p_manipulator, pose, joints);
+  std::vector<double> moved;
+  Eigen::MatrixXd     jacobian;
+  Eigen::Vector3d     position;
+  Eigen::Matrix3d     orientation;
+  Eigen::Vector3d     velocity;
+  Eigen::Vector3d     omega;
+  int i;
+  int k;
+
+  p_manipulator->setAllActiveJointPosition(angle);
+  p_kinematics->solveForwardKinematics(p_manipulator);
+  position    = p_manipulator->getComponentPositionFromWorld(PARALLEL_PLATFORM_TOOL);
+  orientation = p_manipulator->getComponentOrientationFromWorld(PARALLEL_PLATFORM_TOOL);
+  jacobian    = p_kinematics->jacobian(p_manipulator, PARALLEL_PLATFORM_TOOL);
+  CHECK(jacobian.rows() == 6 && jacobian.cols() == joints);
+
+  for (k = 0; k < joints; k++)
+  {
+    moved = angle;
+    moved.at(k) += JACOBIAN_STEP;
+    p_manipulator->setAllActiveJointPosition(moved);
+    p_kinematics->solveForwardKinematics(p_manipulator);
+
+    velocity = (p_manipulator->getComponentPositionFromWorld(PARALLEL_PLATFORM_TOOL) - position) / JACOBIAN_STEP;
+    omega    = math::convertRotationMatrixToOmega(p_manipulator->getComponentOrientationFromWorld(PARALLEL_PLATFORM_TOOL) * orientation.transpose()) / JACOBIAN_STEP;
+
+    for (i = 0; i < 3; i++)
+    {
+      CHECK_NEAR(jacobian(i, k), velocity(i), JACOBIAN_TOLERANCE);
+      CHECK_NEAR(jacobian(i + 3, k), omega(i), JACOBIAN_TOLERANCE);
+    }
+
+    // Back to the pose, the next solve starts from it
+    p_manipulator->setAllActiveJointPosition(angle);
+    p_kinematics->solveForwardKinematics(p_manipulator);
+  }
+}
+
+static void test_delta( void )
+{
+  Manipulator manipulator;
+  delta_kinematics::SolverUsingGeometry kinematics;
+  double x;
+  double y;
+  double z;
+
+  parallel_platform_add(&manipulator, DELTA_JOINTS);
+
+  // Workspace of the ball demo, each solve starts from the one before
+  for (z = 0.0; z <= 0.06; z += 0.01)
+  {
+    for (y = -0.05; y <= 0.05; y += 0.01)
+    {
+      for (x = -0.05; x <= 0.05; x += 0.01)
+      {
+        check_fk(&kinematics, &manipulator, parallel_platform_pose(x, y, z, 0.0, 0.0, 0.0), DELTA_JOINTS);
+      }
+    }
+  }
+
+  check_jacobian(&kinematics, &manipulator, parallel_platform_pose(0.0, 0.0, 0.023, 0.0, 0.0, 0.0), DELTA_JOINTS);
+  check_jacobian(&kinematics, &manipulator, parallel_platform_pose(0.04, -0.03, 0.04, 0.0, 0.0, 0.0), DELTA_JOINTS);
+}
+
+static void test_stewart( void )
+{
+  Manipulator manipulator;
+  stewart_kinematics::SolverUsingGeometry kinematics;
+  double x;
+  double y;
+  double z;
+
+  parallel_platform_add(&manipulator, STEWART_JOINTS);
+
+  // Reachable for any x, y within 3 cm
+  for (z = -0.005; z <= 0.015; z += 0.005)
+  {
+    for (y = -0.03; y <= 0.03; y += 0.005)
+    {
+      for (x = -0.03; x <= 0.03; x += 0.005)
+      {
+        check_fk(&kinematics, &manipulator, parallel_platform_pose(x, y, z, 0.0, 0.0, 0.0), STEWART_JOINTS);
+      }
+    }
+  }
+
+  // Tilted and turned platform
+  check_fk(&kinematics, &manipulator, parallel_platform_pose(0.0, 0.0, 0.0, 0.0, 0.0, 0.1), STEWART_JOINTS);
+  check_fk(&kinematics, &manipulator, parallel_platform_pose(0.01, -0.01, 0.0, 0.1, 0.0, 0.0), STEWART_JOINTS);
+  check_fk(&kinematics, &manipulator, parallel_platform_pose(0.0, 0.01, 0.005, 0.0, -0.1, 0.0), STEWART_JOINTS);
+
+  check_jacobian(&kinematics, &manipulator, parallel_platform_pose(0.0, 0.0, 0.0, 0.0, 0.0, 0.0), STEWART_JOINTS);
+  check_jacobian(&kinematics, &manipulator, parallel_platform_pose(0.01, -0.01, 0.005, 0.0, 0.0, 0.1), STEWART_JOINTS);
+}
+
+int main( void )
+{
+  test_delta();
+  test_stewart();
+
+  return 0;
+}
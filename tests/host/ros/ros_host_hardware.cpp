@@ -0,0 +1,114 @@
+/*
+  ros_host_hardware.cpp - the serial port of a NodeHandle on the host
+*/
+
+#include <string.h>
+#include "ros_host_hardware.h"
+
+
+#define ROS_HOST_FRAME_HEADER   7
+#define ROS_HOST_MSG_BUFFER     4096
+
+
+int RosHostHardware::read( uint8_t *data, int length )
+{
+  int count = (int)(rx.size() - rx_index);
+
+  if (count > length)
+  {
+    count = length;
+  }
+  if (count > rx_chunk)
+  {
+    count = rx_chunk;
+  }
+  memcpy(data, rx.data() + rx_index, count);
+  rx_index += count;
+
+  return count;
+}
+
+void RosHostHardware::write( uint8_t *data, int length )
+{
+  if (length > tx_room)
+  {
+    tx_overflow++;
+  }
+  tx.insert(tx.end(), data, data + length);
+  tx_room -= length;
+  tx_writes++;
+}
+
+
+
+std::vector<uint8_t> ros_host_frame( int id, const ros::Msg &msg )
+{
+  static uint8_t data[ROS_HOST_MSG_BUFFER];
+
+  return ros_host_frame(id, data, msg.serialize(data));
+}
+
+std::vector<uint8_t> ros_host_frame( int id, const uint8_t *p_data, int length )
+{
+  std::vector<uint8_t> frame;
+  int sum;
+  int i;
+
+  frame.push_back(0xFF);
+  frame.push_back(0xFE);
+  frame.push_back(length & 0xFF);
+  frame.push_back(length >> 8);
+  frame.push_back(255 - ((frame[2] + frame[3]) % 256));
+  frame.push_back(id & 0xFF);
+  frame.push_back(id >> 8);
+  frame.insert(frame.end(), p_data, p_data + length);
+
+  sum = 0;
+  for (i = 5; i < (int)frame.size(); i++)
+  {
+    sum += frame[i];
+  }
+  frame.push_back(255 - (sum % 256));
+
+  return frame;
+}
+
+std::vector<ros_host_frame_t> ros_host_frames( const std::vector<uint8_t> &bytes )
+{
+  std::vector<ros_host_frame_t> frames;
+  ros_host_frame_t frame;
+  size_t i = 0;
+  size_t j;
+  int    length;
+  int    sum;
+
+  while (i + ROS_HOST_FRAME_HEADER + 1 <= bytes.size())
+  {
+    length = bytes[i+2] | (bytes[i+3] << 8);
+    if (bytes[i] != 0xFF || bytes[i+1] != 0xFE
+     || (bytes[i+2] + bytes[i+3] + bytes[i+4]) % 256 != 255
+     || i + ROS_HOST_FRAME_HEADER + length + 1 > bytes.size())
+    {
+      i++;
+      continue;
+    }
+
+    sum = 0;
+    for (j = i + 5; j < i + ROS_HOST_FRAME_HEADER + length + 1; j++)
+    {
+      sum += bytes[j];
+    }
+    if (sum % 256 != 255)
+    {
+      i++;
+      continue;
+    }
+
+    frame.id = bytes[i+5] | (bytes[i+6] << 8);
+    frame.data.assign(bytes.begin() + i + ROS_HOST_FRAME_HEADER, bytes.begin() + i + ROS_HOST_FRAME_HEADER + length);
+    frames.push_back(frame);
+    i += ROS_HOST_FRAME_HEADER + length + 1;
+  }
+
+  return frames;
+}
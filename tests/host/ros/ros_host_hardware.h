@@ -0,0 +1,56 @@
+/*
+  ros_host_hardware.h - the serial port of a NodeHandle on the host, and the
+  frames of the rosserial host on the other side of it
+
+  Time is the one of the stubbed board, host_set_micros() moves it.
+*/
+
+#ifndef _ROS_HOST_HARDWARE_H_
+#define _ROS_HOST_HARDWARE_H_
+
+#include <stdint.h>
+#include <vector>
+#include <Arduino.h>
+#include "ros/msg.h"
+
+
+class RosHostHardware
+{
+  public:
+    void init( void ) { }
+
+    // At most rx_chunk bytes per call, as they arrive over USB
+    int  read( uint8_t *data, int length );
+
+    int  availableForWrite( void ) { return tx_room; }
+    void write( uint8_t *data, int length );
+
+    unsigned long time( void )    { return millis(); }
+    unsigned long time_us( void ) { return micros(); }
+
+    // Host side: bytes the port still has to deliver, the bytes written and
+    // the room the next write finds. A write larger than the room is counted.
+    std::vector<uint8_t> rx;
+    size_t               rx_index    = 0;
+    int                  rx_chunk    = 0x7FFF;
+    std::vector<uint8_t> tx;
+    int                  tx_room     = 0x7FFF;
+    uint32_t             tx_writes   = 0;
+    uint32_t             tx_overflow = 0;
+};
+
+typedef struct
+{
+  int                  id;
+  std::vector<uint8_t> data;    // the serialized message
+} ros_host_frame_t;
+
+
+// Frame of a message as rosserial sends it, protocol version 2
+std::vector<uint8_t> ros_host_frame( int id, const ros::Msg &msg );
+std::vector<uint8_t> ros_host_frame( int id, const uint8_t *p_data, int length );
+
+// Frames with correct length and message checksums, anything else is skipped
+std::vector<ros_host_frame_t> ros_host_frames( const std::vector<uint8_t> &bytes );
+
+#endif /* _ROS_HOST_HARDWARE_H_ */
@@ -0,0 +1,41 @@
+/*
+  ros_msg_codec.h - rosserial messages of the TurtleBot3 firmware, built
+  once with the word copies of ros/msg.h and once with its byte copies
+*/
+
+#ifndef _ROS_MSG_CODEC_H_
+#define _ROS_MSG_CODEC_H_
+
+#include <stdint.h>
+
+
+#define ROS_MSG_CODEC_BUFFER  4096
+
+enum
+{
+  ROS_MSG_IMU,
+  ROS_MSG_JOINT_STATE,
+  ROS_MSG_ODOMETRY,
+  ROS_MSG_TF,
+  ROS_MSG_TYPES
+};
+
+typedef struct
+{
+  const char *name;
+
+  const char *(*typeName)( int type );
+
+  // Same content for the same seed in both builds, normal numbers only
+  void (*fill)( int type, uint32_t seed );
+  int  (*serialize)( int type, unsigned char *buffer );
+
+  // Into a message of its own, serializeDecoded() writes it again
+  int  (*deserialize)( int type, unsigned char *buffer );
+  int  (*serializeDecoded)( int type, unsigned char *buffer );
+} ros_msg_codec_t;
+
+extern const ros_msg_codec_t ros_msg_word;
+extern const ros_msg_codec_t ros_msg_byte;
+
+#endif /* _ROS_MSG_CODEC_H_ */
@@ -0,0 +1,10 @@
+/*
+  ros_msg_codec_byte.cpp - messages with the byte copies of ros/msg.h, as
+  before the word copies and on big endian targets
+*/
+
+#define ROS_MSG_BYTEWISE
+#define ROS_MSG_CODEC_NS    byte
+#define ROS_MSG_CODEC_NAME  ros_msg_byte
+
+#include "ros_msg_codec_impl.h"
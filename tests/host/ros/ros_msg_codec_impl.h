@@ -0,0 +1,203 @@
+/*
+  ros_msg_codec_impl.h - body of ros_msg_word and ros_msg_byte
+
+  Each build keeps the messages in a namespace of its own, so the inline
+  serializers of the two do not get merged by the linker. Define
+  ROS_MSG_CODEC_NS and ROS_MSG_CODEC_NAME before including it.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ros_msg_codec.h"
+
+
+namespace ROS_MSG_CODEC_NS
+{
+#include "sensor_msgs/Imu.h"
+#include "sensor_msgs/JointState.h"
+#include "nav_msgs/Odometry.h"
+#include "tf/tfMessage.h"
+
+
+#define CODEC_JOINTS      2
+#define CODEC_TRANSFORMS  2
+
+
+static sensor_msgs::Imu        imu, imu_decoded;
+static sensor_msgs::JointState joint_state, joint_state_decoded;
+static nav_msgs::Odometry      odometry, odometry_decoded;
+static tf::tfMessage           tf_message, tf_message_decoded;
+
+static char  *joint_name[CODEC_JOINTS] = { (char *)"wheel_left_joint", (char *)"wheel_right_joint" };
+static float  joint_position[CODEC_JOINTS];
+static float  joint_velocity[CODEC_JOINTS];
+static float  joint_effort[CODEC_JOINTS];
+
+static geometry_msgs::TransformStamped transforms[CODEC_TRANSFORMS];
+
+static uint32_t codec_seed;
+
+
+static float codec_value( void )
+{
+  static const float scale[] = { 0.001f, 0.1f, 1.0f, 10.0f, 1000.0f };
+  uint32_t r;
+
+  codec_seed = codec_seed * 1664525u + 1013904223u;
+  r = codec_seed >> 8;
+
+  if ((r & 0x0f) == 0)
+  {
+    return 0.0f;
+  }
+  return scale[r % 5] * (2.0f * (float)r / (float)(1u << 24) - 1.0f);
+}
+
+static void codec_header( std_msgs::Header &header, const char *frame_id )
+{
+  header.seq        = codec_seed;
+  header.stamp.sec  = codec_seed >> 4;
+  header.stamp.nsec = codec_seed % 1000000000u;
+  header.frame_id   = frame_id;
+}
+
+template <size_t N>
+static void codec_values( float (&values)[N] )
+{
+  for (size_t i = 0; i < N; i++)
+  {
+    values[i] = codec_value();
+  }
+}
+
+static void codec_vector( geometry_msgs::Vector3 &v )
+{
+  v.x = codec_value();
+  v.y = codec_value();
+  v.z = codec_value();
+}
+
+static void codec_quaternion( geometry_msgs::Quaternion &q )
+{
+  q.x = codec_value();
+  q.y = codec_value();
+  q.z = codec_value();
+  q.w = codec_value();
+}
+
+static void codec_fill( int type, uint32_t seed )
+{
+  size_t i;
+
+  codec_seed = seed;
+
+  switch (type)
+  {
+    case ROS_MSG_IMU:
+      codec_header(imu.header, "imu_link");
+      codec_quaternion(imu.orientation);
+      codec_vector(imu.angular_velocity);
+      codec_vector(imu.linear_acceleration);
+      codec_values(imu.orientation_covariance);
+      codec_values(imu.angular_velocity_covariance);
+      codec_values(imu.linear_acceleration_covariance);
+      break;
+
+    case ROS_MSG_JOINT_STATE:
+      codec_header(joint_state.header, "base_link");
+      for (i = 0; i < CODEC_JOINTS; i++)
+      {
+        joint_position[i] = codec_value();
+        joint_velocity[i] = codec_value();
+        joint_effort[i]   = codec_value();
+      }
+      joint_state.name_length     = CODEC_JOINTS;
+      joint_state.name            = joint_name;
+      joint_state.position_length = CODEC_JOINTS;
+      joint_state.position        = joint_position;
+      joint_state.velocity_length = CODEC_JOINTS;
+      joint_state.velocity        = joint_velocity;
+      joint_state.effort_length   = CODEC_JOINTS;
+      joint_state.effort          = joint_effort;
+      break;
+
+    case ROS_MSG_ODOMETRY:
+      codec_header(odometry.header, "odom");
+      odometry.child_frame_id = "base_footprint";
+      odometry.pose.pose.position.x = codec_value();
+      odometry.pose.pose.position.y = codec_value();
+      odometry.pose.pose.position.z = codec_value();
+      codec_quaternion(odometry.pose.pose.orientation);
+      codec_values(odometry.pose.covariance);
+      codec_vector(odometry.twist.twist.linear);
+      codec_vector(odometry.twist.twist.angular);
+      codec_values(odometry.twist.covariance);
+      break;
+
+    case ROS_MSG_TF:
+      for (i = 0; i < CODEC_TRANSFORMS; i++)
+      {
+        codec_header(transforms[i].header, "odom");
+        transforms[i].child_frame_id = "base_footprint";
+        codec_vector(transforms[i].transform.translation);
+        codec_quaternion(transforms[i].transform.rotation);
+      }
+      tf_message.transforms_length = CODEC_TRANSFORMS;
+      tf_message.transforms        = transforms;
+      break;
+
+    default:
+      break;
+  }
+}
+
+static ros::Msg *codec_message( int type, bool decoded )
+{
+  switch (type)
+  {
+    case ROS_MSG_IMU:         return decoded ? (ros::Msg *)&imu_decoded         : &imu;
+    case ROS_MSG_JOINT_STATE: return decoded ? (ros::Msg *)&joint_state_decoded : &joint_state;
+    case ROS_MSG_ODOMETRY:    return decoded ? (ros::Msg *)&odometry_decoded    : &odometry;
+    case ROS_MSG_TF:          return decoded ? (ros::Msg *)&tf_message_decoded  : &tf_message;
+    default:                  return NULL;
+  }
+}
+
+static const char *codec_type_name( int type )
+{
+  return codec_message(type, false)->getType();
+}
+
+static int codec_serialize( int type, unsigned char *buffer )
+{
+  return codec_message(type, false)->serialize(buffer);
+}
+
+static int codec_deserialize( int type, unsigned char *buffer )
+{
+  return codec_message(type, true)->deserialize(buffer);
+}
+
+static int codec_serialize_decoded( int type, unsigned char *buffer )
+{
+  return codec_message(type, true)->serialize(buffer);
+}
+
+} // namespace ROS_MSG_CODEC_NS
+
+
+#define CODEC_STRING(x)   CODEC_STRING_(x)
+#define CODEC_STRING_(x)  #x
+
+const ros_msg_codec_t ROS_MSG_CODEC_NAME =
+{
+  CODEC_STRING(ROS_MSG_CODEC_NS),
+  ROS_MSG_CODEC_NS::codec_type_name,
+  ROS_MSG_CODEC_NS::codec_fill,
+  ROS_MSG_CODEC_NS::codec_serialize,
+  ROS_MSG_CODEC_NS::codec_deserialize,
+  ROS_MSG_CODEC_NS::codec_serialize_decoded,
+};
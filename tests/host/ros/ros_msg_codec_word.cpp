@@ -0,0 +1,8 @@
+/*
+  ros_msg_codec_word.cpp - messages with the word copies of ros/msg.h
+*/
+
+#define ROS_MSG_CODEC_NS    word
+#define ROS_MSG_CODEC_NAME  ros_msg_word
+
+#include "ros_msg_codec_impl.h"
@@ -0,0 +1,703 @@
+/*
+  test_node_handle.cpp - NodeHandle_ of the TurtleBot3 firmware against a
+  simulated rosserial host, on the stubbed micros()
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include "ros/node_handle.h"
+#include "std_msgs/String.h"
+#include "std_msgs/Time.h"
+#include "ros_host_hardware.h"
+#include "host_stub.h"
+#include "host_test.h"
+
+
+#define TEST_INPUT_SIZE     1024
+#define TEST_STREAM_ITEMS   4000
+#define TEST_TX_QUEUE_SIZE  2048    // as the OpenCR node handle
+
+
+typedef ros::NodeHandle_<RosHostHardware, 25, 25, TEST_INPUT_SIZE, 1024> TestNodeHandle;
+typedef ros::NodeHandle_<RosHostHardware, 25, 25, TEST_INPUT_SIZE, 1024, TEST_TX_QUEUE_SIZE> TestQueueNodeHandle;
+
+
+/*******************************************************************************
+* Time sync
+*******************************************************************************/
+// The clock of the host, running at (1 + drift) of micros()
+typedef struct
+{
+  double  drift;
+  int64_t offset_ns;
+} test_host_clock_t;
+
+static int64_t host_ns( const test_host_clock_t &clock, uint32_t local_us )
+{
+  return clock.offset_ns + (int64_t)llround((double)local_us * 1000.0 * (1.0 + clock.drift));
+}
+
+static int64_t time_ns( const ros::Time &t )
+{
+  return (int64_t)t.sec * 1000000000 + t.nsec;
+}
+
+// Error of the time the node gives a local stamp
+static int64_t sync_error_ns( TestNodeHandle &nh, const test_host_clock_t &clock, uint32_t local_us )
+{
+  return time_ns(nh.toTime(local_us)) - host_ns(clock, local_us);
+}
+
+// One request and reply. The host stamps the reply at stamp_part of the
+// round trip after the request.
+static void sync_once( TestNodeHandle &nh, const test_host_clock_t &clock, uint32_t local_us,
+                       uint32_t rtt_us, double stamp_part )
+{
+  RosHostHardware *hw = nh.getHardware();
+  std_msgs::Time t;
+  int64_t stamp_ns;
+
+  host_set_micros(local_us);
+  nh.requestSyncTime();
+
+  stamp_ns = host_ns(clock, local_us + (uint32_t)(rtt_us * stamp_part));
+  t.data.sec  = (uint32_t)(stamp_ns / 1000000000);
+  t.data.nsec = (uint32_t)(stamp_ns % 1000000000);
+
+  host_set_micros(local_us + rtt_us);
+  hw->rx = ros_host_frame(rosserial_msgs::TopicInfo::ID_TIME, t);
+  hw->rx_index = 0;
+  nh.spinOnce();
+  hw->tx.clear();
+}
+
+static void test_sync_drift( void )
+{
+  static const double drift[] = { 0.0, 150e-6, -300e-6, 450e-6 };
+  static TestNodeHandle nh_list[sizeof(drift) / sizeof(drift[0])];
+  test_host_clock_t clock;
+  uint32_t local_us;
+  uint32_t i;
+  int n;
+
+  for (i = 0; i < sizeof(drift) / sizeof(drift[0]); i++)
+  {
+    TestNodeHandle &nh = nh_list[i];
+
+    clock.drift     = drift[i];
+    clock.offset_ns = 1700000000LL * 1000000000LL + 123456789;
+    nh.initNode();
+
+    // A sync every second for a minute, the host stamps in the middle of
+    // the round trip
+    local_us = 10000;
+    for (n = 0; n < 60; n++)
+    {
+      sync_once(nh, clock, local_us, 1000, 0.5);
+      local_us += 1000000;
+    }
+    CHECK(nh.getSyncRejectCount() == 0);
+    CHECK(nh.getSyncRoundTrip() == 1000);
+    CHECK_NEAR(nh.getSyncDrift(), drift[i], 1e-6);
+
+    // A stamp taken a second after the last sync is still right
+    CHECK(llabs(sync_error_ns(nh, clock, local_us)) < 1000);
+
+    // Another minute with round trips of 1 to 1.2 ms and the host stamping
+    // anywhere in the middle 40 % of them, up to 120 us off. The time stays
+    // within about that of the host and the drift is not lost.
+    for (n = 0; n < 60; n++)
+    {
+      sync_once(nh, clock, local_us, 1000 + (n * 37) % 200, 0.3 + ((n * 7) % 5) / 10.0);
+      local_us += 1000000;
+      CHECK(llabs(sync_error_ns(nh, clock, local_us)) < 250000);
+      CHECK_NEAR(nh.getSyncDrift(), drift[i], 100e-6);
+    }
+    CHECK(nh.getSyncRejectCount() == 0);
+  }
+}
+
+static void test_sync_reject( void )
+{
+  static TestNodeHandle nh;
+  test_host_clock_t clock = { 100e-6, 42LL * 1000000000LL };
+  uint32_t local_us = 5000;
+  uint32_t rtt_us;
+  int64_t  error_ns;
+  float    drift;
+  int n;
+
+  nh.initNode();
+  for (n = 0; n < 30; n++)
+  {
+    sync_once(nh, clock, local_us, 1000, 0.5);
+    local_us += 1000000;
+  }
+  CHECK(nh.getSyncRejectCount() == 0);
+  rtt_us   = nh.getSyncRoundTrip();
+  drift    = nh.getSyncDrift();
+  error_ns = sync_error_ns(nh, clock, local_us);
+
+  // A reply held up by the host for 30 ms, stamped at its end, would move
+  // the clock by 15 ms. It is not used.
+  sync_once(nh, clock, local_us, 30000, 1.0);
+  CHECK(nh.getSyncRejectCount() == 1);
+  CHECK(nh.getSyncRoundTrip() == rtt_us);
+  CHECK(nh.getSyncDrift() == drift);
+  CHECK(sync_error_ns(nh, clock, local_us) == error_ns);
+
+  // Up to twice the shortest round trip and the margin is still used
+  local_us += 1000000;
+  sync_once(nh, clock, local_us, 2 * 1000 + ros::SYNC_RTT_MARGIN_US, 0.5);
+  CHECK(nh.getSyncRejectCount() == 1);
+  CHECK(nh.getSyncRoundTrip() == 2 * 1000 + ros::SYNC_RTT_MARGIN_US);
+
+  // The shortest round trip ages, a link that got slower for good is taken
+  // again after a while
+  for (n = 0; n < 30 && nh.getSyncRejectCount() < 30; n++)
+  {
+    local_us += 1000000;
+    sync_once(nh, clock, local_us, 8000, 0.5);
+  }
+  CHECK(nh.getSyncRoundTrip() == 8000);
+  CHECK(nh.getSyncRejectCount() < 30);
+}
+
+static void test_sync_drift_clamp( void )
+{
+  static const double drift[] = { 2000e-6, -2000e-6 };
+  static TestNodeHandle nh_list[sizeof(drift) / sizeof(drift[0])];
+  test_host_clock_t clock;
+  uint32_t local_us;
+  uint32_t i;
+  int n;
+
+  for (i = 0; i < sizeof(drift) / sizeof(drift[0]); i++)
+  {
+    TestNodeHandle &nh = nh_list[i];
+
+    clock.drift     = drift[i];
+    clock.offset_ns = 1000LL * 1000000000LL;
+    nh.initNode();
+
+    local_us = 1000;
+    for (n = 0; n < 60; n++)
+    {
+      sync_once(nh, clock, local_us, 1000, 0.5);
+      CHECK(fabs(nh.getSyncDrift()) <= ros::SYNC_DRIFT_MAX);
+      local_us += 1000000;
+    }
+    CHECK(nh.getSyncDrift() == (drift[i] > 0 ? ros::SYNC_DRIFT_MAX : -ros::SYNC_DRIFT_MAX));
+  }
+}
+
+
+/*******************************************************************************
+* Input parser
+*******************************************************************************/
+// A frame the node acted on: a message of a subscriber, or 0 when the host
+// asked for the topics
+typedef struct
+{
+  int         id;
+  std::string data;
+} test_event_t;
+
+static std::vector<test_event_t> *p_events;
+
+static void record( int id, const char *data )
+{
+  test_event_t event;
+
+  event.id   = id;
+  event.data = data;
+  p_events->push_back(event);
+}
+
+static void callback_100( const std_msgs::String &msg ) { record(100, msg.data); }
+static void callback_101( const std_msgs::String &msg ) { record(101, msg.data); }
+static void callback_102( const std_msgs::String &msg ) { record(102, msg.data); }
+
+static bool operator==( const test_event_t &a, const test_event_t &b )
+{
+  return a.id == b.id && a.data == b.data;
+}
+
+/*
+  The parser spinOnce() had before it took the input in chunks, one byte per
+  read(), with the length limit of message_in it lacked. What it delivers is
+  what spinOnce() has to deliver.
+*/
+class TestByteParser
+{
+  public:
+    void parse( const std::vector<uint8_t> &bytes, std::vector<test_event_t> &events );
+
+  private:
+    int     mode_     = ros::MODE_FIRST_FF;
+    int     bytes_    = 0;
+    int     topic_    = 0;
+    int     index_    = 0;
+    int     checksum_ = 0;
+    uint8_t message_in_[TEST_INPUT_SIZE];
+};
+
+void TestByteParser::parse( const std::vector<uint8_t> &bytes, std::vector<test_event_t> &events )
+{
+  std_msgs::String msg;
+  size_t i;
+  int    data;
+
+  for (i = 0; i < bytes.size(); i++)
+  {
+    data = bytes[i];
+    checksum_ += data;
+    if (mode_ == ros::MODE_MESSAGE)
+    {
+      message_in_[index_++] = data;
+      bytes_--;
+      if (bytes_ == 0)
+        mode_ = ros::MODE_MSG_CHECKSUM;
+    }
+    else if (mode_ == ros::MODE_FIRST_FF)
+    {
+      if (data == 0xff)
+        mode_++;
+    }
+    else if (mode_ == ros::MODE_PROTOCOL_VER)
+    {
+      if (data == ros::PROTOCOL_VER)
+        mode_++;
+      else
+        mode_ = ros::MODE_FIRST_FF;
+    }
+    else if (mode_ == ros::MODE_SIZE_L)
+    {
+      bytes_ = data;
+      index_ = 0;
+      mode_++;
+      checksum_ = data;
+    }
+    else if (mode_ == ros::MODE_SIZE_H)
+    {
+      bytes_ += data << 8;
+      mode_++;
+    }
+    else if (mode_ == ros::MODE_SIZE_CHECKSUM)
+    {
+      if ((checksum_ % 256) == 255 && bytes_ <= TEST_INPUT_SIZE)
+        mode_++;
+      else
+        mode_ = ros::MODE_FIRST_FF;
+    }
+    else if (mode_ == ros::MODE_TOPIC_L)
+    {
+      topic_ = data;
+      mode_++;
+      checksum_ = data;
+    }
+    else if (mode_ == ros::MODE_TOPIC_H)
+    {
+      topic_ += data << 8;
+      mode_ = ros::MODE_MESSAGE;
+      if (bytes_ == 0)
+        mode_ = ros::MODE_MSG_CHECKSUM;
+    }
+    else if (mode_ == ros::MODE_MSG_CHECKSUM)
+    {
+      mode_ = ros::MODE_FIRST_FF;
+      if ((checksum_ % 256) == 255)
+      {
+        test_event_t event;
+
+        event.id = topic_;
+        if (topic_ >= 100)
+        {
+          msg.deserialize(message_in_);
+          event.data = msg.data;
+        }
+        events.push_back(event);
+      }
+    }
+  }
+}
+
+static uint32_t next( uint32_t &state )
+{
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+static void add_string_frame( std::vector<uint8_t> &stream, int id, int length, uint32_t &state )
+{
+  std::vector<uint8_t> frame;
+  std::string text;
+  std_msgs::String msg;
+  int i;
+
+  for (i = 0; i < length; i++)
+  {
+    text += (char)('a' + next(state) % 26);
+  }
+  msg.data = text.c_str();
+  frame = ros_host_frame(id, msg);
+  stream.insert(stream.end(), frame.begin(), frame.end());
+}
+
+/*
+  What arrives from a host over a noisy link: frames of three topics, from
+  empty up to the largest message_in takes, the topic request of a host
+  that connects, frames with a wrong message or length checksum, frames
+  longer than message_in, cut off frames, and bytes in between that look
+  like the start of a frame.
+*/
+static std::vector<uint8_t> make_stream( void )
+{
+  std::vector<uint8_t> stream;
+  std::vector<uint8_t> frame;
+  std_msgs::String msg;
+  uint32_t state = 12345;
+  size_t start;
+  int length;
+  int item;
+  int i;
+
+  for (item = 0; item < TEST_STREAM_ITEMS; item++)
+  {
+    switch (next(state) % 12)
+    {
+      case 0:   // a wrong message checksum
+        add_string_frame(stream, 100 + next(state) % 3, next(state) % 64, state);
+        stream.back() ^= 1 << (next(state) % 8);
+        break;
+
+      case 1:   // a wrong length checksum
+        start = stream.size();
+        add_string_frame(stream, 100 + next(state) % 3, next(state) % 64, state);
+        stream[start + 4] ^= 0x10;
+        break;
+
+      case 2:   // longer than message_in, with a right length checksum
+        length = TEST_INPUT_SIZE + 1 + next(state) % 2000;
+        frame.assign(length, 0x55);
+        frame = ros_host_frame(100, frame.data(), length);
+        stream.insert(stream.end(), frame.begin(), frame.begin() + 7 + next(state) % 300);
+        break;
+
+      case 3:   // cut off
+        add_string_frame(stream, 100 + next(state) % 3, next(state) % 64, state);
+        stream.resize(stream.size() - 1 - next(state) % 10);
+        break;
+
+      case 4:   // noise, the start of a frame now and then
+        length = next(state) % 20;
+        for (i = 0; i < length; i++)
+        {
+          static const uint8_t noise[] = { 0xff, 0xfe, 0x00, 0x64, 0xff, 0x12 };
+          stream.push_back(noise[next(state) % sizeof(noise)]);
+        }
+        break;
+
+      case 5:   // the host asks for the topics again
+        if (next(state) % 8 == 0)
+        {
+          frame = ros_host_frame(rosserial_msgs::TopicInfo::ID_PUBLISHER, NULL, 0);
+          stream.insert(stream.end(), frame.begin(), frame.end());
+        }
+        break;
+
+      case 6:   // as large as message_in takes
+        add_string_frame(stream, 100 + next(state) % 3, TEST_INPUT_SIZE - 4 - next(state) % 2, state);
+        break;
+
+      default:
+        add_string_frame(stream, 100 + next(state) % 3, next(state) % 300, state);
+        break;
+    }
+  }
+
+  return stream;
+}
+
+static void test_chunked_input( void )
+{
+  // The stream arrives in pieces of this many bytes, read() hands out as many
+  static const int chunk[] = { 1, 7, 128, 1000000 };
+  static TestNodeHandle nh_list[sizeof(chunk) / sizeof(chunk[0])];
+  std::vector<uint8_t> stream = make_stream();
+  std::vector<test_event_t> expected;
+  std::vector<test_event_t> events;
+  TestByteParser parser;
+  ros::Subscriber<std_msgs::String> sub_100("a", callback_100);
+  ros::Subscriber<std_msgs::String> sub_101("b", callback_101);
+  ros::Subscriber<std_msgs::String> sub_102("c", callback_102);
+  size_t   offset;
+  size_t   length;
+  uint32_t i;
+  int      count[3] = { 0, 0, 0 };
+  int      result;
+
+  parser.parse(stream, expected);
+  for (i = 0; i < expected.size(); i++)
+  {
+    if (expected[i].id == 0)
+      count[0]++;
+    else if (expected[i].data.size() + 4 >= TEST_INPUT_SIZE - 1)
+      count[1]++;
+    else
+      count[2]++;
+  }
+  // The stream has all kinds of frames the node acts on
+  CHECK(count[0] > 10 && count[1] > 10 && count[2] > 1000);
+
+  host_set_micros(0);
+  p_events = &events;
+  for (i = 0; i < sizeof(chunk) / sizeof(chunk[0]); i++)
+  {
+    TestNodeHandle  &nh = nh_list[i];
+    RosHostHardware *hw = nh.getHardware();
+
+    nh.initNode();
+    CHECK(nh.subscribe(sub_100) && nh.subscribe(sub_101) && nh.subscribe(sub_102));
+    CHECK(sub_100.id_ == 100 && sub_101.id_ == 101 && sub_102.id_ == 102);
+    hw->rx_chunk = chunk[i];
+
+    events.clear();
+    for (offset = 0; offset < stream.size(); offset += length)
+    {
+      length = stream.size() - offset;
+      if (length > (size_t)chunk[i])
+        length = chunk[i];
+      hw->rx.insert(hw->rx.end(), stream.begin() + offset, stream.begin() + offset + length);
+
+      // spinOnce() returns after the topic request, the rest of the chunk
+      // is parsed by the next call
+      while ((result = nh.spinOnce()) == ros::SPIN_ERR)
+      {
+        record(0, "");
+      }
+      CHECK(result == ros::SPIN_OK);
+      CHECK(hw->rx_index == hw->rx.size());
+      hw->tx.clear();
+    }
+
+    CHECK(events.size() == expected.size());
+    CHECK(events == expected);
+  }
+}
+
+
+/*******************************************************************************
+* Transmit queue
+*******************************************************************************/
+static void connect( TestQueueNodeHandle &nh )
+{
+  RosHostHardware *hw = nh.getHardware();
+
+  hw->rx = ros_host_frame(rosserial_msgs::TopicInfo::ID_PUBLISHER, NULL, 0);
+  hw->rx_index = 0;
+  nh.spinOnce();
+  CHECK(nh.connected());
+  hw->tx.clear();
+}
+
+static int publish( ros::Publisher &pub, const char *text )
+{
+  std_msgs::String msg;
+
+  msg.data = text;
+  return pub.publish(&msg);
+}
+
+// The topics and messages of the frames written to the port, in order
+static std::vector<test_event_t> written( RosHostHardware *hw )
+{
+  std::vector<ros_host_frame_t> frames = ros_host_frames(hw->tx);
+  std::vector<test_event_t> events;
+  std_msgs::String msg;
+  test_event_t event;
+  size_t i;
+
+  for (i = 0; i < frames.size(); i++)
+  {
+    msg.deserialize(frames[i].data.data());
+    event.id   = frames[i].id;
+    event.data = msg.data;
+    events.push_back(event);
+  }
+  hw->tx.clear();
+  return events;
+}
+
+static std::vector<test_event_t> events_of( const std::vector<std::pair<int, const char *> > &list )
+{
+  std::vector<test_event_t> events;
+  test_event_t event;
+  size_t i;
+
+  for (i = 0; i < list.size(); i++)
+  {
+    event.id   = list[i].first;
+    event.data = list[i].second;
+    events.push_back(event);
+  }
+  return events;
+}
+
+static void test_tx_queue( void )
+{
+  static TestQueueNodeHandle nh;
+  RosHostHardware *hw = nh.getHardware();
+  std_msgs::String msg;
+  ros::Publisher pub_low("low", &msg);
+  ros::Publisher pub_normal("normal", &msg);
+  ros::Publisher pub_high("high", &msg);
+  std::vector<test_event_t> events;
+  std::vector<uint8_t> frame;
+  std::string text;
+  char name[16];
+  int  low;
+  int  normal;
+  int  high;
+  int  i;
+
+  host_set_micros(0);
+  nh.initNode();
+  CHECK(nh.advertise(pub_low) && nh.advertise(pub_normal) && nh.advertise(pub_high));
+  CHECK(nh.setTxPriority(pub_low, ros::TX_PRIORITY_LOW));
+  CHECK(nh.setTxPriority(pub_high, ros::TX_PRIORITY_HIGH));
+  low    = pub_low.id_;
+  normal = pub_normal.id_;
+  high   = pub_high.id_;
+  connect(nh);
+
+  // With room, a frame is written when it is published
+  hw->tx_room = 1000000;
+  CHECK(publish(pub_normal, "now") > 0);
+  CHECK(nh.getTxQueueFrames() == 0);
+  CHECK(written(hw) == events_of({ { normal, "now" } }));
+
+  // Higher priority first, the same priority in the order published
+  hw->tx_room = 0;
+  publish(pub_low, "l1");
+  publish(pub_normal, "n1");
+  publish(pub_high, "h1");
+  publish(pub_normal, "n2");
+  publish(pub_high, "h2");
+  publish(pub_low, "l2");
+  CHECK(nh.getTxQueueFrames() == 6);
+  CHECK(hw->tx.empty());
+
+  hw->tx_room = 1000000;
+  nh.flushTx();
+  CHECK(nh.getTxQueueFrames() == 0 && nh.getTxQueueLength() == 0);
+  CHECK(written(hw) == events_of({ { high, "h1" }, { high, "h2" }, { normal, "n1" },
+                                   { normal, "n2" }, { low, "l1" }, { low, "l2" } }));
+
+  // A latest only topic keeps its newest frame in place of the queued one,
+  // the frames of other topics stay
+  CHECK(nh.setTxPriority(pub_normal, ros::TX_PRIORITY_NORMAL, true));
+  hw->tx_room = 0;
+  publish(pub_normal, "n1");
+  publish(pub_low, "l1");
+  publish(pub_normal, "n2");
+  publish(pub_normal, "n3");
+  CHECK(nh.getTxQueueFrames() == 2);
+  CHECK(nh.getTxReplaceCount() == 2);
+
+  hw->tx_room = 1000000;
+  nh.flushTx();
+  CHECK(written(hw) == events_of({ { normal, "n3" }, { low, "l1" } }));
+  CHECK(nh.setTxPriority(pub_normal, ros::TX_PRIORITY_NORMAL, false));
+
+  // All slots taken: the oldest frame of the lowest priority goes, up to the
+  // priority of the new frame. A frame with nothing below it is dropped.
+  hw->tx_room = 0;
+  for (i = 0; i < ros::TX_QUEUE_FRAMES; i++)
+  {
+    snprintf(name, sizeof(name), "n%d", i);
+    CHECK(publish(pub_normal, name) > 0);
+  }
+  CHECK(nh.getTxQueueFrames() == ros::TX_QUEUE_FRAMES);
+  CHECK(nh.getTxDropCount() == 0);
+
+  CHECK(publish(pub_low, "l1") == -1);
+  CHECK(nh.getTxDropCount() == 1);
+  CHECK(publish(pub_normal, "n16") > 0);
+  CHECK(publish(pub_high, "h1") > 0);
+  CHECK(nh.getTxDropCount() == 3);
+  CHECK(nh.getTxQueueFrames() == ros::TX_QUEUE_FRAMES);
+
+  hw->tx_room = 1000000;
+  nh.flushTx();
+  events = written(hw);
+  CHECK(events.size() == (size_t)ros::TX_QUEUE_FRAMES);
+  CHECK(events.front().id == high && events.front().data == "h1");
+  for (i = 1; i < ros::TX_QUEUE_FRAMES; i++)
+  {
+    snprintf(name, sizeof(name), "n%d", i + 1);
+    CHECK(events[i].id == normal && events[i].data == name);
+  }
+
+  // The bytes of the queue are a limit too
+  hw->tx_room = 0;
+  text.assign(600, 'x');
+  for (i = 0; i < 4; i++)
+  {
+    CHECK(publish(pub_normal, text.c_str()) > 0);
+  }
+  CHECK(nh.getTxQueueFrames() == 3);
+  CHECK(nh.getTxDropCount() == 4);
+  CHECK(nh.getTxQueueLength() <= TEST_TX_QUEUE_SIZE);
+  CHECK(nh.getTxQueueMaxLength() <= TEST_TX_QUEUE_SIZE);
+  nh.clearTx();
+  CHECK(nh.getTxQueueFrames() == 0 && nh.getTxQueueLength() == 0);
+  hw->tx.clear();
+
+  // A port with room for part of the queue takes whole frames only, the
+  // next flush goes on with the frame that did not fit
+  for (i = 0; i < 5; i++)
+  {
+    snprintf(name, sizeof(name), "p%d", i);
+    publish(pub_normal, name);
+  }
+  msg.data = "p0";
+  frame = ros_host_frame(normal, msg);
+  hw->tx_room = frame.size() * 5 / 2;
+  hw->tx_overflow = 0;
+  nh.flushTx();
+  CHECK(nh.getTxQueueFrames() == 3);
+  CHECK(hw->tx_overflow == 0);
+  CHECK(written(hw) == events_of({ { normal, "p0" }, { normal, "p1" } }));
+
+  nh.flushTx();
+  CHECK(nh.getTxQueueFrames() == 3);
+  CHECK(hw->tx.empty());
+
+  hw->tx_room += 2 * frame.size();
+  nh.spinOnce();
+  CHECK(nh.getTxQueueFrames() == 1);
+  CHECK(written(hw) == events_of({ { normal, "p2" }, { normal, "p3" } }));
+
+  hw->tx_room = 1000000;
+  nh.flushTx();
+  CHECK(nh.getTxQueueFrames() == 0);
+  CHECK(written(hw) == events_of({ { normal, "p4" } }));
+  CHECK(hw->tx_overflow == 0);
+}
+
+
+int main( void )
+{
+  test_sync_drift();
+  test_sync_reject();
+  test_sync_drift_clamp();
+  test_chunked_input();
+  test_tx_queue();
+
+  return 0;
+}
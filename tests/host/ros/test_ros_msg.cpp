@@ -0,0 +1,288 @@
+/*
+  test_ros_msg.cpp - the word copies of ros/msg.h put the same bytes on the
+  wire as the byte copies and read back what they wrote, and prepared
+  messages put the same bytes on the wire as publishing the message
+*/
+
+#include <string.h>
+#include <math.h>
+#include "ros_msg_codec.h"
+#include "host_test.h"
+
+// Outside of the namespaces of the codecs
+#include "ros/msg.h"
+#include "ros/node_handle.h"
+#include "sensor_msgs/Imu.h"
+#include "nav_msgs/Odometry.h"
+#include "ros_host_hardware.h"
+
+
+#define TEST_SEEDS          20000
+#define TEST_PREPARED_SEEDS 2000
+#define TEST_FRAME_ID       "imu_link"
+#define TEST_ODOM_FRAME_ID  "odom"
+#define TEST_ODOM_CHILD_ID  "base_footprint"
+
+#define HEADER_STAMP_OFFSET 4    // as in turtlebot3_core_config.h
+
+
+typedef ros::NodeHandle_<RosHostHardware, 25, 25, 1024, 1024> TestNodeHandle;
+
+
+static void test_same_bytes( void )
+{
+  static unsigned char word_buffer[ROS_MSG_CODEC_BUFFER];
+  static unsigned char byte_buffer[ROS_MSG_CODEC_BUFFER];
+  static unsigned char input[ROS_MSG_CODEC_BUFFER];
+  static unsigned char again[ROS_MSG_CODEC_BUFFER];
+  uint32_t seed;
+  int      type;
+  int      length;
+
+  for (type = 0; type < ROS_MSG_TYPES; type++)
+  {
+    CHECK(strcmp(ros_msg_word.typeName(type), ros_msg_byte.typeName(type)) == 0);
+
+    for (seed = 1; seed <= TEST_SEEDS; seed++)
+    {
+      ros_msg_word.fill(type, seed);
+      ros_msg_byte.fill(type, seed);
+
+      length = ros_msg_word.serialize(type, word_buffer);
+      CHECK(length > 0 && length <= ROS_MSG_CODEC_BUFFER);
+      CHECK(ros_msg_byte.serialize(type, byte_buffer) == length);
+      CHECK(memcmp(word_buffer, byte_buffer, length) == 0);
+
+      // Each one reads what the other wrote. Strings are terminated in
+      // place, the input is a copy.
+      memcpy(input, byte_buffer, length);
+      CHECK(ros_msg_word.deserialize(type, input) == length);
+      CHECK(ros_msg_word.serializeDecoded(type, again) == length);
+      CHECK(memcmp(again, byte_buffer, length) == 0);
+
+      memcpy(input, word_buffer, length);
+      CHECK(ros_msg_byte.deserialize(type, input) == length);
+      CHECK(ros_msg_byte.serializeDecoded(type, again) == length);
+      CHECK(memcmp(again, word_buffer, length) == 0);
+    }
+  }
+}
+
+static void test_float64( void )
+{
+  static const float values[] = { 0.0f, -0.0f, 1.0f, -2.5f, 3.14159265f, 1e-30f, -1e30f, 65504.0f };
+  unsigned char buffer[8];
+  double   d;
+  float    f;
+  uint32_t i;
+
+  for (i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+  {
+    CHECK(ros::Msg::serializeAvrFloat64(buffer, values[i]) == 8);
+    memcpy(&d, buffer, 8);
+    CHECK(d == (double)values[i]);
+    CHECK(signbit(d) == signbit(values[i]));
+
+    CHECK(ros::Msg::deserializeAvrFloat64(buffer, &f) == 8);
+    CHECK(memcmp(&f, &values[i], 4) == 0);
+  }
+
+  // Infinities and NaN stay what they are
+  ros::Msg::serializeAvrFloat64(buffer, INFINITY);
+  memcpy(&d, buffer, 8);
+  CHECK(isinf(d) && d > 0);
+  ros::Msg::serializeAvrFloat64(buffer, NAN);
+  memcpy(&d, buffer, 8);
+  CHECK(isnan(d));
+
+  // Doubles out of the float range
+  d = 1e300;
+  memcpy(buffer, &d, 8);
+  ros::Msg::deserializeAvrFloat64(buffer, &f);
+  CHECK(isinf(f) && f > 0);
+  d = -1e-300;
+  memcpy(buffer, &d, 8);
+  ros::Msg::deserializeAvrFloat64(buffer, &f);
+  CHECK(f == 0.0f && signbit(f));
+}
+
+// headerLength() of turtlebot3_core.ino
+static int header_length( const char *frame_id )
+{
+  return 4 + 8 + 4 + strlen(frame_id);
+}
+
+static float value( uint32_t seed, int n )
+{
+  return (float)((seed * 7919u + n * 104729u) % 20001u) / 1000.0f - 10.0f;
+}
+
+static void connect( TestNodeHandle &nh )
+{
+  static const uint8_t request[] = { 0 };
+
+  nh.getHardware()->rx = ros_host_frame(rosserial_msgs::TopicInfo::ID_PUBLISHER, request, 0);
+  nh.getHardware()->rx_index = 0;
+  nh.spinOnce();
+  CHECK(nh.connected());
+  nh.getHardware()->tx.clear();
+}
+
+// The bytes publish() of the message sends
+static std::vector<uint8_t> published( TestNodeHandle &nh, ros::Publisher &pub, const ros::Msg &msg )
+{
+  std::vector<uint8_t> bytes;
+
+  nh.getHardware()->tx.clear();
+  CHECK(pub.publish(&msg) > 0);
+  bytes = nh.getHardware()->tx;
+  nh.getHardware()->tx.clear();
+  return bytes;
+}
+
+static std::vector<uint8_t> published( TestNodeHandle &nh, ros::Publisher &pub, ros::PreparedMsgBase_ &prepared )
+{
+  std::vector<uint8_t> bytes;
+
+  nh.getHardware()->tx.clear();
+  CHECK(pub.publish(prepared) > 0);
+  bytes = nh.getHardware()->tx;
+  nh.getHardware()->tx.clear();
+  return bytes;
+}
+
+static void test_prepared( void )
+{
+  static TestNodeHandle nh;
+  sensor_msgs::Imu   imu;
+  nav_msgs::Odometry odom;
+  ros::Publisher imu_pub("imu", &imu);
+  ros::Publisher odom_pub("odom", &odom);
+  ros::PreparedMsg<384> imu_prepared;
+  ros::PreparedMsg<800> odom_prepared;
+  geometry_msgs::Vector3 vector;
+  std_msgs::Header header;
+  std::vector<uint8_t> expected;
+  std::vector<uint8_t> frame;
+  uint8_t  checksum;
+  uint32_t seed;
+  uint32_t checksum_changes = 0;
+  int offset_orientation;
+  int offset_angular_velocity;
+  int offset_linear_acceleration;
+  int offset_pose;
+  int offset_twist;
+  int length;
+  int i;
+
+  nh.initNode();
+  nh.advertise(imu_pub);
+  nh.advertise(odom_pub);
+  connect(nh);
+
+  imu.header.frame_id   = TEST_FRAME_ID;
+  odom.header.frame_id  = TEST_ODOM_FRAME_ID;
+  odom.child_frame_id   = TEST_ODOM_CHILD_ID;
+  for (i = 0; i < 9; i++)
+  {
+    imu.orientation_covariance[i]         = 0.0025 * i;
+    imu.angular_velocity_covariance[i]    = 0.02 * i;
+    imu.linear_acceleration_covariance[i] = 0.04 * i;
+  }
+  for (i = 0; i < 36; i++)
+  {
+    odom.pose.covariance[i]  = 0.001 * i;
+    odom.twist.covariance[i] = 0.002 * i;
+  }
+
+  CHECK(imu_pub.prepare(imu_prepared, &imu));
+  CHECK(odom_pub.prepare(odom_prepared, &odom));
+  CHECK(published(nh, imu_pub, imu_prepared) == published(nh, imu_pub, imu));
+  CHECK(published(nh, odom_pub, odom_prepared) == published(nh, odom_pub, odom));
+
+  // The offsets turtlebot3_core.ino writes at
+  offset_orientation         = header_length(TEST_FRAME_ID);
+  offset_angular_velocity    = offset_orientation + 32 + 72;
+  offset_linear_acceleration = offset_angular_velocity + 24 + 72;
+  offset_pose                = header_length(TEST_ODOM_FRAME_ID) + 4 + strlen(TEST_ODOM_CHILD_ID);
+  offset_twist               = offset_pose + 56 + 288;
+
+  for (seed = 1; seed <= TEST_PREPARED_SEEDS; seed++)
+  {
+    imu.header.stamp.sec  = seed * 13;
+    imu.header.stamp.nsec = (seed * 7919u) % 1000000000u;
+    imu.orientation.w = value(seed, 0);
+    imu.orientation.x = value(seed, 1);
+    imu.orientation.y = value(seed, 2);
+    imu.orientation.z = value(seed, 3);
+    imu.angular_velocity.x    = value(seed, 4);
+    imu.angular_velocity.y    = value(seed, 5);
+    imu.angular_velocity.z    = value(seed, 6);
+    imu.linear_acceleration.x = value(seed, 7);
+    imu.linear_acceleration.y = value(seed, 8);
+    imu.linear_acceleration.z = value(seed, 9);
+
+    checksum = imu_prepared.getFrame()[imu_prepared.getLength() - 1];
+    CHECK(imu_prepared.setTime(HEADER_STAMP_OFFSET, imu.header.stamp));
+    CHECK(imu_prepared.setMsg(offset_orientation, imu.orientation));
+    CHECK(imu_prepared.setMsg(offset_angular_velocity, imu.angular_velocity));
+    CHECK(imu_prepared.setMsg(offset_linear_acceleration, imu.linear_acceleration));
+
+    // The whole frame, the checksum byte at its end included
+    expected = published(nh, imu_pub, imu);
+    frame    = published(nh, imu_pub, imu_prepared);
+    CHECK(frame == expected);
+    CHECK(ros_host_frames(frame).size() == 1);
+    if (frame.back() != checksum)
+    {
+      checksum_changes++;
+    }
+
+    odom.header.stamp = imu.header.stamp;
+    odom.pose.pose.position.x    = value(seed, 10);
+    odom.pose.pose.position.y    = value(seed, 11);
+    odom.pose.pose.orientation.w = value(seed, 12);
+    odom.pose.pose.orientation.z = value(seed, 13);
+    odom.twist.twist.linear.x    = value(seed, 14);
+    odom.twist.twist.angular.z   = value(seed, 15);
+
+    CHECK(odom_prepared.setTime(HEADER_STAMP_OFFSET, odom.header.stamp));
+    CHECK(odom_prepared.setMsg(offset_pose, odom.pose.pose));
+    CHECK(odom_prepared.setMsg(offset_twist, odom.twist.twist));
+    CHECK(published(nh, odom_pub, odom_prepared) == published(nh, odom_pub, odom));
+  }
+  // The checksum byte is written again, not left from the first frame
+  CHECK(checksum_changes > TEST_PREPARED_SEEDS * 9 / 10);
+
+  // Writes that do not fit leave the frame as it is
+  length   = imu_prepared.getLength() - ros::PREPARED_FRAME_HEADER_SIZE - 1;
+  expected = std::vector<uint8_t>(imu_prepared.getFrame(), imu_prepared.getFrame() + imu_prepared.getLength());
+  vector.x = 1.0;
+  vector.y = 2.0;
+  vector.z = 3.0;
+
+  CHECK(imu_prepared.setMsg(-1, vector) == false);
+  CHECK(imu_prepared.setMsg(length - 23, vector) == false);
+  CHECK(imu_prepared.setMsg(length, vector) == false);
+  CHECK(imu_prepared.setMsg(0x7FFFFFF0, vector) == false);
+  CHECK(imu_prepared.setTime(length - 7, imu.header.stamp) == false);
+  CHECK(imu_prepared.setMsg(0, header) == false);
+  CHECK(imu_prepared.setMsg(0, imu) == false);
+  CHECK(std::vector<uint8_t>(imu_prepared.getFrame(), imu_prepared.getFrame() + imu_prepared.getLength()) == expected);
+
+  // The last 24 bytes before the checksum are the covariance of the
+  // acceleration, the frame is still one the host reads
+  CHECK(imu_prepared.setMsg(length - 24, vector));
+  frame = published(nh, imu_pub, imu_prepared);
+  CHECK(ros_host_frames(frame).size() == 1);
+  CHECK(frame != expected);
+}
+
+int main( void )
+{
+  test_same_bytes();
+  test_float64();
+  test_prepared();
+
+  return 0;
+}
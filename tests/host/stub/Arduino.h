@@ -0,0 +1,61 @@
+/*
+  Arduino.h - the part of the OpenCR core the host tests build against
+
+  Time, pins and interrupts do nothing unless a test drives them through
+  host_stub.h, USBSerial keeps what is written for the test to read back.
+*/
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+
+#define UNUSED(x)         (void)(x)
+
+#define HIGH              1
+#define LOW               0
+#define INPUT             0
+#define OUTPUT            1
+#define RISING            3
+#define FALLING           2
+#define MSBFIRST          1
+#define ENABLE            1
+
+#define PI                3.1415926535897932384626433832795
+#define DEG_TO_RAD        0.017453292519943295769236907684886
+#define RAD_TO_DEG        57.295779513082320876798154814105
+
+#define BDPIN_SPI_CS_IMU  1
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+
+void     pinMode( int pin, int mode );
+void     digitalWrite( int pin, int value );
+void     attachInterrupt( uint32_t num, void (*handler)(void), uint32_t mode );
+
+void     delay( uint32_t ms );
+void     delay_ms( uint32_t ms );
+uint32_t millis( void );
+uint32_t micros( void );
+
+
+class USBSerial
+{
+  public:
+    int    availableForWrite( void );
+    size_t write( uint8_t c );
+    size_t write( const uint8_t *buffer, size_t size );
+
+    // Host side: everything written so far and the room the next write finds
+    std::vector<uint8_t> tx;
+    int                  tx_room = 1024;
+};
+
+#endif /* _HOST_ARDUINO_H_ */
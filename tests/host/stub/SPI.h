@@ -0,0 +1,35 @@
+/*
+  SPI.h - a sensor bus that reads 0, no IMU answers on the host
+*/
+
+#ifndef _HOST_SPI_H_
+#define _HOST_SPI_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+#define SPI_MODE0         0
+#define SPI_MODE3         3
+#define SPI_CLOCK_DIV4    0
+#define SPI_CLOCK_DIV8    5
+#define SPI_CLOCK_DIV128  3
+
+
+class SPIClass
+{
+  public:
+    void    begin( void );
+    void    setDataMode( int mode );
+    void    setBitOrder( int order );
+    void    setClockDivider( int div );
+
+    uint8_t transfer( uint8_t data );
+    void    transfer( void *buf, size_t count );
+    void    transfer( const void *tx_buf, void *rx_buf, size_t count );
+    void    write( uint8_t data );
+};
+
+extern SPIClass SPI_IMU;
+
+#endif /* _HOST_SPI_H_ */
@@ -0,0 +1,15 @@
+/*
+  drv_eeprom.h - the emulated EEPROM of OpenCR kept in RAM
+*/
+
+#ifndef _HOST_DRV_EEPROM_H_
+#define _HOST_DRV_EEPROM_H_
+
+#include <stdint.h>
+
+
+uint8_t  drv_eeprom_read_byte( int addr );
+void     drv_eeprom_write_byte( int index, uint8_t data_in );
+uint16_t drv_eeprom_get_length( void );
+
+#endif /* _HOST_DRV_EEPROM_H_ */
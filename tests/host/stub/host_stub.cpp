@@ -0,0 +1,114 @@
+/*
+  host_stub.cpp - fake board behind the stubbed core headers
+*/
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "drv_eeprom.h"
+#include "host_stub.h"
+
+
+static uint32_t host_us = 0;
+
+static uint8_t  eeprom[HOST_EEPROM_LENGTH];
+static uint16_t eeprom_length = HOST_EEPROM_LENGTH;
+static uint32_t eeprom_writes = 0;
+static bool     eeprom_erased = false;
+
+
+void host_set_micros( uint32_t us )
+{
+  host_us = us;
+}
+
+void host_eeprom_erase( void )
+{
+  memset(eeprom, 0xFF, sizeof(eeprom));
+  eeprom_length = HOST_EEPROM_LENGTH;
+  eeprom_writes = 0;
+  eeprom_erased = true;
+}
+
+void host_eeprom_set_length( uint16_t length )
+{
+  eeprom_length = length;
+}
+
+uint32_t host_eeprom_write_count( void )
+{
+  return eeprom_writes;
+}
+
+
+
+void pinMode( int pin, int mode )                                       { UNUSED(pin); UNUSED(mode); }
+void digitalWrite( int pin, int value )                                 { UNUSED(pin); UNUSED(value); }
+void attachInterrupt( uint32_t num, void (*handler)(void), uint32_t mode ) { UNUSED(num); UNUSED(handler); UNUSED(mode); }
+
+void delay( uint32_t ms )    { host_us += ms * 1000; }
+void delay_ms( uint32_t ms ) { host_us += ms * 1000; }
+
+uint32_t millis( void ) { return host_us / 1000; }
+uint32_t micros( void ) { return host_us; }
+
+
+
+int USBSerial::availableForWrite( void )
+{
+  return tx_room;
+}
+
+size_t USBSerial::write( uint8_t c )
+{
+  return write(&c, 1);
+}
+
+size_t USBSerial::write( const uint8_t *buffer, size_t size )
+{
+  if ((int)size > tx_room)
+  {
+    size = tx_room;
+  }
+  tx.insert(tx.end(), buffer, buffer + size);
+
+  return size;
+}
+
+
+
+SPIClass SPI_IMU;
+
+void    SPIClass::begin( void )                                         { }
+void    SPIClass::setDataMode( int mode )                               { UNUSED(mode); }
+void    SPIClass::setBitOrder( int order )                              { UNUSED(order); }
+void    SPIClass::setClockDivider( int div )                            { UNUSED(div); }
+uint8_t SPIClass::transfer( uint8_t data )                              { UNUSED(data); return 0; }
+void    SPIClass::transfer( void *buf, size_t count )                   { memset(buf, 0, count); }
+void    SPIClass::transfer( const void *tx_buf, void *rx_buf, size_t count ) { UNUSED(tx_buf); memset(rx_buf, 0, count); }
+void    SPIClass::write( uint8_t data )                                 { UNUSED(data); }
+
+
+
+uint8_t drv_eeprom_read_byte( int addr )
+{
+  if (eeprom_erased == false)
+  {
+    host_eeprom_erase();
+  }
+  return eeprom[addr % HOST_EEPROM_LENGTH];
+}
+
+void drv_eeprom_write_byte( int index, uint8_t data_in )
+{
+  if (eeprom_erased == false)
+  {
+    host_eeprom_erase();
+  }
+  eeprom[index % HOST_EEPROM_LENGTH] = data_in;
+  eeprom_writes++;
+}
+
+uint16_t drv_eeprom_get_length( void )
+{
+  return eeprom_length;
+}
@@ -0,0 +1,23 @@
+/*
+  host_stub.h - what the tests drive of the stubbed board
+*/
+
+#ifndef _HOST_STUB_H_
+#define _HOST_STUB_H_
+
+#include <stdint.h>
+
+
+#define HOST_EEPROM_LENGTH  4096    // as the OpenCR flash emulation
+
+
+void     host_set_micros( uint32_t us );
+
+// Erased (0xFF) like a new board, writes are counted
+void     host_eeprom_erase( void );
+uint32_t host_eeprom_write_count( void );
+
+// Length drv_eeprom_get_length() reports until the next erase
+void     host_eeprom_set_length( uint16_t length );
+
+#endif /* _HOST_STUB_H_ */
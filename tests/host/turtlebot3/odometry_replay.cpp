@@ -0,0 +1,114 @@
+/*
+  odometry_replay.cpp - runs a tick and IMU log through Turtlebot3Odometry
+
+    odometry_replay [-f wheel|imu|complementary|ekf] [-v] <log>   prints the pose
+    odometry_replay --synth <log>                               writes a log of a known path
+
+  With the true pose in the log it prints how far the odometry was from it.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "odometry_synth.h"
+
+
+static int usage( void )
+{
+  fprintf(stderr, "usage: odometry_replay [-f wheel|imu|complementary|ekf] [-v] <log>\n"
+                  "       odometry_replay --synth <log>\n");
+  return 2;
+}
+
+static int write_synth( const char *path )
+{
+  std::vector<odometry_sample_t> samples;
+  odometry_synth_t cfg;
+  FILE *fp;
+  bool  result;
+
+  odometry_synth_default(&cfg);
+  odometry_synth(&cfg, &samples);
+
+  fp = fopen(path, "w");
+  if (fp == NULL)
+  {
+    perror(path);
+    return 1;
+  }
+  result = odometry_log_write(fp, samples);
+  fclose(fp);
+
+  return result == true ? 0 : 1;
+}
+
+int main( int argc, char **argv )
+{
+  std::vector<odometry_sample_t> samples;
+  odometry_result_t result;
+  OdometryFusion fusion  = ODOMETRY_FUSION_IMU_YAW;
+  bool           verbose = false;
+  const char *path = NULL;
+  FILE *fp;
+  bool  read;
+  int   i;
+
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--synth") == 0 && i + 1 < argc)
+    {
+      return write_synth(argv[i + 1]);
+    }
+    else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+    {
+      i++;
+      if      (strcmp(argv[i], "wheel") == 0)         fusion = ODOMETRY_FUSION_WHEEL;
+      else if (strcmp(argv[i], "imu") == 0)           fusion = ODOMETRY_FUSION_IMU_YAW;
+      else if (strcmp(argv[i], "complementary") == 0) fusion = ODOMETRY_FUSION_COMPLEMENTARY;
+      else if (strcmp(argv[i], "ekf") == 0)           fusion = ODOMETRY_FUSION_EKF;
+      else return usage();
+    }
+    else if (strcmp(argv[i], "-v") == 0)
+    {
+      verbose = true;
+    }
+    else if (path == NULL)
+    {
+      path = argv[i];
+    }
+    else
+    {
+      return usage();
+    }
+  }
+  if (path == NULL)
+  {
+    return usage();
+  }
+
+  fp = fopen(path, "r");
+  if (fp == NULL)
+  {
+    perror(path);
+    return 1;
+  }
+  read = odometry_log_read(fp, &samples);
+  fclose(fp);
+  if (read == false)
+  {
+    fprintf(stderr, "%s: not a tick and IMU log\n", path);
+    return 1;
+  }
+
+  odometry_replay(samples, fusion, &result, NULL, verbose == true ? stdout : NULL);
+
+  printf("samples %u x %.4f y %.4f theta %.4f gyro_bias %.4f",
+         (unsigned)result.samples, result.pose.x, result.pose.y, result.pose.theta, result.gyro_bias);
+  if (samples.empty() == false && samples.back().has_truth == true)
+  {
+    printf(" error %.6f max_error %.6f", result.final_error, result.max_error);
+  }
+  printf("\n");
+
+  return result.samples > 0 ? 0 : 1;
+}
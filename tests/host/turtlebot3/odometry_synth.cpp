@@ -0,0 +1,219 @@
+/*
+  odometry_synth.cpp - tick and IMU logs of a known path of the TurtleBot3
+*/
+
+#include <math.h>
+#include <string.h>
+#include "odometry_synth.h"
+
+
+typedef struct
+{
+  double linear;            // m/s
+  double angular;           // rad/s
+  double seconds;
+} odometry_synth_arc_t;
+
+static const odometry_synth_arc_t synth_path[] =
+{
+  { 0.10,  0.0, 10.0 },
+  { 0.10,  0.5, 12.0 },
+  { 0.05, -0.8,  8.0 },
+  { 0.15,  0.0, 10.0 },
+  { 0.0,   1.0,  6.0 },
+  {-0.08,  0.3, 14.0 },
+};
+
+static uint32_t synth_seed;
+
+
+// Uniform in [-1, 1)
+static float synth_random( void )
+{
+  synth_seed = synth_seed * 1664525u + 1013904223u;
+  return 2.0f * (float)(synth_seed >> 8) / (float)(1u << 24) - 1.0f;
+}
+
+static double synth_normalize( double angle )
+{
+  return atan2(sin(angle), cos(angle));
+}
+
+void odometry_synth_default( odometry_synth_t *p_cfg )
+{
+  memset(p_cfg, 0, sizeof(odometry_synth_t));
+
+  p_cfg->period_us     = 5000;                      // 200 Hz
+  p_cfg->stamp_start   = 0xFFFFFFFFu - 10000000u;   // micros() wraps after 10 s
+  p_cfg->tick_start[ODOMETRY_WHEEL_LEFT]  = INT32_MAX - 1000;
+  p_cfg->tick_start[ODOMETRY_WHEEL_RIGHT] = INT32_MAX - 5000;
+  p_cfg->gyro_bias     = 0.01f;
+  p_cfg->gyro_noise    = 0.005f;
+  p_cfg->seed          = 1;
+}
+
+void odometry_synth( const odometry_synth_t *p_cfg, std::vector<odometry_sample_t> *p_samples )
+{
+  odometry_sample_t sample;
+  double   dt = p_cfg->period_us * 1e-6;
+  double   wheel[ODOMETRY_WHEEL_NUM] = { 0.0, 0.0 };
+  double   rate[ODOMETRY_WHEEL_NUM];
+  double   half;
+  double   chord;
+  uint32_t stamp = p_cfg->stamp_start;
+  uint32_t steps;
+  uint32_t arc;
+  uint32_t n;
+  int      i;
+
+  synth_seed = p_cfg->seed;
+  p_samples->clear();
+
+  memset(&sample, 0, sizeof(sample));
+  sample.has_truth = true;
+
+  for (arc = 0; arc <= sizeof(synth_path) / sizeof(synth_path[0]); arc++)
+  {
+    // The first sample only sets the start
+    steps = 1;
+    rate[ODOMETRY_WHEEL_LEFT]  = 0.0;
+    rate[ODOMETRY_WHEEL_RIGHT] = 0.0;
+    if (arc > 0)
+    {
+      const odometry_synth_arc_t &path = synth_path[arc - 1];
+
+      steps = (uint32_t)(path.seconds / dt + 0.5);
+      rate[ODOMETRY_WHEEL_LEFT]  = (path.linear - path.angular * ODOMETRY_SYNTH_WHEEL_SEPARATION / 2.0) / ODOMETRY_SYNTH_WHEEL_RADIUS;
+      rate[ODOMETRY_WHEEL_RIGHT] = (path.linear + path.angular * ODOMETRY_SYNTH_WHEEL_SEPARATION / 2.0) / ODOMETRY_SYNTH_WHEEL_RADIUS;
+    }
+
+    for (n = 0; n < steps; n++)
+    {
+      if (arc > 0)
+      {
+        const odometry_synth_arc_t &path = synth_path[arc - 1];
+
+        // Exact arc of one tick
+        half  = path.angular * dt / 2.0;
+        chord = path.linear * dt * (half == 0.0 ? 1.0 : sin(half) / half);
+        sample.x     += chord * cos(sample.theta + half);
+        sample.y     += chord * sin(sample.theta + half);
+        sample.theta  = synth_normalize(sample.theta + path.angular * dt);
+
+        stamp += p_cfg->period_us;
+      }
+
+      for (i = 0; i < ODOMETRY_WHEEL_NUM; i++)
+      {
+        wheel[i] += rate[i] * dt;
+        sample.tick[i] = (int32_t)((uint32_t)p_cfg->tick_start[i] + (uint32_t)(int32_t)floor(wheel[i] / ODOMETRY_SYNTH_TICK_TO_RAD));
+      }
+
+      sample.stamp   = stamp;
+      sample.gyro_z  = (arc > 0 ? (float)synth_path[arc - 1].angular : 0.0f) + p_cfg->gyro_bias + p_cfg->gyro_noise * synth_random();
+      sample.imu_yaw = (float)sample.theta;
+
+      p_samples->push_back(sample);
+    }
+  }
+}
+
+bool odometry_log_write( FILE *fp, const std::vector<odometry_sample_t> &samples )
+{
+  size_t n;
+
+  fprintf(fp, "# stamp_us left_tick right_tick gyro_z imu_yaw x y theta\n");
+  for (n = 0; n < samples.size(); n++)
+  {
+    const odometry_sample_t &s = samples[n];
+
+    fprintf(fp, "%u %d %d %.9g %.9g", (unsigned)s.stamp, (int)s.tick[ODOMETRY_WHEEL_LEFT], (int)s.tick[ODOMETRY_WHEEL_RIGHT],
+            s.gyro_z, s.imu_yaw);
+    if (s.has_truth == true)
+    {
+      fprintf(fp, " %.17g %.17g %.17g", s.x, s.y, s.theta);
+    }
+    fprintf(fp, "\n");
+  }
+
+  return ferror(fp) == 0;
+}
+
+bool odometry_log_read( FILE *fp, std::vector<odometry_sample_t> *p_samples )
+{
+  odometry_sample_t sample;
+  char     line[256];
+  unsigned stamp;
+  int      left;
+  int      right;
+  int      fields;
+
+  p_samples->clear();
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+  {
+    if (line[0] == '#' || line[0] == '\n')
+    {
+      continue;
+    }
+
+    fields = sscanf(line, "%u %d %d %f %f %lf %lf %lf", &stamp, &left, &right,
+                    &sample.gyro_z, &sample.imu_yaw, &sample.x, &sample.y, &sample.theta);
+    if (fields != 5 && fields != 8)
+    {
+      return false;
+    }
+    sample.stamp = stamp;
+    sample.tick[ODOMETRY_WHEEL_LEFT]  = left;
+    sample.tick[ODOMETRY_WHEEL_RIGHT] = right;
+    sample.has_truth = (fields == 8);
+
+    p_samples->push_back(sample);
+  }
+
+  return ferror(fp) == 0;
+}
+
+void odometry_replay( const std::vector<odometry_sample_t> &samples, OdometryFusion fusion,
+                      odometry_result_t *p_result, Turtlebot3Odometry *p_odometry, FILE *trace )
+{
+  Turtlebot3Odometry odometry;
+  double error;
+  size_t n;
+
+  if (p_odometry == NULL)
+  {
+    p_odometry = &odometry;
+  }
+  p_odometry->init(ODOMETRY_SYNTH_WHEEL_RADIUS, ODOMETRY_SYNTH_WHEEL_SEPARATION, ODOMETRY_SYNTH_TICK_TO_RAD);
+  p_odometry->setFusion(fusion);
+
+  memset(p_result, 0, sizeof(odometry_result_t));
+
+  for (n = 0; n < samples.size(); n++)
+  {
+    const odometry_sample_t &s = samples[n];
+
+    p_odometry->update(s.tick[ODOMETRY_WHEEL_LEFT], s.tick[ODOMETRY_WHEEL_RIGHT], s.gyro_z, s.imu_yaw, s.stamp);
+    p_result->pose = p_odometry->getPose();
+    p_result->samples++;
+
+    if (trace != NULL)
+    {
+      fprintf(trace, "%10u %9.4f %9.4f %9.4f\n", (unsigned)p_result->pose.stamp,
+              p_result->pose.x, p_result->pose.y, p_result->pose.theta);
+    }
+
+    if (s.has_truth == true)
+    {
+      error = hypot(p_result->pose.x - s.x, p_result->pose.y - s.y);
+      p_result->final_error = error;
+      if (error > p_result->max_error)
+      {
+        p_result->max_error = error;
+      }
+    }
+  }
+
+  p_result->gyro_bias = p_odometry->getGyroBias();
+}
@@ -0,0 +1,77 @@
+/*
+  odometry_synth.h - tick and IMU logs of a known path of the TurtleBot3
+
+  The path is made of arcs of constant speed, so the pose of every control
+  tick is known exactly. The log holds what the firmware would have read:
+  encoder ticks that start near the int32_t wrap, gyro z rate plus bias and
+  noise, and the yaw of the IMU.
+
+  As text, a line per control tick:
+
+    stamp_us left_tick right_tick gyro_z imu_yaw [x y theta]
+
+  The true pose is optional, a recorded log has none. Lines starting with
+  '#' are comments.
+*/
+
+#ifndef _ODOMETRY_SYNTH_H_
+#define _ODOMETRY_SYNTH_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include "turtlebot3/turtlebot3_odometry.h"
+
+
+// TurtleBot3 Burger
+#define ODOMETRY_SYNTH_WHEEL_RADIUS      0.033
+#define ODOMETRY_SYNTH_WHEEL_SEPARATION  0.160
+#define ODOMETRY_SYNTH_TICK_TO_RAD       0.001533981
+
+
+typedef struct
+{
+  uint32_t period_us;
+  uint32_t stamp_start;     // us
+  int32_t  tick_start[ODOMETRY_WHEEL_NUM];
+  float    gyro_bias;       // rad/s
+  float    gyro_noise;      // rad/s, uniform noise of +/- this much
+  uint32_t seed;
+} odometry_synth_t;
+
+typedef struct
+{
+  uint32_t stamp;
+  int32_t  tick[ODOMETRY_WHEEL_NUM];
+  float    gyro_z;
+  float    imu_yaw;
+  bool     has_truth;
+  double   x;
+  double   y;
+  double   theta;
+} odometry_sample_t;
+
+typedef struct
+{
+  OdometryPose pose;        // at the last sample
+  float    gyro_bias;
+  double   final_error;     // m, distance to the true pose at the last sample
+  double   max_error;       // m, largest distance on the way
+  uint32_t samples;
+} odometry_result_t;
+
+
+void odometry_synth_default( odometry_synth_t *p_cfg );
+
+// A minute of driving: straight, turns both ways, on the spot and backwards
+void odometry_synth( const odometry_synth_t *p_cfg, std::vector<odometry_sample_t> *p_samples );
+
+bool odometry_log_write( FILE *fp, const std::vector<odometry_sample_t> &samples );
+bool odometry_log_read( FILE *fp, std::vector<odometry_sample_t> *p_samples );
+
+// Runs the samples through a Turtlebot3Odometry set to fusion, the errors
+// are 0 when the log has no true pose. A trace gets the pose of every tick.
+void odometry_replay( const std::vector<odometry_sample_t> &samples, OdometryFusion fusion,
+                      odometry_result_t *p_result, Turtlebot3Odometry *p_odometry = NULL, FILE *trace = NULL );
+
+#endif /* _ODOMETRY_SYNTH_H_ */
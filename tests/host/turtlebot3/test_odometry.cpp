@@ -0,0 +1,187 @@
+/*
+  test_odometry.cpp - Turtlebot3Odometry follows a known path with ticks
+  that wrap around, and holds the poses for the publishers
+*/
+
+#include <stdio.h>
+#include <vector>
+#include "odometry_synth.h"
+#include "host_test.h"
+
+
+#define TEST_DRIFT        0.0001    // m, wheel and IMU yaw heading
+#define TEST_EKF_DRIFT    0.005     // m
+#define TEST_BIAS_ERROR   0.001     // rad/s
+
+
+static void test_drift( void )
+{
+  std::vector<odometry_sample_t> samples;
+  odometry_synth_t  cfg;
+  odometry_result_t result;
+  odometry_result_t ekf;
+
+  odometry_synth_default(&cfg);
+  odometry_synth(&cfg, &samples);
+
+  // The ticks cross INT32_MAX in the first second
+  CHECK(samples.front().tick[ODOMETRY_WHEEL_LEFT] > 0);
+  CHECK(samples[200].tick[ODOMETRY_WHEEL_LEFT] < 0);
+  CHECK(samples.back().stamp < samples.front().stamp);
+
+  odometry_replay(samples, ODOMETRY_FUSION_WHEEL, &result);
+  CHECK(result.samples == samples.size());
+  CHECK(result.max_error < TEST_DRIFT);
+  CHECK(result.gyro_bias == 0.0f);
+
+  odometry_replay(samples, ODOMETRY_FUSION_IMU_YAW, &result);
+  CHECK(result.max_error < TEST_DRIFT);
+  CHECK_NEAR(result.pose.theta, samples.back().theta, 1e-4);
+
+  // The filter learns the bias of the gyro from the wheels
+  odometry_replay(samples, ODOMETRY_FUSION_EKF, &ekf);
+  CHECK(ekf.max_error < TEST_EKF_DRIFT);
+  CHECK_NEAR(ekf.gyro_bias, cfg.gyro_bias, TEST_BIAS_ERROR);
+
+  // The blend does not, its heading drifts with the bias
+  odometry_replay(samples, ODOMETRY_FUSION_COMPLEMENTARY, &result);
+  CHECK(result.final_error > 10.0 * ekf.final_error);
+
+  // Without a bias it is as good as the wheels
+  cfg.gyro_bias  = 0.0f;
+  cfg.gyro_noise = 0.0f;
+  odometry_synth(&cfg, &samples);
+  odometry_replay(samples, ODOMETRY_FUSION_COMPLEMENTARY, &result);
+  CHECK(result.max_error < TEST_DRIFT);
+}
+
+static void test_wheel_state( void )
+{
+  std::vector<odometry_sample_t> samples;
+  Turtlebot3Odometry odometry;
+  odometry_synth_t   cfg;
+  odometry_result_t  result;
+  float    angle[ODOMETRY_WHEEL_NUM];
+  float    velocity[ODOMETRY_WHEEL_NUM];
+  uint32_t ticks;
+  int      i;
+
+  odometry_synth_default(&cfg);
+  odometry_synth(&cfg, &samples);
+  odometry_replay(samples, ODOMETRY_FUSION_WHEEL, &result, &odometry);
+  odometry.getWheelState(angle, velocity);
+
+  // Angles from the start, across the wrap. They are summed in float, over
+  // a hundred radians that loses some thousandths.
+  for (i = 0; i < ODOMETRY_WHEEL_NUM; i++)
+  {
+    ticks = (uint32_t)samples.back().tick[i] - (uint32_t)samples.front().tick[i];
+    CHECK_NEAR(angle[i], (int32_t)ticks * ODOMETRY_SYNTH_TICK_TO_RAD, 1e-2);
+  }
+
+  // The last arc drives backwards and turns left
+  CHECK(velocity[ODOMETRY_WHEEL_LEFT] < 0.0f);
+  CHECK(velocity[ODOMETRY_WHEEL_RIGHT] < 0.0f);
+  CHECK_NEAR(result.pose.linear_velocity, -0.08, 0.01);
+  CHECK_NEAR(result.pose.angular_velocity, 0.3, 0.05);
+}
+
+static void test_history( void )
+{
+  std::vector<odometry_sample_t> samples;
+  Turtlebot3Odometry odometry;
+  odometry_synth_t   cfg;
+  odometry_result_t  result;
+  OdometryPose pose;
+  OdometryPose older;
+  OdometryPose newer;
+  size_t last;
+
+  CHECK(odometry.getPose(0, &pose) == false);
+
+  odometry_synth_default(&cfg);
+  odometry_synth(&cfg, &samples);
+  odometry_replay(samples, ODOMETRY_FUSION_WHEEL, &result, &odometry);
+  last = samples.size() - 1;
+
+  // Later stamps get the latest pose
+  CHECK(odometry.getPose(samples[last].stamp + 1000, &pose) == true);
+  CHECK(pose.stamp == samples[last].stamp);
+  CHECK(pose.x == result.pose.x && pose.y == result.pose.y);
+
+  // Between two ticks
+  CHECK(odometry.getPose(samples[last - 11].stamp, &older) == true);
+  CHECK(odometry.getPose(samples[last - 10].stamp, &newer) == true);
+  CHECK(older.stamp == samples[last - 11].stamp);
+  CHECK(odometry.getPose(samples[last - 11].stamp + cfg.period_us / 4, &pose) == true);
+  CHECK(pose.stamp == samples[last - 11].stamp + cfg.period_us / 4);
+  CHECK_NEAR(pose.x, older.x + 0.25 * (newer.x - older.x), 1e-6);
+  CHECK_NEAR(pose.y, older.y + 0.25 * (newer.y - older.y), 1e-6);
+  CHECK_NEAR(pose.theta, older.theta + 0.25 * (newer.theta - older.theta), 1e-6);
+  CHECK_NEAR(pose.x, samples[last - 11].x, 1e-4);
+
+  // The ring holds ODOMETRY_HISTORY_SIZE ticks
+  CHECK(odometry.getPose(samples[last - (ODOMETRY_HISTORY_SIZE - 1)].stamp, &pose) == true);
+  CHECK(odometry.getPose(samples[last - (ODOMETRY_HISTORY_SIZE - 1)].stamp - 1, &pose) == false);
+
+  // Across the wrap of micros()
+  odometry.reset();
+  odometry.update(0, 0, 0.0f, 0.0f, 0xFFFFFFFFu - 999u);
+  odometry.update(100, 100, 0.0f, 0.0f, 1000u);
+  CHECK(odometry.getPose(0u, &pose) == true);
+  CHECK(pose.stamp == 0u);
+  CHECK_NEAR(pose.x, 0.5 * 100 * ODOMETRY_SYNTH_TICK_TO_RAD * ODOMETRY_SYNTH_WHEEL_RADIUS, 1e-6);
+}
+
+static void test_log( void )
+{
+  std::vector<odometry_sample_t> samples;
+  std::vector<odometry_sample_t> read;
+  odometry_synth_t  cfg;
+  odometry_result_t result;
+  odometry_result_t again;
+  FILE *fp;
+
+  odometry_synth_default(&cfg);
+  odometry_synth(&cfg, &samples);
+
+  // The replay of the text log is the replay of the samples
+  fp = tmpfile();
+  CHECK(fp != NULL);
+  CHECK(odometry_log_write(fp, samples));
+  rewind(fp);
+  CHECK(odometry_log_read(fp, &read));
+  fclose(fp);
+
+  CHECK(read.size() == samples.size());
+  odometry_replay(samples, ODOMETRY_FUSION_EKF, &result);
+  odometry_replay(read, ODOMETRY_FUSION_EKF, &again);
+  CHECK(again.pose.x == result.pose.x && again.pose.y == result.pose.y && again.pose.theta == result.pose.theta);
+  CHECK_NEAR(again.max_error, result.max_error, 1e-9);
+
+  // A recorded log has no true pose
+  fp = tmpfile();
+  CHECK(fp != NULL);
+  fputs("# recorded\n1000 10 20 0.5 0.1\n6000 30 40 0.5 0.1\n", fp);
+  rewind(fp);
+  CHECK(odometry_log_read(fp, &read));
+  fclose(fp);
+  CHECK(read.size() == 2 && read[1].tick[ODOMETRY_WHEEL_RIGHT] == 40 && read[1].has_truth == false);
+
+  fp = tmpfile();
+  CHECK(fp != NULL);
+  fputs("1000 10\n", fp);
+  rewind(fp);
+  CHECK(odometry_log_read(fp, &read) == false);
+  fclose(fp);
+}
+
+int main( void )
+{
+  test_drift();
+  test_wheel_state();
+  test_history();
+  test_log();
+
+  return 0;
+}
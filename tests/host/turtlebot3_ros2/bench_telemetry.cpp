@@ -0,0 +1,176 @@
+/*
+  bench_telemetry.cpp - telemetry frames of the ROS2 firmware through the
+  stubbed USB port at the intervals the ROS2 node can set
+
+  Simulated time: the main loop puts a frame in the slot at the interval of
+  ADDR_TELEMETRY_INTERVAL, the slave interrupt sends it every 250 us when
+  the CDC buffer has room, the USB host empties the buffer every ms. A frame
+  put before the one in the slot was sent is counted as the firmware counts
+  ADDR_TELEMETRY_DROP. The bytes on the port go through the decoder of the
+  ROS2 node, its lost count has to match the drops.
+
+  Prints the frames per second that arrive, the drops and the host time
+  of encoding and putting one frame.
+
+    bench_telemetry [seconds]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <Arduino.h>
+#include "turtlebot3/turtlebot3_telemetry.h"
+#include "host_stub.h"
+
+
+#define BENCH_SLAVE_PERIOD_US   250     // INTERVAL_US_TO_PROCESS_DXL_SLAVE
+#define BENCH_CDC_BUFFER        2048    // APP_TX_DATA_SIZE
+#define BENCH_USB_PERIOD_US     1000
+
+
+typedef std::chrono::steady_clock bench_clock;
+
+typedef struct
+{
+  const char *name;
+  uint32_t    bytes_per_ms;   // the host takes from the CDC buffer
+  uint32_t    stall_ms;       // the host takes nothing for this long every second
+} bench_usb_t;
+
+typedef struct
+{
+  uint32_t put;
+  uint32_t drop;              // ADDR_TELEMETRY_DROP
+  uint32_t frames;            // decoded
+  uint32_t lost;              // by the decoder
+  uint32_t errors;
+  double   put_us;            // host time of encoding and putting one frame
+} bench_result_t;
+
+
+static void fill( TelemetryData *p_data, uint32_t n )
+{
+  int i;
+
+  memset(p_data, 0, sizeof(TelemetryData));
+  p_data->stamp_us = micros();
+  for (i = 0; i < 3; i++)
+  {
+    p_data->angular_vel[i] = 0.01f * (float)(n % 100) + i;
+    p_data->linear_acc[i]  = 9.81f - 0.001f * (float)(n % 1000) + i;
+    p_data->magnetic[i]    = 30.0f + i;
+  }
+  p_data->orientation[0]      = 1.0f;
+  p_data->present_position[0] = (int32_t)n;
+  p_data->present_position[1] = -(int32_t)n;
+  p_data->bat_voltage_x100    = 1200;
+}
+
+static bench_result_t bench( uint32_t interval_ms, const bench_usb_t &usb, uint32_t seconds )
+{
+  Turtlebot3TelemetrySlot    slot;
+  Turtlebot3TelemetryDecoder decoder;
+  USBSerial     port;
+  TelemetryData data;
+  uint8_t       frame[TELEMETRY_FRAME_MAX_SIZE];
+  uint16_t      length;
+  bench_result_t result = { 0, 0, 0, 0, 0, 0.0 };
+  bench_clock::time_point start;
+  uint32_t pre_time = 0;
+  uint32_t used = 0;
+  uint32_t take;
+  uint32_t us;
+  uint8_t  seq = 0;
+  size_t   i;
+
+  for (us = 0; us < seconds * 1000000; us += BENCH_SLAVE_PERIOD_US)
+  {
+    host_set_micros(us);
+
+    // update_telemetry() of the main loop
+    if (millis() - pre_time >= interval_ms)
+    {
+      pre_time = millis();
+      fill(&data, result.put);
+
+      start = bench_clock::now();
+      length = encode_telemetry_frame(data, seq++, frame, sizeof(frame));
+      if (slot.put(frame, length) == false)
+      {
+        result.drop++;
+      }
+      result.put_us += std::chrono::duration<double, std::micro>(bench_clock::now() - start).count();
+      result.put++;
+    }
+
+    // dxl_slave_timer_handler()
+    port.tx_room = BENCH_CDC_BUFFER - used;
+    slot.send(port);
+    used += port.tx.size();
+
+    for (i = 0; i < port.tx.size(); i++)
+    {
+      if (decoder.parse(port.tx[i]) == true)
+      {
+        result.frames++;
+      }
+    }
+    port.tx.clear();
+
+    // The USB host
+    if (us % BENCH_USB_PERIOD_US == 0 && (us / 1000) % 1000 >= usb.stall_ms)
+    {
+      take = (used < usb.bytes_per_ms) ? used : usb.bytes_per_ms;
+      used -= take;
+    }
+  }
+
+  result.lost   = decoder.get_lost_count();
+  result.errors = decoder.get_error_count();
+  if (result.put > 0)
+  {
+    result.put_us /= result.put;
+  }
+  return result;
+}
+
+int main( int argc, char **argv )
+{
+  static const uint32_t interval[] = { 2, 5, 10, 20 };
+  // Full speed CDC carries about 1 MB/s, a busy host reads in bursts or slowly
+  static const bench_usb_t usb[] =
+  {
+    { "full speed",    1000,   0 },
+    { "stall 100ms/s", 1000, 100 },
+    { "60 kB/s",         60,   0 },
+    { "30 kB/s",         30,   0 },
+  };
+  bench_result_t result;
+  uint32_t seconds = 10;
+  uint32_t i;
+  uint32_t j;
+
+  if (argc > 1)
+  {
+    seconds = strtoul(argv[1], NULL, 0);
+  }
+  if (seconds == 0)
+  {
+    return 2;
+  }
+
+  printf("%-14s %11s %9s %9s %7s %7s %7s %10s\n",
+         "usb", "interval ms", "put/s", "frames/s", "drop", "lost", "errors", "us/put");
+  for (i = 0; i < sizeof(usb) / sizeof(usb[0]); i++)
+  {
+    for (j = 0; j < sizeof(interval) / sizeof(interval[0]); j++)
+    {
+      result = bench(interval[j], usb[i], seconds);
+      printf("%-14s %11u %9.1f %9.1f %7u %7u %7u %10.3f\n",
+             usb[i].name, interval[j], (double)result.put / seconds, (double)result.frames / seconds,
+             result.drop, result.lost, result.errors, result.put_us);
+    }
+  }
+
+  return 0;
+}
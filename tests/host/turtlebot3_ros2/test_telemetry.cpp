@@ -0,0 +1,210 @@
+/*
+  test_telemetry.cpp - telemetry frames of the ROS2 firmware decode to what
+  was encoded, on a port shared with DYNAMIXEL packets
+*/
+
+#include <string.h>
+#include <vector>
+#include "turtlebot3/turtlebot3_telemetry.h"
+#include "host_test.h"
+
+
+static uint32_t test_seed = 1;
+
+static uint32_t test_random( void )
+{
+  test_seed = test_seed * 1664525u + 1013904223u;
+  return test_seed >> 8;
+}
+
+static void fill( TelemetryData *p_data )
+{
+  uint8_t *p_byte = (uint8_t *)p_data;
+  size_t   i;
+
+  memset(p_data, 0, sizeof(TelemetryData));
+  for (i = 0; i < sizeof(TelemetryData); i++)
+  {
+    p_byte[i] = (uint8_t)test_random();
+  }
+}
+
+static bool same( const TelemetryData &a, const TelemetryData &b )
+{
+  return a.stamp_us == b.stamp_us
+      && memcmp(a.angular_vel, b.angular_vel, sizeof(a.angular_vel)) == 0
+      && memcmp(a.linear_acc, b.linear_acc, sizeof(a.linear_acc)) == 0
+      && memcmp(a.magnetic, b.magnetic, sizeof(a.magnetic)) == 0
+      && memcmp(a.orientation, b.orientation, sizeof(a.orientation)) == 0
+      && memcmp(a.present_position, b.present_position, sizeof(a.present_position)) == 0
+      && memcmp(a.present_velocity, b.present_velocity, sizeof(a.present_velocity)) == 0
+      && memcmp(a.present_current, b.present_current, sizeof(a.present_current)) == 0
+      && a.torque_enable == b.torque_enable
+      && a.buttons == b.buttons
+      && a.bat_voltage_x100 == b.bat_voltage_x100;
+}
+
+static std::vector<uint8_t> encode( const TelemetryData &data, uint8_t seq )
+{
+  uint8_t  frame[TELEMETRY_FRAME_MAX_SIZE];
+  uint16_t length;
+
+  length = encode_telemetry_frame(data, seq, frame, sizeof(frame));
+  CHECK(length > 0 && length <= TELEMETRY_FRAME_MAX_SIZE);
+
+  return std::vector<uint8_t>(frame, frame + length);
+}
+
+// Frames decoded from bytes
+static int feed( Turtlebot3TelemetryDecoder &decoder, const std::vector<uint8_t> &bytes )
+{
+  int    frames = 0;
+  size_t i;
+
+  for (i = 0; i < bytes.size(); i++)
+  {
+    if (decoder.parse(bytes[i]) == true)
+    {
+      frames++;
+    }
+  }
+
+  return frames;
+}
+
+// 0xFF 0xFF 0xFD and a reserved byte, 0xFF 0xFF 0xFD 0xFD is a stuffed 0xFD
+static bool has_dxl_header( const std::vector<uint8_t> &bytes )
+{
+  size_t i;
+
+  for (i = 3; i < bytes.size(); i++)
+  {
+    if (bytes[i-3] == 0xFF && bytes[i-2] == 0xFF && bytes[i-1] == 0xFD && bytes[i] != 0xFD)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void test_round_trip( void )
+{
+  Turtlebot3TelemetryDecoder decoder;
+  TelemetryData data;
+  std::vector<uint8_t> frame;
+  uint32_t n;
+
+  for (n = 0; n < 10000; n++)
+  {
+    fill(&data);
+    frame = encode(data, (uint8_t)n);
+
+    CHECK(feed(decoder, frame) == 1);
+    CHECK(same(decoder.get_data(), data));
+    CHECK(decoder.get_seq() == (uint8_t)n);
+  }
+  CHECK(decoder.get_frame_count() == 10000);
+  CHECK(decoder.get_error_count() == 0);
+  CHECK(decoder.get_lost_count() == 0);
+}
+
+static void test_stuffing( void )
+{
+  Turtlebot3TelemetryDecoder decoder;
+  TelemetryData data;
+  std::vector<uint8_t> frame;
+  uint8_t *p_byte = (uint8_t *)&data.angular_vel;
+  size_t   i;
+
+  // DYNAMIXEL headers all over the payload, one at its end
+  fill(&data);
+  for (i = 0; i + 3 <= sizeof(data.angular_vel) + sizeof(data.linear_acc); i += 3)
+  {
+    p_byte[i]   = 0xFF;
+    p_byte[i+1] = 0xFF;
+    p_byte[i+2] = 0xFD;
+  }
+  data.bat_voltage_x100 = 0xFDFFFF00;
+
+  frame = encode(data, 7);
+  CHECK(has_dxl_header(frame) == false);
+
+  CHECK(feed(decoder, frame) == 1);
+  CHECK(same(decoder.get_data(), data));
+
+  // The next frame is not disturbed by the stuffed byte after the last one
+  fill(&data);
+  CHECK(feed(decoder, encode(data, 8)) == 1);
+  CHECK(same(decoder.get_data(), data));
+  CHECK(decoder.get_error_count() == 0);
+}
+
+static void test_shared_port( void )
+{
+  Turtlebot3TelemetryDecoder decoder;
+  TelemetryData data;
+  std::vector<uint8_t> bytes;
+  std::vector<uint8_t> frame;
+  // DYNAMIXEL status packet of ID 200 (ping)
+  static const uint8_t dxl_packet[] = { 0xFF, 0xFF, 0xFD, 0x00, 0xC8, 0x07, 0x00, 0x55, 0x00, 0x06, 0x04, 0x26, 0x65, 0x5D };
+
+  fill(&data);
+  frame = encode(data, 1);
+
+  // Packets and noise between the frames are skipped
+  bytes.insert(bytes.end(), dxl_packet, dxl_packet + sizeof(dxl_packet));
+  bytes.insert(bytes.end(), frame.begin(), frame.end());
+  bytes.insert(bytes.end(), dxl_packet, dxl_packet + sizeof(dxl_packet));
+  bytes.push_back(0xFF);
+  bytes.push_back(0x00);
+  CHECK(feed(decoder, bytes) == 1);
+  CHECK(same(decoder.get_data(), data));
+
+  // A packet cutting a frame drops it, the frame after it is decoded
+  bytes.assign(frame.begin(), frame.begin() + 30);
+  bytes.insert(bytes.end(), dxl_packet, dxl_packet + sizeof(dxl_packet));
+  fill(&data);
+  frame = encode(data, 2);
+  bytes.insert(bytes.end(), frame.begin(), frame.end());
+  CHECK(feed(decoder, bytes) == 1);
+  CHECK(same(decoder.get_data(), data));
+  CHECK(decoder.get_error_count() == 1);
+}
+
+static void test_errors( void )
+{
+  Turtlebot3TelemetryDecoder decoder;
+  TelemetryData data;
+  std::vector<uint8_t> frame;
+  uint8_t small[TELEMETRY_FRAME_MAX_SIZE - 1];
+
+  fill(&data);
+  CHECK(encode_telemetry_frame(data, 0, small, sizeof(small)) == 0);
+
+  // A changed byte fails the CRC
+  frame = encode(data, 10);
+  frame[20] ^= 0x01;
+  CHECK(feed(decoder, frame) == 0);
+  CHECK(decoder.get_error_count() == 1);
+  CHECK(decoder.get_frame_count() == 0);
+
+  // Frames that did not arrive are counted, across the wrap of seq
+  CHECK(feed(decoder, encode(data, 250)) == 1);
+  CHECK(feed(decoder, encode(data, 253)) == 1);
+  CHECK(decoder.get_lost_count() == 2);
+  CHECK(feed(decoder, encode(data, 254)) == 1);
+  CHECK(feed(decoder, encode(data, 255)) == 1);
+  CHECK(feed(decoder, encode(data, 0)) == 1);
+  CHECK(feed(decoder, encode(data, 2)) == 1);
+  CHECK(decoder.get_lost_count() == 3);
+}
+
+int main( void )
+{
+  test_round_trip();
+  test_stuffing();
+  test_shared_port();
+  test_errors();
+
+  return 0;
+}